@@ -4,6 +4,34 @@
 
 namespace vcg = volcart::gui;
 
+namespace
+{
+// Percentiles of the display window when the volume has histograms
+constexpr double WINDOW_LOW{0.1};
+constexpr double WINDOW_HIGH{99.9};
+
+// Quantize a slice for display. Uses a window fixed for the whole volume if
+// its histograms are available, so that contrast is consistent between
+// slices. Otherwise, falls back to plain bit-depth reduction.
+auto DisplayImage(const volcart::Volume& volume, const cv::Mat& slice)
+    -> cv::Mat
+{
+    auto hist = volume.histogram();
+    if (!hist || slice.depth() != CV_16U) {
+        return volcart::QuantizeImage(slice, CV_8U, false);
+    }
+    auto lo = hist->percentile(WINDOW_LOW);
+    auto hi = hist->percentile(WINDOW_HIGH);
+    if (hi <= lo) {
+        return volcart::QuantizeImage(slice, CV_8U, false);
+    }
+    cv::Mat result;
+    auto scale = 255. / (hi - lo);
+    slice.convertTo(result, CV_8U, scale, -lo * scale);
+    return result;
+}
+}  // namespace
+
 vcg::FetchSliceThread::FetchSliceThread(
     volcart::Volume::Pointer volume, QObject* parent)
     : QThread(parent), volume_(std::move(volume))
@@ -47,7 +75,7 @@ void vcg::FetchSliceThread::run()
 
         if (!restart_) {
             const auto slice = volume_->getSliceDataCopy(sliceIdx);
-            auto src = volcart::QuantizeImage(slice, CV_8U, false);
+            auto src = DisplayImage(*volume_, slice);
             emit fetchedSlice(src);
         }
 
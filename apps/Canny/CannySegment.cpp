@@ -2,6 +2,9 @@
 #pragma ide diagnostic ignored "readability-identifier-length"
 #pragma clang diagnostic ignored "-Wunknown-pragmas"
 #pragma ide diagnostic ignored "cppcoreguidelines-avoid-magic-numbers"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <iostream>
 #include <vector>
@@ -9,13 +12,6 @@
 #include <QApplication>
 #include <boost/program_options.hpp>
 #include <opencv2/imgcodecs.hpp>
-#include <vtkAppendPolyData.h>
-#include <vtkCleanPolyData.h>
-#include <vtkCutter.h>
-#include <vtkLine.h>
-#include <vtkPointData.h>
-#include <vtkProbeFilter.h>
-#include <vtkSmartPointer.h>
 
 #include "CannyViewerWindow.hpp"
 #include "vc/app_support/ProgressIndicator.hpp"
@@ -27,17 +23,161 @@
 #include "vc/core/types/VolumePkg.hpp"
 #include "vc/core/util/ImageConversion.hpp"
 #include "vc/core/util/Iteration.hpp"
+#include "vc/core/util/MeshSliceIndex.hpp"
+#include "vc/core/util/Parallel.hpp"
 #include "vc/core/util/String.hpp"
-#include "vc/meshing/ITK2VTK.hpp"
 
 namespace fs = volcart::filesystem;
 namespace po = boost::program_options;
 namespace vc = volcart;
-namespace vcm = volcart::meshing;
 
 using vc::range;
 using vc::range2D;
 
+namespace
+{
+// Segment a single slice, returning the detected surface points
+auto SegmentSlice(
+    const vc::Volume::Pointer& volume,
+    int z,
+    const vc::CannySettings& cannySettings,
+    const vc::MeshSliceIndex* sliceIndex) -> std::vector<cv::Vec3d>
+{
+    std::vector<cv::Vec3d> result;
+    cv::Vec3d first;
+    cv::Vec3d last;
+
+    // Get the slice
+    auto slice =
+        vc::QuantizeImage(volume->getSliceDataCopy(z), CV_8UC1, false);
+
+    auto processed = vc::Canny(slice, cannySettings);
+
+    // Keep all edges
+    if (cannySettings.projectionFrom == 'N') {
+        for (const auto pt : range2D(processed.rows, processed.cols)) {
+            const auto& x = pt.second;
+            const auto& y = pt.first;
+            if (processed.at<std::uint8_t>(y, x) > 0) {
+                result.emplace_back(
+                    static_cast<double>(x), static_cast<double>(y),
+                    static_cast<double>(z));
+            }
+        }
+        return result;
+    }
+
+    // Build the set of rays that will be projected to find the edges
+    std::vector<cv::Vec2d> rayBases;
+    std::vector<cv::Vec2d> rayOrigins;
+
+    if (cannySettings.projectionFrom == 'L') {
+        for (auto y : range(processed.rows)) {
+            rayOrigins.push_back({0, static_cast<double>(y)});
+            rayBases.push_back({1, 0});
+        }
+    } else if (cannySettings.projectionFrom == 'R') {
+        for (auto y : range(processed.rows)) {
+            rayOrigins.push_back({static_cast<double>(processed.cols - 1), static_cast<double>(y)});
+            rayBases.push_back({-1, 0});
+        }
+    } else if (cannySettings.projectionFrom == 'T') {
+        for (auto x : range(processed.cols)) {
+            rayOrigins.push_back({static_cast<double>(x), 0});
+            rayBases.push_back({0, 1});
+        }
+    } else if (cannySettings.projectionFrom == 'B') {
+        for (auto x : range(processed.cols)) {
+            rayOrigins.push_back({static_cast<double>(x), static_cast<double>(processed.rows - 1)});
+            rayBases.push_back({0, -1});
+        }
+    } else if (cannySettings.projectionFrom == 'M' || cannySettings.projectionFrom == 'I') {
+        // go through the mesh faces which intersect this slice
+        for (const auto& seg : sliceIndex->intersect(z)) {
+            const auto& p0 = seg.points[0];
+            const auto& p1 = seg.points[1];
+            const auto& n0 = seg.normals[0];
+            const auto& n1 = seg.normals[1];
+
+            const auto length = cv::norm(p1 - p0);
+            const cv::Vec3d step = (p1 - p0) / length;
+
+            for (auto t = 0; t < static_cast<int>(length); ++t) {
+                auto p = p0 + step * t;
+                // interpolate the normal along the segment
+                cv::Vec3d n = n0 + (n1 - n0) * (t / length);
+                // project normal to xy plane
+                n[2] = 0;
+                // skip normals without an xy component
+                const auto nLength = cv::norm(n);
+                if (nLength == 0) {
+                    continue;
+                }
+                // normalize
+                n = n / nLength;
+                // invert normal if needed
+                if (cannySettings.projectionFrom == 'I') {
+                    n = -n;
+                }
+                // add point to ray origins after converting to 2d
+                rayOrigins.push_back({p[0], p[1]});
+                // add normal to ray bases after converting to 2d
+                rayBases.push_back({n[0], n[1]});
+            }
+        }
+    }
+
+    for (auto r : range(rayBases.size())) {
+        const auto& rayBasis = rayBases[r];
+        const auto& rayOrigin = rayOrigins[r];
+
+        // Get the first
+        auto haveFirst = false;
+
+        auto pt = rayOrigin;
+        int xI = static_cast<int>(pt[0]);
+        int yI = static_cast<int>(pt[1]);
+        while (
+            xI >= 0
+            && xI < processed.cols
+            && yI >= 0
+            && yI < processed.rows
+        ) {
+            // if point is on detected edge
+            if (!haveFirst && processed.at<std::uint8_t>(yI, xI) != 0) {
+                // set first
+                first = {pt[0], pt[1], static_cast<double>(z)};
+                last = first;
+                haveFirst = true;
+                continue;
+            }
+
+            if (cannySettings.midpoint && haveFirst &&
+                processed.at<std::uint8_t>(yI, xI) != 0) {
+                last = {pt[0], pt[1], static_cast<double>(z)};
+            }
+
+            if (!cannySettings.midpoint && haveFirst) {
+                break;
+            }
+
+            // move point along ray
+            pt += rayBasis * 0.5;
+            xI = static_cast<int>(pt[0]);
+            yI = static_cast<int>(pt[1]);
+        }
+
+        if (!haveFirst) {
+            continue;
+        }
+
+        result.emplace_back((first + last) / 2);
+    }
+
+    return result;
+}
+}  // namespace
+
 auto main(int argc, char* argv[]) -> int
 {
     ///// Parse the command line options /////
@@ -49,7 +189,10 @@ auto main(int argc, char* argv[]) -> int
         ("volume", po::value<std::string>(),
            "Volume to use for segmentation. Default: First volume")
         ("output-file,o", po::value<std::string>()->required(),
-           "Output mesh path (PLY)");
+           "Output mesh path (PLY)")
+        ("threads", po::value<std::size_t>()->default_value(0),
+           "Number of slices to segment in parallel. Default: Number of "
+           "hardware threads");
 
     po::options_description segOpts("Segmentation Options");
     segOpts.add_options()
@@ -155,41 +298,19 @@ auto main(int argc, char* argv[]) -> int
 
     // Get meshes
     std::cout << "Loading meshes..." << std::endl;
-    std::vector<vtkSmartPointer<vtkPolyData>> meshes;
+    std::vector<vc::ITKMesh::Pointer> meshes;
     for (const auto& meshPath : cannySettings.fromMeshes) {
-        auto meshFile = vc::ReadMesh(meshPath);
-        auto vtkMesh = vcm::ITK2VTK(meshFile.mesh);
-        meshes.push_back(vtkMesh);
-    }
-
-    // Combine meshes if we have multiple
-    vtkSmartPointer<vtkPolyData> vtkMesh;
-    if (meshes.size() > 1) {
-        // Append all the meshes into a single polydata
-        auto append = vtkSmartPointer<vtkAppendPolyData>::New();
-        for (const auto& mesh : meshes) {
-            append->AddInputData(mesh);
-        }
-        append->Update();
-
-        // Clean it up
-        auto cleaner = vtkSmartPointer<vtkCleanPolyData>::New();
-        cleaner->SetInputConnection(append->GetOutputPort());
-        cleaner->Update();
-
-        vtkMesh = cleaner->GetOutput();
-    } else if (meshes.size() == 1) {
-        vtkMesh = meshes[0];
+        meshes.push_back(vc::ReadMesh(meshPath).mesh);
     }
 
-    vtkSmartPointer<vtkCutter> cutter;
-    vtkSmartPointer<vtkPlane> plane;
-    if (vtkMesh != nullptr) {
-        cutter = vtkSmartPointer<vtkCutter>::New();
-        plane = vtkSmartPointer<vtkPlane>::New();
+    // Index the faces by z so that each slice only intersects the faces which
+    // span it
+    vc::MeshSliceIndex::Pointer sliceIndex;
+    if (not meshes.empty()) {
+        sliceIndex = vc::MeshSliceIndex::New(meshes);
 
-        auto zMin = static_cast<int>(std::floor(vtkMesh->GetBounds()[4]));
-        auto zMax = static_cast<int>(std::ceil(vtkMesh->GetBounds()[5]));
+        auto zMin = static_cast<int>(std::floor(sliceIndex->zMin()));
+        auto zMax = static_cast<int>(std::ceil(sliceIndex->zMax()));
 
         // Bounds checks
         if (zMin < 0) {
@@ -204,17 +325,6 @@ auto main(int argc, char* argv[]) -> int
 
         cannySettings.zMin = zMin;
         cannySettings.zMax = zMax;
-
-        plane->SetOrigin(
-            static_cast<double>(volume->sliceWidth()) / 2,
-            static_cast<double>(volume->sliceHeight()) / 2,
-            0
-        );
-        plane->SetNormal(0, 0, 1);
-
-        cutter->SetInputData(vtkMesh);
-        cutter->SetCutFunction(plane);
-        cutter->Update();
     }
     /**************************************************************************/
 
@@ -231,202 +341,44 @@ auto main(int argc, char* argv[]) -> int
 
     // check that if project from is 'M' or 'I' that we have a mesh
     if ((cannySettings.projectionFrom == 'M' ||
-         cannySettings.projectionFrom == 'I') &&
-        vtkMesh == nullptr) {
-        std::cerr << "ERROR: projection-from=[M,I] requires --from-mesh to be "
-                     "specified\n";
-        return EXIT_FAILURE;
+         cannySettings.projectionFrom == 'I')) {
+        if (sliceIndex == nullptr) {
+            std::cerr << "ERROR: projection-from=[M,I] requires --from-mesh "
+                         "to be specified\n";
+            return EXIT_FAILURE;
+        }
+        if (not sliceIndex->hasNormals()) {
+            std::cerr << "Error: Input mesh has no normals\n";
+            return EXIT_FAILURE;
+        }
     }
 
-    // Segment
+    // Segment batches of slices in parallel. Each slice's points are kept
+    // separately and added to the mesh in slice order.
     std::cout << "Segmenting surface..." << std::endl;
     auto mesh = vc::ITKMesh::New();
-    cv::Vec3d first;
-    cv::Vec3d middle;
-    cv::Vec3d last;
-    auto zMin = static_cast<int>(cannySettings.zMin);
-    auto zMax = static_cast<int>(cannySettings.zMax);
-    for (const auto& z : ProgressWrap(range(zMin, zMax), "Slice:")) {
-        // Get the slice
-        auto slice =
-            vc::QuantizeImage(volume->getSliceDataCopy(z), CV_8UC1, false);
-
-        auto processed = vc::Canny(slice, cannySettings);
-
-        // Keep all edges
-        if (cannySettings.projectionFrom == 'N') {
-            for (const auto pt : range2D(processed.rows, processed.cols)) {
-                const auto& x = pt.second;
-                const auto& y = pt.first;
-                if (processed.at<std::uint8_t>(y, x) > 0) {
-                    middle = {
-                        static_cast<double>(x), static_cast<double>(y),
-                        static_cast<double>(z)};
-                    mesh->SetPoint(mesh->GetNumberOfPoints(), middle.val);
-                }
-            }
-            continue;
-        }
-
-        // Build the set of rays that will be projected to find the edges
-        std::vector<cv::Vec2d> rayBases;
-        std::vector<cv::Vec2d> rayOrigins;
-
-        if (cannySettings.projectionFrom == 'L') {
-            for (auto y : range(processed.rows)) {
-                rayOrigins.push_back({0, static_cast<double>(y)});
-                rayBases.push_back({1, 0});
-            }
-        } else if (cannySettings.projectionFrom == 'R') {
-            for (auto y : range(processed.rows)) {
-                rayOrigins.push_back({static_cast<double>(processed.cols - 1), static_cast<double>(y)});
-                rayBases.push_back({-1, 0});
-            }
-        } else if (cannySettings.projectionFrom == 'T') {
-            for (auto x : range(processed.cols)) {
-                rayOrigins.push_back({static_cast<double>(x), 0});
-                rayBases.push_back({0, 1});
-            }
-        } else if (cannySettings.projectionFrom == 'B') {
-            for (auto x : range(processed.cols)) {
-                rayOrigins.push_back({static_cast<double>(x), static_cast<double>(processed.rows - 1)});
-                rayBases.push_back({0, -1});
-            }
-        } else if (cannySettings.projectionFrom == 'M' || cannySettings.projectionFrom == 'I') {
-            if (plane == nullptr || cutter == nullptr) {
-                std::cerr << "Error: Projection from mesh requested but mesh "
-                             "cutter not initialized\n";
-                return EXIT_FAILURE;
-            }
-            // update plane Z
-            plane->SetOrigin(0, 0, static_cast<double>(z));
-            cutter->Update();
-
-            // get cutter output
-            const vtkSmartPointer<vtkPolyData> cutterOutput =
-                cutter->GetOutput();
-
-            // vtk list of points
-            auto points = vtkSmartPointer<vtkPoints>::New();
-
-            // go through line segments
-            for (auto i = 0; i < cutterOutput->GetNumberOfCells(); ++i) {
-                // get cell
-                const vtkSmartPointer<vtkCell> cell = cutterOutput->GetCell(i);
-
-                // get points as cv::Vec3d
-                const cv::Vec3d p0{cell->GetPoints()->GetPoint(0)};
-                const cv::Vec3d p1{cell->GetPoints()->GetPoint(1)};
-
-                const auto length = cv::norm(p1 - p0);
-                const cv::Vec3d step = (p1 - p0) / length;
-
-                for (auto t = 0; t < static_cast<int>(length); ++t) {
-                    auto p = p0 + step * t;
-                    points->InsertNextPoint(p.val);
-                }
-            }
-
-            // if zero points, skip
-            if (points->GetNumberOfPoints() == 0) {
-                continue;
-            }
-
-            // create polydata
-            const auto pointsPolyData = vtkSmartPointer<vtkPolyData>::New();
-            pointsPolyData->SetPoints(points);
-
-            // use probe filter
-            const auto probeFilter = vtkSmartPointer<vtkProbeFilter>::New();
-            probeFilter->SetInputData(pointsPolyData);
-            probeFilter->SetSourceData(vtkMesh);
-            probeFilter->Update();
-
-            // get probe output
-            const vtkSmartPointer<vtkDataSet> probeOutput =
-                probeFilter->GetOutput();
-
-            // get normal vectors
-            const vtkSmartPointer<vtkDataArray> normals =
-                probeOutput->GetPointData()->GetNormals();
-
-            // check if normals exist
-            if (normals == nullptr) {
-                std::cerr << "Error: Input mesh has no normals\n";
-                return EXIT_FAILURE;
+    auto zMin = static_cast<std::size_t>(cannySettings.zMin);
+    auto zMax = static_cast<std::size_t>(cannySettings.zMax);
+    auto numThreads = vc::NumWorkerThreads(parsed["threads"].as<std::size_t>());
+    auto batchSize = 4 * numThreads;
+    auto numBatches = (zMax - zMin + batchSize - 1) / batchSize;
+    std::vector<std::vector<cv::Vec3d>> slicePoints(batchSize);
+    for (const auto& b : ProgressWrap(range(numBatches), "Slice batch:")) {
+        auto z0 = zMin + b * batchSize;
+        auto z1 = std::min(z0 + batchSize, zMax);
+        vc::ParallelFor(
+            0, z1 - z0,
+            [&](std::size_t i) {
+                slicePoints[i] = SegmentSlice(
+                    volume, static_cast<int>(z0 + i), cannySettings,
+                    sliceIndex.get());
+            },
+            numThreads, 1);
+        for (auto i : range(z1 - z0)) {
+            for (const auto& pt : slicePoints[i]) {
+                mesh->SetPoint(mesh->GetNumberOfPoints(), pt.val);
             }
-
-            // go through points and normals
-            for (auto i = 0; i < probeOutput->GetNumberOfPoints(); ++i) {
-                // get point
-                cv::Vec3d p{probeOutput->GetPoint(i)};
-                // get normal
-                cv::Vec3d n{normals->GetTuple(i)};
-                // check if normal is all zeros
-                if (n[0] == 0 && n[1] == 0 && n[2] == 0) {
-                    continue;
-                }
-                // project normal to xy plane
-                n[2] = 0;
-                // normalize
-                n = n / cv::norm(n);
-                // invert normal if needed
-                if (cannySettings.projectionFrom == 'I') {
-                    n = -n;
-                }
-                // add point to ray origins after converting to 2d
-                rayOrigins.push_back({p[0], p[1]});
-                // add normal to ray bases after converting to 2d
-                rayBases.push_back({n[0], n[1]});
-            }
-        }
-
-        for (auto r : range(rayBases.size())) {
-            const auto& rayBasis = rayBases[r];
-            const auto& rayOrigin = rayOrigins[r];
-
-            // Get the first
-            auto haveFirst = false;
-
-            auto pt = rayOrigin;
-            int xI = static_cast<int>(pt[0]);
-            int yI = static_cast<int>(pt[1]);
-            while (
-                xI >= 0
-                && xI < processed.cols
-                && yI >= 0
-                && yI < processed.rows
-            ) {
-                // if point is on detected edge
-                if (!haveFirst && processed.at<std::uint8_t>(yI, xI) != 0) {
-                    // set first
-                    first = {pt[0], pt[1], static_cast<double>(z)};
-                    last = first;
-                    haveFirst = true;
-                    continue;
-                }
-
-                if (cannySettings.midpoint && haveFirst &&
-                    processed.at<std::uint8_t>(yI, xI) != 0) {
-                    last = {pt[0], pt[1], static_cast<double>(z)};
-                }
-
-                if (!cannySettings.midpoint && haveFirst) {
-                    break;
-                }
-
-                // move point along ray
-                pt += rayBasis * 0.5;
-                xI = static_cast<int>(pt[0]);
-                yI = static_cast<int>(pt[1]);
-            }
-
-            if (!haveFirst) {
-                continue;
-            }
-
-            middle = (first + last) / 2;
-            mesh->SetPoint(mesh->GetNumberOfPoints(), middle.val);
+            slicePoints[i].clear();
         }
     }
 
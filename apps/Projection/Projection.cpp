@@ -11,12 +11,6 @@
 #include <opencv2/core.hpp>
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/imgproc.hpp>
-#include <vtkAppendPolyData.h>
-#include <vtkCleanPolyData.h>
-#include <vtkCutter.h>
-#include <vtkPlane.h>
-#include <vtkSmartPointer.h>
-#include <vtkStripper.h>
 
 #include "ProjectionViewerWindow.hpp"
 #include "vc/app_support/ProgressIndicator.hpp"
@@ -26,12 +20,11 @@
 #include "vc/core/types/VolumePkg.hpp"
 #include "vc/core/util/Iteration.hpp"
 #include "vc/core/util/Logging.hpp"
-#include "vc/meshing/ITK2VTK.hpp"
+#include "vc/core/util/MeshSliceIndex.hpp"
 
 namespace po = boost::program_options;
 namespace fs = volcart::filesystem;
 namespace vc = volcart;
-namespace vcm = volcart::meshing;
 
 auto main(int argc, char* argv[]) -> int
 {
@@ -149,41 +142,16 @@ auto main(int argc, char* argv[]) -> int
 
     // Get meshes
     std::cout << "Loading meshes..." << std::endl;
-    std::vector<vtkSmartPointer<vtkPolyData>> meshes;
+    std::vector<vc::ITKMesh::Pointer> meshes;
     for (const auto& meshPath : meshPaths) {
-        auto meshFile = vc::ReadMesh(meshPath);
-        auto vtkMesh = vcm::ITK2VTK(meshFile.mesh);
-        meshes.push_back(vtkMesh);
+        meshes.push_back(vc::ReadMesh(meshPath).mesh);
     }
 
-    // Combine meshes if we have multiple
-    vtkSmartPointer<vtkPolyData> vtkMesh;
-    if (meshes.size() > 1) {
-        // Append all of the meshes into a single polydata
-        auto append = vtkSmartPointer<vtkAppendPolyData>::New();
-        for (auto& mesh : meshes) {
-            append->AddInputData(mesh);
-        }
-        append->Update();
-
-        // Clean it up
-        auto cleaner = vtkSmartPointer<vtkCleanPolyData>::New();
-        cleaner->SetInputConnection(append->GetOutputPort());
-        cleaner->Update();
-
-        vtkMesh = cleaner->GetOutput();
-    } else {
-        vtkMesh = meshes[0];
-    }
-
-    // Setup intersection plane
-    vtkSmartPointer<vtkPlane> cutPlane = vtkSmartPointer<vtkPlane>::New();
-    cutPlane->SetOrigin(width / 2.0, height / 2.0, 0);
-    cutPlane->SetNormal(0, 0, 1);
-    projectionSettings.zMin =
-        static_cast<int>(std::floor(vtkMesh->GetBounds()[4]));
-    projectionSettings.zMax =
-        static_cast<int>(std::ceil(vtkMesh->GetBounds()[5]));
+    // Index the mesh faces by z so that each slice only intersects the faces
+    // which span it
+    auto sliceIndex = vc::MeshSliceIndex::New(meshes);
+    projectionSettings.zMin = static_cast<int>(std::floor(sliceIndex->zMin()));
+    projectionSettings.zMax = static_cast<int>(std::ceil(sliceIndex->zMax()));
 
     // Bounds checks
     if (projectionSettings.zMin < 0) {
@@ -196,20 +164,11 @@ auto main(int argc, char* argv[]) -> int
         projectionSettings.zMax += 1;
     }
 
-    // Setup cutting and stripping pipeline
-    auto cutter = vtkSmartPointer<vtkCutter>::New();
-    cutter->SetCutFunction(cutPlane);
-    cutter->SetInputData(vtkMesh);
-
-    auto stripper = vtkSmartPointer<vtkStripper>::New();
-    stripper->SetInputConnection(cutter->GetOutputPort());
-
     if (parsed.count("visualize") > 0) {
         QApplication app(argc, argv);
         QGuiApplication::setApplicationDisplayName(
             ProjectionViewerWindow::tr("Projection Viewer"));
-        ProjectionViewerWindow viewer(
-            &projectionSettings, cutPlane, stripper, volume);
+        ProjectionViewerWindow viewer(&projectionSettings, sliceIndex, volume);
         viewer.show();
         QApplication::exec();
     }
@@ -223,9 +182,7 @@ auto main(int argc, char* argv[]) -> int
              vc::range(projectionSettings.zMin, projectionSettings.zMax),
              "vc::projection::Projecting:")) {
         // Cut the mesh and get the intersection
-        cutPlane->SetOrigin(width / 2.0, height / 2.0, zIdx);
-        stripper->Update();
-        auto* intersection = stripper->GetOutput();
+        auto intersection = sliceIndex->polylines(zIdx);
 
         // Setup the output image
         if (projectionSettings.intersectOnly) {
@@ -237,15 +194,11 @@ auto main(int argc, char* argv[]) -> int
         }
 
         // Draw the intersections
-        for (auto cId = 0; cId < intersection->GetNumberOfCells(); ++cId) {
-            auto* inputCell = intersection->GetCell(cId);
-
+        for (const auto& line : intersection) {
             contour.clear();
-            for (auto pIt = 0; pIt < inputCell->GetNumberOfPoints(); ++pIt) {
-                auto pId = inputCell->GetPointId(pIt);
-                contour.emplace_back(cv::Point(
-                    static_cast<int>(intersection->GetPoint(pId)[0]),
-                    static_cast<int>(intersection->GetPoint(pId)[1])));
+            for (const auto& p : line) {
+                contour.emplace_back(
+                    static_cast<int>(p[0]), static_cast<int>(p[1]));
             }
 
             cv::polylines(
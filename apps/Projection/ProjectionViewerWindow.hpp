@@ -19,10 +19,6 @@
 #include <QVBoxLayout>
 #include <QWaitCondition>
 #include <QWheelEvent>
-#include <vtkCutter.h>
-#include <vtkPlane.h>
-#include <vtkSmartPointer.h>
-#include <vtkStripper.h>
 
 #include "PPMProjectionViewerWidget.hpp"
 #include "Projection.hpp"
@@ -30,6 +26,7 @@
 #include "SliceProjectionViewerWidget.hpp"
 #include "vc/core/types/Volume.hpp"
 #include "vc/core/util/ImageConversion.hpp"
+#include "vc/core/util/MeshSliceIndex.hpp"
 
 class ProjectionViewerWindow : public QMainWindow
 {
@@ -40,8 +37,7 @@ class ProjectionViewerWindow : public QMainWindow
 public:
     explicit ProjectionViewerWindow(
         volcart::ProjectionSettings* settings,
-        const vtkSmartPointer<vtkPlane>& cutPlane,
-        const vtkSmartPointer<vtkStripper>& stripper,
+        const volcart::MeshSliceIndex::Pointer& sliceIndex,
         volcart::Volume::Pointer& volume,
         QWidget* parent = nullptr);
 
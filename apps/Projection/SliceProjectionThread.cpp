@@ -1,12 +1,8 @@
 #include "SliceProjectionThread.hpp"
 
 SliceProjectionThread::SliceProjectionThread(
-    vtkSmartPointer<vtkPlane> cutPlane,
-    vtkSmartPointer<vtkStripper> stripper,
-    QObject* parent)
-    : QThread(parent)
-    , cutPlane_(std::move(cutPlane))
-    , stripper_(std::move(stripper))
+    volcart::MeshSliceIndex::Pointer sliceIndex, QObject* parent)
+    : QThread(parent), sliceIndex_(std::move(sliceIndex))
 {
 }
 
@@ -47,13 +43,13 @@ void SliceProjectionThread::run()
         mutex_.lock();
         cv::Mat src = mat_;
         volcart::ProjectionSettings settings = settings_;
-        // Cut the mesh and get the intersection
-        cutPlane_->SetOrigin(
-            src.size().width / 2.0, src.size().height / 2.0, sliceIdx_);
-        stripper_->Update();
-        auto* intersection = stripper_->GetOutput();
+        auto sliceIdx = sliceIdx_;
         mutex_.unlock();
 
+        // Cut the mesh and get the intersection. The index is immutable, so
+        // this doesn't need the lock.
+        auto intersection = sliceIndex_->polylines(sliceIdx);
+
         if (!restart_) {
             cv::Mat outputImg;
             std::vector<cv::Point> contour;
@@ -67,16 +63,11 @@ void SliceProjectionThread::run()
             }
 
             // Draw the intersections
-            for (auto cId = 0; cId < intersection->GetNumberOfCells(); ++cId) {
-                auto* inputCell = intersection->GetCell(cId);
-
+            for (const auto& line : intersection) {
                 contour.clear();
-                for (auto pIt = 0; pIt < inputCell->GetNumberOfPoints();
-                     ++pIt) {
-                    auto pId = inputCell->GetPointId(pIt);
-                    contour.emplace_back(cv::Point(
-                        static_cast<int>(intersection->GetPoint(pId)[0]),
-                        static_cast<int>(intersection->GetPoint(pId)[1])));
+                for (const auto& p : line) {
+                    contour.emplace_back(
+                        static_cast<int>(p[0]), static_cast<int>(p[1]));
                 }
                 cv::polylines(
                     outputImg, contour, false, settings.color,
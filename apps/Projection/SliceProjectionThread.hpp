@@ -4,11 +4,9 @@
 #include <QThread>
 #include <QWaitCondition>
 #include <opencv2/core.hpp>
-#include <vtkPlane.h>
-#include <vtkSmartPointer.h>
-#include <vtkStripper.h>
 
 #include "Projection.hpp"
+#include "vc/core/util/MeshSliceIndex.hpp"
 
 class SliceProjectionThread : public QThread
 {
@@ -18,8 +16,7 @@ class SliceProjectionThread : public QThread
 
 public:
     explicit SliceProjectionThread(
-        vtkSmartPointer<vtkPlane> cutPlane,
-        vtkSmartPointer<vtkStripper> stripper,
+        volcart::MeshSliceIndex::Pointer sliceIndex,
         QObject* parent = nullptr);
     ~SliceProjectionThread() override;
 
@@ -41,6 +38,5 @@ private:
     cv::Mat mat_;
     volcart::ProjectionSettings settings_;
     int sliceIdx_;
-    vtkSmartPointer<vtkPlane> cutPlane_;
-    vtkSmartPointer<vtkStripper> stripper_;
+    volcart::MeshSliceIndex::Pointer sliceIndex_;
 };
@@ -7,10 +7,8 @@
 
 SliceProjectionViewerWidget::SliceProjectionViewerWidget(
     volcart::Volume::Pointer& volume,
-    vtkSmartPointer<vtkPlane> cutPlane,
-    vtkSmartPointer<vtkStripper> stripper)
-    : fetchSliceThread_(volume)
-    , projectionThread_(std::move(cutPlane), std::move(stripper))
+    volcart::MeshSliceIndex::Pointer sliceIndex)
+    : fetchSliceThread_(volume), projectionThread_(std::move(sliceIndex))
 {
     qRegisterMetaType<cv::Mat>("cv::Mat");
     connect(
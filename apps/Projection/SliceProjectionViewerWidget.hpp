@@ -4,11 +4,10 @@
 #include <QScrollArea>
 #include <QWidget>
 #include <opencv2/core.hpp>
-#include <vtkPlane.h>
-#include <vtkStripper.h>
 
 #include "SliceProjectionThread.hpp"
 #include "vc/core/types/Volume.hpp"
+#include "vc/core/util/MeshSliceIndex.hpp"
 #include "vc/gui_support/FetchSliceThread.hpp"
 #include "vc/gui_support/ImageScrollArea.hpp"
 
@@ -21,8 +20,7 @@ class SliceProjectionViewerWidget : public volcart::gui::ImageScrollArea
 public:
     SliceProjectionViewerWidget(
         volcart::Volume::Pointer& volume,
-        vtkSmartPointer<vtkPlane> cutPlane,
-        vtkSmartPointer<vtkStripper> stripper);
+        volcart::MeshSliceIndex::Pointer sliceIndex);
 
 signals:
     void sliceLoaded();
@@ -3,12 +3,42 @@
 #include "CVolumeViewer.hpp"
 #include "HBase.hpp"
 
+#include <cmath>
+
+#include "vc/core/util/ImageConversion.hpp"
+
 using namespace ChaoVis;
 using qga = QGuiApplication;
 
 #define BGND_RECT_MARGIN 8
 #define DEFAULT_TEXT_COLOR QColor(255, 255, 120)
 #define ZOOM_FACTOR 1.15
+#define TILE_SIZE 512
+#define BASE_IMAGE_Z -2
+#define TILE_Z -1
+
+namespace
+{
+// Wrap a slice region in a QImage. The result shares the buffer of the
+// region, so it has to be converted before the region is released.
+QImage TileToQImage(const cv::Mat& tile)
+{
+    if (tile.type() == CV_8UC1) {
+        return QImage(
+            tile.data, tile.cols, tile.rows, tile.step,
+            QImage::Format_Grayscale8);
+    }
+    if (tile.type() == CV_16UC1) {
+        return QImage(
+            tile.data, tile.cols, tile.rows, tile.step,
+            QImage::Format_Grayscale16);
+    }
+    auto converted = volcart::QuantizeImage(tile, CV_16U);
+    return QImage(
+        converted.data, converted.cols, converted.rows, converted.step,
+        QImage::Format_Grayscale16).copy();
+}
+}  // namespace
 
 // Constructor
 CVolumeViewerView::CVolumeViewerView(QWidget* parent)
@@ -172,6 +202,10 @@ CVolumeViewer::CVolumeViewer(QWidget* parent)
 
     fGraphicsView->viewport()->installEventFilter(this);
 
+    // Load the tiles which become visible while panning
+    connect(fGraphicsView->horizontalScrollBar(), &QScrollBar::valueChanged, this, [this]() { UpdateTiles(); });
+    connect(fGraphicsView->verticalScrollBar(), &QScrollBar::valueChanged, this, [this]() { UpdateTiles(); });
+
     fButtonsLayout = new QHBoxLayout;
     fButtonsLayout->addWidget(fZoomInBtn);
     fButtonsLayout->addWidget(fZoomOutBtn);
@@ -229,6 +263,40 @@ void CVolumeViewer::SetButtonsEnabled(bool state)
 }
 
 void CVolumeViewer::SetImage(const QImage& nSrc)
+{
+    ClearTiles();
+    fPyramid = nullptr;
+    fTileSliceIndex = -1;
+
+    SetBaseImage(nSrc, QTransform());
+}
+
+bool CVolumeViewer::SetSlice(volcart::SlicePyramid::Pointer pyramid, int nSliceIndex)
+{
+    // The coarsest level is always drawn beneath the tiles, so that regions
+    // whose tiles are not yet loaded are never blank
+    auto coarsest = pyramid->numLevels() - 1;
+    auto overview = pyramid->getSliceData(nSliceIndex, coarsest);
+    if (overview.empty()) {
+        return false;
+    }
+
+    ClearTiles();
+    fPyramid = std::move(pyramid);
+    fTileSliceIndex = nSliceIndex;
+
+    // Scale the overview up to full-resolution scene coordinates
+    auto full = fPyramid->levelSize(0);
+    auto transform = QTransform::fromScale(
+        static_cast<double>(full.width) / overview.cols,
+        static_cast<double>(full.height) / overview.rows);
+    SetBaseImage(TileToQImage(overview).copy(), transform);
+
+    UpdateTiles();
+    return true;
+}
+
+void CVolumeViewer::SetBaseImage(const QImage& nSrc, const QTransform& nTransform)
 {
     if (fImgQImage == nullptr) {
         fImgQImage = new QImage(nSrc);
@@ -242,14 +310,96 @@ void CVolumeViewer::SetImage(const QImage& nSrc)
     // Add the QPixmap to the scene as a QGraphicsPixmapItem
     if (!fBaseImageItem) {
         fBaseImageItem = fScene->addPixmap(pixmap);
+        fBaseImageItem->setZValue(BASE_IMAGE_Z);
     } else {
         fBaseImageItem->setPixmap(pixmap);
     }
+    fBaseImageItem->setTransform(nTransform);
 
     UpdateButtons();
     update();
 }
 
+// Load the visible tiles of the pyramid level matching the zoom and drop the
+// ones which scrolled out of view
+void CVolumeViewer::UpdateTiles(void)
+{
+    if (!fPyramid) {
+        return;
+    }
+
+    auto level = fPyramid->levelForScale(fScaleFactor);
+    if (level != fTileLevel) {
+        ClearTiles();
+        fTileLevel = level;
+    }
+
+    // The base image already shows the coarsest level
+    if (level == fPyramid->numLevels() - 1) {
+        return;
+    }
+
+    // Visible region in scene coordinates, which are full-resolution slice
+    // coordinates
+    auto full = fPyramid->levelSize(0);
+    auto size = fPyramid->levelSize(level);
+    auto sx = static_cast<double>(full.width) / size.width;
+    auto sy = static_cast<double>(full.height) / size.height;
+    auto visible = fGraphicsView->mapToScene(fGraphicsView->viewport()->rect()).boundingRect();
+    visible &= QRectF(0, 0, full.width, full.height);
+    if (visible.isEmpty()) {
+        ClearTiles();
+        return;
+    }
+
+    // Range of visible tiles at this level
+    auto tx0 = static_cast<int>(visible.left() / sx) / TILE_SIZE;
+    auto ty0 = static_cast<int>(visible.top() / sy) / TILE_SIZE;
+    auto tx1 = static_cast<int>(std::ceil(visible.right() / sx)) / TILE_SIZE;
+    auto ty1 = static_cast<int>(std::ceil(visible.bottom() / sy)) / TILE_SIZE;
+
+    for (auto it = fTileItems.begin(); it != fTileItems.end();) {
+        auto [tx, ty] = it->first;
+        if (tx < tx0 || tx > tx1 || ty < ty0 || ty > ty1) {
+            fScene->removeItem(it->second);
+            delete it->second;
+            it = fTileItems.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    auto flags = fSkipImageFormatConv ? Qt::NoFormatConversion : Qt::AutoColor;
+    for (int ty = ty0; ty <= ty1; ty++) {
+        for (int tx = tx0; tx <= tx1; tx++) {
+            if (fTileItems.count({tx, ty}) > 0) {
+                continue;
+            }
+
+            cv::Rect rect(tx * TILE_SIZE, ty * TILE_SIZE, TILE_SIZE, TILE_SIZE);
+            auto tile = fPyramid->getTile(fTileSliceIndex, level, rect);
+            if (tile.empty()) {
+                continue;
+            }
+
+            auto item = fScene->addPixmap(QPixmap::fromImage(TileToQImage(tile), flags));
+            item->setZValue(TILE_Z);
+            item->setTransform(QTransform::fromScale(sx, sy));
+            item->setPos(rect.x * sx, rect.y * sy);
+            fTileItems[{tx, ty}] = item;
+        }
+    }
+}
+
+void CVolumeViewer::ClearTiles(void)
+{
+    for (auto& [key, item] : fTileItems) {
+        fScene->removeItem(item);
+        delete item;
+    }
+    fTileItems.clear();
+}
+
 void CVolumeViewer::SetNumSlices(int num)
 {
     fImageIndexSpin->setMaximum(num);
@@ -257,6 +407,11 @@ void CVolumeViewer::SetNumSlices(int num)
 
 bool CVolumeViewer::eventFilter(QObject* watched, QEvent* event)
 {
+    // Resizing the view can reveal tiles
+    if (fGraphicsView && watched == fGraphicsView->viewport() && event->type() == QEvent::Resize) {
+        UpdateTiles();
+    }
+
     // Wheel events
     if (watched == fGraphicsView || (fGraphicsView && watched == fGraphicsView->viewport()) && event->type() == QEvent::Wheel) {
 
@@ -310,6 +465,7 @@ bool CVolumeViewer::eventFilter(QObject* watched, QEvent* event)
             currentRotation += delta;
             currentRotation = currentRotation % 360;
             fImageRotationSpin->setValue(currentRotation);
+            UpdateTiles();
             return true;
         } 
         // View scrolling
@@ -346,6 +502,7 @@ void CVolumeViewer::ScaleImage(double nFactor)
     fGraphicsView->scale(nFactor, nFactor);
 
     UpdateButtons();
+    UpdateTiles();
 }
 
 void CVolumeViewer::CenterOn(const QPointF& point)
@@ -361,6 +518,7 @@ void CVolumeViewer::SetRotation(int degrees)
         currentRotation += delta;
         currentRotation = currentRotation % 360;
         fImageRotationSpin->setValue(currentRotation);
+        UpdateTiles();
     }
 }
 
@@ -374,6 +532,7 @@ void CVolumeViewer::ResetRotation()
     fGraphicsView->rotate(-currentRotation);
     currentRotation = 0;
     fImageRotationSpin->setValue(currentRotation);
+    UpdateTiles();
 }
 
 // Handle zoom in click
@@ -400,6 +559,7 @@ void CVolumeViewer::OnResetClicked(void)
     fImageRotationSpin->setValue(currentRotation);
 
     UpdateButtons();
+    UpdateTiles();
 }
 
 // Handle next image click
@@ -454,6 +614,11 @@ void CVolumeViewer::UpdateButtons(void)
 // Reset the viewer
 void CVolumeViewer::Reset()
 {
+    ClearTiles();
+    fPyramid = nullptr;
+    fTileSliceIndex = -1;
+    fTileLevel = -1;
+
     if (fBaseImageItem) {
         delete fBaseImageItem;
         fBaseImageItem = nullptr;
@@ -2,6 +2,9 @@
 // Chao Du 2015 April
 #pragma once
 
+#include <map>
+#include <utility>
+
 #include <QtWidgets>
 #include <opencv2/core/core.hpp>
 #include <opencv2/imgproc.hpp>
@@ -11,6 +14,8 @@
 #include <QGraphicsScene>
 #include <QDebug>
 
+#include "vc/core/types/SlicePyramid.hpp"
+
 namespace ChaoVis
 {
 
@@ -69,6 +74,10 @@ public:
     void Reset();
 
     virtual void SetImage(const QImage& nSrc);
+    // Show a slice from a multi-resolution pyramid. Only the tiles of the
+    // pyramid level matching the current zoom which are visible in the
+    // viewport are converted and drawn. Returns false if the slice is missing.
+    bool SetSlice(volcart::SlicePyramid::Pointer pyramid, int nSliceIndex);
     void SetImageIndex(int nImageIndex)
     {
         fImageIndex = nImageIndex;
@@ -104,6 +113,9 @@ protected:
     void ScaleImage(double nFactor);
     void CenterOn(const QPointF& point);
     virtual void UpdateButtons(void);
+    void SetBaseImage(const QImage& nSrc, const QTransform& nTransform);
+    void UpdateTiles(void);
+    void ClearTiles(void);
 
 protected:
     // widget components
@@ -135,6 +147,12 @@ protected:
     bool fSkipImageFormatConv;
 
     QGraphicsPixmapItem* fBaseImageItem;
+
+    // tiled slice rendering
+    volcart::SlicePyramid::Pointer fPyramid;
+    int fTileSliceIndex{-1};
+    int fTileLevel{-1};
+    std::map<std::pair<int, int>, QGraphicsPixmapItem*> fTileItems;
 };  // class CVolumeViewer
 
 }  // namespace ChaoVis
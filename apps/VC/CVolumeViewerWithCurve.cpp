@@ -531,11 +531,10 @@ void CVolumeViewerWithCurve::WidgetLoc2ImgLoc(
 
     QPointF scenePoint = fGraphicsView->mapToScene(widgetPoint.toPoint());
 
-    // Step 2: Convert scene coordinates to item coordinates
-    QPointF itemPoint = fBaseImageItem->mapFromScene(scenePoint);
-
-    nImgLoc[0] = static_cast<float>(itemPoint.x());
-    nImgLoc[1] = static_cast<float>(itemPoint.y());
+    // Step 2: Scene coordinates are full-resolution image coordinates, even
+    // if the base image shows a downsampled pyramid level
+    nImgLoc[0] = static_cast<float>(scenePoint.x());
+    nImgLoc[1] = static_cast<float>(scenePoint.y());
 }
 
 // Select point on curves
@@ -89,8 +89,7 @@ CWindow::CWindow()
     , fAnnotationListWidget(nullptr)
     , fPenTool(nullptr)
     , fSegTool(nullptr)
-    , stopPrefetching(false)
-    , prefetchSliceIndex(-1)
+    , lblPrefetchStats(nullptr)
 {
     const QSettings settings("VC.ini", QSettings::IniFormat);
     undoStack = new QUndoStack(this);
@@ -129,6 +128,10 @@ CWindow::CWindow()
     impactRangeSteps = SettingsDialog::expandSettingToIntRange(settings.value("viewer/impact_range_steps", "1-3, 5, 8, 11, 15, 20, 28, 40, 60, 100, 200").toString());
     scanRangeSteps = SettingsDialog::expandSettingToIntRange(settings.value("viewer/scan_range_steps", "1, 2, 5, 10, 20, 50, 100, 200, 500, 1000").toString());
 
+    // Preload half of the cached slices on either side of the current slice
+    prefetcher = std::make_unique<SlicePrefetcher>(PREFETCH_THREADS);
+    prefetcher->SetRadius(fSegParams.cache_slices / 2);
+
     // create UI widgets
     CreateWidgets();
 
@@ -198,11 +201,8 @@ CWindow::CWindow()
 // Destructor
 CWindow::~CWindow(void)
 {
-    stopPrefetching.store(true);
-    cv.notify_one();  // Wake up the thread if it's waitings
-    if (prefetchWorker.joinable()) {
-        prefetchWorker.join();
-    }
+    prefetchStatsTimer.stop();
+    prefetcher.reset();
     worker_thread_.quit();
     worker_thread_.wait();
     SDL_Quit();
@@ -456,6 +456,12 @@ void CWindow::CreateWidgets(void)
     // Set up the status bar
     statusBar = this->findChild<QStatusBar*>("statusBar");
 
+    // Slice cache statistics, for tuning the number of preloaded slices
+    lblPrefetchStats = new QLabel(this);
+    statusBar->addPermanentWidget(lblPrefetchStats);
+    connect(&prefetchStatsTimer, &QTimer::timeout, this, &CWindow::UpdatePrefetchStats);
+    prefetchStatsTimer.start(PREFETCH_STATS_INTERVAL_MS);
+
     // setup shortcuts
     slicePrev = new QShortcut(QKeySequence(Qt::Key_Left), this);
     sliceNext = new QShortcut(QKeySequence(Qt::Key_Right), this);
@@ -1564,56 +1570,27 @@ void CWindow::SetCurrentCurve(int nCurrentSliceIndex)
     }
 }
 
-void CWindow::prefetchSlices(void) {
-  while (true) {
-    std::unique_lock<std::mutex> lk(cv_m);
-    cv.wait(lk, [this]{return prefetchSliceIndex != -1 || stopPrefetching.load();});
-
-    if (stopPrefetching.load()) {
-      break;
+// Queue the slices around a slice for prefetching, dropping the requests for
+// the previous slice
+void CWindow::startPrefetching(int index)
+{
+    if (currentVolume == nullptr) {
+        return;
     }
-
-    QSettings settings("VC.ini", QSettings::IniFormat);
-    int prefetchSize = settings.value("perf/preloaded_slices", 200).toInt() / 2;
-    int stepSize = std::max(fSegParams.step_size, 1);
-    int currentSliceIndex = prefetchSliceIndex.load();
-    int start = std::max(0, currentSliceIndex - prefetchSize * stepSize);
-    int end = std::min(currentVolume->numSlices()-1, currentSliceIndex + prefetchSize * stepSize);
-
-    int n = 5;  // Number Fetching Threads
-    // fetching from index outwards
-    for (int offset = 0; offset <= prefetchSize * stepSize; offset = offset + n * stepSize) {
-        std::vector<std::thread> threads;
-
-        for (int i = 0; i <= n; i++) {
-            // Fetch the slice data on the right side
-            if (currentSliceIndex + offset + i * stepSize <= end) {
-                threads.emplace_back(&volcart::Volume::getSliceData, currentVolume, currentSliceIndex + offset + i * stepSize);
-            }
-            // Fetch the slice data on the left side
-            if (currentSliceIndex - offset - i * stepSize >= start) {
-                threads.emplace_back(&volcart::Volume::getSliceData, currentVolume, currentSliceIndex - offset - i * stepSize);
-            }
-        }
-
-        for (auto& t : threads) {
-            t.join();
-        }
-
-        // Check if prefetching was stopped or slice index changed
-        if (stopPrefetching.load() || prefetchSliceIndex.load() != currentSliceIndex) {
-            break;
-        }
+    if (prefetchVolume != currentVolume) {
+        prefetchVolume = currentVolume;
+        prefetcher->SetVolume(currentVolume);
     }
-
-    prefetchSliceIndex = -1;
-  }
+    prefetcher->Prefetch(index, fSegParams.step_size);
 }
 
-// Function to start prefetching around a certain slice
-void CWindow::startPrefetching(int index) {
-  prefetchSliceIndex = index;
-  cv.notify_one();
+void CWindow::UpdatePrefetchStats(void)
+{
+    lblPrefetchStats->setText(tr("Slice cache: %1 hits, %2 misses | Prefetched: %3 (%4 pending)")
+        .arg(prefetcher->GetHits())
+        .arg(prefetcher->GetMisses())
+        .arg(prefetcher->GetLoaded())
+        .arg(prefetcher->GetPending()));
 }
 
 // Open slice
@@ -1622,11 +1599,20 @@ void CWindow::OpenSlice(void)
     QImage aImgQImage;
     cv::Mat aImgMat;
     if (fVpkg != nullptr) {
-        // Stop prefetching
-        prefetchSliceIndex = -1;
-        cv.notify_one();
+        // Free the I/O for the requested slice, then preload around it
+        prefetcher->Cancel();
+        prefetcher->RecordLookup(currentVolume->isCached(fPathOnSliceIndex));
 
-        aImgMat = currentVolume->getSliceData(fPathOnSliceIndex);
+        // Show the slice tile by tile, at the resolution matching the zoom
+        if (!currentPyramid || currentPyramid->volume() != currentVolume) {
+            currentPyramid = volcart::SlicePyramid::New(currentVolume);
+        }
+        if (fVolumeViewerWidget->SetSlice(currentPyramid, fPathOnSliceIndex)) {
+            fVolumeViewerWidget->SetImageIndex(fPathOnSliceIndex);
+            startPrefetching(fPathOnSliceIndex);
+            UpdatePrefetchStats();
+            return;
+        }
     } else {
         aImgMat = cv::Mat::zeros(10, 10, CV_8UC1);
     }
@@ -1656,6 +1642,8 @@ void CWindow::OpenSlice(void)
 
     fVolumeViewerWidget->SetImage(aImgQImage);
     fVolumeViewerWidget->SetImageIndex(fPathOnSliceIndex);
+    startPrefetching(fPathOnSliceIndex);
+    UpdatePrefetchStats();
 }
 
 // Initialize path list
@@ -1826,6 +1814,9 @@ void CWindow::CloseVolume(void)
     fVpkg = nullptr;
     fSegmentationId = "";
     currentVolume = nullptr;
+    currentPyramid = nullptr;
+    prefetchVolume = nullptr;
+    prefetcher->SetVolume(nullptr);
     fWindowState = EWindowState::WindowStateIdle;  // Set Window State to Idle
     fPenTool->setChecked(false);                   // Reset Pen Tool Button
     fSegTool->setChecked(false);                   // Reset Segmentation Tool Button
@@ -2554,10 +2545,6 @@ void CWindow::TogglePenTool(void)
 void CWindow::ToggleSegmentationTool(void)
 {
     if (fSegTool->isChecked()) {
-        // If the prefetching worker is not yet running, start it
-        if (!prefetchWorker.joinable()) {
-            prefetchWorker = std::thread(&CWindow::prefetchSlices, this);
-        }
         // Start prefetching around the current slice
         startPrefetching(fPathOnSliceIndex);
         fSliceIndexToolStart = fPathOnSliceIndex;
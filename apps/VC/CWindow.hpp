@@ -20,13 +20,16 @@
 #include "MathUtils.hpp"
 #include "ui_VCMain.h"
 #include "SegmentationStruct.hpp"
+#include "SlicePrefetcher.hpp"
 
+#include "vc/core/types/SlicePyramid.hpp"
 #include "vc/core/types/VolumePkg.hpp"
 #include "vc/segmentation/ChainSegmentationAlgorithm.hpp"
 
 #include <thread>
 #include <condition_variable>
 #include <atomic>
+#include <memory>
 #include <SDL2/SDL.h>
 #include <cmath>
 #include <queue>
@@ -147,8 +150,8 @@ private:
     void SetCurrentCurve(int nCurrentSliceIndex);
     void SetUpAnnotations(void);
 
-    void prefetchSlices(void);
     void startPrefetching(int index);
+    void UpdatePrefetchStats(void);
     void OpenSlice(void);
 
     void InitPathList(void);
@@ -241,6 +244,7 @@ private:
     std::string fSegmentationId;
     std::string fHighlightedSegmentationId;
     volcart::Volume::Pointer currentVolume;
+    volcart::SlicePyramid::Pointer currentPyramid; // downsampled levels of currentVolume for the viewer
 
     static const int AMPLITUDE = 28000;
     static const int FREQUENCY = 44100;
@@ -357,12 +361,13 @@ private:
     QAction* undoAction;
     QAction* redoAction;
 
-    // Prefetching worker
-    std::thread prefetchWorker;
-    std::condition_variable cv;
-    std::mutex cv_m;
-    std::atomic<bool> stopPrefetching;
-    std::atomic<int> prefetchSliceIndex;
+    // Prefetching workers
+    static const int PREFETCH_THREADS = 6;
+    static const int PREFETCH_STATS_INTERVAL_MS = 500;
+    std::unique_ptr<SlicePrefetcher> prefetcher;
+    volcart::Volume::Pointer prefetchVolume; // volume the prefetcher loads from
+    QLabel* lblPrefetchStats;
+    QTimer prefetchStatsTimer;
 };  // class CWindow
 
 class VolPkgBackend : public QObject
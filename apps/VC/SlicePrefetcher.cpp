@@ -0,0 +1,94 @@
+// SlicePrefetcher.cpp
+#include "SlicePrefetcher.hpp"
+
+#include <algorithm>
+#include <utility>
+
+using namespace ChaoVis;
+
+SlicePrefetcher::SlicePrefetcher(std::size_t numThreads)
+{
+    numThreads = std::max<std::size_t>(numThreads, 1);
+    for (std::size_t i = 0; i < numThreads; i++) {
+        fWorkers.emplace_back(&SlicePrefetcher::Run, this);
+    }
+}
+
+SlicePrefetcher::~SlicePrefetcher()
+{
+    {
+        std::unique_lock<std::mutex> lock(fMutex);
+        fStop = true;
+    }
+    fCondition.notify_all();
+    for (auto& worker : fWorkers) {
+        worker.join();
+    }
+}
+
+void SlicePrefetcher::SetVolume(volcart::Volume::Pointer volume)
+{
+    std::unique_lock<std::mutex> lock(fMutex);
+    fVolume = std::move(volume);
+    fQueue = {};
+}
+
+void SlicePrefetcher::Prefetch(int sliceIndex, int step)
+{
+    step = std::max(step, 1);
+    {
+        std::unique_lock<std::mutex> lock(fMutex);
+        fQueue = {};
+        if (!fVolume) {
+            return;
+        }
+
+        auto numSlices = fVolume->numSlices();
+        for (int offset = step; offset <= fRadius * step; offset += step) {
+            if (sliceIndex + offset < numSlices) {
+                fQueue.push({offset, sliceIndex + offset});
+            }
+            if (sliceIndex - offset >= 0) {
+                fQueue.push({offset, sliceIndex - offset});
+            }
+        }
+    }
+    fCondition.notify_all();
+}
+
+void SlicePrefetcher::Cancel()
+{
+    std::unique_lock<std::mutex> lock(fMutex);
+    fQueue = {};
+}
+
+std::size_t SlicePrefetcher::GetPending() const
+{
+    std::unique_lock<std::mutex> lock(fMutex);
+    return fQueue.size();
+}
+
+void SlicePrefetcher::Run()
+{
+    while (true) {
+        volcart::Volume::Pointer volume;
+        int sliceIndex{0};
+        {
+            std::unique_lock<std::mutex> lock(fMutex);
+            fCondition.wait(lock, [this] { return fStop || !fQueue.empty(); });
+            if (fStop) {
+                return;
+            }
+            sliceIndex = fQueue.top().sliceIndex;
+            fQueue.pop();
+            volume = fVolume;
+        }
+
+        // The load itself cannot be interrupted, but stays useful since the
+        // slice ends up in the cache
+        if (!volume->isCached(sliceIndex)) {
+            volume->getSliceData(sliceIndex);
+            ++fLoaded;
+        }
+    }
+}
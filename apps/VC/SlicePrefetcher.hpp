@@ -0,0 +1,77 @@
+// SlicePrefetcher.hpp
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "vc/core/types/Volume.hpp"
+
+namespace ChaoVis
+{
+
+// Loads the slices around the current slice into the volume's slice cache
+// using a fixed set of worker threads. Requests are served in order of their
+// distance from the current slice. Every call to Prefetch() replaces all
+// pending requests, so that requests for slices which are no longer near the
+// current slice are dropped as soon as the user moves on.
+class SlicePrefetcher
+{
+public:
+    explicit SlicePrefetcher(std::size_t numThreads);
+    ~SlicePrefetcher();
+
+    SlicePrefetcher(const SlicePrefetcher&) = delete;
+    SlicePrefetcher& operator=(const SlicePrefetcher&) = delete;
+
+    // Set the volume to load from. Cancels all pending requests.
+    void SetVolume(volcart::Volume::Pointer volume);
+    // Number of slices loaded on either side of the current slice
+    void SetRadius(int radius) { fRadius = radius; }
+    int GetRadius() const { return fRadius; }
+
+    // Queue the slices within the radius of a slice, every step slices
+    void Prefetch(int sliceIndex, int step = 1);
+    // Drop all pending requests
+    void Cancel();
+
+    // Record whether a slice shown in the viewer was already cached
+    void RecordLookup(bool hit) { ++(hit ? fHits : fMisses); }
+    std::size_t GetHits() const { return fHits; }
+    std::size_t GetMisses() const { return fMisses; }
+    // Number of slices loaded by the workers
+    std::size_t GetLoaded() const { return fLoaded; }
+    // Number of requests waiting for a worker
+    std::size_t GetPending() const;
+
+private:
+    struct Request {
+        int distance;
+        int sliceIndex;
+        // Closest slices first
+        bool operator<(const Request& other) const
+        {
+            return distance > other.distance;
+        }
+    };
+
+    void Run();
+
+    volcart::Volume::Pointer fVolume;
+    std::priority_queue<Request> fQueue;
+    mutable std::mutex fMutex;
+    std::condition_variable fCondition;
+    bool fStop{false};
+    std::vector<std::thread> fWorkers;
+
+    std::atomic<int> fRadius{100};
+    std::atomic<std::size_t> fHits{0};
+    std::atomic<std::size_t> fMisses{0};
+    std::atomic<std::size_t> fLoaded{0};
+};
+
+}  // namespace ChaoVis
@@ -18,8 +18,14 @@ public:
     bool operator!=(const SliceImage& b) const { return !operator==(b); }
     bool operator<(const SliceImage& b) const;
 
+    // Read the image from disk
+    cv::Mat load() const;
     bool analyze();
+    // Analyze an image previously read with load()
+    bool analyze(const cv::Mat& image);
     cv::Mat conformedImage();
+    // Conform an image previously read with load()
+    cv::Mat conformedImage(cv::Mat image) const;
     int width() { return w_; }
     int height() { return h_; }
     double min() { return min_; }
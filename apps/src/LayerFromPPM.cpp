@@ -19,6 +19,7 @@
 #include "vc/core/util/MemorySizeStringParser.hpp"
 #include "vc/core/util/String.hpp"
 #include "vc/texturing/LayerTexture.hpp"
+#include "vc/texturing/TiledTexturing.hpp"
 
 using namespace volcart;
 namespace fs = volcart::filesystem;
@@ -42,6 +43,25 @@ auto GetTransformOpts() -> po::options_description
 
     return opts;
 }
+
+auto GetTilingOpts() -> po::options_description
+{
+    // clang-format off
+    po::options_description opts("Tiling Options");
+    opts.add_options()
+        ("tile-size", po::value<std::size_t>(), "If provided, generate the "
+            "layers in square tiles with this edge length in pixels. Each "
+            "tile is written to the tile directory as soon as it is "
+            "complete, and an interrupted run resumes from the completed "
+            "tiles.")
+        ("tile-dir", po::value<std::string>(), "Directory for the tile "
+            "images and the resume manifest. Default: [output-dir]/tiles/")
+        ("tiles-only", "Do not assemble the finished tiles into the layer "
+            "images.");
+    // clang-format on
+
+    return opts;
+}
 }  // namespace
 
 auto main(int argc, char* argv[]) -> int
@@ -86,6 +106,7 @@ auto main(int argc, char* argv[]) -> int
     all.add(GetGeneralOpts())
         .add(ioOpts)
         .add(::GetTransformOpts())
+        .add(::GetTilingOpts())
         .add(filterOptions)
         .add(ppmOptions);
     // clang-format on
@@ -195,15 +216,10 @@ auto main(int argc, char* argv[]) -> int
     auto interval = parsed["interval"].as<double>();
     auto direction = static_cast<Direction>(parsed["direction"].as<int>());
 
-    // Read the ppm
-    Logger()->info("Loading PPM...");
-    auto ppm = PerPixelMap::New(PerPixelMap::ReadPPM(inputPPMPath));
-
-    ///// Transform the PPM /////
+    ///// Load the transform /////
+    Transform3D::Pointer tfm;
     if (parsed.count("transform") > 0) {
-        // load the transform
         auto tfmId = parsed.at("transform").as<std::string>();
-        Transform3D::Pointer tfm;
         if (vpkg.hasTransform(tfmId)) {
             tfm = vpkg.transform(tfmId);
         } else {
@@ -217,9 +233,6 @@ auto main(int argc, char* argv[]) -> int
                 Logger()->warn("Cannot invert transform. Using original.");
             }
         }
-
-        Logger()->info("Applying transform...");
-        ppm = ApplyTransform(ppm, tfm);
     }
 
     // Setup line generator
@@ -228,12 +241,6 @@ auto main(int argc, char* argv[]) -> int
     line->setSamplingInterval(interval);
     line->setSamplingDirection(direction);
 
-    // Layer texture
-    texturing::LayerTexture layerGen;
-    layerGen.setVolume(volume);
-    layerGen.setPerPixelMap(ppm);
-    layerGen.setGenerator(line);
-
     // Progress reporting
     auto enableProgress = parsed["progress"].as<bool>();
     ProgressConfig cfg;
@@ -242,24 +249,98 @@ auto main(int argc, char* argv[]) -> int
             DurationFromString(parsed["progress-interval"].as<std::string>());
     }
 
-    if (enableProgress) {
-        ReportProgress(layerGen, "Generating layers:", cfg);
-        Logger()->debug("Generating layers...");
-    } else {
-        Logger()->info("Generating layers...");
-    }
+    PerPixelMap::Pointer ppm;
+    std::size_t numLayers{0};
+    if (parsed.count("tile-size") > 0) {
+        // Identify the settings which affect the layers for resuming
+        std::ostringstream params;
+        params << fs::weakly_canonical(inputPPMPath).string() << ';'
+               << volume->id() << ';' << radius << ';' << interval << ';'
+               << static_cast<int>(direction) << ';';
+        if (parsed.count("transform") > 0) {
+            params << parsed["transform"].as<std::string>() << ';'
+                   << parsed.count("invert-transform");
+        }
+
+        fs::path tileDir = outDir / "tiles";
+        if (parsed.count("tile-dir") > 0) {
+            tileDir = parsed["tile-dir"].as<std::string>();
+        }
 
-    auto texture = layerGen.compute();
+        texturing::TiledTexturing tiler;
+        tiler.setPPMPath(inputPPMPath);
+        tiler.setTileSize(parsed["tile-size"].as<std::size_t>());
+        tiler.setTileDirectory(tileDir);
+        tiler.setParameterString(params.str());
+        tiler.setAlgorithmFactory([&](const PerPixelMap::Pointer& tile) {
+            auto layerGen = texturing::LayerTexture::New();
+            layerGen->setVolume(volume);
+            layerGen->setPerPixelMap((tfm) ? ApplyTransform(tile, tfm) : tile);
+            layerGen->setGenerator(line);
+            return layerGen;
+        });
+
+        if (enableProgress) {
+            ReportProgress(tiler, "Generating layer tiles:", cfg);
+            Logger()->debug("Generating layer tiles...");
+        } else {
+            Logger()->info("Generating layer tiles: {}", tileDir.string());
+        }
+        tiler.compute();
+        numLayers = tiler.numOutputs();
+
+        // Assemble and write one layer at a time
+        if (parsed.count("tiles-only") == 0) {
+            Logger()->info("Writing layers...");
+            auto pad = std::to_string(numLayers).size();
+            for (std::size_t i = 0; i < numLayers; i++) {
+                auto name = to_padded_string(i, pad) + "." + imgFmt;
+                WriteImage(outDir / name, tiler.assemble(i), writeOpts);
+            }
+        }
 
-    // Write the image sequence
-    const fs::path filepath = outDir / ("{}." + imgFmt);
-    if (enableProgress) {
-        Logger()->debug("Writing layers...");
-        auto progIt = ProgressWrap(texture, "Writing layers:", cfg);
-        WriteImageSequence(filepath, progIt, writeOpts);
+        // Only load the full PPM if a new one was requested
+        if (parsed.count("output-ppm") > 0) {
+            Logger()->info("Loading PPM...");
+            ppm = PerPixelMap::New(PerPixelMap::ReadPPM(inputPPMPath));
+        }
     } else {
-        Logger()->info("Writing layers...");
-        WriteImageSequence(filepath, texture, writeOpts);
+        // Read the ppm
+        Logger()->info("Loading PPM...");
+        ppm = PerPixelMap::New(PerPixelMap::ReadPPM(inputPPMPath));
+
+        ///// Transform the PPM /////
+        if (tfm) {
+            Logger()->info("Applying transform...");
+            ppm = ApplyTransform(ppm, tfm);
+        }
+
+        // Layer texture
+        texturing::LayerTexture layerGen;
+        layerGen.setVolume(volume);
+        layerGen.setPerPixelMap(ppm);
+        layerGen.setGenerator(line);
+
+        if (enableProgress) {
+            ReportProgress(layerGen, "Generating layers:", cfg);
+            Logger()->debug("Generating layers...");
+        } else {
+            Logger()->info("Generating layers...");
+        }
+
+        auto texture = layerGen.compute();
+        numLayers = texture.size();
+
+        // Write the image sequence
+        const fs::path filepath = outDir / ("{}." + imgFmt);
+        if (enableProgress) {
+            Logger()->debug("Writing layers...");
+            auto progIt = ProgressWrap(texture, "Writing layers:", cfg);
+            WriteImageSequence(filepath, progIt, writeOpts);
+        } else {
+            Logger()->info("Writing layers...");
+            WriteImageSequence(filepath, texture, writeOpts);
+        }
     }
 
     if (parsed.count("output-ppm") > 0) {
@@ -274,7 +355,7 @@ auto main(int argc, char* argv[]) -> int
         newPPM.setCellMap(ppm->cellMap());
 
         // Fill new PPM
-        auto z = static_cast<double>(texture.size() - 1) / 2.0;
+        auto z = static_cast<double>(numLayers - 1) / 2.0;
         auto normal = (parsed.count("negative-normal") > 0) ? -1.0 : 1.0;
         for (auto [y, x] : range2D(height, width)) {
             if (!newPPM.hasMapping(y, x)) {
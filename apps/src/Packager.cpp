@@ -1,27 +1,44 @@
 #include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <exception>
+#include <functional>
 #include <iostream>
 #include <limits>
+#include <list>
+#include <mutex>
 #include <regex>
+#include <thread>
+#include <vector>
 
 #include <boost/program_options.hpp>
+#include <nlohmann/json.hpp>
 
 #include "vc/app_support/ProgressIndicator.hpp"
 #include "vc/apps/packager/SliceImage.hpp"
 #include "vc/core/filesystem.hpp"
 #include "vc/core/io/FileFilters.hpp"
 #include "vc/core/io/SkyscanMetadataIO.hpp"
+#include "vc/core/io/TIFFIO.hpp"
 #include "vc/core/types/Metadata.hpp"
+#include "vc/core/types/SlicePyramid.hpp"
+#include "vc/core/types/VolumeBlockStats.hpp"
+#include "vc/core/types/VolumeChunks.hpp"
+#include "vc/core/types/VolumeHistogram.hpp"
 #include "vc/core/types/VolumePkg.hpp"
+#include "vc/core/util/BoundedQueue.hpp"
 #include "vc/core/util/FormatStrToRegexStr.hpp"
 #include "vc/core/util/Iteration.hpp"
 #include "vc/core/util/Logging.hpp"
+#include "vc/core/util/Parallel.hpp"
 #include "vc/core/util/String.hpp"
 
 namespace fs = volcart::filesystem;
 namespace po = boost::program_options;
 namespace vc = volcart;
 namespace vci = volcart::io;
+namespace tio = volcart::tiffio;
 
 enum class Flip { None, Horizontal, Vertical, ZFlip, Both, All };
 
@@ -42,9 +59,107 @@ struct VolumeInfo {
     Flip flipOption{Flip::None};
     vc::Metadata meta;
     bool compress{false};
+    // Derived outputs. Sizes of 0 disable the output.
+    bool writePyramid{false};
+    int blockSize{0};
+    int histogramBlockSize{0};
+    int chunkSize{0};
+};
+
+// Worker counts and queue size of the ingest pipeline
+struct PipelineOptions {
+    std::size_t readThreads{2};
+    std::size_t convertThreads{0};
+    std::size_t writeThreads{0};
+    std::size_t queueSize{8};
 };
 
 static bool DoAnalyze{true};
+static PipelineOptions Pipeline;
+
+// A slice moving between the stages of the ingest pipeline
+struct SliceItem {
+    std::size_t idx{0};
+    cv::Mat image;
+};
+
+// Worker threads of a staged pipeline. Each stage is a set of workers which
+// fill an output queue. The output queue is closed once all of the stage's
+// workers return, which tells the next stage that no more items are coming.
+// If a worker throws, all queues are closed so that the other stages stop,
+// and the first exception is rethrown by join().
+class SlicePipeline
+{
+public:
+    using Queue = vc::BoundedQueue<SliceItem>;
+
+    SlicePipeline() = default;
+    SlicePipeline(const SlicePipeline&) = delete;
+    SlicePipeline& operator=(const SlicePipeline&) = delete;
+    ~SlicePipeline()
+    {
+        abort();
+        for (auto& t : threads_) {
+            if (t.joinable()) {
+                t.join();
+            }
+        }
+    }
+
+    void addStage(std::size_t numThreads, std::function<void()> fn, Queue& out)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            queues_.push_back(&out);
+        }
+        numThreads = vc::NumWorkerThreads(numThreads);
+        auto& running = running_.emplace_back(numThreads);
+        for (std::size_t i = 0; i < numThreads; i++) {
+            threads_.emplace_back([this, fn, &out, &running]() {
+                try {
+                    fn();
+                } catch (...) {
+                    {
+                        std::unique_lock<std::mutex> lock(mutex_);
+                        if (!error_) {
+                            error_ = std::current_exception();
+                        }
+                    }
+                    abort();
+                }
+                if (--running == 0) {
+                    out.close();
+                }
+            });
+        }
+    }
+
+    void join()
+    {
+        for (auto& t : threads_) {
+            t.join();
+        }
+        threads_.clear();
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+private:
+    void abort()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (auto* q : queues_) {
+            q->close();
+        }
+    }
+
+    std::vector<std::thread> threads_;
+    std::list<std::atomic<std::size_t>> running_;
+    std::vector<Queue*> queues_;
+    std::exception_ptr error_;
+    std::mutex mutex_;
+};
 
 auto GetVolumeInfo(const po::variables_map& parsed) -> VolumeInfo;
 void AddVolume(vc::VolumePkg::Pointer& volpkg, const VolumeInfo& info);
@@ -83,9 +198,52 @@ auto main(int argc, char* argv[]) -> int
             "Flip options: Vertical flip (vf), horizontal flip (hf), both, "
             "z-flip (zf), all, [none].")
         ("compress,c", "Compress slice images");
+
+    po::options_description derived_options("Derived data");
+    derived_options.add_options()
+        ("write-pyramid",
+            "Write downsampled levels of every slice for multi-resolution "
+            "viewing.")
+        ("write-block-stats",
+            "Write a summary of the minimum and maximum intensity of every "
+            "block of voxels. Used to skip empty regions when texturing.")
+        ("block-size", po::value<int>()->default_value(
+            vc::VolumeBlockStats::DEFAULT_BLOCK_SIZE),
+            "Block edge length (in voxels) of --write-block-stats.")
+        ("write-histogram",
+            "Write intensity histograms of every slice and every block of "
+            "voxels. Used to look up intensity percentiles for contrast "
+            "windowing and normalization.")
+        ("histogram-block-size", po::value<int>()->default_value(
+            vc::VolumeHistogram::DEFAULT_BLOCK_SIZE),
+            "Block edge length (in voxels) of --write-histogram.")
+        ("write-chunks",
+            "Write a copy of the volume split into cubic chunks.")
+        ("chunk-size", po::value<int>()->default_value(
+            vc::VolumeChunks::DEFAULT_CHUNK_SIZE),
+            "Chunk edge length (in voxels) of --write-chunks.");
+
+    po::options_description perf_options("Performance");
+    perf_options.add_options()
+        ("read-threads", po::value<std::size_t>()->default_value(2),
+            "Number of threads reading slice images. If 0, use all hardware "
+            "threads.")
+        ("convert-threads", po::value<std::size_t>()->default_value(0),
+            "Number of threads analyzing, converting, and flipping slice "
+            "images. If 0, use all hardware threads.")
+        ("write-threads", po::value<std::size_t>()->default_value(0),
+            "Number of threads encoding and writing slices to the volume. If "
+            "0, use all hardware threads.")
+        ("queue-size", po::value<std::size_t>()->default_value(8),
+            "Maximum number of slices waiting between two stages. Limits "
+            "memory use.");
     
     po::options_description helpOpts("Usage");
-    helpOpts.add(options).add(volpkg_metadata).add(volume_options);
+    helpOpts.add(options)
+        .add(volpkg_metadata)
+        .add(volume_options)
+        .add(derived_options)
+        .add(perf_options);
 
     po::options_description all("Usage");
     all.add(helpOpts).add_options()(
@@ -112,6 +270,11 @@ auto main(int argc, char* argv[]) -> int
 
     // Set global opt
     DoAnalyze = parsed["analyze"].as<bool>();
+    Pipeline.readThreads = parsed["read-threads"].as<std::size_t>();
+    Pipeline.convertThreads = parsed["convert-threads"].as<std::size_t>();
+    Pipeline.writeThreads = parsed["write-threads"].as<std::size_t>();
+    Pipeline.queueSize =
+        std::max<std::size_t>(parsed["queue-size"].as<std::size_t>(), 1);
 
     ///// New VolumePkg /////
     // Get the output volpkg path
@@ -257,6 +420,20 @@ auto GetVolumeInfo(const po::variables_map& parsed) -> VolumeInfo
     // Whether to compress
     info.compress = parsed.count("compress") != 0;
 
+    // Derived outputs
+    info.writePyramid = parsed.count("write-pyramid") != 0;
+    if (parsed.count("write-block-stats") != 0) {
+        info.blockSize = std::max(parsed["block-size"].as<int>(), 1);
+    }
+    if (parsed.count("write-histogram") != 0) {
+        info.histogramBlockSize = std::clamp(
+            parsed["histogram-block-size"].as<int>(), 1,
+            vc::VolumeHistogram::MAX_BLOCK_SIZE);
+    }
+    if (parsed.count("write-chunks") != 0) {
+        info.chunkSize = std::max(parsed["chunk-size"].as<int>(), 1);
+    }
+
     return info;
 }
 
@@ -319,9 +496,48 @@ void AddVolume(vc::VolumePkg::Pointer& volpkg, const VolumeInfo& info)
     auto volMax = std::numeric_limits<double>::lowest();
     std::vector<fs::path> mismatches;
     if (DoAnalyze) {
-        for (auto& slice : vc::ProgressWrap(slices, "Analyzing slices")) {
+        // Read and analyze the slices in parallel
+        std::vector<char> analyzed(slices.size(), 0);
+        {
+            SlicePipeline::Queue loaded(Pipeline.queueSize);
+            SlicePipeline::Queue done(Pipeline.queueSize);
+            SlicePipeline pipeline;
+            std::atomic<std::size_t> next{0};
+            pipeline.addStage(
+                Pipeline.readThreads,
+                [&]() {
+                    for (auto i = next++; i < slices.size(); i = next++) {
+                        if (!loaded.push({i, slices[i].load()})) {
+                            return;
+                        }
+                    }
+                },
+                loaded);
+            pipeline.addStage(
+                Pipeline.convertThreads,
+                [&]() {
+                    while (auto item = loaded.pop()) {
+                        analyzed[item->idx] =
+                            slices[item->idx].analyze(item->image);
+                        if (!done.push({item->idx, {}})) {
+                            return;
+                        }
+                    }
+                },
+                done);
+            for ([[maybe_unused]] const auto& i : vc::ProgressWrap(
+                     vc::range(slices.size()), "Analyzing slices")) {
+                if (!done.pop()) {
+                    break;
+                }
+            }
+            pipeline.join();
+        }
+
+        // Check the results in slice order
+        for (const auto& [idx, slice] : vc::enumerate(slices)) {
             // Skip if we can't analyze
-            if (!slice.analyze()) {
+            if (!analyzed[idx]) {
                 continue;
             }
 
@@ -395,48 +611,195 @@ void AddVolume(vc::VolumePkg::Pointer& volpkg, const VolumeInfo& info)
                      info.flipOption == Flip::Both ||
                      info.flipOption == Flip::All;
 
-    // Move the slices into the VolPkg
-    using vc::enumerate;
-    using vc::ProgressWrap;
-    for (auto pair : ProgressWrap(enumerate(slices), "Saving to volpkg")) {
-        const auto& idx = pair.first;
-        auto& slice = pair.second;
-        // Convert or flip
-        if (slice.needsConvert() || slice.needsScale() || needsFlip ||
-            info.compress) {
-            // Override slice min/max with volume min/max
-            if (slice.needsScale()) {
-                slice.setScale(volMax, volMin);
+    // Whether a slice needs to be re-encoded or can just be copied
+    auto needsConform = [&](vc::SliceImage& slice) {
+        return slice.needsConvert() || slice.needsScale() || needsFlip ||
+               info.compress;
+    };
+
+    // Derived outputs are built from each final slice as it is written, so
+    // only the slices in the pipeline are held in memory
+    const cv::Vec3i volSize{
+        volume->sliceWidth(), volume->sliceHeight(), volume->numSlices()};
+    std::vector<cv::Size> levelSizes;
+    if (info.writePyramid) {
+        levelSizes = vc::SlicePyramid::LevelSizes({volSize[0], volSize[1]});
+        for (int level = 1; level < static_cast<int>(levelSizes.size());
+             level++) {
+            fs::create_directories(
+                vc::SlicePyramid::LevelPath(volume->path(), level));
+        }
+    }
+    vc::VolumeBlockStats::Pointer blockStats;
+    if (info.blockSize > 0) {
+        blockStats = vc::VolumeBlockStats::New(volSize, info.blockSize);
+    }
+    vc::VolumeHistogram::Pointer histogram;
+    if (info.histogramBlockSize > 0) {
+        histogram = vc::VolumeHistogram::New(volSize, info.histogramBlockSize);
+    }
+    vc::VolumeChunks::Pointer chunks;
+    if (info.chunkSize > 0) {
+        chunks = vc::VolumeChunks::New(
+            volume->path() / vc::VolumeChunks::DEFAULT_DIRNAME, volSize,
+            info.chunkSize);
+    }
+    const auto writeDerived =
+        levelSizes.size() > 1 || blockStats || histogram || chunks;
+
+    // Move the slices into the VolPkg. Slices are read, converted, and
+    // written by separate sets of workers. Every slice is written to the
+    // volume's file for its index, so the slice order does not depend on the
+    // order in which the workers finish.
+    SlicePipeline::Queue loaded(Pipeline.queueSize);
+    SlicePipeline::Queue conformed(Pipeline.queueSize);
+    SlicePipeline::Queue done(Pipeline.queueSize);
+    SlicePipeline pipeline;
+    std::atomic<std::size_t> next{0};
+
+    // Read
+    pipeline.addStage(
+        Pipeline.readThreads,
+        [&]() {
+            for (auto i = next++; i < slices.size(); i = next++) {
+                cv::Mat image;
+                if (needsConform(slices[i]) || writeDerived) {
+                    image = slices[i].load();
+                }
+                if (!loaded.push({i, image})) {
+                    return;
+                }
             }
-
-            // Get slice
-            auto tmp = slice.conformedImage();
-
-            // Apply flips
-            switch (info.flipOption) {
-                case Flip::All:
-                case Flip::Both:
-                    cv::flip(tmp, tmp, -1);
-                    break;
-                case Flip::Vertical:
-                    cv::flip(tmp, tmp, 0);
-                    break;
-                case Flip::Horizontal:
-                    cv::flip(tmp, tmp, 1);
-                    break;
-                case Flip::ZFlip:
-                case Flip::None:
-                    // Do nothing
-                    break;
+        },
+        loaded);
+
+    // Convert and flip
+    pipeline.addStage(
+        Pipeline.convertThreads,
+        [&]() {
+            while (auto item = loaded.pop()) {
+                auto& slice = slices[item->idx];
+                if (needsConform(slice)) {
+                    // Override slice min/max with volume min/max
+                    if (slice.needsScale()) {
+                        slice.setScale(volMax, volMin);
+                    }
+
+                    // Get slice
+                    auto tmp = slice.conformedImage(item->image);
+
+                    // Apply flips
+                    switch (info.flipOption) {
+                        case Flip::All:
+                        case Flip::Both:
+                            cv::flip(tmp, tmp, -1);
+                            break;
+                        case Flip::Vertical:
+                            cv::flip(tmp, tmp, 0);
+                            break;
+                        case Flip::Horizontal:
+                            cv::flip(tmp, tmp, 1);
+                            break;
+                        case Flip::ZFlip:
+                        case Flip::None:
+                            // Do nothing
+                            break;
+                    }
+                    item->image = tmp;
+                }
+                if (!conformed.push(std::move(*item))) {
+                    return;
+                }
+            }
+        },
+        conformed);
+
+    // Encode and write
+    pipeline.addStage(
+        Pipeline.writeThreads,
+        [&]() {
+            while (auto item = conformed.pop()) {
+                // Add to volume
+                if (needsConform(slices[item->idx])) {
+                    volume->setSliceData(
+                        static_cast<int>(item->idx), item->image,
+                        info.compress);
+                }
+
+                // Just copy to the volume
+                else {
+                    fs::copy_file(
+                        slices[item->idx].path,
+                        volume->getSlicePath(static_cast<int>(item->idx)));
+                }
+
+                // Derived outputs
+                if (writeDerived) {
+                    auto z = static_cast<int>(item->idx);
+                    auto name = volume->getSlicePath(z).filename();
+                    auto level = item->image;
+                    for (int l = 1; l < static_cast<int>(levelSizes.size());
+                         l++) {
+                        level =
+                            vc::SlicePyramid::Downsample(level, levelSizes[l]);
+                        tio::WriteTIFF(
+                            vc::SlicePyramid::LevelPath(volume->path(), l) /
+                                name,
+                            level,
+                            info.compress ? tio::Compression::LZW
+                                          : tio::Compression::NONE);
+                    }
+                    if (blockStats) {
+                        blockStats->addSlice(z, item->image);
+                    }
+                    if (histogram) {
+                        histogram->addSlice(z, item->image);
+                    }
+                    if (chunks) {
+                        chunks->addSlice(z, item->image);
+                    }
+                }
+                if (!done.push({item->idx, {}})) {
+                    return;
+                }
             }
+        },
+        done);
 
-            // Add to volume
-            volume->setSliceData(idx, tmp, info.compress);
+    using vc::ProgressWrap;
+    for ([[maybe_unused]] const auto& i :
+         ProgressWrap(vc::range(slices.size()), "Saving to volpkg")) {
+        if (!done.pop()) {
+            break;
         }
+    }
+    pipeline.join();
 
-        // Just copy to the volume
-        else {
-            fs::copy_file(slice.path, volume->getSlicePath(idx));
-        }
+    // Record the derived outputs
+    if (levelSizes.size() > 1) {
+        volume->setDerivedData(
+            "pyramid", {{"path", vc::SlicePyramid::DEFAULT_DIRNAME},
+                        {"levels", levelSizes.size()}});
+    }
+    if (blockStats) {
+        blockStats->write(volume->blockStatsPath());
+        volume->setDerivedData(
+            "block_stats", {{"path", vc::VolumeBlockStats::DEFAULT_FILENAME},
+                            {"block_size", info.blockSize}});
     }
+    if (histogram) {
+        histogram->write(volume->histogramPath());
+        volume->setDerivedData(
+            "histogram", {{"path", vc::VolumeHistogram::DEFAULT_FILENAME},
+                          {"block_size", info.histogramBlockSize},
+                          {"bins", vc::VolumeHistogram::NUM_BINS}});
+    }
+    if (chunks) {
+        volume->setDerivedData(
+            "chunks", {{"path", vc::VolumeChunks::DEFAULT_DIRNAME},
+                       {"chunk_size", info.chunkSize},
+                       {"dtype", "uint16"},
+                       {"order", "zyx"}});
+    }
+    volume->saveMetadata();
 }
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <unordered_map>
@@ -33,7 +34,14 @@ enum class SmoothOpt { Off = 0, Before, After, Both };
 enum class FlatteningAlgorithm { ABF = 0, LSCM, Orthographic };
 
 // Available texturing algorithms
-enum class Method { Composite = 0, Intersection, Integral, Thickness, Layers };
+enum class Method {
+    Composite = 0,
+    Intersection,
+    Integral,
+    Thickness,
+    Layers,
+    MultiOutput
+};
 
 // What to transform to the target volume
 enum class TransformInput { Raw = 0, Resampled, PerPixelMap };
@@ -74,7 +82,21 @@ auto GetIOOpts() -> po::options_description
         "Output file path for the generated PPM.")
     ("compression", po::value<int>(), "Image compression level")
     ("save-graph", po::value<bool>()->default_value(true),
-        "Save the generated render graph into the volume package.");
+        "Save the generated render graph into the volume package.")
+    ("graph-threads", po::value<std::size_t>()->default_value(0),
+        "Number of threads used to update independent branches of the render "
+        "graph concurrently. If 0, uses the number of available hardware "
+        "threads. Per-node timing and memory use are saved in the render "
+        "graph.")
+    ("memoize", po::value<bool>()->default_value(false),
+        "Memoize the results of expensive nodes (resampling, flattening, and "
+        "PPM generation) in the volume package. Re-running with the same "
+        "mesh and parameters loads these results instead of recomputing "
+        "them.")
+    ("memoize-limit", po::value<std::string>()->default_value("10GB"),
+        "Maximum size of the memoized results. When exceeded, the least "
+        "recently used results are removed. Accepts the suffixes: "
+        "(K|M|G|T)(B).");
     // clang-format on
 
     return opts;
@@ -130,6 +152,10 @@ auto GetMeshingOpts() -> po::options_description
             "  1 = Before mesh resampling\n"
             "  2 = After mesh resampling\n"
             "  3 = Both before and after mesh resampling")
+        ("mesh-smoothing-engine", po::value<LaplacianSmoothMeshNode::Engine>()
+            ->default_value(LaplacianSmoothMeshNode::Engine::VTK, "vtk"),
+            "Mesh smoothing implementation. Options: vtk (default), native "
+            "(multithreaded)")
         ("intermediate-mesh", po::value<std::string>(),"Output file path for the "
             "intermediate (i.e. scale + resampled) mesh. File is saved prior "
             "to flattening. Useful for testing meshing parameters.")
@@ -149,6 +175,27 @@ auto GetUVOpts() -> po::options_description
                 "  0 = ABF\n"
                 "  1 = LSCM\n"
                 "  2 = Orthographic Projection")
+        ("uv-solver", po::value<int>()->default_value(0),
+            "Select the LSCM solver used by the ABF and LSCM flattening "
+            "algorithms:\n"
+                "  0 = OpenABF\n"
+                "  1 = Sparse (multithreaded, supports warm starts)")
+        ("uv-warm-start", po::value<std::string>(), "Path to a previously "
+            "flattened mesh with a UV map. Used to warm-start the sparse "
+            "LSCM solver. Vertex IDs must match those of the mesh being "
+            "flattened.")
+        ("uv-patch-faces", po::value<std::size_t>()->default_value(0),
+            "If greater than 0, meshes with more faces than this are "
+            "flattened in overlapping patches of approximately this many "
+            "faces. Patches are flattened in parallel and then aligned. "
+            "Bounds the memory used by the ABF and LSCM solvers.")
+        ("uv-patch-overlap", po::value<std::size_t>()->default_value(4),
+            "Number of rings of neighboring faces added to each patch when "
+            "flattening in patches.")
+        ("uv-patch-memory", po::value<std::string>(), "Memory budget for "
+            "the patch solvers. Limits the number of patches flattened "
+            "concurrently. Accepts the suffixes: (K|M|G|T)(B). Default: "
+            "Unlimited.")
         ("uv-reuse", "If input-mesh is specified, attempt to use its existing "
             "UV map instead of generating a new one.")
         ("uv-align-to-axis", po::value<UVMap::AlignmentAxis>()->default_value(UVMap::AlignmentAxis::ZPos, "+Z"),
@@ -191,7 +238,8 @@ auto GetFilteringOpts() -> po::options_description
                  "  1 = Intersection\n"
                  "  2 = Integral\n"
                  "  3 = Thickness\n"
-                 "  4 = Layers")
+                 "  4 = Layers\n"
+                 "  5 = Multi-output Composite")
         ("neighborhood-shape,n", po::value<int>()->default_value(0),
              "Neighborhood shape:\n"
                  "  0 = Linear\n"
@@ -209,7 +257,14 @@ auto GetFilteringOpts() -> po::options_description
         ("shading", po::value<int>()->default_value(1),
             "Surface Normal Shading:\n"
                 "  0 = Flat\n"
-                "  1 = Smooth");
+                "  1 = Smooth")
+        ("skip-below", po::value<std::uint16_t>()->default_value(0),
+            "Treat volume regions whose maximum intensity is below this value "
+            "as empty and do not sample them. Uses (and, if needed, computes) "
+            "a summary of the volume's intensities. 0 = disabled")
+        ("skip-block-size", po::value<int>()->default_value(32),
+            "Edge length, in voxels, of the blocks summarized for "
+            "--skip-below");
     // clang-format on
 
     return opts;
@@ -226,7 +281,11 @@ auto GetCompositeOpts() -> po::options_description
                 "  1 = Maximum\n"
                 "  2 = Median\n"
                 "  3 = Mean\n"
-                "  4 = Median w/ Averaging");
+                "  4 = Median w/ Averaging")
+        ("filters", po::value<std::vector<int>>()->multitoken(),
+            "Filters applied by the Multi-output Composite method, one image "
+            "per filter. Uses the values of --filter. Default: the value of "
+            "--filter");
     // clang-format on
 
     return opts;
@@ -345,6 +404,16 @@ auto main(int argc, char* argv[]) -> int
         return EXIT_FAILURE;
     }
 
+    // Enable memoization of expensive nodes
+    if (parsed["memoize"].as<bool>()) {
+        auto limit =
+            MemorySizeStringParser(parsed["memoize-limit"].as<std::string>());
+        auto memo = MemoCache::New(vpkg->renderCacheDir(), limit);
+        Logger()->debug(
+            "Memoizing node results in: {}", memo->root().string());
+        SetGlobalMemoCache(memo);
+    }
+
     //// Create the graph pipeline ////
     std::shared_ptr<smgl::Graph> graph;
     if (parsed["save-graph"].as<bool>()) {
@@ -503,6 +572,15 @@ auto main(int argc, char* argv[]) -> int
     results["voxelsize"] = &tgtVolProps->voxelSize;
     results["volume"] = &tgtVolProps->volumeOut;
 
+    // Summarize the volume for skipping empty regions
+    const auto skipBelow = parsed["skip-below"].as<std::uint16_t>();
+    if (skipBelow > 0) {
+        auto blockStats = graph->insertNode<VolumeBlockStatsNode>();
+        blockStats->volumeIn = tgtVolProps->volumeOut;
+        blockStats->blockSize = parsed["skip-block-size"].as<int>();
+        results["volume"] = &blockStats->volumeOut;
+    }
+
     //// Setup transform ////
     Transform3D::Identifier tfmId;
     const bool disableTfm = parsed.count("disable-transform") > 0;
@@ -586,10 +664,13 @@ auto main(int argc, char* argv[]) -> int
         // Pre-smooth
         auto smoothType =
             static_cast<SmoothOpt>(parsed["mesh-resample-smoothing"].as<int>());
+        auto smoothEngine = parsed["mesh-smoothing-engine"]
+                                .as<LaplacianSmoothMeshNode::Engine>();
         if (smoothType == SmoothOpt::Both || smoothType == SmoothOpt::Before) {
             Logger()->debug("Adding mesh smoothing node (pre-resample)");
             auto smooth = graph->insertNode<LaplacianSmoothMeshNode>();
             smooth->input = *results["mesh"];
+            smooth->engine = smoothEngine;
             results["mesh"] = &smooth->output;
         }
 
@@ -649,6 +730,7 @@ auto main(int argc, char* argv[]) -> int
             Logger()->debug("Adding mesh smoothing node (post-resample)");
             auto smooth = graph->insertNode<LaplacianSmoothMeshNode>();
             smooth->input = *results["mesh"];
+            smooth->engine = smoothEngine;
             results["mesh"] = &smooth->output;
         }
     }
@@ -698,6 +780,22 @@ auto main(int argc, char* argv[]) -> int
             auto flatten = graph->insertNode<ABFNode>();
             flatten->input = *results["mesh"];
             flatten->useABF = (method == FlatteningAlgorithm::ABF);
+            flatten->solver =
+                static_cast<ABFNode::Solver>(parsed["uv-solver"].as<int>());
+            if (parsed.count("uv-warm-start") > 0) {
+                Logger()->debug("Adding warm start UV map loader node");
+                auto warmStart = graph->insertNode<LoadMeshNode>();
+                warmStart->path = parsed["uv-warm-start"].as<std::string>();
+                warmStart->cacheArgs = true;
+                flatten->initialUVMap = warmStart->uvMap;
+            }
+            flatten->maxPatchFaces = parsed["uv-patch-faces"].as<std::size_t>();
+            flatten->patchOverlap =
+                parsed["uv-patch-overlap"].as<std::size_t>();
+            if (parsed.count("uv-patch-memory") > 0) {
+                flatten->memoryLimit = MemorySizeStringParser(
+                    parsed["uv-patch-memory"].as<std::string>());
+            }
             results["uvMap"] = &flatten->uvMap;
             results["uvMesh"] = &flatten->output;
 
@@ -874,6 +972,7 @@ auto main(int argc, char* argv[]) -> int
         neighborGen->interval = parsed["interval"].as<double>();
         neighborGen->direction =
             static_cast<Direction>(parsed["direction"].as<int>());
+        neighborGen->skipThreshold = skipBelow;
 
         // Calculate neighbordhood radius
         if (parsed.count("radius") > 0) {
@@ -901,6 +1000,7 @@ auto main(int argc, char* argv[]) -> int
 
     // Setup texturing method
     smgl::Node::Pointer texturing;
+    std::string texturePort{"texture"};
     bool textureIsSeq = false;
     if (method == Method::Intersection) {
         Logger()->debug("Adding intersection texture node");
@@ -976,10 +1076,30 @@ auto main(int argc, char* argv[]) -> int
         textureIsSeq = true;
     }
 
+    else if (method == Method::MultiOutput) {
+        Logger()->debug("Adding multi-output texture node");
+        using Filter = MultiOutputTextureNode::Filter;
+        std::vector<Filter> filters;
+        if (parsed.count("filters") > 0) {
+            for (auto f : parsed["filters"].as<std::vector<int>>()) {
+                filters.push_back(static_cast<Filter>(f));
+            }
+        } else {
+            filters.push_back(static_cast<Filter>(parsed["filter"].as<int>()));
+        }
+        auto t = graph->insertNode<MultiOutputTextureNode>();
+        t->generator = *results["generator"];
+        t->filters = filters;
+        t->generateLayers = false;
+        texturing = t;
+        texturePort = "textures";
+        textureIsSeq = true;
+    }
+
     // Set/get generic parameters
     texturing->getInputPort("ppm") = *results["ppm"];
     texturing->getInputPort("volume") = *results["volume"];
-    results["texture"] = &texturing->getOutputPort("texture");
+    results["texture"] = &texturing->getOutputPort(texturePort);
 
     // If we're generating an image sequence and using the default output file
     // change the name to a sequence
@@ -1032,7 +1152,25 @@ auto main(int argc, char* argv[]) -> int
     // Update the graph
     try {
         Logger()->debug("Starting graph update");
-        auto status = graph->update();
+        GraphExecutor executor;
+        executor.setNumThreads(parsed["graph-threads"].as<std::size_t>());
+        auto status = executor.update(*graph);
+        for (const auto& p : executor.profile()) {
+            Logger()->debug(
+                "Node {} :: Time: {:.3f}s || Peak RSS Delta: {} || Output "
+                "Size: {}",
+                p.uuid, p.seconds,
+                BytesToMemorySizeString(
+                    std::max<std::int64_t>(p.peakRSSDelta, 0), "MB"),
+                BytesToMemorySizeString(p.outputBytes, "MB"));
+        }
+        Logger()->info("Graph update time: {:.3f}s", executor.totalSeconds());
+        if (auto memo = GlobalMemoCache()) {
+            Logger()->info(
+                "Memoized results :: Loaded: {} || Computed: {} || Size: {}",
+                memo->hits(), memo->misses(),
+                BytesToMemorySizeString(memo->size(), "MB"));
+        }
         if (status == smgl::Graph::State::Updating) {
             Logger()->error("Graph already updating");
         } else if (status == smgl::Graph::State::Error) {
@@ -1106,6 +1244,48 @@ auto operator>>(std::istream& is, UVMap::AlignmentAxis& v) -> std::istream&
 }
 }  // namespace volcart
 
+// LaplacianSmoothMeshNode::Engine
+// NOLINTNEXTLINE(readability-identifier-naming): Must be exact signature
+void validate(
+    boost::any& v,
+    const std::vector<std::string>& values,
+    LaplacianSmoothMeshNode::Engine* /* target type */,
+    int /* unused */)
+{
+    using namespace boost::program_options;
+    // argument only passed once
+    validators::check_first_occurrence(v);
+    // get a single string, error ir more than one
+    const auto& s = validators::get_single_string(values);
+    // cast to type
+    v = boost::any(boost::lexical_cast<LaplacianSmoothMeshNode::Engine>(s));
+}
+
+namespace volcart::meshing
+{
+auto operator>>(std::istream& is, LaplacianSmooth::Engine& v) -> std::istream&
+{
+    // get the first token
+    std::string s;
+    if (not(is >> s)) {
+        return is;
+    };
+
+    // find a match
+    vc::to_lower(s);
+    if (s == "vtk") {
+        v = LaplacianSmooth::Engine::VTK;
+        is.clear();
+    } else if (s == "native") {
+        v = LaplacianSmooth::Engine::Native;
+        is.clear();
+    } else {
+        is.setstate(std::ios_base::failbit);
+    }
+    return is;
+}
+}  // namespace volcart::meshing
+
 // TransformInput
 // NOLINTNEXTLINE(readability-identifier-naming): Must be exact signature
 void validate(
@@ -25,6 +25,7 @@
 #include "vc/texturing/IntegralTexture.hpp"
 #include "vc/texturing/IntersectionTexture.hpp"
 #include "vc/texturing/ThicknessTexture.hpp"
+#include "vc/texturing/TiledTexturing.hpp"
 
 using namespace volcart;
 namespace fs = volcart::filesystem;
@@ -49,6 +50,27 @@ auto GetTransformOpts() -> po::options_description
 
     return opts;
 }
+
+auto GetTilingOpts() -> po::options_description
+{
+    // clang-format off
+    po::options_description opts("Tiling Options");
+    opts.add_options()
+        ("tile-size", po::value<std::size_t>(), "If provided, texture the PPM "
+            "in square tiles with this edge length in pixels. Each tile is "
+            "written to the tile directory as soon as it is complete, and an "
+            "interrupted run resumes from the completed tiles. Only supported "
+            "by the Intersection, Composite, and unnormalized Thickness "
+            "methods.")
+        ("tile-dir", po::value<std::string>(), "Directory for the tile "
+            "images and the resume manifest. Default: "
+            "[output-file stem]_tiles/ next to the output file.")
+        ("tiles-only", "Do not assemble the finished tiles into the output "
+            "image.");
+    // clang-format on
+
+    return opts;
+}
 }  // namespace
 
 auto main(int argc, char* argv[]) -> int
@@ -72,6 +94,7 @@ auto main(int argc, char* argv[]) -> int
     all.add(GetGeneralOpts())
             .add(ioOpts)
             .add(::GetTransformOpts())
+            .add(::GetTilingOpts())
             .add(GetFilteringOpts())
             .add(GetCompositeOpts())
             .add(GetIntegralOpts())
@@ -191,15 +214,10 @@ auto main(int argc, char* argv[]) -> int
     }
     auto normalize = parsed["normalize-output"].as<bool>();
 
-    // Read the ppm
-    Logger()->info("Loading PPM...");
-    auto ppm = PerPixelMap::New(std::move(PerPixelMap::ReadPPM(inputPPMPath)));
-
-    ///// Transform the PPM /////
+    ///// Load the transform /////
+    Transform3D::Pointer tfm;
     if (parsed.count("transform") > 0) {
-        // load the transform
         auto tfmId = parsed.at("transform").as<std::string>();
-        Transform3D::Pointer tfm;
         if (vpkg->hasTransform(tfmId)) {
             tfm = vpkg->transform(tfmId);
         } else {
@@ -213,9 +231,29 @@ auto main(int argc, char* argv[]) -> int
                 Logger()->warn("Cannot invert transform. Using original.");
             }
         }
+    }
 
-        Logger()->info("Applying transform...");
-        ppm = ApplyTransform(ppm, tfm);
+    // Tiled texturing is only supported by per-pixel methods
+    const auto tiled = parsed.count("tile-size") > 0;
+    if (tiled and (method == Method::Integral or
+                   (method == Method::Thickness and normalize))) {
+        Logger()->error(
+            "Tiled texturing is not supported by the selected method.");
+        return EXIT_FAILURE;
+    }
+
+    // Load mask
+    VolumetricMask::Pointer mask;
+    if (method == Method::Thickness) {
+        if (maskPath.empty()) {
+            Logger()->error(
+                "Selected Thickness texturing, but did not "
+                "provide volume mask path.");
+            std::exit(EXIT_FAILURE);
+        }
+        Logger()->info("Loading volume mask...");
+        auto pts = PointSetIO<cv::Vec3i>::ReadPointSet(maskPath);
+        mask = VolumetricMask::New(pts);
     }
 
     ///// Setup Neighborhood /////
@@ -265,77 +303,137 @@ auto main(int argc, char* argv[]) -> int
     Logger()->info(ss.str());
 
     Logger()->debug("Setting up texturing algorithm...");
-    vct::TexturingAlgorithm::Pointer textureGen;
-    if (method == Method::Intersection) {
-        auto intersect = vct::IntersectionTexture::New();
-        intersect->setVolume(volume);
-        intersect->setPerPixelMap(ppm);
-        textureGen = intersect;
-    }
+    auto makeTextureGen = [&](const PerPixelMap::Pointer& ppm) {
+        vct::TexturingAlgorithm::Pointer textureGen;
+        if (method == Method::Intersection) {
+            auto intersect = vct::IntersectionTexture::New();
+            intersect->setVolume(volume);
+            intersect->setPerPixelMap(ppm);
+            textureGen = intersect;
+        }
 
-    else if (method == Method::Composite) {
-        auto composite = vct::CompositeTexture::New();
-        composite->setPerPixelMap(ppm);
-        composite->setVolume(volume);
-        composite->setFilter(filter);
-        composite->setGenerator(generator);
-        textureGen = composite;
-    }
+        else if (method == Method::Composite) {
+            auto composite = vct::CompositeTexture::New();
+            composite->setPerPixelMap(ppm);
+            composite->setVolume(volume);
+            composite->setFilter(filter);
+            composite->setGenerator(generator);
+            textureGen = composite;
+        }
 
-    else if (method == Method::Integral) {
-        auto integral = vct::IntegralTexture::New();
-        integral->setPerPixelMap(ppm);
-        integral->setVolume(volume);
-        integral->setGenerator(generator);
-        integral->setWeightMethod(weightType);
-        integral->setLinearWeightDirection(weightDirection);
-        integral->setExponentialDiffExponent(weightExponent);
-        integral->setExponentialDiffBaseMethod(expoDiffBaseMethod);
-        integral->setExponentialDiffBaseValue(expoDiffBase);
-        integral->setClampValuesToMax(clampToMax);
-        if (clampToMax) {
-            integral->setClampMax(parsed["clamp-to-max"].as<std::uint16_t>());
+        else if (method == Method::Integral) {
+            auto integral = vct::IntegralTexture::New();
+            integral->setPerPixelMap(ppm);
+            integral->setVolume(volume);
+            integral->setGenerator(generator);
+            integral->setWeightMethod(weightType);
+            integral->setLinearWeightDirection(weightDirection);
+            integral->setExponentialDiffExponent(weightExponent);
+            integral->setExponentialDiffBaseMethod(expoDiffBaseMethod);
+            integral->setExponentialDiffBaseValue(expoDiffBase);
+            integral->setClampValuesToMax(clampToMax);
+            if (clampToMax) {
+                integral->setClampMax(
+                    parsed["clamp-to-max"].as<std::uint16_t>());
+            }
+            textureGen = integral;
         }
-        textureGen = integral;
-    }
 
-    else if (method == Method::Thickness) {
-        // Load mask
-        if (maskPath.empty()) {
-            Logger()->error(
-                "Selected Thickness texturing, but did not "
-                "provide volume mask path.");
-            std::exit(EXIT_FAILURE);
+        else if (method == Method::Thickness) {
+            auto thickness = vct::ThicknessTexture::New();
+            thickness->setPerPixelMap(ppm);
+            thickness->setVolumetricMask(mask);
+            thickness->setNormalizeOutput(normalize);
+            textureGen = thickness;
         }
-        Logger()->info("Loading volume mask...");
-        auto pts = PointSetIO<cv::Vec3i>::ReadPointSet(maskPath);
-        auto mask = VolumetricMask::New(pts);
 
-        auto thickness = vct::ThicknessTexture::New();
-        thickness->setPerPixelMap(ppm);
-        thickness->setVolumetricMask(mask);
-        thickness->setNormalizeOutput(normalize);
-        textureGen = thickness;
+        return textureGen;
+    };
+
+    ProgressConfig cfg;
+    if (parsed.count("progress-interval") > 0) {
+        cfg.interval =
+            DurationFromString(parsed["progress-interval"].as<std::string>());
     }
 
-    if (parsed["progress"].as<bool>()) {
-        ProgressConfig cfg;
-        if (parsed.count("progress-interval") > 0) {
-            cfg.interval = DurationFromString(
-                parsed["progress-interval"].as<std::string>());
+    PerPixelMap::Pointer ppm;
+    if (tiled) {
+        // Identify the settings which affect the texture for resuming
+        std::ostringstream params;
+        params << fs::weakly_canonical(inputPPMPath).string() << ';'
+               << volume->id() << ';' << static_cast<int>(method) << ';'
+               << static_cast<int>(filter) << ';' << maskPath.string() << ';'
+               << ss.str() << ';';
+        if (parsed.count("transform") > 0) {
+            params << parsed["transform"].as<std::string>() << ';'
+                   << parsed.count("invert-transform");
+        }
+
+        fs::path tileDir;
+        if (parsed.count("tile-dir") > 0) {
+            tileDir = parsed["tile-dir"].as<std::string>();
+        } else {
+            tileDir = outputPath.parent_path() /
+                      (outputPath.stem().string() + "_tiles");
+        }
+
+        vct::TiledTexturing tiler;
+        tiler.setPPMPath(inputPPMPath);
+        tiler.setTileSize(parsed["tile-size"].as<std::size_t>());
+        tiler.setTileDirectory(tileDir);
+        tiler.setParameterString(params.str());
+        tiler.setAlgorithmFactory([&](const PerPixelMap::Pointer& tile) {
+            auto tilePPM = (tfm) ? ApplyTransform(tile, tfm) : tile;
+            return makeTextureGen(tilePPM);
+        });
+
+        if (parsed["progress"].as<bool>()) {
+            ReportProgress(tiler, "Texturing tiles:", cfg);
+            Logger()->debug("Texturing tiles...");
+        } else {
+            Logger()->info("Texturing tiles: {}", tileDir.string());
+        }
+        tiler.compute();
+
+        if (parsed.count("tiles-only") == 0) {
+            Logger()->info("Writing output image...");
+            WriteImage(outputPath, tiler.assemble());
+        }
+
+        // Only load the full PPM if a new one was requested
+        if (parsed.count("output-ppm") > 0) {
+            Logger()->info("Loading PPM...");
+            ppm = PerPixelMap::New(PerPixelMap::ReadPPM(inputPPMPath));
+            if (tfm) {
+                ppm = ApplyTransform(ppm, tfm);
+            }
         }
-        ReportProgress(*textureGen, "Texturing:", cfg);
-        Logger()->debug("Texturing...");
     } else {
-        Logger()->info("Texturing...");
-    }
+        // Read the ppm
+        Logger()->info("Loading PPM...");
+        ppm = PerPixelMap::New(PerPixelMap::ReadPPM(inputPPMPath));
+
+        ///// Transform the PPM /////
+        if (tfm) {
+            Logger()->info("Applying transform...");
+            ppm = ApplyTransform(ppm, tfm);
+        }
+
+        auto textureGen = makeTextureGen(ppm);
+        if (parsed["progress"].as<bool>()) {
+            ReportProgress(*textureGen, "Texturing:", cfg);
+            Logger()->debug("Texturing...");
+        } else {
+            Logger()->info("Texturing...");
+        }
 
-    Logger()->debug("Starting texturing algorithm...");
-    auto texture = textureGen->compute();
+        Logger()->debug("Starting texturing algorithm...");
+        auto texture = textureGen->compute();
 
-    // Write the output
-    Logger()->info("Writing output image...");
-    WriteImage(outputPath, texture[0]);
+        // Write the output
+        Logger()->info("Writing output image...");
+        WriteImage(outputPath, texture[0]);
+    }
 
     if (parsed.count("output-ppm") > 0) {
         Logger()->info("Writing output PPM...");
@@ -39,6 +39,7 @@ static const double kDefaultDelta = 1.0 / 3.0;
 static const int kDefaultPeakDistanceWeight = 50;
 static const bool kDefaultConsiderPrevious = false;
 static constexpr int kDefaultResliceSize = 32;
+static constexpr std::size_t kDefaultNumThreads = 0;
 
 static int SaveInterval{-1};
 static int CurrentIteration{0};
@@ -84,6 +85,9 @@ auto main(int argc, char* argv[]) -> int
             "Number of optimization iterations")
         ("reslice-size,r", po::value<int>()->default_value(kDefaultResliceSize),
          "Size of reslice window")
+        ("threads", po::value<std::size_t>()->default_value(kDefaultNumThreads),
+            "Number of threads used to generate candidate positions. If 0, "
+            "uses all available threads")
         ("alpha,a", po::value<double>()->default_value(kDefaultAlpha),
             "Coefficient for internal energy metric")
         ("k1", po::value<double>()->default_value(kDefaultK1),
@@ -101,6 +105,9 @@ auto main(int argc, char* argv[]) -> int
             po::value<bool>()->default_value(kDefaultConsiderPrevious),
             "Consider propagation of a point's previous XY position as a "
             "candidate when optimizing each iteration")
+        ("incremental-energy", "Optimize each step with the incrementally "
+            "updated chain energy. Faster on long chains, but may choose "
+            "different positions than the default energy.")
         ("visualize", "Display curve visualization as algorithm runs");
 
     // TFF options
@@ -342,6 +349,7 @@ auto main(int argc, char* argv[]) -> int
         segmenter.setStepSize(step);
         segmenter.setOptimizationIterations(parsed["num-iters"].as<int>());
         segmenter.setResliceSize(parsed["reslice-size"].as<int>());
+        segmenter.setNumThreads(parsed["threads"].as<std::size_t>());
         segmenter.setAlpha(parsed["alpha"].as<double>());
         segmenter.setK1(parsed["k1"].as<double>());
         segmenter.setK2(parsed["k2"].as<double>());
@@ -349,6 +357,10 @@ auto main(int argc, char* argv[]) -> int
         segmenter.setDelta(parsed["delta"].as<double>());
         segmenter.setDistanceWeightFactor(parsed["distance-weight"].as<int>());
         segmenter.setConsiderPrevious(parsed["consider-previous"].as<bool>());
+        if (parsed.count("incremental-energy") > 0) {
+            using Energy = vs::LocalResliceSegmentation::Energy;
+            segmenter.setEnergy(Energy::Incremental);
+        }
         segmenter.setVisualize(parsed.count("visualize") > 0);
         segmenter.setDumpVis(parsed.count("dump-vis") > 0);
         if (enableProgress) {
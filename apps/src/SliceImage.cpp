@@ -34,7 +34,14 @@ auto SliceImage::operator<(const SliceImage& b) const -> bool
     return aName.size() < bName.size();
 }
 
-auto SliceImage::analyze() -> bool
+auto SliceImage::load() const -> cv::Mat
+{
+    return cv::imread(path.string(), cv::IMREAD_ANYCOLOR | cv::IMREAD_ANYDEPTH);
+}
+
+auto SliceImage::analyze() -> bool { return analyze(load()); }
+
+auto SliceImage::analyze(const cv::Mat& image) -> bool
 {
     // return if the path is wrong or if this isn't a regular file
     if (!(volcart::filesystem::exists(path)) ||
@@ -45,9 +52,6 @@ auto SliceImage::analyze() -> bool
     // Set needsConvert_ if it's not a tif
     needsConvert_ = !io::FileExtensionFilter(path, {"tif", "tiff"});
 
-    auto image =
-        cv::imread(path.string(), cv::IMREAD_ANYCOLOR | cv::IMREAD_ANYDEPTH);
-
     w_ = image.cols;
     h_ = image.rows;
 
@@ -65,12 +69,10 @@ auto SliceImage::analyze() -> bool
     return true;
 }
 
-auto SliceImage::conformedImage() -> cv::Mat
-{
-    // Load the image
-    auto image =
-        cv::imread(path.string(), cv::IMREAD_ANYCOLOR | cv::IMREAD_ANYDEPTH);
+auto SliceImage::conformedImage() -> cv::Mat { return conformedImage(load()); }
 
+auto SliceImage::conformedImage(cv::Mat image) const -> cv::Mat
+{
     // Remap values to 16 bit
     if (needsScale_) {
         image.convertTo(
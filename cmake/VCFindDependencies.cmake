@@ -26,6 +26,9 @@ endif()
 message(STATUS "Using filesystem library: ${VC_FS_LIB}")
 list(APPEND VC_CUSTOM_MODULES "${CMAKE_MODULE_PATH}/FindFilesystem.cmake")
 
+### Threads ###
+find_package(Threads REQUIRED)
+
 ### Qt6 ###
 if((VC_BUILD_APPS OR VC_BUILD_UTILS) AND VC_BUILD_GUI)
     find_package(Qt6 6.5 QUIET REQUIRED COMPONENTS Widgets Gui Core Network)
@@ -0,0 +1,170 @@
+#pragma once
+
+/** @file */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "vc/core/filesystem.hpp"
+#include "vc/core/io/MemoryMappedFile.hpp"
+#include "vc/core/io/PointSetIO.hpp"
+#include "vc/core/types/Exceptions.hpp"
+#include "vc/core/types/OrderedPointSet.hpp"
+#include "vc/core/types/PointSet.hpp"
+
+namespace volcart
+{
+
+/**
+ * @class MappedPointSet
+ * @brief Read-only view of a binary PointSet or OrderedPointSet file
+ *
+ * Memory maps a binary point set file (`.vcps`, `.ppm`) and provides typed
+ * access to its points without reading them into memory first. Opening a
+ * file only parses its header, and points are paged in by the operating
+ * system as they are accessed. This makes the view well suited for
+ * consumers which only read the points once.
+ *
+ * Files written by PointSetIO have an aligned header, so their points are
+ * used in place. Files written by older versions may place the points at an
+ * offset which is not suitably aligned for T. The points of such files are
+ * copied into memory when opened. isMapped() reports which case applies.
+ *
+ * @tparam T Point type. Must match the type and dimension in the header.
+ *
+ * @ingroup IO
+ */
+template <typename T>
+class MappedPointSet
+{
+public:
+    /** Header type */
+    using Header = typename PointSetIO<T>::Header;
+
+    /** Const iterator type */
+    using ConstIterator = const T*;
+
+    /**@{*/
+    /**
+     * @brief Map a binary point set file
+     *
+     * @throws volcart::IOException if the file cannot be mapped, its header
+     * does not match T, or it is too short for the size in its header
+     */
+    explicit MappedPointSet(const filesystem::path& path) : file_{path}
+    {
+        // Parse the header with the regular reader. Unordered parsing
+        // accepts ordered files as well.
+        std::ifstream infile{path.string(), std::ios::binary};
+        if (not infile.is_open()) {
+            throw IOException("could not open file '" + path.string() + "'");
+        }
+        header_ = PointSetIO<T>::ParseHeader(infile, false);
+        auto offset = static_cast<std::size_t>(infile.tellg());
+        if (offset + header_.size * sizeof(T) > file_.size()) {
+            throw IOException("unexpected end of file");
+        }
+
+        const auto* bytes = file_.data() + offset;
+        if (reinterpret_cast<std::uintptr_t>(bytes) % alignof(T) == 0) {
+            data_ = reinterpret_cast<const T*>(bytes);
+            mapped_ = true;
+        } else {
+            copy_.resize(header_.size);
+            std::memcpy(copy_.data(), bytes, header_.size * sizeof(T));
+            data_ = copy_.data();
+        }
+    }
+    /**@}*/
+
+    /**@{*/
+    /** @brief Get the file header */
+    [[nodiscard]] auto header() const -> const Header& { return header_; }
+
+    /** @brief Whether the file contains an OrderedPointSet */
+    [[nodiscard]] auto ordered() const -> bool { return header_.ordered; }
+
+    /** @brief Get the number of points */
+    [[nodiscard]] auto size() const -> std::size_t { return header_.size; }
+
+    /** @brief Whether the file contains no points */
+    [[nodiscard]] auto empty() const -> bool { return header_.size == 0; }
+
+    /** @brief Get the width of an ordered file */
+    [[nodiscard]] auto width() const -> std::size_t { return header_.width; }
+
+    /** @brief Get the height of an ordered file */
+    [[nodiscard]] auto height() const -> std::size_t
+    {
+        return header_.height;
+    }
+
+    /** @brief Whether the points are used in place from the mapping */
+    [[nodiscard]] auto isMapped() const -> bool { return mapped_; }
+    /**@}*/
+
+    /**@{*/
+    /** @brief Get a pointer to the first point */
+    [[nodiscard]] auto data() const -> const T* { return data_; }
+
+    /** @brief Get a point by index */
+    auto operator[](std::size_t idx) const -> const T& { return data_[idx]; }
+
+    /** @brief Get a point of an ordered file by 2D index */
+    auto operator()(std::size_t y, std::size_t x) const -> const T&
+    {
+        return data_[y * header_.width + x];
+    }
+
+    /** @brief Get an iterator to the first point */
+    [[nodiscard]] auto begin() const -> ConstIterator { return data_; }
+
+    /** @brief Get an iterator past the last point */
+    [[nodiscard]] auto end() const -> ConstIterator
+    {
+        return data_ + header_.size;
+    }
+    /**@}*/
+
+    /**@{*/
+    /** @brief Copy the points into a PointSet */
+    [[nodiscard]] auto toPointSet() const -> PointSet<T>
+    {
+        PointSet<T> ps(size());
+        ps.append(*this);
+        return ps;
+    }
+
+    /**
+     * @brief Copy the points into an OrderedPointSet
+     *
+     * @throws volcart::IOException if the file is not ordered
+     */
+    [[nodiscard]] auto toOrderedPointSet() const -> OrderedPointSet<T>
+    {
+        if (not header_.ordered) {
+            throw IOException("point set file is not ordered");
+        }
+        OrderedPointSet<T> ps{header_.width};
+        ps.pushRows(begin(), end());
+        return ps;
+    }
+    /**@}*/
+
+private:
+    /** File mapping */
+    MemoryMappedFile file_;
+    /** File header */
+    Header header_;
+    /** First point */
+    const T* data_{nullptr};
+    /** Whether data_ points into the mapping */
+    bool mapped_{false};
+    /** Copy of the points of files with unaligned data */
+    std::vector<T> copy_;
+};
+
+}  // namespace volcart
@@ -0,0 +1,65 @@
+#pragma once
+
+/** @file */
+
+#include <cstddef>
+
+#include "vc/core/filesystem.hpp"
+
+namespace volcart
+{
+
+/**
+ * @class MemoryMappedFile
+ * @brief Read-only memory mapping of a file
+ *
+ * Maps the entire file into memory so that its contents can be accessed
+ * without reading them into a separate buffer. Pages are loaded by the
+ * operating system on first access and are shared with the page cache. The
+ * mapping is released when the object is destroyed.
+ *
+ * @ingroup IO
+ */
+class MemoryMappedFile
+{
+public:
+    /**@{*/
+    /**
+     * @brief Map a file
+     *
+     * @throws volcart::IOException if the file cannot be opened or mapped
+     */
+    explicit MemoryMappedFile(const filesystem::path& path);
+
+    /** Move constructor */
+    MemoryMappedFile(MemoryMappedFile&& other) noexcept;
+
+    /** Move assignment operator */
+    auto operator=(MemoryMappedFile&& other) noexcept -> MemoryMappedFile&;
+
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    auto operator=(const MemoryMappedFile&) -> MemoryMappedFile& = delete;
+
+    /** Unmaps the file */
+    ~MemoryMappedFile();
+    /**@}*/
+
+    /**@{*/
+    /** @brief Get a pointer to the first byte of the file */
+    [[nodiscard]] auto data() const -> const char* { return data_; }
+
+    /** @brief Get the size of the file in bytes */
+    [[nodiscard]] auto size() const -> std::size_t { return size_; }
+    /**@}*/
+
+private:
+    /** Release the mapping */
+    void unmap_();
+
+    /** Mapped data */
+    const char* data_{nullptr};
+    /** Size of the mapping */
+    std::size_t size_{0};
+};
+
+}  // namespace volcart
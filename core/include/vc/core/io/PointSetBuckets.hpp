@@ -0,0 +1,191 @@
+#pragma once
+
+/** @file */
+
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "vc/core/filesystem.hpp"
+#include "vc/core/types/Exceptions.hpp"
+
+namespace volcart
+{
+
+/**
+ * @class PointSetBuckets
+ * @brief Group a stream of points into buckets with bounded memory
+ *
+ * Points are added to numbered buckets (e.g. one per slice) in any order.
+ * Added points are buffered in memory until the number of buffered points
+ * reaches the memory limit, at which point every buffer is appended to its
+ * bucket's spill file in the spill directory. This provides an external
+ * bucket sort of arbitrarily large point sets: no more than maxBuffered
+ * points are held in memory while adding, and each bucket can be read back
+ * on its own afterwards. If every point fits in memory, no spill files are
+ * written.
+ *
+ * Spill files are removed when the object is destroyed.
+ *
+ * @tparam T Point type
+ *
+ * @ingroup IO
+ */
+template <typename T>
+class PointSetBuckets
+{
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param dir Existing directory for the spill files
+     * @param maxBuffered Maximum number of points held in memory
+     */
+    PointSetBuckets(filesystem::path dir, std::size_t maxBuffered)
+        : dir_{std::move(dir)}, maxBuffered_{maxBuffered}
+    {
+    }
+
+    PointSetBuckets(const PointSetBuckets&) = delete;
+    auto operator=(const PointSetBuckets&) -> PointSetBuckets& = delete;
+
+    /** Destructor. Removes the spill files. */
+    ~PointSetBuckets()
+    {
+        for (const auto& [id, bucket] : buckets_) {
+            if (bucket.spilled > 0) {
+                std::remove(spill_path_(id).string().c_str());
+            }
+        }
+    }
+
+    /**
+     * @brief Add a point to a bucket
+     *
+     * @throws volcart::IOException if the buffers need to be spilled and a
+     * spill file cannot be written
+     */
+    void add(std::size_t bucket, const T& p)
+    {
+        buckets_[bucket].buffer.push_back(p);
+        if (++buffered_ >= maxBuffered_) {
+            flush();
+        }
+    }
+
+    /**
+     * @brief Append every buffered point to its spill file
+     *
+     * @throws volcart::IOException if a spill file cannot be written
+     */
+    void flush()
+    {
+        for (auto& [id, bucket] : buckets_) {
+            if (bucket.buffer.empty()) {
+                continue;
+            }
+            // Replace stale files on the first spill
+            auto path = spill_path_(id);
+            auto mode = std::ios::binary;
+            mode |= (bucket.spilled == 0) ? std::ios::trunc : std::ios::app;
+            std::ofstream out{path.string(), mode};
+            out.write(
+                reinterpret_cast<const char*>(bucket.buffer.data()),
+                static_cast<std::streamsize>(
+                    bucket.buffer.size() * sizeof(T)));
+            out.close();
+            if (out.fail()) {
+                auto msg = "failure writing file '" + path.string() + "'";
+                throw IOException(msg);
+            }
+            bucket.spilled += bucket.buffer.size();
+            // Release the memory, not just the contents
+            std::vector<T>().swap(bucket.buffer);
+        }
+        buffered_ = 0;
+    }
+
+    /** @brief Get the IDs of the non-empty buckets in ascending order */
+    [[nodiscard]] auto buckets() const -> std::vector<std::size_t>
+    {
+        std::vector<std::size_t> ids;
+        ids.reserve(buckets_.size());
+        for (const auto& b : buckets_) {
+            ids.push_back(b.first);
+        }
+        return ids;
+    }
+
+    /** @brief Get the number of points in a bucket */
+    [[nodiscard]] auto size(std::size_t bucket) const -> std::size_t
+    {
+        auto it = buckets_.find(bucket);
+        if (it == buckets_.end()) {
+            return 0;
+        }
+        return it->second.spilled + it->second.buffer.size();
+    }
+
+    /**
+     * @brief Read the points of a bucket
+     *
+     * Points are returned in the order they were added. Different buckets
+     * can be read concurrently, but not while points are being added.
+     *
+     * @throws volcart::IOException if the bucket's spill file cannot be read
+     */
+    [[nodiscard]] auto read(std::size_t bucket) const -> std::vector<T>
+    {
+        auto it = buckets_.find(bucket);
+        if (it == buckets_.end()) {
+            return {};
+        }
+        const auto& b = it->second;
+
+        std::vector<T> points(b.spilled);
+        if (b.spilled > 0) {
+            auto path = spill_path_(bucket);
+            std::ifstream in{path.string(), std::ios::binary};
+            in.read(
+                reinterpret_cast<char*>(points.data()),
+                static_cast<std::streamsize>(b.spilled * sizeof(T)));
+            if (not in) {
+                auto msg = "failure reading file '" + path.string() + "'";
+                throw IOException(msg);
+            }
+        }
+        points.insert(points.end(), b.buffer.begin(), b.buffer.end());
+        return points;
+    }
+
+private:
+    /** Bucket contents */
+    struct Bucket {
+        /** Points which have not been spilled */
+        std::vector<T> buffer;
+        /** Number of points in the spill file */
+        std::size_t spilled{0};
+    };
+
+    /** Get the spill file path of a bucket */
+    [[nodiscard]] auto spill_path_(std::size_t bucket) const
+        -> filesystem::path
+    {
+        return dir_ / ("bucket_" + std::to_string(bucket) + ".bin");
+    }
+
+    /** Spill directory */
+    filesystem::path dir_;
+    /** Memory limit, in points */
+    std::size_t maxBuffered_;
+    /** Buckets by ID */
+    std::map<std::size_t, Bucket> buckets_;
+    /** Number of buffered points */
+    std::size_t buffered_{0};
+};
+
+}  // namespace volcart
@@ -35,6 +35,12 @@ enum class IOMode { ASCII = 0, BINARY };
  * information is then encoded in either ASCII or binary, as determined at
  * time of write.
  *
+ * Headers are padded with a comment line so that their length is a multiple
+ * of HEADER_ALIGNMENT. The points of a binary file are then suitably aligned
+ * to be used in place from a memory mapping of the file.
+ *
+ * @see volcart::MappedPointSet
+ *
  * @ingroup IO
  *
  * @see volcart::PointSet
@@ -43,7 +49,14 @@ enum class IOMode { ASCII = 0, BINARY };
 template <typename T>
 class PointSetIO
 {
+    static_assert(
+        sizeof(T) == T::channels * sizeof(typename T::value_type),
+        "points must be tightly packed");
+
 public:
+    /** Alignment of the point data in written files, in bytes */
+    static constexpr std::size_t HEADER_ALIGNMENT{64};
+
     /** @brief PointSet file header information */
     struct Header {
         std::size_t width{0};
@@ -75,6 +88,65 @@ public:
         }
     }
 
+    /**
+     * @brief Read a rectangular region of a binary OrderedPointSet file
+     *
+     * Only the rows and columns in the region are read from disk, so the
+     * memory required is proportional to the size of the region rather than
+     * the size of the file. The region is clamped to the bounds of the file.
+     */
+    static OrderedPointSet<T> ReadOrderedPointSetRegion(
+        const volcart::filesystem::path& path,
+        std::size_t originY,
+        std::size_t originX,
+        std::size_t height,
+        std::size_t width)
+    {
+        std::ifstream infile{path.string(), std::ios::binary};
+        if (!infile.is_open()) {
+            auto msg = "could not open file '" + path.string() + "'";
+            throw IOException(msg);
+        }
+        auto header = PointSetIO<T>::ParseHeader(infile, true);
+        if (originY >= header.height or originX >= header.width) {
+            throw IOException("region origin out-of-bounds");
+        }
+        height = std::min(height, header.height - originY);
+        width = std::min(width, header.width - originX);
+
+        // Size of a point on disk
+        auto pointBytes = header.dim * TypeBytes(header.type);
+        auto dataStart = static_cast<std::size_t>(infile.tellg());
+
+        // Read data one row segment at a time
+        OrderedPointSet<T> ps{width};
+        std::vector<T> points(width, 0);
+        for (std::size_t h = 0; h < height; ++h) {
+            auto offset = ((originY + h) * header.width + originX) * pointBytes;
+            infile.seekg(static_cast<std::streamoff>(dataStart + offset));
+            infile.read(
+                reinterpret_cast<char*>(points.data()), width * pointBytes);
+            if (!infile) {
+                throw IOException("unexpected end of file");
+            }
+            ps.pushRow(points);
+        }
+
+        return ps;
+    }
+
+    /** @brief Read the header of a PointSet or OrderedPointSet file */
+    static Header ReadHeader(
+        const volcart::filesystem::path& path, bool ordered = true)
+    {
+        std::ifstream infile{path.string(), std::ios::binary};
+        if (!infile.is_open()) {
+            auto msg = "could not open file '" + path.string() + "'";
+            throw IOException(msg);
+        }
+        return ParseHeader(infile, ordered);
+    }
+
     /** @brief Read PointSet from file
      *
      * @copydetails PointSetIO::ReadOrderedPointSet()
@@ -125,10 +197,22 @@ public:
 
     /**@{*/
     /** @brief Generate a PointSet header string */
-    static std::string MakeHeader(PointSet<T> ps)
+    static std::string MakeHeader(const PointSet<T>& ps)
+    {
+        return MakeHeader(ps.size());
+    }
+
+    /**
+     * @brief Generate a PointSet header string for a number of points
+     *
+     * The header is padded to at least minLength bytes. Streaming writers use
+     * this to reserve space for a header which is rewritten once the final
+     * number of points is known.
+     */
+    static std::string MakeHeader(std::size_t size, std::size_t minLength = 0)
     {
         std::stringstream ss;
-        ss << "size: " << ps.size() << std::endl;
+        ss << "size: " << size << std::endl;
         ss << "dim: " << T::channels << std::endl;
         ss << "ordered: false" << std::endl;
 
@@ -146,12 +230,11 @@ public:
         }
 
         ss << "version: " << PointSet<T>::FORMAT_VERSION << std::endl;
-        ss << PointSet<T>::HEADER_TERMINATOR << std::endl;
 
-        return ss.str();
+        return AlignHeader(ss.str(), minLength);
     }
     /** @brief Generate an OrderedPointSet header string */
-    static std::string MakeOrderedHeader(OrderedPointSet<T> ps)
+    static std::string MakeOrderedHeader(const OrderedPointSet<T>& ps)
     {
         std::stringstream ss;
         ss << "width: " << ps.width() << std::endl;
@@ -173,9 +256,8 @@ public:
         }
 
         ss << "version: " << PointSet<T>::FORMAT_VERSION << std::endl;
-        ss << PointSet<T>::HEADER_TERMINATOR << std::endl;
 
-        return ss.str();
+        return AlignHeader(ss.str());
     }
 
     /**
@@ -337,6 +419,41 @@ public:
     /**@}*/
 
 private:
+    /**
+     * Pad a header with a comment line and terminate it so that its length
+     * is a multiple of HEADER_ALIGNMENT and at least minLength
+     */
+    static std::string AlignHeader(
+        std::string header, std::size_t minLength = 0)
+    {
+        // Padding comment is at least "#\n", terminator is "<>\n"
+        std::string terminator{PointSet<T>::HEADER_TERMINATOR};
+        auto length = header.size() + 2 + terminator.size() + 1;
+        auto extra = (length < minLength) ? minLength - length : 0;
+        length += extra;
+        extra += (HEADER_ALIGNMENT - length % HEADER_ALIGNMENT) %
+                 HEADER_ALIGNMENT;
+        header += "#" + std::string(extra, ' ') + "\n";
+        header += terminator + "\n";
+        return header;
+    }
+
+    /** Size in bytes of a header element type */
+    static std::size_t TypeBytes(const std::string& type)
+    {
+        if (type == "float") {
+            return sizeof(float);
+        }
+        if (type == "double") {
+            return sizeof(double);
+        }
+        if (type == "int") {
+            return sizeof(int);
+        }
+        auto msg = "Unrecognized type: " + type;
+        throw IOException(msg);
+    }
+
     /**@{*/
     /** @brief Read an ASCII PointSet */
     static PointSet<T> ReadPointSetAscii(const volcart::filesystem::path& path)
@@ -402,24 +519,15 @@ private:
             throw IOException(msg);
         }
         auto header = PointSetIO<T>::ParseHeader(infile, false);
-        PointSet<T> ps{header.size};
 
-        // Size of binary elements to read
-        std::size_t typeBytes{};
-        if (header.type == "float") {
-            typeBytes = sizeof(float);
-        } else if (header.type == "double") {
-            typeBytes = sizeof(double);
-        } else if (header.type == "int") {
-            typeBytes = sizeof(int);
-        }
-
-        // Read data
-        T t;
-        for (std::size_t i = 0; i < header.size; ++i) {
-            auto nbytes = header.dim * typeBytes;
-            infile.read(reinterpret_cast<char*>(t.val), nbytes);
-            ps.push_back(t);
+        // The header was validated against T, so the points can be read in
+        // a single block
+        PointSet<T> ps(header.size, T{});
+        infile.read(
+            reinterpret_cast<char*>(ps.data()),
+            static_cast<std::streamsize>(header.size * sizeof(T)));
+        if (!infile) {
+            throw IOException("unexpected end of file");
         }
 
         return ps;
@@ -435,31 +543,19 @@ private:
             throw IOException(msg);
         }
         auto header = PointSetIO<T>::ParseHeader(infile, true);
-        OrderedPointSet<T> ps{header.width};
-
-        // Size of binary elements to read
-        std::size_t typeBytes = sizeof(int);
-        if (header.type == "float") {
-            typeBytes = sizeof(float);
-        } else if (header.type == "double") {
-            typeBytes = sizeof(double);
-        } else if (header.type == "int") {
-            typeBytes = sizeof(int);
-        } else {
-            auto msg = "Unrecognized type: " + header.type;
-            throw IOException(msg);
-        }
 
-        // Read data
-        T t;
-        std::size_t nbytes = header.width * header.dim * typeBytes;
-        std::vector<T> points(header.width, 0);
-        points.reserve(header.width);
-        for (std::size_t h = 0; h < header.height; ++h) {
-            infile.read(reinterpret_cast<char*>(points.data()), nbytes);
-            ps.pushRow(points);
+        // The header was validated against T, so the points can be read in
+        // a single block
+        std::vector<T> points(header.width * header.height);
+        infile.read(
+            reinterpret_cast<char*>(points.data()),
+            static_cast<std::streamsize>(points.size() * sizeof(T)));
+        if (!infile) {
+            throw IOException("unexpected end of file");
         }
 
+        OrderedPointSet<T> ps{header.width};
+        ps.pushRows(std::begin(points), std::end(points));
         return ps;
     }
     /**@}*/
@@ -467,7 +563,7 @@ private:
     /**@{*/
     /** @brief Write an ASCII PointSet */
     static void WritePointSetAscii(
-        const volcart::filesystem::path& path, PointSet<T> ps)
+        const volcart::filesystem::path& path, const PointSet<T>& ps)
     {
         std::ofstream outfile{path.string()};
         if (!outfile.is_open()) {
@@ -494,7 +590,7 @@ private:
 
     /** @brief Write a binary PointSet */
     static void WritePointSetBinary(
-        const volcart::filesystem::path& path, PointSet<T> ps)
+        const volcart::filesystem::path& path, const PointSet<T>& ps)
     {
         std::ofstream outfile{path.string(), std::ios::binary};
         if (!outfile.is_open()) {
@@ -505,10 +601,9 @@ private:
         auto header = PointSetIO<T>::MakeHeader(ps);
         outfile.write(header.c_str(), header.size());
 
-        for (const auto& p : ps) {
-            auto nbytes = T::channels * sizeof(typename T::value_type);
-            outfile.write(reinterpret_cast<const char*>(p.val), nbytes);
-        }
+        outfile.write(
+            reinterpret_cast<const char*>(ps.data()),
+            static_cast<std::streamsize>(ps.size() * sizeof(T)));
 
         outfile.flush();
         outfile.close();
@@ -520,7 +615,7 @@ private:
 
     /** @brief Write an ASCII OrderedPointSet */
     static void WriteOrderedPointSetAscii(
-        const volcart::filesystem::path& path, OrderedPointSet<T> ps)
+        const volcart::filesystem::path& path, const OrderedPointSet<T>& ps)
     {
         std::ofstream outfile{path.string()};
         if (!outfile.is_open()) {
@@ -547,7 +642,7 @@ private:
 
     /** @brief Write a binary OrderedPointSet */
     static void WriteOrderedPointSetBinary(
-        const volcart::filesystem::path& path, OrderedPointSet<T> ps)
+        const volcart::filesystem::path& path, const OrderedPointSet<T>& ps)
     {
         std::ofstream outfile{path.string(), std::ios::binary};
         if (!outfile.is_open()) {
@@ -558,10 +653,9 @@ private:
         auto header = PointSetIO<T>::MakeOrderedHeader(ps);
         outfile.write(header.c_str(), header.size());
 
-        for (const auto& p : ps) {
-            auto nbytes = T::channels * sizeof(typename T::value_type);
-            outfile.write(reinterpret_cast<const char*>(p.val), nbytes);
-        }
+        outfile.write(
+            reinterpret_cast<const char*>(ps.data()),
+            static_cast<std::streamsize>(ps.size() * sizeof(T)));
 
         outfile.flush();
         outfile.close();
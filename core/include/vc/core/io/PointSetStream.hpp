@@ -0,0 +1,215 @@
+#pragma once
+
+/** @file */
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+#include "vc/core/filesystem.hpp"
+#include "vc/core/io/PointSetIO.hpp"
+#include "vc/core/types/Exceptions.hpp"
+
+namespace volcart
+{
+
+/**
+ * @class PointSetReader
+ * @brief Read the points of a binary PointSet file in chunks
+ *
+ * Reads a binary PointSet or OrderedPointSet file sequentially, a chunk of
+ * points at a time, so that files larger than the available memory can be
+ * processed. Points are returned in file order.
+ *
+ * @tparam T Point type. Must match the type and dimension in the header.
+ *
+ * @see volcart::PointSetWriter
+ * @see volcart::MappedPointSet
+ *
+ * @ingroup IO
+ */
+template <typename T>
+class PointSetReader
+{
+public:
+    /** Header type */
+    using Header = typename PointSetIO<T>::Header;
+
+    /**
+     * @brief Open a binary point set file and read its header
+     *
+     * @throws volcart::IOException if the file cannot be opened or its
+     * header does not match T
+     */
+    explicit PointSetReader(const filesystem::path& path)
+        : infile_{path.string(), std::ios::binary}
+    {
+        if (not infile_.is_open()) {
+            throw IOException("could not open file '" + path.string() + "'");
+        }
+        header_ = PointSetIO<T>::ParseHeader(infile_, false);
+    }
+
+    /** @brief Get the file header */
+    [[nodiscard]] auto header() const -> const Header& { return header_; }
+
+    /** @brief Get the number of points in the file */
+    [[nodiscard]] auto size() const -> std::size_t { return header_.size; }
+
+    /** @brief Get the number of points which have not been read */
+    [[nodiscard]] auto remaining() const -> std::size_t
+    {
+        return header_.size - read_;
+    }
+
+    /**
+     * @brief Read the next chunk of points
+     *
+     * Replaces the contents of buffer with up to count points. The buffer
+     * can be reused between calls to avoid reallocation.
+     *
+     * @return Number of points read. Zero once every point has been read.
+     * @throws volcart::IOException if the file ends early
+     */
+    auto read(std::vector<T>& buffer, std::size_t count) -> std::size_t
+    {
+        count = std::min(count, remaining());
+        buffer.resize(count);
+        infile_.read(
+            reinterpret_cast<char*>(buffer.data()),
+            static_cast<std::streamsize>(count * sizeof(T)));
+        if (not infile_) {
+            throw IOException("unexpected end of file");
+        }
+        read_ += count;
+        return count;
+    }
+
+private:
+    /** Input file */
+    std::ifstream infile_;
+    /** File header */
+    Header header_;
+    /** Number of points read */
+    std::size_t read_{0};
+};
+
+/**
+ * @class PointSetWriter
+ * @brief Write a binary PointSet file incrementally
+ *
+ * Writes points to a binary PointSet file as they are produced, so that the
+ * full set never needs to be held in memory. The header reserves space for
+ * the largest possible point count and is rewritten with the final count by
+ * close(). The resulting file is identical in format to one written by
+ * PointSetIO::WritePointSet().
+ *
+ * The destructor closes the file, but ignores errors. Call close() to be
+ * notified of write failures.
+ *
+ * @tparam T Point type
+ *
+ * @see volcart::PointSetReader
+ *
+ * @ingroup IO
+ */
+template <typename T>
+class PointSetWriter
+{
+public:
+    /**
+     * @brief Create a binary point set file
+     *
+     * @throws volcart::IOException if the file cannot be opened
+     */
+    explicit PointSetWriter(const filesystem::path& path)
+        : path_{path}
+        , outfile_{path.string(), std::ios::binary}
+        , headerLength_{PointSetIO<T>::MakeHeader(MAX_SIZE).size()}
+    {
+        if (not outfile_.is_open()) {
+            throw IOException("could not open file '" + path.string() + "'");
+        }
+        write_header_();
+    }
+
+    PointSetWriter(const PointSetWriter&) = delete;
+    auto operator=(const PointSetWriter&) -> PointSetWriter& = delete;
+
+    /** Destructor. Closes the file. */
+    ~PointSetWriter()
+    {
+        try {
+            close();
+        } catch (...) {
+        }
+    }
+
+    /** @brief Append a point */
+    void write(const T& p) { write(&p, 1); }
+
+    /** @brief Append count contiguous points */
+    void write(const T* points, std::size_t count)
+    {
+        outfile_.write(
+            reinterpret_cast<const char*>(points),
+            static_cast<std::streamsize>(count * sizeof(T)));
+        size_ += count;
+    }
+
+    /** @brief Append a vector of points */
+    void write(const std::vector<T>& points)
+    {
+        write(points.data(), points.size());
+    }
+
+    /** @brief Get the number of points written */
+    [[nodiscard]] auto size() const -> std::size_t { return size_; }
+
+    /**
+     * @brief Write the final header and close the file
+     *
+     * Does nothing if the file is already closed.
+     *
+     * @throws volcart::IOException if the file could not be written
+     */
+    void close()
+    {
+        if (not outfile_.is_open()) {
+            return;
+        }
+        outfile_.seekp(0);
+        write_header_();
+        outfile_.close();
+        if (outfile_.fail()) {
+            auto msg = "failure writing file '" + path_.string() + "'";
+            throw IOException(msg);
+        }
+    }
+
+private:
+    /** Point count used to size the reserved header */
+    static constexpr std::size_t MAX_SIZE{
+        std::numeric_limits<std::size_t>::max()};
+
+    /** Write the header for the current size at the current position */
+    void write_header_()
+    {
+        // Never longer than the reserved header, so padded to the same length
+        auto header = PointSetIO<T>::MakeHeader(size_, headerLength_);
+        outfile_.write(header.c_str(), header.size());
+    }
+
+    /** Output path */
+    filesystem::path path_;
+    /** Output file */
+    std::ofstream outfile_;
+    /** Length of the reserved header */
+    std::size_t headerLength_;
+    /** Number of points written */
+    std::size_t size_{0};
+};
+
+}  // namespace volcart
@@ -2,6 +2,8 @@
 
 /** @file */
 
+#include <cstdint>
+
 #include "vc/core/neighborhood/NeighborhoodGenerator.hpp"
 
 namespace volcart
@@ -48,7 +50,28 @@ public:
         const Volume::Pointer& v,
         const cv::Vec3d& pt,
         const std::vector<cv::Vec3d>& axes) override;
+
+    /**
+     * @copydoc NeighborhoodGenerator::sample()
+     *
+     * Throws if `setAutoGenAxes()` is `false`.
+     */
+    void sample(
+        const Volume::Pointer& v,
+        const cv::Vec3d& pt,
+        const cv::Vec3d& axis,
+        std::uint16_t* out) override;
     /**@}*/
+
+private:
+    /** Sample the cuboid defined by three axes into a buffer */
+    void sample_(
+        const Volume::Pointer& v,
+        const cv::Vec3d& pt,
+        const cv::Vec3d& a0,
+        const cv::Vec3d& a1,
+        const cv::Vec3d& a2,
+        std::uint16_t* out) const;
 };
 
 }  // namespace volcart
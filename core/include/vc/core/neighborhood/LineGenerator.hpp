@@ -2,6 +2,10 @@
 
 /** @file */
 
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
 #include "vc/core/neighborhood/NeighborhoodGenerator.hpp"
 
 namespace volcart
@@ -45,7 +49,18 @@ public:
         const Volume::Pointer& v,
         const cv::Vec3d& pt,
         const std::vector<cv::Vec3d>& axes) override;
+
+    /** @copydoc NeighborhoodGenerator::sample() */
+    void sample(
+        const Volume::Pointer& v,
+        const cv::Vec3d& pt,
+        const cv::Vec3d& axis,
+        std::uint16_t* out) override;
     /**@}*/
+
+private:
+    /** Get the starting offset and number of samples along the line */
+    auto sample_range_() const -> std::pair<double, std::size_t>;
 };
 
 }  // namespace volcart
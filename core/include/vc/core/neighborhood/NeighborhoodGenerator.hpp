@@ -2,9 +2,12 @@
 
 /** @file */
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <numeric>
 
 #include "vc/core/types/NDArray.hpp"
 #include "vc/core/types/Volume.hpp"
@@ -52,6 +55,14 @@ public:
      * parameters
      */
     virtual Neighborhood::Extent extents() const = 0;
+
+    /** @brief Get the number of samples in the neighborhood */
+    std::size_t size() const
+    {
+        auto e = extents();
+        return std::accumulate(
+            e.begin(), e.end(), std::size_t{1}, std::multiplies<>());
+    }
     /**@}*/
 
     /**@{*/
@@ -85,6 +96,22 @@ public:
      */
     void setSamplingDirection(Direction d) { direction_ = d; }
 
+    /**
+     * @brief Skip samples in regions darker than a threshold
+     *
+     * If the Volume has a VolumeBlockStats summary, samples in blocks whose
+     * maximum intensity is below `t` are set to 0 without reading the
+     * Volume. Since such samples are treated as air, this only changes the
+     * result of filters which are sensitive to dark samples (e.g. minimum and
+     * mean). Generators which support it may also skip entire neighborhoods.
+     *
+     * Default: 0 (disabled)
+     */
+    void setSkipThreshold(std::uint16_t t) { skipThreshold_ = t; }
+
+    /** @copydoc setSkipThreshold() */
+    std::uint16_t skipThreshold() const { return skipThreshold_; }
+
     /**
      * @brief Enable/Disable auto-generation of missing axes
      *
@@ -99,6 +126,28 @@ public:
         const Volume::Pointer& v,
         const cv::Vec3d& pt,
         const std::vector<cv::Vec3d>& axes) = 0;
+
+    /**
+     * @brief Sample a neighborhood centered on a point into a buffer
+     *
+     * Writes the flattened neighborhood which would be returned by
+     * `compute(v, pt, {axis})` to `out`, which must have room for at least
+     * size() samples. Any axes after the first are generated as in compute().
+     *
+     * Derived classes should override this method to sample directly into
+     * `out` without allocating. This makes it suitable for per-pixel use in
+     * hot loops with a reusable, per-thread buffer. Implementations do not
+     * modify the generator and may be called concurrently.
+     */
+    virtual void sample(
+        const Volume::Pointer& v,
+        const cv::Vec3d& pt,
+        const cv::Vec3d& axis,
+        std::uint16_t* out)
+    {
+        auto n = compute(v, pt, {axis});
+        std::copy(n.begin(), n.end(), out);
+    }
     /**@}*/
 
 protected:
@@ -121,6 +170,29 @@ protected:
 
     /** Auto-generate Axes flag */
     bool autoGenAxes_{true};
+    /** Intensity below which regions are skipped */
+    std::uint16_t skipThreshold_{0};
+
+    /**
+     * Block summary used to skip samples, or nullptr if samples are not
+     * skipped
+     */
+    VolumeBlockStats::Pointer skip_stats_(const Volume::Pointer& v) const
+    {
+        return skipThreshold_ > 0 ? v->blockStats() : nullptr;
+    }
+
+    /** Interpolate the Volume at a position unless it is skipped */
+    std::uint16_t sample_at_(
+        const Volume::Pointer& v,
+        const VolumeBlockStats* stats,
+        const cv::Vec3d& p) const
+    {
+        if (stats and stats->maxAt(p) < skipThreshold_) {
+            return 0;
+        }
+        return v->interpolateAt(p);
+    }
 };
 
 }  // namespace volcart
@@ -35,16 +35,16 @@ public:
     DiskBasedObjectBaseClass() = delete;
 
     /** @brief Get the "unique" ID for the object */
-    Identifier id() const { return metadata_.get<std::string>("uuid"); }
+    Identifier id() const { return id_.get(); }
 
     /** @brief Get the path to the object */
     volcart::filesystem::path path() const { return path_; }
 
     /** @brief Get the human-readable name for the object */
-    std::string name() const { return metadata_.get<std::string>("name"); }
+    std::string name() const { return name_.get(); }
 
     /** @brief Set the human-readable name of the object */
-    void setName(std::string n) { metadata_.set("name", std::move(n)); }
+    void setName(std::string n) { name_.set(metadata_, std::move(n)); }
 
     /** @brief Update metadata on disk */
     void saveMetadata() { metadata_.save(); }
@@ -62,5 +62,11 @@ protected:
 
     /** Location for the object on disk */
     volcart::filesystem::path path_;
+
+private:
+    /** Cached ID */
+    volcart::MetadataField<Identifier> id_{"uuid"};
+    /** Cached name */
+    volcart::MetadataField<std::string> name_{"name"};
 };
 }  // namespace volcart
@@ -0,0 +1,56 @@
+#pragma once
+
+/** @file */
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "vc/core/types/ITKMesh.hpp"
+
+namespace volcart
+{
+
+/**
+ * @brief Contiguous vertex and face arrays for a triangle mesh
+ *
+ * A flat copy of the geometry stored in an ITKMesh for algorithms which
+ * index vertices and faces directly or which process them in parallel.
+ * Vertex and face IDs match those of the source mesh.
+ *
+ * @ingroup Types
+ */
+struct MeshArrays {
+    /** Triangular face type */
+    using Face = std::array<std::size_t, 3>;
+
+    /** Vertex positions */
+    std::vector<cv::Vec3d> vertices;
+    /** Vertex normals. Empty if normals were not requested. */
+    std::vector<cv::Vec3d> normals;
+    /** Triangular faces */
+    std::vector<Face> faces;
+};
+
+/**
+ * @brief Copy an ITKMesh into contiguous vertex and face arrays
+ *
+ * @param copyNormals If `true`, also copy the vertex normals
+ *
+ * @ingroup Types
+ */
+auto ToMeshArrays(const ITKMesh::Pointer& mesh, bool copyNormals = false)
+    -> MeshArrays;
+
+/**
+ * @brief Construct an ITKMesh from contiguous vertex and face arrays
+ *
+ * Vertex normals are only assigned if MeshArrays::normals is not empty.
+ *
+ * @ingroup Types
+ */
+auto ToITKMesh(const MeshArrays& arrays) -> ITKMesh::Pointer;
+
+}  // namespace volcart
@@ -4,6 +4,9 @@
 
 #include <fstream>
 #include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
 
 #include <nlohmann/json.hpp>
 #include <opencv2/core.hpp>
@@ -112,4 +115,73 @@ protected:
     /** Location where the JSON file will be stored*/
     volcart::filesystem::path path_;
 };
+
+/**
+ * @class MetadataField
+ * @brief Typed, cached view of a single Metadata key
+ *
+ * Metadata::get() performs a JSON lookup and type conversion on every call.
+ * For values read in inner loops, a MetadataField keeps a converted copy of
+ * the value which is refreshed by load() and written through by set(). The
+ * owner of the Metadata is responsible for calling load() whenever the
+ * Metadata is replaced and for routing all writes of the key through set().
+ *
+ * Like Metadata, a field is safe to read from multiple threads as long as it
+ * is not modified at the same time.
+ *
+ * @tparam T Value type
+ *
+ * @ingroup Types
+ */
+template <typename T>
+class MetadataField
+{
+public:
+    /** @brief Construct a field for a metadata key */
+    explicit MetadataField(std::string key) : key_{std::move(key)} {}
+
+    /** @brief Get the metadata key */
+    const std::string& key() const { return key_; }
+
+    /** @brief Return whether the field has a value */
+    bool hasValue() const { return value_.has_value(); }
+
+    /**
+     * @brief Get the cached value
+     *
+     * Throws an std::runtime_error if the key was not set, like
+     * Metadata::get().
+     */
+    const T& get() const
+    {
+        if (not value_) {
+            auto msg = "could not find key '" + key_ + "' in metadata";
+            throw std::runtime_error(msg);
+        }
+        return *value_;
+    }
+
+    /** @brief Refresh the cached value from the metadata */
+    void load(const Metadata& meta)
+    {
+        if (meta.hasKey(key_)) {
+            value_ = meta.get<T>(key_);
+        } else {
+            value_.reset();
+        }
+    }
+
+    /** @brief Set the value in the metadata and update the cached value */
+    void set(Metadata& meta, T value)
+    {
+        meta.set(key_, value);
+        value_ = std::move(value);
+    }
+
+private:
+    /** Metadata key */
+    std::string key_;
+    /** Cached value */
+    std::optional<T> value_;
+};
 }  // namespace volcart
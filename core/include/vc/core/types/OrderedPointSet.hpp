@@ -5,6 +5,7 @@
 #include <cassert>
 #include <cstddef>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <stdexcept>
 
@@ -142,6 +143,21 @@ public:
             std::begin(points), std::end(points), std::back_inserter(data_));
     }
 
+    /**
+     * @brief Add one or more rows of points to the OrderedPointSet
+     *
+     * Points are in row-major order. The number of points must be a multiple
+     * of the width.
+     */
+    template <class InputIt>
+    void pushRows(InputIt first, InputIt last)
+    {
+        auto count = static_cast<std::size_t>(std::distance(first, last));
+        assert(count % width_ == 0 && "rows incorrect size");
+        data_.reserve(data_.size() + count);
+        data_.insert(std::end(data_), first, last);
+    }
+
     // Cannot add individual points to this class because it would break
     // width constraint calculation
     void push_back(const T& val) = delete;
@@ -4,6 +4,7 @@
 
 #include <cstddef>
 #include <memory>
+#include <utility>
 
 #include <opencv2/core.hpp>
 
@@ -238,6 +239,38 @@ public:
 
     /** @brief Read a PerPixelMap from disk */
     static auto ReadPPM(const filesystem::path& path) -> PerPixelMap;
+
+    /**
+     * @brief Read a rectangular region of a PerPixelMap from disk
+     *
+     * Only the mappings inside the region are read. `mask` should be the
+     * full-size pixel mask returned by ReadPPMMask(). It is cropped to the
+     * region and may be empty. The cell map is not loaded. The region is
+     * clamped to the bounds of the PerPixelMap.
+     */
+    static auto ReadPPMRegion(
+        const filesystem::path& path,
+        std::size_t originY,
+        std::size_t originX,
+        std::size_t height,
+        std::size_t width,
+        const cv::Mat& mask = {}) -> PerPixelMap;
+
+    /**
+     * @brief Read the pixel mask of a PerPixelMap on disk
+     *
+     * Returns an empty image if the mask could not be read.
+     */
+    static auto ReadPPMMask(const filesystem::path& path) -> cv::Mat;
+
+    /**
+     * @brief Read the dimensions of a PerPixelMap on disk without reading
+     * its mappings
+     *
+     * @return The height and width of the PerPixelMap
+     */
+    static auto ReadPPMDimensions(const filesystem::path& path)
+        -> std::pair<std::size_t, std::size_t>;
     /**@}*/
 
     /** @brief Create a cropped PPM */
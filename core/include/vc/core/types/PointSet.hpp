@@ -93,6 +93,12 @@ public:
     /** @brief Get the PointSet storage container */
     Container as_vector() { return data_; }
 
+    /** @brief Get a pointer to the contiguous point storage */
+    T* data() { return data_.data(); }
+
+    /** @copydoc data() */
+    const T* data() const { return data_.data(); }
+
     /** @brief Remove all elements from the PointSet */
     void clear() { data_.clear(); }
     /**@}*/
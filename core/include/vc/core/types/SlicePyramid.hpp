@@ -0,0 +1,150 @@
+#pragma once
+
+/** @file */
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "vc/core/filesystem.hpp"
+#include "vc/core/types/LRUCache.hpp"
+#include "vc/core/types/Volume.hpp"
+
+namespace volcart
+{
+
+/**
+ * @brief Multi-resolution view of the slices of a Volume
+ *
+ * Level 0 is the full-resolution slice as returned by
+ * Volume::getSliceData(). Every following level halves the width and height
+ * of the previous level (rounding up), until the largest dimension is no
+ * larger than MIN_LEVEL_SIZE. Viewers use the coarser levels to display a
+ * zoomed-out slice without converting and drawing every full-resolution
+ * pixel.
+ *
+ * Levels are read from the volume's `pyramid/<level>/` directory if it
+ * exists and otherwise are built lazily from the next finer level with
+ * area-averaging. Levels above 0 are kept in an LRU cache, while level 0 uses
+ * the volume's own slice cache.
+ *
+ * All member functions are thread-safe.
+ *
+ * @ingroup Types
+ */
+class SlicePyramid
+{
+public:
+    /** Pointer type */
+    using Pointer = std::shared_ptr<SlicePyramid>;
+
+    /** Coarsest level size: levels are added until both dimensions fit */
+    static constexpr int MIN_LEVEL_SIZE = 256;
+
+    /** Default number of cached downsampled slices */
+    static constexpr std::size_t DEFAULT_CAPACITY = 256;
+
+    /** Name of the precomputed levels directory in the volume directory */
+    static constexpr auto DEFAULT_DIRNAME = "pyramid";
+
+    /**@{*/
+    /** @brief Construct the pyramid for a volume */
+    explicit SlicePyramid(
+        Volume::Pointer volume, std::size_t capacity = DEFAULT_CAPACITY);
+
+    /** @copydoc SlicePyramid(Volume::Pointer, std::size_t) */
+    static auto New(
+        Volume::Pointer volume, std::size_t capacity = DEFAULT_CAPACITY)
+        -> Pointer;
+    /**@}*/
+
+    /**@{*/
+    /** @brief Get the volume */
+    [[nodiscard]] auto volume() const -> Volume::Pointer;
+
+    /** @brief Get the number of levels, including the full resolution */
+    [[nodiscard]] auto numLevels() const -> int;
+
+    /** @brief Get the slice size at a level */
+    [[nodiscard]] auto levelSize(int level) const -> cv::Size;
+
+    /**
+     * @brief Get the coarsest level which has at least the resolution needed
+     * to display a slice at the given scale
+     *
+     * A scale of 1 displays one slice pixel per screen pixel and selects
+     * level 0. A scale of 0.25 selects level 2.
+     */
+    [[nodiscard]] auto levelForScale(double scale) const -> int;
+
+    /** @brief Whether a level is read from disk rather than built */
+    [[nodiscard]] auto isPrecomputed(int level) const -> bool;
+    /**@}*/
+
+    /**@{*/
+    /**
+     * @brief Get a slice at the given level
+     *
+     * Returns an empty matrix if the slice is missing.
+     *
+     * @warning As with Volume::getSliceData(), the returned matrix shares its
+     * data with the cache and should not be modified.
+     */
+    [[nodiscard]] auto getSliceData(int index, int level) const -> cv::Mat;
+
+    /**
+     * @brief Get a rectangular region of a slice at the given level
+     *
+     * `rect` is in the pixel coordinates of the level and is clipped to the
+     * level size. The returned matrix is a view into the cached slice.
+     */
+    [[nodiscard]] auto getTile(int index, int level, cv::Rect rect) const
+        -> cv::Mat;
+    /**@}*/
+
+    /**@{*/
+    /** @brief Set the maximum number of cached downsampled slices */
+    void setCacheCapacity(std::size_t capacity);
+
+    /** @brief Purge the cache of downsampled slices */
+    void cachePurge() const;
+    /**@}*/
+
+    /** @brief Directory containing the precomputed slices of a level */
+    static auto LevelPath(const filesystem::path& volumePath, int level)
+        -> filesystem::path;
+
+    /** @brief Get the size of every level of a slice, starting at level 0 */
+    static auto LevelSizes(cv::Size sliceSize) -> std::vector<cv::Size>;
+
+    /**
+     * @brief Downsample a slice to the next level
+     *
+     * Tools which precompute levels should use this so that their levels
+     * match the ones built on demand.
+     */
+    static auto Downsample(const cv::Mat& slice, cv::Size size) -> cv::Mat;
+
+private:
+    /** Build or load a level above 0 */
+    [[nodiscard]] auto load_level_(int index, int level) const -> cv::Mat;
+    /** Cache key of a slice level */
+    [[nodiscard]] auto key_(int index, int level) const -> std::int64_t;
+
+    /** Volume */
+    Volume::Pointer volume_;
+    /** Size of each level */
+    std::vector<cv::Size> sizes_;
+    /** Whether each level exists on disk */
+    std::vector<bool> precomputed_;
+    /** Downsampled slice cache */
+    mutable LRUCache<std::int64_t, cv::Mat> cache_;
+    /** Protects cache_ */
+    mutable std::mutex mutex_;
+};
+
+}  // namespace volcart
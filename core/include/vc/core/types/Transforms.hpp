@@ -5,6 +5,7 @@
 #include <cstddef>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <string>
 
 #include <nlohmann/json.hpp>
@@ -140,6 +141,43 @@ public:
     [[nodiscard]] auto applyPointAndNormal(
         const cv::Vec6d& ptN, bool normalize = true) const -> cv::Vec6d;
 
+    /**
+     * @brief Get the transform as a single 4x4 affine matrix
+     *
+     * Returns std::nullopt if the transform cannot be expressed as an affine
+     * matrix. Used by applyBatch() to avoid per-point virtual calls.
+     */
+    [[nodiscard]] virtual auto affineMatrix() const
+        -> std::optional<cv::Matx44d>;
+
+    /**
+     * @brief Transform arrays of points and normals in place
+     *
+     * Transforms count points starting at `points` and count normals
+     * starting at `normals`. The components of each value are contiguous,
+     * and consecutive values are `stride` doubles apart. This allows
+     * interleaved point and normal arrays, such as the cv::Vec6d values of a
+     * PerPixelMap, to be transformed without copying. Either array may be
+     * nullptr.
+     *
+     * If affineMatrix() is available, the matrix is applied to blocks of
+     * values with a loop which the compiler can vectorize. Otherwise, this
+     * calls applyPoint() and applyVector() for every value. Large arrays are
+     * split across worker threads.
+     *
+     * @param normalize If true (default), the transformed normals are
+     * normalized
+     * @param numThreads Number of worker threads. If 0 (default), uses all
+     * available threads.
+     */
+    void applyBatch(
+        double* points,
+        double* normals,
+        std::size_t count,
+        std::size_t stride = 3,
+        bool normalize = true,
+        std::size_t numThreads = 0) const;
+
     /**
      * @brief Compose two transforms into a single new transform
      *
@@ -272,6 +310,9 @@ public:
     /** @copydoc Transform3D::applyVector() */
     [[nodiscard]] auto applyVector(const cv::Vec3d& vector) const
         -> cv::Vec3d final;
+    /** @copydoc Transform3D::affineMatrix() */
+    [[nodiscard]] auto affineMatrix() const
+        -> std::optional<cv::Matx44d> final;
 
     /** @brief Get the current transform parameters */
     [[nodiscard]] auto params() const -> Parameters;
@@ -381,6 +422,9 @@ public:
     /** @copydoc Transform3D::applyVector() */
     [[nodiscard]] auto applyVector(const cv::Vec3d& vector) const
         -> cv::Vec3d final;
+    /** @copydoc Transform3D::affineMatrix() */
+    [[nodiscard]] auto affineMatrix() const
+        -> std::optional<cv::Matx44d> final;
 
 private:
     /** Don't allow construction on the stack */
@@ -457,6 +501,9 @@ public:
     /** @copydoc Transform3D::applyVector() */
     [[nodiscard]] auto applyVector(const cv::Vec3d& vector) const
         -> cv::Vec3d final;
+    /** @copydoc Transform3D::affineMatrix() */
+    [[nodiscard]] auto affineMatrix() const
+        -> std::optional<cv::Matx44d> final;
 
     /**
      * @brief Add a transform to the end of the composite transform stack
@@ -490,25 +537,46 @@ private:
     void from_meta_(const Metadata& meta) final;
 };
 
-/** @brief Apply a transform to an ITKMesh */
+/**
+ * @brief Apply a transform to an ITKMesh
+ *
+ * Vertices and normals are transformed with Transform3D::applyBatch().
+ *
+ * @param numThreads Number of worker threads. If 0 (default), uses all
+ * available threads.
+ */
 auto ApplyTransform(
     const ITKMesh::Pointer& mesh,
     const Transform3D::Pointer& transform,
-    bool normalize = true) -> ITKMesh::Pointer;
+    bool normalize = true,
+    std::size_t numThreads = 0) -> ITKMesh::Pointer;
 
-/** @brief Apply a transform to a PerPixelMap */
+/**
+ * @brief Apply a transform to a PerPixelMap
+ *
+ * Mappings are transformed in place with Transform3D::applyBatch().
+ *
+ * @param numThreads Number of worker threads. If 0 (default), uses all
+ * available threads.
+ */
 auto ApplyTransform(
     const PerPixelMap& ppm,
     const Transform3D::Pointer& transform,
-    bool normalize = true) -> PerPixelMap;
+    bool normalize = true,
+    std::size_t numThreads = 0) -> PerPixelMap;
 
 /** @brief Apply a transform to a PerPixelMap::Pointer */
 auto ApplyTransform(
     const PerPixelMap::Pointer& ppm,
     const Transform3D::Pointer& transform,
-    bool normalize = true) -> PerPixelMap::Pointer;
+    bool normalize = true,
+    std::size_t numThreads = 0) -> PerPixelMap::Pointer;
 
-/** @brief Apply a transform to a PointSet */
+/**
+ * @brief Apply a transform to a PointSet
+ *
+ * PointSets of cv::Vec3d are transformed with Transform3D::applyBatch().
+ */
 template <class PointSetT>
 auto ApplyTransform(const PointSetT& ps, const Transform3D::Pointer& transform)
     -> PointSetT;
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+
 /** DEBUG ONLY: Print AffineTransform to std::ostream */
 auto operator<<(std::ostream& os, const volcart::AffineTransform& t)
     -> std::ostream&;
@@ -12,9 +16,16 @@ auto ApplyTransform(const PointSetT& ps, const Transform3D::Pointer& transform)
     -> PointSetT
 {
     PointSetT output(ps);
-    std::transform(
-        output.begin(), output.end(), output.begin(),
-        [transform](const auto& a) { return transform->applyPoint(a); });
+    using Point = std::decay_t<decltype(*std::begin(output))>;
+    if constexpr (std::is_same_v<Point, cv::Vec3d>) {
+        if (not output.empty()) {
+            transform->applyBatch(output.data()->val, nullptr, output.size());
+        }
+    } else {
+        std::transform(
+            output.begin(), output.end(), output.begin(),
+            [transform](const auto& a) { return transform->applyPoint(a); });
+    }
     return output;
 }
 
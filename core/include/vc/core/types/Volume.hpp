@@ -2,9 +2,15 @@
 
 /** @file */
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <mutex>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
 
 #include "vc/core/filesystem.hpp"
 #include "vc/core/types/BoundingBox.hpp"
@@ -12,6 +18,8 @@
 #include "vc/core/types/DiskBasedObjectBaseClass.hpp"
 #include "vc/core/types/LRUCache.hpp"
 #include "vc/core/types/Reslice.hpp"
+#include "vc/core/types/VolumeBlockStats.hpp"
+#include "vc/core/types/VolumeHistogram.hpp"
 
 namespace volcart
 {
@@ -47,6 +55,23 @@ public:
     /** Default slice cache capacity */
     static constexpr std::size_t DEFAULT_CAPACITY = 200;
 
+    /** @brief Parameters of a Reslice plane */
+    struct ReslicePlane {
+        /** Center of the Reslice image */
+        cv::Vec3d center;
+        /** X-axis of the Reslice plane */
+        cv::Vec3d xvec;
+        /** Y-axis of the Reslice plane */
+        cv::Vec3d yvec;
+    };
+
+    /**
+     * @brief Callback for resliceEach()
+     *
+     * Called with the index of the plane and its Reslice.
+     */
+    using ResliceFn = std::function<void(std::size_t, const Reslice&)>;
+
     /**@{*/
     /** Default constructor. Cannot be constructed without path. */
     Volume() = delete;
@@ -181,6 +206,42 @@ public:
         const cv::Vec3d& yvec,
         int width = 64,
         int height = 64) const;
+
+    /**
+     * @brief Create a Reslice image for each of a set of planes
+     *
+     * Produces the same images as calling reslice() for every plane, but
+     * fetches each slice intersected by the planes only once and samples the
+     * fetched slices directly. This avoids a slice cache lookup for every
+     * interpolated voxel. All intersected slices are held in memory for the
+     * duration of the call, so this is intended for many small reslices of a
+     * local region.
+     *
+     * @param numThreads Number of worker threads. If 0, uses all hardware
+     * threads.
+     */
+    std::vector<Reslice> reslice(
+        const std::vector<ReslicePlane>& planes,
+        int width = 64,
+        int height = 64,
+        std::size_t numThreads = 1) const;
+
+    /**
+     * @brief Create a Reslice image for each of a set of planes and pass it
+     * to a callback
+     *
+     * Like reslice(const std::vector<ReslicePlane>&, int, int, std::size_t),
+     * but every worker thread renders into a single scratch image which is
+     * reused for all of its planes. The Reslice passed to `fn` is only valid
+     * for the duration of the call: clone its image to keep it. `fn` is
+     * called concurrently when using multiple threads.
+     */
+    void resliceEach(
+        const std::vector<ReslicePlane>& planes,
+        const ResliceFn& fn,
+        int width = 64,
+        int height = 64,
+        std::size_t numThreads = 1) const;
     /**@}*/
 
     /**@{*/
@@ -209,10 +270,65 @@ public:
     /** @brief Get the current number of cached slices */
     std::size_t getCacheSize() const { return cache_->size(); }
 
+    /** @brief Whether a slice is currently in the slice cache */
+    bool isCached(int index) const;
+
     /** @brief Purge the slice cache */
     void cachePurge() const;
     /**@}*/
 
+    /**@{*/
+    /**
+     * @brief Get the block intensity summary of the volume
+     *
+     * If no summary has been set, loads the summary stored in the volume
+     * directory. Returns `nullptr` if there is none.
+     */
+    VolumeBlockStats::Pointer blockStats() const;
+
+    /** @brief Set the block intensity summary of the volume */
+    void setBlockStats(VolumeBlockStats::Pointer stats);
+
+    /** @brief Get the path of the stored block intensity summary */
+    volcart::filesystem::path blockStatsPath() const;
+    /**@}*/
+
+    /**@{*/
+    /**
+     * @brief Get the intensity histograms of the volume
+     *
+     * If no histograms have been set, loads the histograms stored in the
+     * volume directory. Returns `nullptr` if there are none, or if the
+     * stored histograms cannot be read or do not match the volume.
+     */
+    VolumeHistogram::Pointer histogram() const;
+
+    /** @brief Set the intensity histograms of the volume */
+    void setHistogram(VolumeHistogram::Pointer histogram);
+
+    /** @brief Get the path of the stored intensity histograms */
+    volcart::filesystem::path histogramPath() const;
+    /**@}*/
+
+    /**@{*/
+    /**
+     * @brief Record derived data stored in the volume directory
+     *
+     * Derived data, such as precomputed pyramid levels or a chunked copy of
+     * the volume, are described in the `derived` object of the volume
+     * metadata, keyed by name. Call saveMetadata() to write the change to
+     * disk.
+     */
+    void setDerivedData(const std::string& name, const nlohmann::json& info);
+
+    /**
+     * @brief Get the description of derived data
+     *
+     * Returns null if there is no derived data with the given name.
+     */
+    nlohmann::json derivedData(const std::string& name) const;
+    /**@}*/
+
 protected:
     /** Slice width */
     int width_{0};
@@ -222,6 +338,12 @@ protected:
     int slices_{0};
     /** Slice file name padding */
     int numSliceCharacters_{0};
+    /** Voxel size, cached from the metadata */
+    MetadataField<double> voxelSize_{"voxelsize"};
+    /** Minimum intensity, cached from the metadata */
+    MetadataField<double> min_{"min"};
+    /** Maximum intensity, cached from the metadata */
+    MetadataField<double> max_{"max"};
 
     /** Whether to use slice cache */
     bool cacheSlices_{true};
@@ -235,8 +357,31 @@ protected:
     cv::Mat load_slice_(int index) const;
     /** Load slice from cache */
     cv::Mat cache_slice_(int index) const;
+    /**
+     * Fetch the slices intersected by a set of Reslice planes. Returns a
+     * table indexed by slice number in which other slices are empty.
+     */
+    std::vector<cv::Mat> fetch_reslice_slices_(
+        const std::vector<ReslicePlane>& planes,
+        int width,
+        int height,
+        std::size_t numThreads) const;
     /** Shared mutex for thread-safe access */
     mutable std::shared_mutex cache_mutex_;
     mutable std::shared_mutex print_mutex_;
+
+    /** Block intensity summary */
+    mutable VolumeBlockStats::Pointer blockStats_;
+    /** Whether loading the stored summary has been attempted */
+    mutable std::atomic<bool> blockStatsLoaded_{false};
+    /** Serializes loading the stored summary */
+    mutable std::mutex blockStatsMutex_;
+
+    /** Intensity histograms */
+    mutable VolumeHistogram::Pointer histogram_;
+    /** Whether loading the stored histograms has been attempted */
+    mutable std::atomic<bool> histogramLoaded_{false};
+    /** Serializes loading the stored histograms */
+    mutable std::mutex histogramMutex_;
 };
 }  // namespace volcart
@@ -0,0 +1,157 @@
+#pragma once
+
+/** @file */
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "vc/core/filesystem.hpp"
+
+namespace volcart
+{
+
+class Volume;
+
+/**
+ * @brief Coarse per-block intensity summary of a Volume
+ *
+ * Divides the volume into cubic blocks and records the minimum and maximum
+ * intensity of every block. Consumers use the maximum to find regions which
+ * only contain air (intensities below some threshold) without reading any
+ * voxels, e.g. NeighborhoodGenerator::setSkipThreshold().
+ *
+ * Neighboring blocks overlap by one voxel: block `b` along an axis summarizes
+ * the voxels `[b * blockSize(), (b + 1) * blockSize()]`. As a result, all of
+ * the voxels read by Volume::interpolateAt() for a position lie in the block
+ * which contains the position, so maxAt() is an upper bound on the
+ * interpolated intensity.
+ *
+ * The summary is computed once with Compute(), or incrementally with
+ * addSlice() while the slices are written, and stored in the volume
+ * directory as DEFAULT_FILENAME.
+ *
+ * @ingroup Types
+ */
+class VolumeBlockStats
+{
+public:
+    /** Pointer type */
+    using Pointer = std::shared_ptr<VolumeBlockStats>;
+
+    /** Default block edge length, in voxels */
+    static constexpr int DEFAULT_BLOCK_SIZE{32};
+
+    /** File name of the summary in the volume directory */
+    static constexpr auto DEFAULT_FILENAME = "block_stats.bin";
+
+    /**@{*/
+    /**
+     * @brief Construct an empty summary for a volume of the given size
+     *
+     * @param volumeSize Volume size as (width, height, slices)
+     */
+    explicit VolumeBlockStats(
+        const cv::Vec3i& volumeSize, int blockSize = DEFAULT_BLOCK_SIZE);
+
+    /** @copydoc VolumeBlockStats(const cv::Vec3i&, int) */
+    static auto New(
+        const cv::Vec3i& volumeSize, int blockSize = DEFAULT_BLOCK_SIZE)
+        -> Pointer;
+
+    /**
+     * @brief Compute the summary of a volume
+     *
+     * Slices are summarized in parallel.
+     */
+    static auto Compute(
+        const Volume& volume,
+        int blockSize = DEFAULT_BLOCK_SIZE,
+        std::size_t numThreads = 0) -> Pointer;
+    /**@}*/
+
+    /**@{*/
+    /**
+     * @brief Add a slice to the summary
+     *
+     * Slices can be added in any order and from multiple threads, but not
+     * while the summary is being queried or written.
+     *
+     * @throws std::invalid_argument if the slice is not a single-channel,
+     * 16-bit image of the volume's slice size
+     */
+    void addSlice(int z, const cv::Mat& slice);
+    /**@}*/
+
+    /**@{*/
+    /** @brief Get the volume size as (width, height, slices) */
+    [[nodiscard]] auto volumeSize() const -> cv::Vec3i;
+
+    /** @brief Get the block edge length */
+    [[nodiscard]] auto blockSize() const -> int;
+
+    /** @brief Get the number of blocks along (x, y, z) */
+    [[nodiscard]] auto numBlocks() const -> cv::Vec3i;
+
+    /** @brief Get the minimum intensity of a block */
+    [[nodiscard]] auto min(int bx, int by, int bz) const -> std::uint16_t;
+
+    /** @brief Get the maximum intensity of a block */
+    [[nodiscard]] auto max(int bx, int by, int bz) const -> std::uint16_t;
+
+    /**
+     * @brief Upper bound of the interpolated intensity at a position
+     *
+     * Returns 0 for positions outside of the volume.
+     */
+    [[nodiscard]] auto maxAt(const cv::Vec3d& p) const -> std::uint16_t;
+
+    /**
+     * @brief Upper bound of the interpolated intensity along a line segment
+     *
+     * Considers every block in the bounding box of the segment.
+     */
+    [[nodiscard]] auto maxAlong(const cv::Vec3d& a, const cv::Vec3d& b) const
+        -> std::uint16_t;
+    /**@}*/
+
+    /**@{*/
+    /** @brief Write the summary to a file */
+    void write(const filesystem::path& path) const;
+
+    /**
+     * @brief Read a summary written by write()
+     *
+     * @throws volcart::IOException if the file cannot be read
+     */
+    static auto Read(const filesystem::path& path) -> Pointer;
+    /**@}*/
+
+private:
+    /** Merge the block summary of a slice into a slab of blocks */
+    void merge_slab_(
+        int bz,
+        const std::vector<std::uint16_t>& lo,
+        const std::vector<std::uint16_t>& hi);
+    /** Flat index of a block */
+    [[nodiscard]] auto index_(int bx, int by, int bz) const -> std::size_t;
+
+    /** Volume size */
+    cv::Vec3i size_;
+    /** Block edge length */
+    int blockSize_;
+    /** Number of blocks */
+    cv::Vec3i blocks_;
+    /** Per-block minima, z-major */
+    std::vector<std::uint16_t> min_;
+    /** Per-block maxima, z-major */
+    std::vector<std::uint16_t> max_;
+    /** Serializes addSlice() */
+    std::mutex mutex_;
+};
+
+}  // namespace volcart
@@ -0,0 +1,129 @@
+#pragma once
+
+/** @file */
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "vc/core/filesystem.hpp"
+#include "vc/core/types/NDArray.hpp"
+
+namespace volcart
+{
+
+/**
+ * @brief Chunked copy of a Volume
+ *
+ * Stores a volume as cubic chunks of chunkSize() voxels so that consumers of
+ * a small 3D region only read the voxels near that region instead of every
+ * intersecting slice. Each chunk is a file in the chunk directory named
+ * `<cz>/<cy>_<cx>.raw` which contains the chunk's voxels as raw, native
+ * byte-order 16-bit values in z, y, x order. Chunks on the upper edges of
+ * the volume are clipped to the volume's size.
+ *
+ * Chunks are written slice by slice with addSlice(), so a volume can be
+ * converted while it is streamed without holding more than one slice in
+ * memory. The chunk directory of a volume is usually
+ * `<volume>/DEFAULT_DIRNAME`.
+ *
+ * @ingroup Types
+ */
+class VolumeChunks
+{
+public:
+    /** Pointer type */
+    using Pointer = std::shared_ptr<VolumeChunks>;
+
+    /** Chunk data type */
+    using Chunk = NDArray<std::uint16_t>;
+
+    /** Default chunk edge length, in voxels */
+    static constexpr int DEFAULT_CHUNK_SIZE{128};
+
+    /** Name of the chunk directory in the volume directory */
+    static constexpr auto DEFAULT_DIRNAME = "chunks";
+
+    /**@{*/
+    /**
+     * @brief Construct chunks for a volume of the given size
+     *
+     * The directory is created when the first slice is added.
+     *
+     * @param dir Chunk directory
+     * @param volumeSize Volume size as (width, height, slices)
+     */
+    VolumeChunks(
+        filesystem::path dir,
+        const cv::Vec3i& volumeSize,
+        int chunkSize = DEFAULT_CHUNK_SIZE);
+
+    /** @copydoc VolumeChunks(filesystem::path, const cv::Vec3i&, int) */
+    static auto New(
+        filesystem::path dir,
+        const cv::Vec3i& volumeSize,
+        int chunkSize = DEFAULT_CHUNK_SIZE) -> Pointer;
+    /**@}*/
+
+    /**@{*/
+    /**
+     * @brief Write a slice into the chunks which contain it
+     *
+     * Different slices can be added concurrently and in any order.
+     *
+     * @throws std::invalid_argument if the slice is not a single-channel,
+     * 16-bit image of the volume's slice size
+     * @throws volcart::IOException if a chunk file cannot be written
+     */
+    void addSlice(int z, const cv::Mat& slice);
+    /**@}*/
+
+    /**@{*/
+    /** @brief Get the chunk directory */
+    [[nodiscard]] auto path() const -> filesystem::path;
+
+    /** @brief Get the volume size as (width, height, slices) */
+    [[nodiscard]] auto volumeSize() const -> cv::Vec3i;
+
+    /** @brief Get the chunk edge length */
+    [[nodiscard]] auto chunkSize() const -> int;
+
+    /** @brief Get the number of chunks along (x, y, z) */
+    [[nodiscard]] auto numChunks() const -> cv::Vec3i;
+
+    /** @brief Get the size of a chunk as (width, height, depth) */
+    [[nodiscard]] auto chunkExtent(int cx, int cy, int cz) const -> cv::Vec3i;
+
+    /** @brief Get the file path of a chunk */
+    [[nodiscard]] auto chunkPath(int cx, int cy, int cz) const
+        -> filesystem::path;
+
+    /**
+     * @brief Read a chunk
+     *
+     * @return Array of voxels indexed as (z, y, x)
+     * @throws volcart::IOException if the chunk file cannot be read
+     */
+    [[nodiscard]] auto readChunk(int cx, int cy, int cz) const -> Chunk;
+    /**@}*/
+
+private:
+    /** Create the files of a slab of chunks */
+    void create_slab_(int cz);
+
+    /** Chunk directory */
+    filesystem::path dir_;
+    /** Volume size */
+    cv::Vec3i size_;
+    /** Chunk edge length */
+    int chunkSize_;
+    /** Number of chunks */
+    cv::Vec3i chunks_;
+    /** Creates every slab of chunks once */
+    std::vector<std::once_flag> slabCreated_;
+};
+
+}  // namespace volcart
@@ -0,0 +1,196 @@
+#pragma once
+
+/** @file */
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "vc/core/filesystem.hpp"
+
+namespace volcart
+{
+
+class Volume;
+
+/**
+ * @brief Intensity histograms of a Volume
+ *
+ * Records a histogram of the 16-bit intensities of every slice and of every
+ * cubic block of voxels. The histograms are computed once and stored in the
+ * volume directory as DEFAULT_FILENAME, after which intensity percentiles
+ * (e.g. for contrast windowing or normalization) can be looked up without
+ * reading any voxels.
+ *
+ * Intensities are counted in NUM_BINS bins of BIN_WIDTH values each.
+ * Percentiles are linearly interpolated within a bin. Queries over a range
+ * of slices use cumulative slice histograms, so their cost does not depend
+ * on the number of slices. Queries over a region of interest combine the
+ * histograms of every block which intersects the region, and so include
+ * the voxels of the partially covered blocks on its edges.
+ *
+ * The histograms are computed with Compute(), or incrementally with
+ * addSlice() while the slices are written.
+ *
+ * @ingroup Types
+ */
+class VolumeHistogram
+{
+public:
+    /** Pointer type */
+    using Pointer = std::shared_ptr<VolumeHistogram>;
+
+    /** Histogram type: Number of voxels in each bin */
+    using Histogram = std::vector<std::uint64_t>;
+
+    /** Number of histogram bins */
+    static constexpr int NUM_BINS{256};
+
+    /** Number of intensity values per bin */
+    static constexpr int BIN_WIDTH{65536 / NUM_BINS};
+
+    /** Default block edge length, in voxels */
+    static constexpr int DEFAULT_BLOCK_SIZE{128};
+
+    /** Maximum block edge length, so that block counts fit in 32 bits */
+    static constexpr int MAX_BLOCK_SIZE{1024};
+
+    /** File name of the histograms in the volume directory */
+    static constexpr auto DEFAULT_FILENAME = "histogram.bin";
+
+    /**@{*/
+    /**
+     * @brief Construct empty histograms for a volume of the given size
+     *
+     * @param volumeSize Volume size as (width, height, slices)
+     * @throws std::invalid_argument if the volume size is not positive or
+     * the block size is not in the range [1, MAX_BLOCK_SIZE]
+     */
+    explicit VolumeHistogram(
+        const cv::Vec3i& volumeSize, int blockSize = DEFAULT_BLOCK_SIZE);
+
+    /** @copydoc VolumeHistogram(const cv::Vec3i&, int) */
+    static auto New(
+        const cv::Vec3i& volumeSize, int blockSize = DEFAULT_BLOCK_SIZE)
+        -> Pointer;
+
+    /**
+     * @brief Compute the histograms of a volume
+     *
+     * Slices are counted in parallel.
+     */
+    static auto Compute(
+        const Volume& volume,
+        int blockSize = DEFAULT_BLOCK_SIZE,
+        std::size_t numThreads = 0) -> Pointer;
+    /**@}*/
+
+    /**@{*/
+    /**
+     * @brief Add a slice to the histograms
+     *
+     * Slices can be added in any order and from multiple threads, but not
+     * while the histograms are being written. Each slice should only be
+     * added once.
+     *
+     * @throws std::invalid_argument if the slice is not a single-channel,
+     * 16-bit image of the volume's slice size
+     */
+    void addSlice(int z, const cv::Mat& slice);
+    /**@}*/
+
+    /**@{*/
+    /** @brief Get the volume size as (width, height, slices) */
+    [[nodiscard]] auto volumeSize() const -> cv::Vec3i;
+
+    /** @brief Get the block edge length */
+    [[nodiscard]] auto blockSize() const -> int;
+
+    /** @brief Get the number of blocks along (x, y, z) */
+    [[nodiscard]] auto numBlocks() const -> cv::Vec3i;
+
+    /** @brief Get the histogram of the whole volume */
+    [[nodiscard]] auto histogram() const -> Histogram;
+
+    /**
+     * @brief Get the histogram of the slices in [zMin, zMax]
+     *
+     * The range is clamped to the volume.
+     */
+    [[nodiscard]] auto histogram(int zMin, int zMax) const -> Histogram;
+
+    /**
+     * @brief Get the histogram of a region of the slices in [zMin, zMax]
+     *
+     * Includes every block which intersects the region. The region is
+     * clamped to the volume.
+     */
+    [[nodiscard]] auto histogram(const cv::Rect& roi, int zMin, int zMax) const
+        -> Histogram;
+
+    /** @brief Get the p-th percentile intensity of the whole volume */
+    [[nodiscard]] auto percentile(double p) const -> double;
+
+    /** @brief Get the p-th percentile intensity of the slices [zMin, zMax] */
+    [[nodiscard]] auto percentile(double p, int zMin, int zMax) const
+        -> double;
+
+    /**
+     * @brief Get the p-th percentile intensity of a region of the slices
+     * [zMin, zMax]
+     */
+    [[nodiscard]] auto percentile(
+        double p, const cv::Rect& roi, int zMin, int zMax) const -> double;
+
+    /**
+     * @brief Get the p-th percentile intensity of a histogram
+     *
+     * @param p Percentile in the range [0, 100]
+     * @return Intensity, interpolated within its bin. 0 if the histogram is
+     * empty.
+     */
+    static auto Percentile(const Histogram& h, double p) -> double;
+    /**@}*/
+
+    /**@{*/
+    /** @brief Write the histograms to a file */
+    void write(const filesystem::path& path) const;
+
+    /**
+     * @brief Read histograms written by write()
+     *
+     * @throws volcart::IOException if the file cannot be read
+     */
+    static auto Read(const filesystem::path& path) -> Pointer;
+    /**@}*/
+
+private:
+    /** Rebuild the cumulative slice histograms if slices were added */
+    void update_cumulative_() const;
+    /** Offset of the first bin of a block */
+    [[nodiscard]] auto block_offset_(int bx, int by, int bz) const
+        -> std::size_t;
+
+    /** Volume size */
+    cv::Vec3i size_;
+    /** Block edge length */
+    int blockSize_;
+    /** Number of blocks */
+    cv::Vec3i blocks_;
+    /** Per-slice histograms */
+    std::vector<std::uint64_t> slices_;
+    /** Per-block histograms, z-major */
+    std::vector<std::uint32_t> blockBins_;
+    /** Cumulative slice histograms: Entry z counts the slices before z */
+    mutable std::vector<std::uint64_t> cumulative_;
+    /** Whether cumulative_ is up to date */
+    mutable bool cumulativeValid_{false};
+    /** Serializes addSlice() with queries and updates of cumulative_ */
+    mutable std::mutex mutex_;
+};
+
+}  // namespace volcart
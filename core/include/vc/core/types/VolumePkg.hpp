@@ -248,6 +248,15 @@ public:
 
     /** @copydoc VolumePkg::render(const Render::Identifier&) const */
     auto render(const Render::Identifier& id) -> Render::Pointer;
+
+    /**
+     * @brief Get the directory for memoized render graph results
+     *
+     * Shared by all Renders in the VolumePkg. The directory is hidden inside
+     * the renders directory and is not loaded as a Render. It is not created
+     * by this function.
+     */
+    [[nodiscard]] auto renderCacheDir() const -> filesystem::path;
     /**@}*/
 
     /** @name Transform Data */
@@ -0,0 +1,119 @@
+#pragma once
+
+/** @file */
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+
+namespace volcart
+{
+
+/**
+ * @brief Fixed-capacity, thread-safe FIFO queue for connecting the stages of
+ * a pipeline
+ *
+ * Producers block in push() while the queue is full and consumers block in
+ * pop() while it is empty, which limits the amount of work buffered between
+ * stages. Once a producer stage is done, close() the queue: consumers drain
+ * the remaining items and then receive an empty result from pop(). Closing
+ * is also used to abort a pipeline, as blocked producers are released and
+ * further items are rejected.
+ *
+ * @ingroup Util
+ */
+template <typename T>
+class BoundedQueue
+{
+public:
+    /** @brief Construct a queue which holds at most `capacity` items */
+    explicit BoundedQueue(std::size_t capacity) : capacity_{capacity}
+    {
+        if (capacity_ == 0) {
+            throw std::invalid_argument("queue capacity must be positive");
+        }
+    }
+
+    /**
+     * @brief Add an item to the back of the queue
+     *
+     * Blocks while the queue is full.
+     *
+     * @return false if the queue was closed and the item was not added
+     */
+    auto push(T item) -> bool
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(
+            lock, [this] { return closed_ or items_.size() < capacity_; });
+        if (closed_) {
+            return false;
+        }
+        items_.push_back(std::move(item));
+        lock.unlock();
+        notEmpty_.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Remove the item at the front of the queue
+     *
+     * Blocks while the queue is empty and open.
+     *
+     * @return The item, or an empty optional if the queue is closed and
+     * empty
+     */
+    auto pop() -> std::optional<T>
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmpty_.wait(lock, [this] { return closed_ or not items_.empty(); });
+        if (items_.empty()) {
+            return std::nullopt;
+        }
+        std::optional<T> item{std::move(items_.front())};
+        items_.pop_front();
+        lock.unlock();
+        notFull_.notify_one();
+        return item;
+    }
+
+    /** @brief Close the queue and wake all blocked producers and consumers */
+    void close()
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        notFull_.notify_all();
+        notEmpty_.notify_all();
+    }
+
+    /** @brief Get the number of queued items */
+    [[nodiscard]] auto size() const -> std::size_t
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return items_.size();
+    }
+
+    /** @brief Get the maximum number of queued items */
+    [[nodiscard]] auto capacity() const -> std::size_t { return capacity_; }
+
+private:
+    /** Maximum number of items */
+    std::size_t capacity_;
+    /** Queued items */
+    std::deque<T> items_;
+    /** Whether the queue was closed */
+    bool closed_{false};
+    /** Protects items_ and closed_ */
+    mutable std::mutex mutex_;
+    /** Signaled when an item is removed */
+    std::condition_variable notFull_;
+    /** Signaled when an item is added */
+    std::condition_variable notEmpty_;
+};
+
+}  // namespace volcart
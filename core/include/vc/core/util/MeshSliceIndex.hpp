@@ -0,0 +1,155 @@
+#pragma once
+
+/** @file */
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "vc/core/types/ITKMesh.hpp"
+#include "vc/core/types/MeshArrays.hpp"
+
+namespace volcart
+{
+
+/**
+ * @brief Z-interval index for intersecting a triangle mesh with z-planes
+ *
+ * Cutting a mesh with a plane (e.g. with `vtkCutter`) tests every face of the
+ * mesh, so intersecting a large mesh with every slice of a volume is
+ * quadratic. This index buckets the faces of a mesh into slabs of fixed
+ * thickness along the z-axis. A face is assigned to every slab which its
+ * z-extent overlaps, so the faces which intersect the plane `z = k` are found
+ * by visiting the single slab containing `k`.
+ *
+ * The index is immutable after construction and can be queried from multiple
+ * threads.
+ *
+ * @ingroup Util
+ */
+class MeshSliceIndex
+{
+public:
+    /** Pointer type */
+    using Pointer = std::shared_ptr<MeshSliceIndex>;
+
+    /** @brief Intersection of a face with a z-plane */
+    struct Segment {
+        /** End points of the segment */
+        std::array<cv::Vec3d, 2> points;
+        /**
+         * Vertex normals interpolated at the end points. Zero if the mesh
+         * does not have normals.
+         */
+        std::array<cv::Vec3d, 2> normals;
+        /** Index of the intersected face */
+        std::size_t face{0};
+        /**
+         * Mesh edges on which the end points lie, as pairs of vertex indices
+         * in ascending order
+         */
+        std::array<std::array<std::size_t, 2>, 2> edges;
+    };
+
+    /** @brief Connected sequence of intersection points */
+    using Polyline = std::vector<cv::Vec3d>;
+
+    /**@{*/
+    /**
+     * @brief Build the index for a mesh
+     *
+     * @param slabWidth Thickness of the slabs along the z-axis. Smaller slabs
+     * reduce the number of faces tested by a query, but faces which span
+     * multiple slabs are stored once per slab.
+     */
+    explicit MeshSliceIndex(const ITKMesh::Pointer& mesh, double slabWidth = 1);
+
+    /** @copydoc MeshSliceIndex(const ITKMesh::Pointer&, double) */
+    explicit MeshSliceIndex(MeshArrays mesh, double slabWidth = 1);
+
+    /**
+     * @brief Build the index for the combination of multiple meshes
+     *
+     * The meshes are not merged, so each produces its own polylines. Vertex
+     * normals are only used if every mesh has them.
+     */
+    explicit MeshSliceIndex(
+        const std::vector<ITKMesh::Pointer>& meshes, double slabWidth = 1);
+
+    /** Make a new shared instance */
+    template <typename... Args>
+    static auto New(Args... args) -> Pointer
+    {
+        return std::make_shared<MeshSliceIndex>(std::forward<Args>(args)...);
+    }
+    /**@}*/
+
+    /**@{*/
+    /** @brief Minimum z-value of the mesh */
+    [[nodiscard]] auto zMin() const -> double;
+
+    /** @brief Maximum z-value of the mesh */
+    [[nodiscard]] auto zMax() const -> double;
+
+    /** @brief Whether the indexed mesh has vertex normals */
+    [[nodiscard]] auto hasNormals() const -> bool;
+
+    /** @brief Get the indexed mesh */
+    [[nodiscard]] auto mesh() const -> const MeshArrays&;
+    /**@}*/
+
+    /**@{*/
+    /** @brief Get the indices of the faces whose z-extent contains `z` */
+    [[nodiscard]] auto faces(double z) const -> std::vector<std::size_t>;
+
+    /**
+     * @brief Intersect the mesh with the plane at `z`
+     *
+     * Returns one segment for every face which crosses the plane. Vertices
+     * which lie on the plane are treated as being above it, so faces which
+     * only touch the plane at a vertex and faces which lie in the plane do
+     * not produce segments. Segment end points are ordered consistently with
+     * the winding of their face. End points on a shared edge are identical
+     * for both faces which share the edge.
+     */
+    [[nodiscard]] auto intersect(double z) const -> std::vector<Segment>;
+
+    /**
+     * @brief Intersect the mesh with the plane at `z` and connect the
+     * segments into polylines
+     *
+     * Equivalent to cutting the mesh with `vtkCutter` and joining the cut
+     * with `vtkStripper`. Segments which share a mesh edge are joined. Closed
+     * loops repeat their first point at the end. The run time is
+     * proportional to the number of faces which span `z`.
+     */
+    [[nodiscard]] auto polylines(double z) const -> std::vector<Polyline>;
+    /**@}*/
+
+private:
+    /** Build the slab buckets */
+    void build_();
+    /** Slab which contains z. May be out of range. */
+    [[nodiscard]] auto slab_(double z) const -> std::ptrdiff_t;
+
+    /** Indexed mesh */
+    MeshArrays mesh_;
+    /** Slab thickness */
+    double slabWidth_{1};
+    /** Mesh z bounds */
+    double zMin_{0};
+    /** @copydoc zMin_ */
+    double zMax_{0};
+    /** Per-face z-extent */
+    std::vector<cv::Vec2d> faceZ_;
+    /** Start of each slab's face list in slabFaces_. Size: slabs + 1. */
+    std::vector<std::size_t> slabOffsets_;
+    /** Concatenated face lists of all slabs */
+    std::vector<std::size_t> slabFaces_;
+};
+
+}  // namespace volcart
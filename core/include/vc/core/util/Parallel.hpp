@@ -0,0 +1,185 @@
+#pragma once
+
+/** @file */
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace volcart
+{
+
+namespace detail
+{
+/** Cap on the default worker count of the calling thread. 0 if uncapped. */
+inline thread_local std::size_t DefaultThreadLimit{0};
+}  // namespace detail
+
+/**
+ * @brief Get the number of worker threads to use for a requested thread count
+ *
+ * If `requested` is 0, returns the number of hardware threads reported by
+ * the system, reduced to the calling thread's ScopedThreadLimit if one is
+ * active. Always returns at least 1.
+ *
+ * @ingroup Util
+ */
+inline auto NumWorkerThreads(std::size_t requested = 0) -> std::size_t
+{
+    if (requested > 0) {
+        return requested;
+    }
+    auto n = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    if (detail::DefaultThreadLimit > 0) {
+        n = std::min(n, detail::DefaultThreadLimit);
+    }
+    return n;
+}
+
+/**
+ * @brief Cap the default worker count of the calling thread
+ *
+ * While in scope, NumWorkerThreads() and the parallel algorithms in this
+ * file use at most `limit` threads on the calling thread when no explicit
+ * thread count is requested. Used to keep concurrently running tasks which
+ * parallelize internally from oversubscribing the CPU. A limit of 0 removes
+ * the cap. Explicit thread counts are not affected.
+ *
+ * @ingroup Util
+ */
+class ScopedThreadLimit
+{
+public:
+    /** @brief Set the limit until destruction */
+    explicit ScopedThreadLimit(std::size_t limit)
+        : previous_{detail::DefaultThreadLimit}
+    {
+        detail::DefaultThreadLimit = limit;
+    }
+
+    ScopedThreadLimit(const ScopedThreadLimit&) = delete;
+    auto operator=(const ScopedThreadLimit&) -> ScopedThreadLimit& = delete;
+
+    /** @brief Restore the previous limit */
+    ~ScopedThreadLimit() { detail::DefaultThreadLimit = previous_; }
+
+private:
+    /** Limit in effect before construction */
+    std::size_t previous_;
+};
+
+/**
+ * @brief Run a function over chunks of an index range using a set of worker
+ * threads
+ *
+ * The range [begin, end) is split into chunks of at most `grainSize`
+ * indices which are dynamically assigned to the worker threads. `fn` is
+ * called as `fn(chunkBegin, chunkEnd, threadIdx)`, where `threadIdx` is in
+ * the range [0, numThreads) and can be used to index per-thread scratch
+ * storage. If any invocation of `fn` throws, the remaining chunks are
+ * abandoned and the first exception is rethrown on the calling thread.
+ *
+ * @param numThreads Number of worker threads. If 0, uses
+ * NumWorkerThreads().
+ * @param grainSize Maximum chunk size. If 0, the range is split into
+ * approximately 4 chunks per thread.
+ *
+ * @ingroup Util
+ */
+template <typename Fn>
+void ParallelForChunks(
+    std::size_t begin,
+    std::size_t end,
+    Fn&& fn,
+    std::size_t numThreads = 0,
+    std::size_t grainSize = 0)
+{
+    if (end <= begin) {
+        return;
+    }
+
+    auto count = end - begin;
+    numThreads = std::min(NumWorkerThreads(numThreads), count);
+    if (grainSize == 0) {
+        grainSize = std::max<std::size_t>(count / (4 * numThreads), 1);
+    }
+
+    // Run inline when there's nothing to split
+    if (numThreads == 1) {
+        for (auto b = begin; b < end; b += grainSize) {
+            fn(b, std::min(b + grainSize, end), std::size_t{0});
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> next{begin};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    auto worker = [&](std::size_t threadIdx) {
+        while (not failed) {
+            auto b = next.fetch_add(grainSize);
+            if (b >= end) {
+                break;
+            }
+            try {
+                fn(b, std::min(b + grainSize, end), threadIdx);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (not error) {
+                    error = std::current_exception();
+                }
+                failed = true;
+            }
+        }
+    };
+
+    // The calling thread is used as worker 0
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+    for (std::size_t t = 1; t < numThreads; t++) {
+        threads.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+/**
+ * @brief Run a function for every index in a range using a set of worker
+ * threads
+ *
+ * `fn` is called as `fn(idx)` for every index in [begin, end). Calls are
+ * made concurrently and in no particular order.
+ *
+ * @see ParallelForChunks
+ * @ingroup Util
+ */
+template <typename Fn>
+void ParallelFor(
+    std::size_t begin,
+    std::size_t end,
+    Fn&& fn,
+    std::size_t numThreads = 0,
+    std::size_t grainSize = 0)
+{
+    ParallelForChunks(
+        begin, end,
+        [&fn](std::size_t b, std::size_t e, std::size_t /*threadIdx*/) {
+            for (auto i = b; i < e; i++) {
+                fn(i);
+            }
+        },
+        numThreads, grainSize);
+}
+
+}  // namespace volcart
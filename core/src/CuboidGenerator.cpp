@@ -8,6 +8,23 @@ static const std::vector<cv::Vec3d> BASIS_VECTORS = {
 
 using namespace volcart;
 
+namespace
+{
+// Generate an axis orthogonal to n
+auto OrthogonalAxis(const cv::Vec3d& n) -> cv::Vec3d
+{
+    // Find a basis vector not parallel to n
+    cv::Vec3d basis;
+    for (const auto& b : BASIS_VECTORS) {
+        if (n.dot(b) != 1.0) {
+            basis = b;
+            break;
+        }
+    }
+    return cv::normalize(n.cross(basis));
+}
+}  // namespace
+
 auto CuboidGenerator::compute(
     const Volume::Pointer& v,
     const cv::Vec3d& pt,
@@ -17,15 +34,7 @@ auto CuboidGenerator::compute(
     auto bases = axes;
     if (autoGenAxes_) {
         if (bases.size() == 1) {
-            // Find a basis vector not parallel to n
-            cv::Vec3d basis;
-            for (const auto& b : BASIS_VECTORS) {
-                if (bases[0].dot(b) != 1.0) {
-                    basis = b;
-                    break;
-                }
-            }
-            bases.emplace_back(cv::normalize(bases[0].cross(basis)));
+            bases.emplace_back(OrthogonalAxis(bases[0]));
         }
 
         if (bases.size() == 2) {
@@ -40,26 +49,61 @@ auto CuboidGenerator::compute(
         throw std::invalid_argument(msg);
     }
 
+    Neighborhood output(3, extents());
+    sample_(v, pt, bases[0], bases[1], bases[2], output.data());
+    return output;
+}
+
+void CuboidGenerator::sample(
+    const Volume::Pointer& v,
+    const cv::Vec3d& pt,
+    const cv::Vec3d& axis,
+    std::uint16_t* out)
+{
+    if (not autoGenAxes_) {
+        throw std::invalid_argument("Invalid number of axes (1). Need 3.");
+    }
+    auto a1 = OrthogonalAxis(axis);
+    auto a2 = cv::normalize(axis.cross(a1));
+    sample_(v, pt, axis, a1, a2, out);
+}
+
+void CuboidGenerator::sample_(
+    const Volume::Pointer& v,
+    const cv::Vec3d& pt,
+    const cv::Vec3d& a0,
+    const cv::Vec3d& a1,
+    const cv::Vec3d& a2,
+    std::uint16_t* out) const
+{
     // Get center and primary radius of directional subvolume
     auto center = pt;
     auto radius = radius_;
     if (direction_ != Direction::Bidirectional) {
         radius[0] /= 2.0;
-        auto offset = bases[0] * radius[0];
+        auto offset = a0 * radius[0];
         if (direction_ == Direction::Negative) {
             offset *= -1;
         }
         center += offset;
     }
 
-    // Get the number of samples along each basis
-    auto extent = extents();
+    // Get the number of samples along each basis. Matches extents(), but
+    // doesn't allocate.
+    auto samples = [this](double r) {
+        return static_cast<std::size_t>(std::floor(2.0 * r / interval_) + 1);
+    };
+    const auto nz = samples(radius[0]);
+    const auto ny = samples(radius[1]);
+    const auto nx = samples(radius[2]);
+
+    // Summary used to skip samples in dark regions
+    const auto stats = skip_stats_(v);
 
-    // Iterate over the axes
-    Neighborhood output(3, extent);
-    for (std::size_t z = 0; z < extent[0]; ++z) {
-        for (std::size_t y = 0; y < extent[1]; ++y) {
-            for (std::size_t x = 0; x < extent[2]; ++x) {
+    // Iterate over the axes in row-major (z, y, x) order
+    for (std::size_t z = 0; z < nz; ++z) {
+        for (std::size_t y = 0; y < ny; ++y) {
+            for (std::size_t x = 0; x < nx; ++x) {
 
                 // Offset along each axis
                 auto zOffset = -radius[0] + (z * interval_);
@@ -67,16 +111,14 @@ auto CuboidGenerator::compute(
                 auto xOffset = -radius[2] + (x * interval_);
 
                 // Current 3D position
-                auto p = center + (bases[2] * xOffset) + (bases[1] * yOffset) +
-                         (bases[0] * zOffset);
+                auto p = center + (a2 * xOffset) + (a1 * yOffset) +
+                         (a0 * zOffset);
 
                 // Assign to the subvolume array
-                output(z, y, x) = v->interpolateAt(p);
+                *out++ = sample_at_(v, stats.get(), p);
             }
         }
     }
-
-    return output;
 }
 
 auto CuboidGenerator::extents() const -> Neighborhood::Extent
@@ -93,4 +135,4 @@ auto CuboidGenerator::extents() const -> Neighborhood::Extent
         static_cast<std::size_t>(std::floor(2.0 * radius_[2] / interval_) + 1));
 
     return extent;
-}
\ No newline at end of file
+}
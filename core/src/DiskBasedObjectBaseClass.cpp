@@ -12,6 +12,8 @@ DiskBasedObjectBaseClass::DiskBasedObjectBaseClass(
     : path_(std::move(path))
 {
     metadata_ = volcart::Metadata(path_ / METADATA_FILE);
+    id_.load(metadata_);
+    name_.load(metadata_);
 }
 
 // Create new file on disk
@@ -20,6 +22,6 @@ DiskBasedObjectBaseClass::DiskBasedObjectBaseClass(
     : path_(std::move(path))
 {
     metadata_.setPath((path_ / METADATA_FILE));
-    metadata_.set("uuid", uuid);
-    metadata_.set("name", name);
+    id_.set(metadata_, std::move(uuid));
+    name_.set(metadata_, std::move(name));
 }
\ No newline at end of file
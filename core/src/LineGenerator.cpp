@@ -1,5 +1,6 @@
 #include "vc/core/neighborhood/LineGenerator.hpp"
 
+#include <algorithm>
 #include <cstddef>
 
 #include "vc/core/util/FloatComparison.hpp"
@@ -18,6 +19,39 @@ auto LineGenerator::compute(
         throw std::invalid_argument(msg);
     }
 
+    Neighborhood n(1, sample_range_().second);
+    sample(v, pt, axes[0], n.data());
+    return n;
+}
+
+void LineGenerator::sample(
+    const Volume::Pointer& v,
+    const cv::Vec3d& pt,
+    const cv::Vec3d& axis,
+    std::uint16_t* out)
+{
+    const auto [min, count] = sample_range_();
+
+    // Skip the whole line if it only passes through dark blocks
+    const auto stats = skip_stats_(v);
+    if (stats) {
+        auto first = pt + axis * min;
+        auto last = pt + axis * (min + (count - 1) * interval_);
+        if (stats->maxAlong(first, last) < skipThreshold_) {
+            std::fill(out, out + count, 0);
+            return;
+        }
+    }
+
+    // Iterate through range
+    for (std::size_t it = 0; it < count; it++) {
+        auto offset = min + (it * interval_);
+        out[it] = sample_at_(v, stats.get(), pt + (axis * offset));
+    }
+}
+
+auto LineGenerator::sample_range_() const -> std::pair<double, std::size_t>
+{
     // Interval bounds
     if (AlmostEqual(interval_, 0.0)) {
         throw std::domain_error("Sampling interval too small");
@@ -46,21 +80,12 @@ auto LineGenerator::compute(
         }
     }
 
-    // Iterate through range
     auto count =
         static_cast<std::size_t>(std::floor((max - min) / interval_) + 1);
-    Neighborhood n(1, count);
-    for (std::size_t it = 0; it < count; it++) {
-        auto offset = min + (it * interval_);
-        n(it) = v->interpolateAt(pt + (axes[0] * offset));
-    }
-
-    return n;
+    return {min, count};
 }
 
 auto LineGenerator::extents() const -> Neighborhood::Extent
 {
-    auto radius =
-        (direction_ != Direction::Bidirectional) ? radius_[0] / 2 : radius_[0];
-    return {static_cast<std::size_t>(std::floor(2.0 * radius / interval_) + 1)};
-}
\ No newline at end of file
+    return {sample_range_().second};
+}
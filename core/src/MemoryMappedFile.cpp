@@ -0,0 +1,79 @@
+#include "vc/core/io/MemoryMappedFile.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "vc/core/types/Exceptions.hpp"
+
+namespace fs = volcart::filesystem;
+
+using namespace volcart;
+
+MemoryMappedFile::MemoryMappedFile(const fs::path& path)
+{
+    auto fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw IOException(
+            "could not open file '" + path.string() +
+            "': " + std::strerror(errno));
+    }
+
+    struct stat sb {
+    };
+    if (fstat(fd, &sb) == -1) {
+        auto msg = std::strerror(errno);
+        close(fd);
+        throw IOException(
+            "could not stat file '" + path.string() + "': " + msg);
+    }
+    size_ = static_cast<std::size_t>(sb.st_size);
+
+    // Empty files cannot be mapped
+    if (size_ > 0) {
+        auto* data = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED) {
+            auto msg = std::strerror(errno);
+            close(fd);
+            throw IOException(
+                "could not map file '" + path.string() + "': " + msg);
+        }
+        data_ = static_cast<const char*>(data);
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    close(fd);
+}
+
+MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& other) noexcept
+    : data_{std::exchange(other.data_, nullptr)}
+    , size_{std::exchange(other.size_, 0)}
+{
+}
+
+auto MemoryMappedFile::operator=(MemoryMappedFile&& other) noexcept
+    -> MemoryMappedFile&
+{
+    if (this != &other) {
+        unmap_();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+}
+
+MemoryMappedFile::~MemoryMappedFile() { unmap_(); }
+
+void MemoryMappedFile::unmap_()
+{
+    if (data_ != nullptr) {
+        munmap(const_cast<char*>(data_), size_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+}
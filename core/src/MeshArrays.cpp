@@ -0,0 +1,60 @@
+#include "vc/core/types/MeshArrays.hpp"
+
+using namespace volcart;
+
+auto volcart::ToMeshArrays(const ITKMesh::Pointer& mesh, bool copyNormals)
+    -> MeshArrays
+{
+    MeshArrays arrays;
+    arrays.vertices.resize(mesh->GetNumberOfPoints());
+    if (copyNormals) {
+        arrays.normals.resize(mesh->GetNumberOfPoints());
+    }
+    ITKPixel n;
+    for (auto pt = mesh->GetPoints()->Begin(); pt != mesh->GetPoints()->End();
+         ++pt) {
+        const auto& p = pt->Value();
+        arrays.vertices[pt.Index()] = {p[0], p[1], p[2]};
+        if (copyNormals and mesh->GetPointData(pt.Index(), &n)) {
+            arrays.normals[pt.Index()] = {n[0], n[1], n[2]};
+        }
+    }
+
+    arrays.faces.resize(mesh->GetNumberOfCells());
+    for (auto cell = mesh->GetCells()->Begin(); cell != mesh->GetCells()->End();
+         ++cell) {
+        auto ids = cell.Value()->PointIdsBegin();
+        arrays.faces[cell.Index()] = {ids[0], ids[1], ids[2]};
+    }
+
+    return arrays;
+}
+
+auto volcart::ToITKMesh(const MeshArrays& arrays) -> ITKMesh::Pointer
+{
+    auto mesh = ITKMesh::New();
+    auto hasNormals = arrays.normals.size() == arrays.vertices.size();
+    ITKPoint p;
+    for (std::size_t v = 0; v < arrays.vertices.size(); v++) {
+        const auto& pos = arrays.vertices[v];
+        p[0] = pos[0];
+        p[1] = pos[1];
+        p[2] = pos[2];
+        mesh->SetPoint(v, p);
+        if (hasNormals) {
+            mesh->SetPointData(v, arrays.normals[v].val);
+        }
+    }
+
+    ITKCell::CellAutoPointer cell;
+    for (std::size_t f = 0; f < arrays.faces.size(); f++) {
+        const auto& face = arrays.faces[f];
+        cell.TakeOwnership(new ITKTriangle);
+        cell->SetPointId(0, face[0]);
+        cell->SetPointId(1, face[1]);
+        cell->SetPointId(2, face[2]);
+        mesh->SetCell(f, cell);
+    }
+
+    return mesh;
+}
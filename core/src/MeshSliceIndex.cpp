@@ -0,0 +1,264 @@
+#include "vc/core/util/MeshSliceIndex.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+using namespace volcart;
+
+namespace
+{
+using Edge = std::array<std::size_t, 2>;
+
+struct EdgeHash {
+    auto operator()(const Edge& e) const -> std::size_t
+    {
+        return std::hash<std::size_t>{}(e[0]) * 31 +
+               std::hash<std::size_t>{}(e[1]);
+    }
+};
+
+// Concatenate meshes into a single set of arrays
+auto Combine(const std::vector<ITKMesh::Pointer>& meshes) -> MeshArrays
+{
+    MeshArrays combined;
+    auto normals = true;
+    for (const auto& mesh : meshes) {
+        normals &= mesh->GetPointData() != nullptr and
+                   mesh->GetPointData()->Size() == mesh->GetNumberOfPoints();
+        auto arrays = ToMeshArrays(mesh, true);
+        auto offset = combined.vertices.size();
+        combined.vertices.insert(
+            combined.vertices.end(), arrays.vertices.begin(),
+            arrays.vertices.end());
+        combined.normals.insert(
+            combined.normals.end(), arrays.normals.begin(),
+            arrays.normals.end());
+        for (const auto& f : arrays.faces) {
+            combined.faces.push_back(
+                {f[0] + offset, f[1] + offset, f[2] + offset});
+        }
+    }
+    if (not normals) {
+        combined.normals.clear();
+    }
+    return combined;
+}
+}  // namespace
+
+MeshSliceIndex::MeshSliceIndex(const ITKMesh::Pointer& mesh, double slabWidth)
+    : MeshSliceIndex(Combine({mesh}), slabWidth)
+{
+}
+
+MeshSliceIndex::MeshSliceIndex(
+    const std::vector<ITKMesh::Pointer>& meshes, double slabWidth)
+    : MeshSliceIndex(Combine(meshes), slabWidth)
+{
+}
+
+MeshSliceIndex::MeshSliceIndex(MeshArrays mesh, double slabWidth)
+    : mesh_{std::move(mesh)}, slabWidth_{slabWidth}
+{
+    if (slabWidth_ <= 0) {
+        throw std::invalid_argument("slab width must be positive");
+    }
+    build_();
+}
+
+auto MeshSliceIndex::zMin() const -> double { return zMin_; }
+
+auto MeshSliceIndex::zMax() const -> double { return zMax_; }
+
+auto MeshSliceIndex::hasNormals() const -> bool
+{
+    return not mesh_.normals.empty() and
+           mesh_.normals.size() == mesh_.vertices.size();
+}
+
+auto MeshSliceIndex::mesh() const -> const MeshArrays& { return mesh_; }
+
+void MeshSliceIndex::build_()
+{
+    // Per-face z-extents and mesh bounds
+    faceZ_.resize(mesh_.faces.size());
+    zMin_ = std::numeric_limits<double>::max();
+    zMax_ = std::numeric_limits<double>::lowest();
+    for (std::size_t f = 0; f < mesh_.faces.size(); f++) {
+        const auto& face = mesh_.faces[f];
+        auto z0 = mesh_.vertices[face[0]][2];
+        auto z1 = mesh_.vertices[face[1]][2];
+        auto z2 = mesh_.vertices[face[2]][2];
+        faceZ_[f] = {std::min({z0, z1, z2}), std::max({z0, z1, z2})};
+        zMin_ = std::min(zMin_, faceZ_[f][0]);
+        zMax_ = std::max(zMax_, faceZ_[f][1]);
+    }
+    if (mesh_.faces.empty()) {
+        zMin_ = zMax_ = 0;
+        slabOffsets_ = {0, 0};
+        return;
+    }
+
+    // Count the faces in each slab
+    auto numSlabs = static_cast<std::size_t>(slab_(zMax_)) + 1;
+    slabOffsets_.assign(numSlabs + 1, 0);
+    for (const auto& z : faceZ_) {
+        for (auto s = slab_(z[0]); s <= slab_(z[1]); s++) {
+            slabOffsets_[s + 1]++;
+        }
+    }
+    for (std::size_t s = 0; s < numSlabs; s++) {
+        slabOffsets_[s + 1] += slabOffsets_[s];
+    }
+
+    // Fill the face lists
+    slabFaces_.resize(slabOffsets_.back());
+    auto next = slabOffsets_;
+    for (std::size_t f = 0; f < faceZ_.size(); f++) {
+        for (auto s = slab_(faceZ_[f][0]); s <= slab_(faceZ_[f][1]); s++) {
+            slabFaces_[next[s]++] = f;
+        }
+    }
+}
+
+auto MeshSliceIndex::slab_(double z) const -> std::ptrdiff_t
+{
+    return static_cast<std::ptrdiff_t>(std::floor((z - zMin_) / slabWidth_));
+}
+
+auto MeshSliceIndex::faces(double z) const -> std::vector<std::size_t>
+{
+    std::vector<std::size_t> result;
+    auto s = slab_(z);
+    if (s < 0 or s + 1 >= static_cast<std::ptrdiff_t>(slabOffsets_.size())) {
+        return result;
+    }
+    for (auto i = slabOffsets_[s]; i < slabOffsets_[s + 1]; i++) {
+        auto f = slabFaces_[i];
+        if (faceZ_[f][0] <= z and z <= faceZ_[f][1]) {
+            result.push_back(f);
+        }
+    }
+    return result;
+}
+
+auto MeshSliceIndex::intersect(double z) const -> std::vector<Segment>
+{
+    std::vector<Segment> segments;
+    auto normals = hasNormals();
+    for (auto f : faces(z)) {
+        const auto& face = mesh_.faces[f];
+        std::array<double, 3> d{};
+        std::array<bool, 3> above{};
+        for (std::size_t i = 0; i < 3; i++) {
+            d[i] = mesh_.vertices[face[i]][2] - z;
+            above[i] = d[i] >= 0;
+        }
+
+        // Find the vertex on its own side of the plane
+        std::size_t lone{3};
+        for (std::size_t i = 0; i < 3; i++) {
+            if (above[i] != above[(i + 1) % 3] and
+                above[i] != above[(i + 2) % 3]) {
+                lone = i;
+                break;
+            }
+        }
+        // Skip faces which only touch the plane at the lone vertex
+        if (lone == 3 or d[lone] == 0) {
+            continue;
+        }
+
+        // Interpolate along the two edges which cross the plane. Always
+        // interpolate from the lower vertex index so that faces which share
+        // an edge produce identical points.
+        Segment seg;
+        seg.face = f;
+        for (std::size_t e = 0; e < 2; e++) {
+            auto a = std::min(face[lone], face[(lone + 1 + e) % 3]);
+            auto b = std::max(face[lone], face[(lone + 1 + e) % 3]);
+            const auto& va = mesh_.vertices[a];
+            const auto& vb = mesh_.vertices[b];
+            auto t = (z - va[2]) / (vb[2] - va[2]);
+            seg.points[e] = va + t * (vb - va);
+            if (normals) {
+                const auto& na = mesh_.normals[a];
+                seg.normals[e] = na + t * (mesh_.normals[b] - na);
+            }
+            seg.edges[e] = {a, b};
+        }
+        segments.emplace_back(seg);
+    }
+    return segments;
+}
+
+auto MeshSliceIndex::polylines(double z) const -> std::vector<Polyline>
+{
+    static constexpr auto NONE = std::numeric_limits<std::size_t>::max();
+
+    // Map each edge to the (up to) two segments which end on it
+    auto segs = intersect(z);
+    std::unordered_map<Edge, std::array<std::size_t, 2>, EdgeHash> edgeSegs;
+    edgeSegs.reserve(2 * segs.size());
+    for (std::size_t s = 0; s < segs.size(); s++) {
+        for (const auto& e : segs[s].edges) {
+            auto [it, inserted] = edgeSegs.try_emplace(e, Edge{s, NONE});
+            if (not inserted and it->second[1] == NONE) {
+                it->second[1] = s;
+            }
+        }
+    }
+
+    // Segment across an edge from segment s
+    auto neighbor = [&](const Edge& e, std::size_t s) {
+        const auto& pair = edgeSegs.at(e);
+        return pair[0] == s ? pair[1] : pair[0];
+    };
+
+    // Walk from a segment along the given edge, adding each new point.
+    // Returns true if the walk returned to the starting segment.
+    std::vector<bool> visited(segs.size(), false);
+    auto walk = [&](std::size_t start, Edge edge, Polyline& pts) {
+        auto cur = start;
+        while (true) {
+            auto next = neighbor(edge, cur);
+            if (next == start) {
+                return true;
+            }
+            if (next == NONE or visited[next]) {
+                return false;
+            }
+            visited[next] = true;
+            auto end = segs[next].edges[0] == edge ? 1 : 0;
+            pts.push_back(segs[next].points[end]);
+            edge = segs[next].edges[end];
+            cur = next;
+        }
+    };
+
+    std::vector<Polyline> lines;
+    for (std::size_t s = 0; s < segs.size(); s++) {
+        if (visited[s]) {
+            continue;
+        }
+        visited[s] = true;
+
+        Polyline fwd{segs[s].points[0], segs[s].points[1]};
+        // Closed loops already end on the starting point
+        if (walk(s, segs[s].edges[1], fwd)) {
+            lines.emplace_back(std::move(fwd));
+            continue;
+        }
+
+        Polyline bwd;
+        walk(s, segs[s].edges[0], bwd);
+        Polyline line(bwd.rbegin(), bwd.rend());
+        line.insert(line.end(), fwd.begin(), fwd.end());
+        lines.emplace_back(std::move(line));
+    }
+    return lines;
+}
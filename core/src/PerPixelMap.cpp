@@ -143,6 +143,50 @@ auto PerPixelMap::ReadPPM(const fs::path& path) -> PerPixelMap
     return ppm;
 }
 
+auto PerPixelMap::ReadPPMRegion(
+    const fs::path& path,
+    std::size_t originY,
+    std::size_t originX,
+    std::size_t height,
+    std::size_t width,
+    const cv::Mat& mask) -> PerPixelMap
+{
+    PerPixelMap ppm;
+    ppm.map_ = volcart::PointSetIO<cv::Vec6d>::ReadOrderedPointSetRegion(
+        path, originY, originX, height, width);
+    ppm.height_ = ppm.map_.height();
+    ppm.width_ = ppm.map_.width();
+
+    if (not mask.empty()) {
+        const cv::Rect roi(
+            static_cast<int>(originX), static_cast<int>(originY),
+            static_cast<int>(ppm.width_), static_cast<int>(ppm.height_));
+        mask(roi).copyTo(ppm.mask_);
+    }
+
+    return ppm;
+}
+
+auto PerPixelMap::ReadPPMMask(const fs::path& path) -> cv::Mat
+{
+    cv::Mat mask;
+    auto maskPath = MaskPath(path);
+    if (fs::exists(maskPath)) {
+        mask = cv::imread(maskPath.string(), cv::IMREAD_GRAYSCALE);
+    }
+    if (mask.empty()) {
+        Logger()->warn("Failed to read mask: {}", maskPath.string());
+    }
+    return mask;
+}
+
+auto PerPixelMap::ReadPPMDimensions(const fs::path& path)
+    -> std::pair<std::size_t, std::size_t>
+{
+    auto header = volcart::PointSetIO<cv::Vec6d>::ReadHeader(path);
+    return {header.height, header.width};
+}
+
 PerPixelMap::PerPixelMap(std::size_t height, std::size_t width)
     : height_{height}, width_{width}
 {
@@ -0,0 +1,165 @@
+#include "vc/core/types/SlicePyramid.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include <opencv2/imgproc.hpp>
+
+#include "vc/core/io/TIFFIO.hpp"
+
+namespace fs = volcart::filesystem;
+namespace tio = volcart::tiffio;
+
+using namespace volcart;
+
+SlicePyramid::SlicePyramid(Volume::Pointer volume, std::size_t capacity)
+    : volume_{std::move(volume)}, cache_{capacity}
+{
+    if (not volume_) {
+        throw std::invalid_argument("volume is null");
+    }
+
+    sizes_ = LevelSizes({volume_->sliceWidth(), volume_->sliceHeight()});
+
+    precomputed_.push_back(false);
+    for (int level = 1; level < numLevels(); level++) {
+        precomputed_.push_back(
+            fs::is_directory(LevelPath(volume_->path(), level)));
+    }
+}
+
+auto SlicePyramid::New(Volume::Pointer volume, std::size_t capacity)
+    -> Pointer
+{
+    return std::make_shared<SlicePyramid>(std::move(volume), capacity);
+}
+
+auto SlicePyramid::volume() const -> Volume::Pointer { return volume_; }
+
+auto SlicePyramid::numLevels() const -> int
+{
+    return static_cast<int>(sizes_.size());
+}
+
+auto SlicePyramid::levelSize(int level) const -> cv::Size
+{
+    return sizes_.at(level);
+}
+
+auto SlicePyramid::levelForScale(double scale) const -> int
+{
+    if (scale >= 1) {
+        return 0;
+    }
+    auto level = static_cast<int>(std::floor(std::log2(1 / scale)));
+    return std::clamp(level, 0, numLevels() - 1);
+}
+
+auto SlicePyramid::isPrecomputed(int level) const -> bool
+{
+    return precomputed_.at(level);
+}
+
+auto SlicePyramid::getSliceData(int index, int level) const -> cv::Mat
+{
+    if (level < 0 or level >= numLevels()) {
+        throw std::out_of_range("pyramid level out of range");
+    }
+    if (level == 0) {
+        return volume_->getSliceData(index);
+    }
+
+    auto key = key_(index, level);
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (cache_.contains(key)) {
+            return cache_.get(key);
+        }
+    }
+
+    // Built outside of the lock so that other slices and levels can be
+    // served in the meantime
+    auto slice = load_level_(index, level);
+    if (not slice.empty()) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cache_.put(key, slice);
+    }
+    return slice;
+}
+
+auto SlicePyramid::getTile(int index, int level, cv::Rect rect) const
+    -> cv::Mat
+{
+    auto slice = getSliceData(index, level);
+    if (slice.empty()) {
+        return slice;
+    }
+    rect &= cv::Rect{0, 0, slice.cols, slice.rows};
+    if (rect.empty()) {
+        return {};
+    }
+    return slice(rect);
+}
+
+void SlicePyramid::setCacheCapacity(std::size_t capacity)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    cache_.setCapacity(capacity);
+}
+
+void SlicePyramid::cachePurge() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    cache_.purge();
+}
+
+auto SlicePyramid::LevelPath(const fs::path& volumePath, int level)
+    -> fs::path
+{
+    return volumePath / DEFAULT_DIRNAME / std::to_string(level);
+}
+
+auto SlicePyramid::LevelSizes(cv::Size sliceSize) -> std::vector<cv::Size>
+{
+    std::vector<cv::Size> sizes{sliceSize};
+    while (std::max(sliceSize.width, sliceSize.height) > MIN_LEVEL_SIZE) {
+        sliceSize = {(sliceSize.width + 1) / 2, (sliceSize.height + 1) / 2};
+        sizes.push_back(sliceSize);
+    }
+    return sizes;
+}
+
+auto SlicePyramid::Downsample(const cv::Mat& slice, cv::Size size) -> cv::Mat
+{
+    cv::Mat dst;
+    cv::resize(slice, dst, size, 0, 0, cv::INTER_AREA);
+    return dst;
+}
+
+auto SlicePyramid::load_level_(int index, int level) const -> cv::Mat
+{
+    // Precomputed level, falling back to building it if the slice is missing
+    if (precomputed_[level]) {
+        auto name = volume_->getSlicePath(index).filename();
+        auto path = LevelPath(volume_->path(), level) / name;
+        if (fs::exists(path)) {
+            try {
+                return tio::ReadTIFF(path);
+            } catch (const std::exception&) {
+            }
+        }
+    }
+
+    auto src = getSliceData(index, level - 1);
+    if (src.empty()) {
+        return src;
+    }
+    return Downsample(src, sizes_[level]);
+}
+
+auto SlicePyramid::key_(int index, int level) const -> std::int64_t
+{
+    return static_cast<std::int64_t>(index) * numLevels() + level;
+}
@@ -1,11 +1,15 @@
 #include "vc/core/types/Transforms.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <fstream>
 #include <iomanip>
 
 #include "vc/core/util/Iteration.hpp"
 #include "vc/core/util/Json.hpp"
 #include "vc/core/util/Logging.hpp"
+#include "vc/core/util/Parallel.hpp"
 
 using namespace volcart;
 namespace vc = volcart;
@@ -26,6 +30,70 @@ auto LoadMetadata(const fs::path& path) -> nlohmann::ordered_json
     i >> m;
     return m;
 }
+
+// Number of values transformed at a time by ApplyAffine
+constexpr std::size_t AFFINE_BLOCK_SIZE{256};
+
+// Minimum number of values given to a worker thread by applyBatch
+constexpr std::size_t BATCH_GRAIN_SIZE{16384};
+
+// Apply an affine matrix to count strided 3D values in place. w is the
+// homogeneous coordinate of the values: 1 for points, 0 for vectors. Values
+// are copied into structure-of-arrays blocks so that the arithmetic loops
+// have no strided accesses or dependencies and can be vectorized.
+void ApplyAffine(
+    const cv::Matx44d& m,
+    double* values,
+    std::size_t count,
+    std::size_t stride,
+    double w,
+    bool normalize)
+{
+    const double tx = m(0, 3) * w;
+    const double ty = m(1, 3) * w;
+    const double tz = m(2, 3) * w;
+
+    std::array<double, AFFINE_BLOCK_SIZE> xs{};
+    std::array<double, AFFINE_BLOCK_SIZE> ys{};
+    std::array<double, AFFINE_BLOCK_SIZE> zs{};
+    for (std::size_t b = 0; b < count; b += AFFINE_BLOCK_SIZE) {
+        auto n = std::min(AFFINE_BLOCK_SIZE, count - b);
+        auto* v = values + b * stride;
+
+        for (std::size_t i = 0; i < n; i++) {
+            xs[i] = v[i * stride];
+            ys[i] = v[i * stride + 1];
+            zs[i] = v[i * stride + 2];
+        }
+
+        for (std::size_t i = 0; i < n; i++) {
+            auto x = xs[i];
+            auto y = ys[i];
+            auto z = zs[i];
+            xs[i] = m(0, 0) * x + m(0, 1) * y + m(0, 2) * z + tx;
+            ys[i] = m(1, 0) * x + m(1, 1) * y + m(1, 2) * z + ty;
+            zs[i] = m(2, 0) * x + m(2, 1) * y + m(2, 2) * z + tz;
+        }
+
+        // Zero-length vectors stay zero, like cv::normalize()
+        if (normalize) {
+            for (std::size_t i = 0; i < n; i++) {
+                auto len =
+                    std::sqrt(xs[i] * xs[i] + ys[i] * ys[i] + zs[i] * zs[i]);
+                auto scale = (len > 0) ? 1. / len : 0.;
+                xs[i] *= scale;
+                ys[i] *= scale;
+                zs[i] *= scale;
+            }
+        }
+
+        for (std::size_t i = 0; i < n; i++) {
+            v[i * stride] = xs[i];
+            v[i * stride + 1] = ys[i];
+            v[i * stride + 2] = zs[i];
+        }
+    }
+}
 }  // namespace
 
 ///////////////////////////////////////
@@ -54,6 +122,62 @@ auto Transform3D::applyPointAndNormal(
     return {p[0], p[1], p[2], n[0], n[1], n[2]};
 }
 
+auto Transform3D::affineMatrix() const -> std::optional<cv::Matx44d>
+{
+    return std::nullopt;
+}
+
+void Transform3D::applyBatch(
+    double* points,
+    double* normals,
+    std::size_t count,
+    std::size_t stride,
+    bool normalize,
+    std::size_t numThreads) const
+{
+    if (count == 0) {
+        return;
+    }
+
+    // Don't start threads which would have nothing to do
+    auto chunks = (count + BATCH_GRAIN_SIZE - 1) / BATCH_GRAIN_SIZE;
+    numThreads = std::min(NumWorkerThreads(numThreads), chunks);
+
+    auto matrix = affineMatrix();
+    auto apply = [&](std::size_t first, std::size_t last, std::size_t) {
+        auto n = last - first;
+        auto* p = (points) ? points + first * stride : nullptr;
+        auto* nml = (normals) ? normals + first * stride : nullptr;
+
+        // Fast path: A single matrix for every value
+        if (matrix) {
+            if (p) {
+                ApplyAffine(*matrix, p, n, stride, 1, false);
+            }
+            if (nml) {
+                ApplyAffine(*matrix, nml, n, stride, 0, normalize);
+            }
+            return;
+        }
+
+        // Slow path: Apply the transform to each value
+        for (std::size_t i = 0; i < n; i++) {
+            if (p) {
+                auto* v = p + i * stride;
+                auto t = applyPoint({v[0], v[1], v[2]});
+                std::copy(t.val, t.val + 3, v);
+            }
+            if (nml) {
+                auto* v = nml + i * stride;
+                auto t = (normalize) ? applyUnitVector({v[0], v[1], v[2]})
+                                     : applyVector({v[0], v[1], v[2]});
+                std::copy(t.val, t.val + 3, v);
+            }
+        }
+    };
+    ParallelForChunks(0, count, apply, numThreads, BATCH_GRAIN_SIZE);
+}
+
 void Transform3D::clear()
 {
     src_.clear();
@@ -185,6 +309,11 @@ auto AffineTransform::applyVector(const cv::Vec3d& vector) const -> cv::Vec3d
     return {p[0], p[1], p[2]};
 }
 
+auto AffineTransform::affineMatrix() const -> std::optional<cv::Matx44d>
+{
+    return params_;
+}
+
 void AffineTransform::to_meta_(Metadata& meta) { meta["params"] = params_; }
 
 void AffineTransform::from_meta_(const Metadata& meta)
@@ -362,6 +491,11 @@ auto IdentityTransform::applyVector(const cv::Vec3d& vector) const -> cv::Vec3d
     return vector;
 }
 
+auto IdentityTransform::affineMatrix() const -> std::optional<cv::Matx44d>
+{
+    return cv::Matx44d::eye();
+}
+
 void IdentityTransform::to_meta_(Metadata& meta) {}
 
 void IdentityTransform::from_meta_(const Metadata& meta) {}
@@ -401,7 +535,21 @@ auto CompositeTransform::applyVector(const cv::Vec3d& vector) const -> cv::Vec3d
     for (const auto& t : tfms_) {
         vec = t->applyVector(vec);
     }
-    return vector;
+    return vec;
+}
+
+auto CompositeTransform::affineMatrix() const -> std::optional<cv::Matx44d>
+{
+    // Each transform is applied to the result of the previous one
+    auto result = cv::Matx44d::eye();
+    for (const auto& t : tfms_) {
+        auto m = t->affineMatrix();
+        if (not m) {
+            return std::nullopt;
+        }
+        result = *m * result;
+    }
+    return result;
 }
 
 void CompositeTransform::push_back(const Transform3D::Pointer& t)
@@ -421,12 +569,12 @@ void CompositeTransform::push_back(const Transform3D::Pointer& t)
 
         // If a composite transform, push its stack to the front of the queue
         if (tfm->type() == CompositeTransform::TYPE) {
-            auto cmp = std::dynamic_pointer_cast<CompositeTransform>(t);
+            auto cmp = std::dynamic_pointer_cast<CompositeTransform>(tfm);
             queue.insert(queue.begin(), cmp->tfms_.begin(), cmp->tfms_.end());
         }
         // Otherwise, add this tfm to the queue
         else {
-            tfms_.push_back(t->clone());
+            tfms_.push_back(tfm->clone());
         }
     }
 }
@@ -489,35 +637,52 @@ void CompositeTransform::from_meta_(const Metadata& meta)
 auto vc::ApplyTransform(
     const ITKMesh::Pointer& mesh,
     const Transform3D::Pointer& transform,
-    bool normalize) -> ITKMesh::Pointer
-{
-    // Generate a new mesh
-    auto out = ITKMesh::New();
-
-    // Copy and transform the vertices/normals
+    bool normalize,
+    std::size_t numThreads) -> ITKMesh::Pointer
+{
+    // Gather the vertices and normals into contiguous arrays
+    auto numPts = mesh->GetNumberOfPoints();
+    std::vector<cv::Vec3d> pts;
+    std::vector<cv::Vec3d> nmls;
+    std::vector<bool> hasNml;
+    pts.reserve(numPts);
+    nmls.reserve(numPts);
+    hasNml.reserve(numPts);
+    ITKPixel n;
     for (auto pt = mesh->GetPoints()->Begin(); pt != mesh->GetPoints()->End();
          ++pt) {
+        const auto& p = pt->Value();
+        pts.emplace_back(p[0], p[1], p[2]);
+        if (mesh->GetPointData(pt.Index(), &n)) {
+            nmls.emplace_back(n[0], n[1], n[2]);
+            hasNml.push_back(true);
+        } else {
+            nmls.emplace_back(0, 0, 0);
+            hasNml.push_back(false);
+        }
+    }
 
-        // Transform point
-        auto p = pt->Value();
-        auto tPt = transform->applyPoint({p[0], p[1], p[2]});
-        p[0] = tPt[0];
-        p[1] = tPt[1];
-        p[2] = tPt[2];
-        out->SetPoint(pt.Index(), p);
+    // Transform
+    if (numPts > 0) {
+        transform->applyBatch(
+            pts.data()->val, nmls.data()->val, numPts, 3, normalize,
+            numThreads);
+    }
 
-        // Transform vertex normal
-        ITKPixel n;
-        if (mesh->GetPointData(pt.Index(), &n)) {
-            cv::Vec3d tNml;
-            if (normalize) {
-                tNml = transform->applyUnitVector({n[0], n[1], n[2]});
-            } else {
-                tNml = transform->applyVector({n[0], n[1], n[2]});
-            }
-            n[0] = tNml[0];
-            n[1] = tNml[1];
-            n[2] = tNml[2];
+    // Generate a new mesh with the transformed vertices/normals
+    auto out = ITKMesh::New();
+    ITKPoint p;
+    std::size_t idx{0};
+    for (auto pt = mesh->GetPoints()->Begin(); pt != mesh->GetPoints()->End();
+         ++pt, ++idx) {
+        p[0] = pts[idx][0];
+        p[1] = pts[idx][1];
+        p[2] = pts[idx][2];
+        out->SetPoint(pt.Index(), p);
+        if (hasNml[idx]) {
+            n[0] = nmls[idx][0];
+            n[1] = nmls[idx][1];
+            n[2] = nmls[idx][2];
             out->SetPointData(pt.Index(), n);
         }
     }
@@ -531,22 +696,46 @@ auto vc::ApplyTransform(
 auto vc::ApplyTransform(
     const PerPixelMap& ppm,
     const Transform3D::Pointer& transform,
-    bool normalize) -> PerPixelMap
+    bool normalize,
+    std::size_t numThreads) -> PerPixelMap
 {
     PerPixelMap output(ppm);
-
-    for (auto [y, x] : output.getMappingCoords()) {
-        const auto& m = output.getMapping(y, x);
-        output(y, x) = transform->applyPointAndNormal(m, normalize);
+    if (output.width() == 0 or output.height() == 0) {
+        return output;
     }
 
+    // Each row is transformed as runs of consecutive mapped pixels. Point
+    // and normal are interleaved in the Vec6d values, so both arrays have a
+    // stride of 6.
+    auto width = output.width();
+    ParallelFor(
+        0, output.height(),
+        [&](std::size_t y) {
+            std::size_t x{0};
+            while (x < width) {
+                if (not output.hasMapping(y, x)) {
+                    x++;
+                    continue;
+                }
+                auto first = x;
+                while (x < width and output.hasMapping(y, x)) {
+                    x++;
+                }
+                auto* v = output(y, first).val;
+                transform->applyBatch(v, v + 3, x - first, 6, normalize, 1);
+            }
+        },
+        numThreads);
+
     return output;
 }
 
 auto vc::ApplyTransform(
     const PerPixelMap::Pointer& ppm,
     const Transform3D::Pointer& transform,
-    bool normalize) -> PerPixelMap::Pointer
+    bool normalize,
+    std::size_t numThreads) -> PerPixelMap::Pointer
 {
-    return PerPixelMap::New(ApplyTransform(*ppm, transform, normalize));
-}
\ No newline at end of file
+    return PerPixelMap::New(
+        ApplyTransform(*ppm, transform, normalize, numThreads));
+}
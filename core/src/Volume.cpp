@@ -1,11 +1,16 @@
 #include "vc/core/types/Volume.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
 #include <sstream>
 
 #include <opencv2/imgcodecs.hpp>
 
 #include "vc/core/io/TIFFIO.hpp"
+#include "vc/core/types/Exceptions.hpp"
+#include "vc/core/util/Logging.hpp"
+#include "vc/core/util/Parallel.hpp"
 
 namespace fs = volcart::filesystem;
 namespace tio = volcart::tiffio;
@@ -23,6 +28,9 @@ Volume::Volume(fs::path path) : DiskBasedObjectBaseClass(std::move(path))
     height_ = metadata_.get<int>("height");
     slices_ = metadata_.get<int>("slices");
     numSliceCharacters_ = std::to_string(slices_).size();
+    voxelSize_.load(metadata_);
+    min_.load(metadata_);
+    max_.load(metadata_);
 
     std::vector<std::mutex> init_mutexes(slices_);
 
@@ -39,9 +47,9 @@ Volume::Volume(fs::path path, std::string uuid, std::string name)
     metadata_.set("width", width_);
     metadata_.set("height", height_);
     metadata_.set("slices", slices_);
-    metadata_.set("voxelsize", double{});
-    metadata_.set("min", double{});
-    metadata_.set("max", double{});
+    voxelSize_.set(metadata_, double{});
+    min_.set(metadata_, double{});
+    max_.set(metadata_, double{});
 }
 
 // Load a Volume from disk, return a pointer
@@ -60,12 +68,9 @@ auto Volume::New(fs::path path, std::string uuid, std::string name)
 auto Volume::sliceWidth() const -> int { return width_; }
 auto Volume::sliceHeight() const -> int { return height_; }
 auto Volume::numSlices() const -> int { return slices_; }
-auto Volume::voxelSize() const -> double
-{
-    return metadata_.get<double>("voxelsize");
-}
-auto Volume::min() const -> double { return metadata_.get<double>("min"); }
-auto Volume::max() const -> double { return metadata_.get<double>("max"); }
+auto Volume::voxelSize() const -> double { return voxelSize_.get(); }
+auto Volume::min() const -> double { return min_.get(); }
+auto Volume::max() const -> double { return max_.get(); }
 
 void Volume::setSliceWidth(int w)
 {
@@ -86,9 +91,9 @@ void Volume::setNumberOfSlices(std::size_t numSlices)
     metadata_.set("slices", numSlices);
 }
 
-void Volume::setVoxelSize(double s) { metadata_.set("voxelsize", s); }
-void Volume::setMin(double m) { metadata_.set("min", m); }
-void Volume::setMax(double m) { metadata_.set("max", m); }
+void Volume::setVoxelSize(double s) { voxelSize_.set(metadata_, s); }
+void Volume::setMin(double m) { min_.set(metadata_, m); }
+void Volume::setMax(double m) { max_.set(metadata_, m); }
 
 auto Volume::bounds() const -> Volume::Bounds
 {
@@ -187,7 +192,7 @@ auto Volume::interpolateAt(double x, double y, double z) const -> std::uint16_t
     auto c00 =
         intensityAt(x0, y0, z0) * (1 - dx) + intensityAt(x1, y0, z0) * dx;
     auto c10 =
-        intensityAt(x0, y1, z0) * (1 - dx) + intensityAt(x1, y0, z0) * dx;
+        intensityAt(x0, y1, z0) * (1 - dx) + intensityAt(x1, y1, z0) * dx;
     auto c01 =
         intensityAt(x0, y0, z1) * (1 - dx) + intensityAt(x1, y0, z1) * dx;
     auto c11 =
@@ -222,6 +227,157 @@ auto Volume::reslice(
     return Reslice(m, origin, xnorm, ynorm);
 }
 
+namespace
+{
+// Trilinear interpolation from a table of fetched slices. Matches
+// Volume::interpolateAt().
+auto InterpolateFromSlices(
+    const std::vector<cv::Mat>& slices, const cv::Vec3d& v) -> std::uint16_t
+{
+    auto at = [&slices](int x, int y, int z) -> double {
+        if (z < 0 or z >= static_cast<int>(slices.size()) or
+            slices[z].empty() or x < 0 or x >= slices[z].cols or y < 0 or
+            y >= slices[z].rows) {
+            return 0;
+        }
+        return slices[z].at<std::uint16_t>(y, x);
+    };
+
+    double intPart;
+    double dx = std::modf(v[0], &intPart);
+    auto x0 = static_cast<int>(intPart);
+    int x1 = x0 + 1;
+    double dy = std::modf(v[1], &intPart);
+    auto y0 = static_cast<int>(intPart);
+    int y1 = y0 + 1;
+    double dz = std::modf(v[2], &intPart);
+    auto z0 = static_cast<int>(intPart);
+    int z1 = z0 + 1;
+
+    auto c00 = at(x0, y0, z0) * (1 - dx) + at(x1, y0, z0) * dx;
+    auto c10 = at(x0, y1, z0) * (1 - dx) + at(x1, y1, z0) * dx;
+    auto c01 = at(x0, y0, z1) * (1 - dx) + at(x1, y0, z1) * dx;
+    auto c11 = at(x0, y1, z1) * (1 - dx) + at(x1, y1, z1) * dx;
+
+    auto c0 = c00 * (1 - dy) + c10 * dy;
+    auto c1 = c01 * (1 - dy) + c11 * dy;
+
+    auto c = c0 * (1 - dz) + c1 * dz;
+    return static_cast<std::uint16_t>(cvRound(c));
+}
+
+// Render a Reslice plane into m from a table of fetched slices
+auto ResliceFromSlices(
+    const std::vector<cv::Mat>& slices,
+    const Volume& volume,
+    const Volume::ReslicePlane& plane,
+    cv::Mat& m) -> Reslice
+{
+    auto xnorm = cv::normalize(plane.xvec);
+    auto ynorm = cv::normalize(plane.yvec);
+    auto origin = plane.center - ((m.cols / 2) * xnorm + (m.rows / 2) * ynorm);
+
+    for (int h = 0; h < m.rows; ++h) {
+        auto* row = m.ptr<std::uint16_t>(h);
+        for (int w = 0; w < m.cols; ++w) {
+            cv::Vec3d v = origin + (h * ynorm) + (w * xnorm);
+            row[w] = volume.isInBounds(v) ? InterpolateFromSlices(slices, v)
+                                          : std::uint16_t{0};
+        }
+    }
+
+    return Reslice(m, origin, xnorm, ynorm);
+}
+}  // namespace
+
+auto Volume::reslice(
+    const std::vector<ReslicePlane>& planes,
+    int width,
+    int height,
+    std::size_t numThreads) const -> std::vector<Reslice>
+{
+    auto slices = fetch_reslice_slices_(planes, width, height, numThreads);
+
+    std::vector<Reslice> result(planes.size(), Reslice(cv::Mat(), {}, {}, {}));
+    ParallelFor(
+        0, planes.size(),
+        [&](std::size_t i) {
+            cv::Mat m(height, width, CV_16UC1);
+            result[i] = ResliceFromSlices(slices, *this, planes[i], m);
+        },
+        numThreads, 1);
+    return result;
+}
+
+void Volume::resliceEach(
+    const std::vector<ReslicePlane>& planes,
+    const ResliceFn& fn,
+    int width,
+    int height,
+    std::size_t numThreads) const
+{
+    auto slices = fetch_reslice_slices_(planes, width, height, numThreads);
+
+    // One scratch image per worker thread
+    std::vector<cv::Mat> scratch(NumWorkerThreads(numThreads));
+    ParallelForChunks(
+        0, planes.size(),
+        [&](std::size_t b, std::size_t e, std::size_t threadIdx) {
+            auto& m = scratch[threadIdx];
+            m.create(height, width, CV_16UC1);
+            for (auto i = b; i < e; i++) {
+                fn(i, ResliceFromSlices(slices, *this, planes[i], m));
+            }
+        },
+        numThreads);
+}
+
+auto Volume::fetch_reslice_slices_(
+    const std::vector<ReslicePlane>& planes,
+    int width,
+    int height,
+    std::size_t numThreads) const -> std::vector<cv::Mat>
+{
+    // Mark the slices spanned by the corners of each plane. Interpolation
+    // also reads the slice above each sample.
+    std::vector<bool> needed(slices_, false);
+    for (const auto& plane : planes) {
+        auto xnorm = cv::normalize(plane.xvec);
+        auto ynorm = cv::normalize(plane.yvec);
+        auto origin =
+            plane.center - ((width / 2) * xnorm + (height / 2) * ynorm);
+        auto zMin = origin[2];
+        auto zMax = origin[2];
+        for (const auto& corner :
+             {origin + (width - 1) * xnorm, origin + (height - 1) * ynorm,
+              origin + (width - 1) * xnorm + (height - 1) * ynorm}) {
+            zMin = std::min(zMin, corner[2]);
+            zMax = std::max(zMax, corner[2]);
+        }
+        auto first = std::max(static_cast<int>(std::floor(zMin)), 0);
+        auto last =
+            std::min(static_cast<int>(std::floor(zMax)) + 1, slices_ - 1);
+        for (auto z = first; z <= last; z++) {
+            needed[z] = true;
+        }
+    }
+
+    std::vector<int> indices;
+    for (int z = 0; z < slices_; z++) {
+        if (needed[z]) {
+            indices.push_back(z);
+        }
+    }
+
+    // Fetch each slice once
+    std::vector<cv::Mat> slices(slices_);
+    ParallelFor(
+        0, indices.size(),
+        [&](std::size_t i) { slices[indices[i]] = getSliceData(indices[i]); },
+        numThreads, 1);
+    return slices;
+}
+
 auto Volume::load_slice_(int index) const -> cv::Mat
 {
     {
@@ -272,6 +428,108 @@ auto Volume::cache_slice_(int index) const -> cv::Mat
 }
 
 
+auto Volume::isCached(int index) const -> bool
+{
+    std::shared_lock<std::shared_mutex> lock(cache_mutex_);
+    return cacheSlices_ and cache_->contains(index);
+}
+
+auto Volume::blockStats() const -> VolumeBlockStats::Pointer
+{
+    // Called per sample by neighborhood generators, so avoid the lock once
+    // the stored summary has been loaded
+    if (blockStatsLoaded_.load(std::memory_order_acquire)) {
+        return std::atomic_load(&blockStats_);
+    }
+
+    std::unique_lock<std::mutex> lock(blockStatsMutex_);
+    if (not blockStatsLoaded_.load()) {
+        auto path = blockStatsPath();
+        if (fs::exists(path)) {
+            auto stats = VolumeBlockStats::Read(path);
+            if (stats->volumeSize() == cv::Vec3i{width_, height_, slices_}) {
+                std::atomic_store(&blockStats_, stats);
+            }
+        }
+        blockStatsLoaded_.store(true, std::memory_order_release);
+    }
+    return std::atomic_load(&blockStats_);
+}
+
+void Volume::setBlockStats(VolumeBlockStats::Pointer stats)
+{
+    std::unique_lock<std::mutex> lock(blockStatsMutex_);
+    std::atomic_store(&blockStats_, std::move(stats));
+    blockStatsLoaded_.store(true, std::memory_order_release);
+}
+
+auto Volume::blockStatsPath() const -> fs::path
+{
+    return path_ / VolumeBlockStats::DEFAULT_FILENAME;
+}
+
+auto Volume::histogram() const -> VolumeHistogram::Pointer
+{
+    if (histogramLoaded_.load(std::memory_order_acquire)) {
+        return std::atomic_load(&histogram_);
+    }
+
+    std::unique_lock<std::mutex> lock(histogramMutex_);
+    if (not histogramLoaded_.load()) {
+        auto path = histogramPath();
+        if (fs::exists(path)) {
+            // A bad file is treated as missing, so callers fall back to
+            // computing intensities on the fly
+            try {
+                auto hist = VolumeHistogram::Read(path);
+                if (hist->volumeSize() ==
+                    cv::Vec3i{width_, height_, slices_}) {
+                    std::atomic_store(&histogram_, hist);
+                }
+            } catch (const IOException& e) {
+                Logger()->warn(
+                    "Ignoring volume histograms {}: {}", path.string(),
+                    e.what());
+            }
+        }
+        histogramLoaded_.store(true, std::memory_order_release);
+    }
+    return std::atomic_load(&histogram_);
+}
+
+void Volume::setHistogram(VolumeHistogram::Pointer histogram)
+{
+    std::unique_lock<std::mutex> lock(histogramMutex_);
+    std::atomic_store(&histogram_, std::move(histogram));
+    histogramLoaded_.store(true, std::memory_order_release);
+}
+
+auto Volume::histogramPath() const -> fs::path
+{
+    return path_ / VolumeHistogram::DEFAULT_FILENAME;
+}
+
+void Volume::setDerivedData(
+    const std::string& name, const nlohmann::json& info)
+{
+    auto derived = nlohmann::json::object();
+    if (metadata_.hasKey("derived")) {
+        derived = metadata_.get<nlohmann::json>("derived");
+    }
+    derived[name] = info;
+    metadata_.set("derived", derived);
+}
+
+auto Volume::derivedData(const std::string& name) const -> nlohmann::json
+{
+    if (not metadata_.hasKey("derived")) {
+        return nullptr;
+    }
+    auto derived = metadata_.get<nlohmann::json>("derived");
+    auto it = derived.find(name);
+    return it == derived.end() ? nlohmann::json() : *it;
+}
+
 void Volume::cachePurge() const 
 {
     std::unique_lock<std::shared_mutex> lock(cache_mutex_);
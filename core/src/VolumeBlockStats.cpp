@@ -0,0 +1,244 @@
+#include "vc/core/types/VolumeBlockStats.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "vc/core/types/Exceptions.hpp"
+#include "vc/core/types/Volume.hpp"
+#include "vc/core/util/Parallel.hpp"
+
+namespace fs = volcart::filesystem;
+
+using namespace volcart;
+
+namespace
+{
+constexpr std::array<char, 8> MAGIC{'V', 'C', 'B', 'L', 'O', 'C', 'K', 'S'};
+constexpr std::uint32_t VERSION{1};
+
+// Number of blocks needed to cover a dimension
+auto NumBlocks(int dim, int blockSize) -> int
+{
+    return std::max((dim + blockSize - 1) / blockSize, 1);
+}
+
+// Block containing a voxel coordinate, clamped to the valid blocks
+auto BlockOf(double v, int dim, int blockSize) -> int
+{
+    auto i = std::clamp(static_cast<int>(std::floor(v)), 0, dim - 1);
+    return i / blockSize;
+}
+}  // namespace
+
+VolumeBlockStats::VolumeBlockStats(const cv::Vec3i& volumeSize, int blockSize)
+    : size_{volumeSize}, blockSize_{blockSize}
+{
+    if (blockSize_ < 1) {
+        throw std::invalid_argument("block size must be positive");
+    }
+    for (int i = 0; i < 3; i++) {
+        if (size_[i] < 1) {
+            throw std::invalid_argument("volume size must be positive");
+        }
+        blocks_[i] = NumBlocks(size_[i], blockSize_);
+    }
+    auto count = static_cast<std::size_t>(blocks_[0]) * blocks_[1] * blocks_[2];
+    min_.assign(count, std::numeric_limits<std::uint16_t>::max());
+    max_.assign(count, 0);
+}
+
+auto VolumeBlockStats::New(const cv::Vec3i& volumeSize, int blockSize)
+    -> Pointer
+{
+    return std::make_shared<VolumeBlockStats>(volumeSize, blockSize);
+}
+
+auto VolumeBlockStats::Compute(
+    const Volume& volume, int blockSize, std::size_t numThreads) -> Pointer
+{
+    auto stats = New(
+        {volume.sliceWidth(), volume.sliceHeight(), volume.numSlices()},
+        blockSize);
+    ParallelFor(
+        0, volume.numSlices(),
+        [&](std::size_t z) {
+            auto slice = volume.getSliceData(static_cast<int>(z));
+            if (not slice.empty()) {
+                stats->addSlice(static_cast<int>(z), slice);
+            }
+        },
+        numThreads);
+    return stats;
+}
+
+void VolumeBlockStats::addSlice(int z, const cv::Mat& slice)
+{
+    if (z < 0 or z >= size_[2]) {
+        throw std::invalid_argument("slice index out of range");
+    }
+    if (slice.type() != CV_16UC1 or slice.cols != size_[0] or
+        slice.rows != size_[1]) {
+        throw std::invalid_argument("slice does not match volume");
+    }
+
+    // Summarize the slice without holding the lock
+    auto count = static_cast<std::size_t>(blocks_[0]) * blocks_[1];
+    std::vector<std::uint16_t> lo(count);
+    std::vector<std::uint16_t> hi(count);
+    for (int by = 0; by < blocks_[1]; by++) {
+        auto y0 = by * blockSize_;
+        auto y1 = std::min(y0 + blockSize_, size_[1] - 1);
+        for (int bx = 0; bx < blocks_[0]; bx++) {
+            auto x0 = bx * blockSize_;
+            auto x1 = std::min(x0 + blockSize_, size_[0] - 1);
+            double l{0};
+            double h{0};
+            cv::minMaxLoc(
+                slice(cv::Range(y0, y1 + 1), cv::Range(x0, x1 + 1)), &l, &h);
+            lo[by * blocks_[0] + bx] = static_cast<std::uint16_t>(l);
+            hi[by * blocks_[0] + bx] = static_cast<std::uint16_t>(h);
+        }
+    }
+
+    // Slices on the boundary between two slabs belong to both
+    std::unique_lock<std::mutex> lock(mutex_);
+    merge_slab_(z / blockSize_, lo, hi);
+    if (z % blockSize_ == 0 and z > 0) {
+        merge_slab_(z / blockSize_ - 1, lo, hi);
+    }
+}
+
+void VolumeBlockStats::merge_slab_(
+    int bz,
+    const std::vector<std::uint16_t>& lo,
+    const std::vector<std::uint16_t>& hi)
+{
+    auto offset = index_(0, 0, bz);
+    for (std::size_t i = 0; i < lo.size(); i++) {
+        min_[offset + i] = std::min(min_[offset + i], lo[i]);
+        max_[offset + i] = std::max(max_[offset + i], hi[i]);
+    }
+}
+
+auto VolumeBlockStats::volumeSize() const -> cv::Vec3i { return size_; }
+
+auto VolumeBlockStats::blockSize() const -> int { return blockSize_; }
+
+auto VolumeBlockStats::numBlocks() const -> cv::Vec3i { return blocks_; }
+
+auto VolumeBlockStats::min(int bx, int by, int bz) const -> std::uint16_t
+{
+    return min_.at(index_(bx, by, bz));
+}
+
+auto VolumeBlockStats::max(int bx, int by, int bz) const -> std::uint16_t
+{
+    return max_.at(index_(bx, by, bz));
+}
+
+auto VolumeBlockStats::maxAt(const cv::Vec3d& p) const -> std::uint16_t
+{
+    // Same bounds test as Volume::interpolateAt()
+    for (int i = 0; i < 3; i++) {
+        if (not(p[i] >= 0 and p[i] < size_[i])) {
+            return 0;
+        }
+    }
+    return max_[index_(
+        static_cast<int>(p[0]) / blockSize_,
+        static_cast<int>(p[1]) / blockSize_,
+        static_cast<int>(p[2]) / blockSize_)];
+}
+
+auto VolumeBlockStats::maxAlong(const cv::Vec3d& a, const cv::Vec3d& b) const
+    -> std::uint16_t
+{
+    std::array<int, 3> lo{};
+    std::array<int, 3> hi{};
+    for (int i = 0; i < 3; i++) {
+        auto l = std::min(a[i], b[i]);
+        auto h = std::max(a[i], b[i]);
+        if (not(h >= 0 and l < size_[i])) {
+            return 0;
+        }
+        lo[i] = BlockOf(l, size_[i], blockSize_);
+        hi[i] = BlockOf(h, size_[i], blockSize_);
+    }
+
+    std::uint16_t result{0};
+    for (auto bz = lo[2]; bz <= hi[2]; bz++) {
+        for (auto by = lo[1]; by <= hi[1]; by++) {
+            for (auto bx = lo[0]; bx <= hi[0]; bx++) {
+                result = std::max(result, max_[index_(bx, by, bz)]);
+            }
+        }
+    }
+    return result;
+}
+
+void VolumeBlockStats::write(const fs::path& path) const
+{
+    std::ofstream file(path.string(), std::ios::binary);
+    if (not file.is_open()) {
+        throw IOException("Could not open file for writing: " + path.string());
+    }
+
+    std::array<std::int32_t, 4> header{
+        size_[0], size_[1], size_[2], blockSize_};
+    file.write(MAGIC.data(), MAGIC.size());
+    file.write(reinterpret_cast<const char*>(&VERSION), sizeof(VERSION));
+    file.write(reinterpret_cast<const char*>(header.data()), sizeof(header));
+    auto bytes = min_.size() * sizeof(std::uint16_t);
+    file.write(reinterpret_cast<const char*>(min_.data()), bytes);
+    file.write(reinterpret_cast<const char*>(max_.data()), bytes);
+    if (file.fail()) {
+        throw IOException("Failed to write file: " + path.string());
+    }
+}
+
+auto VolumeBlockStats::Read(const fs::path& path) -> Pointer
+{
+    std::ifstream file(path.string(), std::ios::binary);
+    if (not file.is_open()) {
+        throw IOException("Could not open file for reading: " + path.string());
+    }
+
+    std::array<char, 8> magic{};
+    std::uint32_t version{0};
+    std::array<std::int32_t, 4> header{};
+    file.read(magic.data(), magic.size());
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(header.data()), sizeof(header));
+    if (file.fail() or magic != MAGIC) {
+        throw IOException("Not a block statistics file: " + path.string());
+    }
+    if (version != VERSION) {
+        throw IOException(
+            "Unsupported block statistics version: " +
+            std::to_string(version));
+    }
+
+    Pointer stats;
+    try {
+        stats = New({header[0], header[1], header[2]}, header[3]);
+    } catch (const std::invalid_argument&) {
+        throw IOException("Invalid block statistics header: " + path.string());
+    }
+    auto bytes = stats->min_.size() * sizeof(std::uint16_t);
+    file.read(reinterpret_cast<char*>(stats->min_.data()), bytes);
+    file.read(reinterpret_cast<char*>(stats->max_.data()), bytes);
+    if (file.fail()) {
+        throw IOException("Truncated block statistics file: " + path.string());
+    }
+    return stats;
+}
+
+auto VolumeBlockStats::index_(int bx, int by, int bz) const -> std::size_t
+{
+    return (static_cast<std::size_t>(bz) * blocks_[1] + by) * blocks_[0] + bx;
+}
@@ -0,0 +1,143 @@
+#include "vc/core/types/VolumeChunks.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "vc/core/types/Exceptions.hpp"
+
+namespace fs = volcart::filesystem;
+
+using namespace volcart;
+
+VolumeChunks::VolumeChunks(
+    fs::path dir, const cv::Vec3i& volumeSize, int chunkSize)
+    : dir_{std::move(dir)}, size_{volumeSize}, chunkSize_{chunkSize}
+{
+    if (chunkSize_ < 1) {
+        throw std::invalid_argument("chunk size must be positive");
+    }
+    for (int i = 0; i < 3; i++) {
+        if (size_[i] < 1) {
+            throw std::invalid_argument("volume size must be positive");
+        }
+        chunks_[i] = (size_[i] + chunkSize_ - 1) / chunkSize_;
+    }
+    slabCreated_ = std::vector<std::once_flag>(chunks_[2]);
+}
+
+auto VolumeChunks::New(fs::path dir, const cv::Vec3i& volumeSize, int chunkSize)
+    -> Pointer
+{
+    return std::make_shared<VolumeChunks>(
+        std::move(dir), volumeSize, chunkSize);
+}
+
+void VolumeChunks::addSlice(int z, const cv::Mat& slice)
+{
+    if (z < 0 or z >= size_[2]) {
+        throw std::invalid_argument("slice index out of range");
+    }
+    if (slice.type() != CV_16UC1 or slice.cols != size_[0] or
+        slice.rows != size_[1]) {
+        throw std::invalid_argument("slice does not match volume");
+    }
+
+    auto cz = z / chunkSize_;
+    std::call_once(slabCreated_[cz], [this, cz]() { create_slab_(cz); });
+
+    // Every slice fills one plane of each chunk in its slab. Planes of
+    // different slices do not overlap, so concurrent writers need no lock.
+    for (int cy = 0; cy < chunks_[1]; cy++) {
+        for (int cx = 0; cx < chunks_[0]; cx++) {
+            auto extent = chunkExtent(cx, cy, cz);
+            cv::Mat plane = slice(
+                cv::Rect(
+                    cx * chunkSize_, cy * chunkSize_, extent[0], extent[1]));
+            if (not plane.isContinuous()) {
+                plane = plane.clone();
+            }
+
+            auto path = chunkPath(cx, cy, cz);
+            std::fstream file(
+                path.string(), std::ios::in | std::ios::out | std::ios::binary);
+            auto planeBytes = plane.total() * plane.elemSize();
+            file.seekp(static_cast<std::streamoff>(
+                (z - cz * chunkSize_) * planeBytes));
+            file.write(
+                reinterpret_cast<const char*>(plane.data),
+                static_cast<std::streamsize>(planeBytes));
+            if (file.fail()) {
+                throw IOException("Failed to write chunk: " + path.string());
+            }
+        }
+    }
+}
+
+void VolumeChunks::create_slab_(int cz)
+{
+    fs::create_directories(dir_ / std::to_string(cz));
+    for (int cy = 0; cy < chunks_[1]; cy++) {
+        for (int cx = 0; cx < chunks_[0]; cx++) {
+            auto extent = chunkExtent(cx, cy, cz);
+            auto path = chunkPath(cx, cy, cz);
+            std::ofstream file(path.string(), std::ios::binary);
+            if (not file.is_open()) {
+                throw IOException("Could not create chunk: " + path.string());
+            }
+            file.close();
+            fs::resize_file(
+                path, static_cast<std::uintmax_t>(extent[0]) * extent[1] *
+                          extent[2] * sizeof(std::uint16_t));
+        }
+    }
+}
+
+auto VolumeChunks::path() const -> fs::path { return dir_; }
+
+auto VolumeChunks::volumeSize() const -> cv::Vec3i { return size_; }
+
+auto VolumeChunks::chunkSize() const -> int { return chunkSize_; }
+
+auto VolumeChunks::numChunks() const -> cv::Vec3i { return chunks_; }
+
+auto VolumeChunks::chunkExtent(int cx, int cy, int cz) const -> cv::Vec3i
+{
+    cv::Vec3i c{cx, cy, cz};
+    cv::Vec3i extent;
+    for (int i = 0; i < 3; i++) {
+        if (c[i] < 0 or c[i] >= chunks_[i]) {
+            throw std::out_of_range("chunk index out of range");
+        }
+        extent[i] = std::min(chunkSize_, size_[i] - c[i] * chunkSize_);
+    }
+    return extent;
+}
+
+auto VolumeChunks::chunkPath(int cx, int cy, int cz) const -> fs::path
+{
+    return dir_ / std::to_string(cz) /
+           (std::to_string(cy) + "_" + std::to_string(cx) + ".raw");
+}
+
+auto VolumeChunks::readChunk(int cx, int cy, int cz) const -> Chunk
+{
+    auto extent = chunkExtent(cx, cy, cz);
+    Chunk chunk(3, extent[2], extent[1], extent[0]);
+
+    auto path = chunkPath(cx, cy, cz);
+    std::ifstream file(path.string(), std::ios::binary);
+    if (not file.is_open()) {
+        throw IOException("Could not open chunk: " + path.string());
+    }
+    file.read(
+        reinterpret_cast<char*>(chunk.data()),
+        static_cast<std::streamsize>(chunk.size() * sizeof(std::uint16_t)));
+    if (file.fail()) {
+        throw IOException("Truncated chunk: " + path.string());
+    }
+    return chunk;
+}
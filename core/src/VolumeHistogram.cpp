@@ -0,0 +1,299 @@
+#include "vc/core/types/VolumeHistogram.hpp"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+#include "vc/core/types/Exceptions.hpp"
+#include "vc/core/types/Volume.hpp"
+#include "vc/core/util/Parallel.hpp"
+
+namespace fs = volcart::filesystem;
+
+using namespace volcart;
+
+namespace
+{
+constexpr std::array<char, 8> MAGIC{'V', 'C', 'H', 'I', 'S', 'T', 'O', 'G'};
+constexpr std::uint32_t VERSION{1};
+
+// Intensity to bin index shift
+constexpr int BIN_SHIFT{8};
+static_assert(
+    (1 << BIN_SHIFT) == VolumeHistogram::BIN_WIDTH,
+    "bin shift does not match bin width");
+
+constexpr auto NUM_BINS = static_cast<std::size_t>(VolumeHistogram::NUM_BINS);
+
+// Number of blocks needed to cover a dimension
+auto NumBlocks(int dim, int blockSize) -> int
+{
+    return (dim + blockSize - 1) / blockSize;
+}
+}  // namespace
+
+VolumeHistogram::VolumeHistogram(const cv::Vec3i& volumeSize, int blockSize)
+    : size_{volumeSize}, blockSize_{blockSize}
+{
+    if (blockSize_ < 1 or blockSize_ > MAX_BLOCK_SIZE) {
+        throw std::invalid_argument("block size out of range");
+    }
+    for (int i = 0; i < 3; i++) {
+        if (size_[i] < 1) {
+            throw std::invalid_argument("volume size must be positive");
+        }
+        blocks_[i] = NumBlocks(size_[i], blockSize_);
+    }
+    auto count = static_cast<std::size_t>(blocks_[0]) * blocks_[1] * blocks_[2];
+    slices_.assign(size_[2] * NUM_BINS, 0);
+    blockBins_.assign(count * NUM_BINS, 0);
+}
+
+auto VolumeHistogram::New(const cv::Vec3i& volumeSize, int blockSize)
+    -> Pointer
+{
+    return std::make_shared<VolumeHistogram>(volumeSize, blockSize);
+}
+
+auto VolumeHistogram::Compute(
+    const Volume& volume, int blockSize, std::size_t numThreads) -> Pointer
+{
+    auto hist = New(
+        {volume.sliceWidth(), volume.sliceHeight(), volume.numSlices()},
+        blockSize);
+    ParallelFor(
+        0, volume.numSlices(),
+        [&](std::size_t z) {
+            auto slice = volume.getSliceData(static_cast<int>(z));
+            if (not slice.empty()) {
+                hist->addSlice(static_cast<int>(z), slice);
+            }
+        },
+        numThreads);
+    return hist;
+}
+
+void VolumeHistogram::addSlice(int z, const cv::Mat& slice)
+{
+    if (z < 0 or z >= size_[2]) {
+        throw std::invalid_argument("slice index out of range");
+    }
+    if (slice.type() != CV_16UC1 or slice.cols != size_[0] or
+        slice.rows != size_[1]) {
+        throw std::invalid_argument("slice does not match volume");
+    }
+
+    // Count the slice without holding the lock
+    auto rowBlocks = static_cast<std::size_t>(blocks_[0]) * blocks_[1];
+    std::vector<std::uint32_t> bins(rowBlocks * NUM_BINS, 0);
+    for (int y = 0; y < size_[1]; y++) {
+        const auto* row = slice.ptr<std::uint16_t>(y);
+        auto by = y / blockSize_;
+        for (int bx = 0; bx < blocks_[0]; bx++) {
+            auto* b = &bins[(by * blocks_[0] + bx) * NUM_BINS];
+            auto x1 = std::min((bx + 1) * blockSize_, size_[0]);
+            for (auto x = bx * blockSize_; x < x1; x++) {
+                b[row[x] >> BIN_SHIFT]++;
+            }
+        }
+    }
+
+    // The slice histogram is the sum of its blocks
+    std::array<std::uint64_t, NUM_BINS> sliceBins{};
+    for (std::size_t i = 0; i < bins.size(); i++) {
+        sliceBins[i % NUM_BINS] += bins[i];
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    std::copy(
+        sliceBins.begin(), sliceBins.end(), slices_.begin() + z * NUM_BINS);
+    auto offset = block_offset_(0, 0, z / blockSize_);
+    for (std::size_t i = 0; i < bins.size(); i++) {
+        blockBins_[offset + i] += bins[i];
+    }
+    cumulativeValid_ = false;
+}
+
+auto VolumeHistogram::volumeSize() const -> cv::Vec3i { return size_; }
+
+auto VolumeHistogram::blockSize() const -> int { return blockSize_; }
+
+auto VolumeHistogram::numBlocks() const -> cv::Vec3i { return blocks_; }
+
+auto VolumeHistogram::histogram() const -> Histogram
+{
+    return histogram(0, size_[2] - 1);
+}
+
+auto VolumeHistogram::histogram(int zMin, int zMax) const -> Histogram
+{
+    Histogram h(NUM_BINS, 0);
+    zMin = std::max(zMin, 0);
+    zMax = std::min(zMax, size_[2] - 1);
+    if (zMin > zMax) {
+        return h;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    update_cumulative_();
+    const auto* lo = &cumulative_[zMin * NUM_BINS];
+    const auto* hi = &cumulative_[(zMax + 1) * NUM_BINS];
+    for (std::size_t b = 0; b < NUM_BINS; b++) {
+        h[b] = hi[b] - lo[b];
+    }
+    return h;
+}
+
+auto VolumeHistogram::histogram(const cv::Rect& roi, int zMin, int zMax) const
+    -> Histogram
+{
+    Histogram h(NUM_BINS, 0);
+    auto r = roi & cv::Rect(0, 0, size_[0], size_[1]);
+    zMin = std::max(zMin, 0);
+    zMax = std::min(zMax, size_[2] - 1);
+    if (r.empty() or zMin > zMax) {
+        return h;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (auto bz = zMin / blockSize_; bz <= zMax / blockSize_; bz++) {
+        for (auto by = r.y / blockSize_; by <= (r.br().y - 1) / blockSize_;
+             by++) {
+            for (auto bx = r.x / blockSize_;
+                 bx <= (r.br().x - 1) / blockSize_; bx++) {
+                const auto* b = &blockBins_[block_offset_(bx, by, bz)];
+                for (std::size_t i = 0; i < NUM_BINS; i++) {
+                    h[i] += b[i];
+                }
+            }
+        }
+    }
+    return h;
+}
+
+auto VolumeHistogram::percentile(double p) const -> double
+{
+    return Percentile(histogram(), p);
+}
+
+auto VolumeHistogram::percentile(double p, int zMin, int zMax) const -> double
+{
+    return Percentile(histogram(zMin, zMax), p);
+}
+
+auto VolumeHistogram::percentile(
+    double p, const cv::Rect& roi, int zMin, int zMax) const -> double
+{
+    return Percentile(histogram(roi, zMin, zMax), p);
+}
+
+auto VolumeHistogram::Percentile(const Histogram& h, double p) -> double
+{
+    auto total = std::accumulate(h.begin(), h.end(), std::uint64_t{0});
+    if (total == 0) {
+        return 0;
+    }
+
+    // Find the bin which contains the target rank and interpolate within it
+    auto target = std::clamp(p, 0., 100.) / 100. * static_cast<double>(total);
+    double before{0};
+    double value{0};
+    for (std::size_t b = 0; b < h.size(); b++) {
+        if (h[b] == 0) {
+            continue;
+        }
+        auto count = static_cast<double>(h[b]);
+        auto offset = std::clamp((target - before) / count, 0., 1.);
+        value = (static_cast<double>(b) + offset) * BIN_WIDTH;
+        if (before + count >= target) {
+            break;
+        }
+        before += count;
+    }
+    return std::min(value, 65535.);
+}
+
+void VolumeHistogram::write(const fs::path& path) const
+{
+    std::ofstream file(path.string(), std::ios::binary);
+    if (not file.is_open()) {
+        throw IOException("Could not open file for writing: " + path.string());
+    }
+
+    std::array<std::int32_t, 5> header{
+        size_[0], size_[1], size_[2], blockSize_, NUM_BINS};
+    file.write(MAGIC.data(), MAGIC.size());
+    file.write(reinterpret_cast<const char*>(&VERSION), sizeof(VERSION));
+    file.write(reinterpret_cast<const char*>(header.data()), sizeof(header));
+    file.write(
+        reinterpret_cast<const char*>(slices_.data()),
+        slices_.size() * sizeof(std::uint64_t));
+    file.write(
+        reinterpret_cast<const char*>(blockBins_.data()),
+        blockBins_.size() * sizeof(std::uint32_t));
+    if (file.fail()) {
+        throw IOException("Failed to write file: " + path.string());
+    }
+}
+
+auto VolumeHistogram::Read(const fs::path& path) -> Pointer
+{
+    std::ifstream file(path.string(), std::ios::binary);
+    if (not file.is_open()) {
+        throw IOException("Could not open file for reading: " + path.string());
+    }
+
+    std::array<char, 8> magic{};
+    std::uint32_t version{0};
+    std::array<std::int32_t, 5> header{};
+    file.read(magic.data(), magic.size());
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(header.data()), sizeof(header));
+    if (file.fail() or magic != MAGIC) {
+        throw IOException("Not a volume histogram file: " + path.string());
+    }
+    if (version != VERSION or header[4] != NUM_BINS) {
+        throw IOException(
+            "Unsupported volume histogram version: " +
+            std::to_string(version));
+    }
+
+    Pointer hist;
+    try {
+        hist = New({header[0], header[1], header[2]}, header[3]);
+    } catch (const std::invalid_argument&) {
+        throw IOException("Invalid volume histogram header: " + path.string());
+    }
+    file.read(
+        reinterpret_cast<char*>(hist->slices_.data()),
+        hist->slices_.size() * sizeof(std::uint64_t));
+    file.read(
+        reinterpret_cast<char*>(hist->blockBins_.data()),
+        hist->blockBins_.size() * sizeof(std::uint32_t));
+    if (file.fail()) {
+        throw IOException("Truncated volume histogram file: " + path.string());
+    }
+    return hist;
+}
+
+void VolumeHistogram::update_cumulative_() const
+{
+    if (cumulativeValid_) {
+        return;
+    }
+    cumulative_.assign((size_[2] + 1) * NUM_BINS, 0);
+    for (std::size_t i = 0; i < slices_.size(); i++) {
+        cumulative_[i + NUM_BINS] = cumulative_[i] + slices_[i];
+    }
+    cumulativeValid_ = true;
+}
+
+auto VolumeHistogram::block_offset_(int bx, int by, int bz) const
+    -> std::size_t
+{
+    auto idx = (static_cast<std::size_t>(bz) * blocks_[1] + by) * blocks_[0];
+    return (idx + bx) * NUM_BINS;
+}
@@ -308,7 +308,9 @@ VolumePkg::VolumePkg(const fs::path& fileLocation) : rootDir_{fileLocation}
 
     // Load Renders into the renders_
     for (const auto& entry : fs::directory_iterator(::RendDir(rootDir_))) {
-        if (fs::is_directory(entry)) {
+        // Hidden directories (e.g. the render cache) are not Renders
+        auto name = entry.path().filename().string();
+        if (fs::is_directory(entry) and name.front() != '.') {
             auto r = Render::New(entry);
             renders_.emplace(r->id(), r);
         }
@@ -500,6 +502,11 @@ auto VolumePkg::segmentationNames() const -> std::vector<std::string>
     return names;
 }
 
+auto VolumePkg::renderCacheDir() const -> fs::path
+{
+    return ::RendDir(rootDir_) / ".cache";
+}
+
 // Make a new folder inside the volume package to house everything for this
 // segmentation and push back the new segmentation into our vector of
 // segmentations_
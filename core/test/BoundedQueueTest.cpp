@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "vc/core/util/BoundedQueue.hpp"
+
+using namespace volcart;
+
+TEST(BoundedQueue, FIFOOrder)
+{
+    BoundedQueue<int> queue(3);
+    EXPECT_EQ(queue.capacity(), 3);
+    EXPECT_TRUE(queue.push(1));
+    EXPECT_TRUE(queue.push(2));
+    EXPECT_TRUE(queue.push(3));
+    EXPECT_EQ(queue.size(), 3);
+
+    EXPECT_EQ(queue.pop(), 1);
+    EXPECT_EQ(queue.pop(), 2);
+    EXPECT_EQ(queue.pop(), 3);
+    EXPECT_EQ(queue.size(), 0);
+}
+
+TEST(BoundedQueue, CloseDrainsThenStops)
+{
+    BoundedQueue<int> queue(2);
+    queue.push(1);
+    queue.close();
+    EXPECT_FALSE(queue.push(2));
+    EXPECT_EQ(queue.pop(), 1);
+    EXPECT_FALSE(queue.pop().has_value());
+}
+
+TEST(BoundedQueue, ProducersAndConsumers)
+{
+    static constexpr int NUM_ITEMS{10000};
+    static constexpr int NUM_THREADS{4};
+    BoundedQueue<int> queue(8);
+
+    // Each producer pushes a disjoint set of values
+    std::vector<std::thread> producers;
+    for (int t = 0; t < NUM_THREADS; t++) {
+        producers.emplace_back([&queue, t]() {
+            for (auto i = t; i < NUM_ITEMS; i += NUM_THREADS) {
+                queue.push(i);
+            }
+        });
+    }
+
+    std::vector<std::vector<int>> seen(NUM_THREADS);
+    std::vector<std::thread> consumers;
+    for (int t = 0; t < NUM_THREADS; t++) {
+        consumers.emplace_back([&queue, &seen, t]() {
+            while (auto i = queue.pop()) {
+                EXPECT_LE(queue.size(), queue.capacity());
+                seen[t].push_back(*i);
+            }
+        });
+    }
+
+    for (auto& p : producers) {
+        p.join();
+    }
+    queue.close();
+    for (auto& c : consumers) {
+        c.join();
+    }
+
+    std::vector<int> counts(NUM_ITEMS, 0);
+    for (const auto& s : seen) {
+        for (const auto& i : s) {
+            counts[i]++;
+        }
+    }
+    for (const auto& c : counts) {
+        EXPECT_EQ(c, 1);
+    }
+}
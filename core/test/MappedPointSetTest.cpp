@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "vc/core/filesystem.hpp"
+#include "vc/core/io/MappedPointSet.hpp"
+#include "vc/core/io/PointSetIO.hpp"
+#include "vc/core/types/Exceptions.hpp"
+#include "vc/core/types/OrderedPointSet.hpp"
+#include "vc/core/types/PointSet.hpp"
+
+using namespace volcart;
+namespace fs = volcart::filesystem;
+
+namespace
+{
+// Write an ordered point set of cv::Vec3i with a hand-written header
+void WriteLegacyFile(const fs::path& path, const std::string& header)
+{
+    std::vector<cv::Vec3i> points{{1, 2, 3}, {4, 5, 6}, {7, 8, 9}};
+    std::ofstream out{path.string(), std::ios::binary};
+    out << header;
+    out.write(
+        reinterpret_cast<const char*>(points.data()),
+        static_cast<std::streamsize>(points.size() * sizeof(cv::Vec3i)));
+}
+}  // namespace
+
+TEST(MappedPointSet, Ordered)
+{
+    OrderedPointSet<cv::Vec3d> grid{7};
+    for (int y = 0; y < 5; y++) {
+        std::vector<cv::Vec3d> row;
+        for (int x = 0; x < 7; x++) {
+            row.emplace_back(x, y, 0.5 * x * y);
+        }
+        grid.pushRow(row);
+    }
+    const fs::path path{"vc_core_MappedPointSet_Ordered.vcps"};
+    PointSetIO<cv::Vec3d>::WriteOrderedPointSet(path, grid);
+
+    // Points start at an aligned offset
+    auto dataBytes = grid.size() * sizeof(cv::Vec3d);
+    auto headerBytes = fs::file_size(path) - dataBytes;
+    EXPECT_EQ(headerBytes % PointSetIO<cv::Vec3d>::HEADER_ALIGNMENT, 0);
+
+    MappedPointSet<cv::Vec3d> mapped(path);
+    EXPECT_TRUE(mapped.isMapped());
+    EXPECT_TRUE(mapped.ordered());
+    ASSERT_EQ(mapped.width(), 7);
+    ASSERT_EQ(mapped.height(), 5);
+    ASSERT_EQ(mapped.size(), grid.size());
+    for (std::size_t y = 0; y < 5; y++) {
+        for (std::size_t x = 0; x < 7; x++) {
+            EXPECT_EQ(mapped(y, x), grid(y, x));
+        }
+    }
+
+    auto copy = mapped.toOrderedPointSet();
+    EXPECT_EQ(copy.width(), grid.width());
+    EXPECT_EQ(copy.height(), grid.height());
+    EXPECT_TRUE(std::equal(copy.begin(), copy.end(), grid.begin()));
+}
+
+TEST(MappedPointSet, Unordered)
+{
+    PointSet<cv::Vec3i> ps;
+    for (int i = 0; i < 100; i++) {
+        ps.push_back({i, 2 * i, 3 * i});
+    }
+    const fs::path path{"vc_core_MappedPointSet_Unordered.vcps"};
+    PointSetIO<cv::Vec3i>::WritePointSet(path, ps);
+
+    MappedPointSet<cv::Vec3i> mapped(path);
+    EXPECT_FALSE(mapped.ordered());
+    ASSERT_EQ(mapped.size(), ps.size());
+    EXPECT_TRUE(std::equal(mapped.begin(), mapped.end(), ps.begin()));
+    EXPECT_THROW(mapped.toOrderedPointSet(), IOException);
+
+    auto copy = mapped.toPointSet();
+    EXPECT_TRUE(std::equal(copy.begin(), copy.end(), ps.begin()));
+}
+
+TEST(MappedPointSet, UnalignedLegacyHeader)
+{
+    // The comment leaves the points at an odd offset
+    const fs::path path{"vc_core_MappedPointSet_Legacy.vcps"};
+    WriteLegacyFile(
+        path,
+        "# legacy\nwidth: 3\nheight: 1\ndim: 3\nordered: true\ntype: int\n"
+        "version: 1\n<>\n");
+
+    MappedPointSet<cv::Vec3i> mapped(path);
+    EXPECT_FALSE(mapped.isMapped());
+    EXPECT_EQ(mapped(0, 0), cv::Vec3i(1, 2, 3));
+    EXPECT_EQ(mapped(0, 2), cv::Vec3i(7, 8, 9));
+
+    // The regular reader agrees
+    auto read = PointSetIO<cv::Vec3i>::ReadOrderedPointSet(path);
+    EXPECT_EQ(read(0, 1), mapped(0, 1));
+}
+
+TEST(MappedPointSet, TruncatedFileThrows)
+{
+    const fs::path path{"vc_core_MappedPointSet_Truncated.vcps"};
+    WriteLegacyFile(
+        path,
+        "width: 3\nheight: 2\ndim: 3\nordered: true\ntype: int\n"
+        "version: 1\n<>\n");
+    EXPECT_THROW(MappedPointSet<cv::Vec3i>{path}, IOException);
+    EXPECT_THROW(PointSetIO<cv::Vec3i>::ReadOrderedPointSet(path), IOException);
+}
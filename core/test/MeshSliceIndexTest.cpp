@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "vc/core/shapes/Sphere.hpp"
+#include "vc/core/util/MeshSliceIndex.hpp"
+
+using namespace volcart;
+
+TEST(MeshSliceIndex, SingleFace)
+{
+    MeshArrays mesh;
+    mesh.vertices = {{0, 0, 0}, {2, 0, 2}, {0, 2, 2}};
+    mesh.normals = {{0, 0, 1}, {0, 0, 1}, {0, 0, 1}};
+    mesh.faces = {{0, 1, 2}};
+    MeshSliceIndex index(mesh, 0.5);
+    EXPECT_DOUBLE_EQ(index.zMin(), 0);
+    EXPECT_DOUBLE_EQ(index.zMax(), 2);
+    EXPECT_TRUE(index.hasNormals());
+
+    auto segs = index.intersect(1);
+    ASSERT_EQ(segs.size(), 1);
+    EXPECT_EQ(segs[0].face, 0);
+    EXPECT_EQ(segs[0].points[0], cv::Vec3d(1, 0, 1));
+    EXPECT_EQ(segs[0].points[1], cv::Vec3d(0, 1, 1));
+    EXPECT_EQ(segs[0].normals[0], cv::Vec3d(0, 0, 1));
+
+    // Outside of the mesh and touching a single vertex
+    EXPECT_TRUE(index.intersect(-1).empty());
+    EXPECT_TRUE(index.intersect(3).empty());
+    EXPECT_TRUE(index.intersect(0).empty());
+}
+
+TEST(MeshSliceIndex, MatchesBruteForce)
+{
+    auto mesh = ToMeshArrays(shapes::Sphere(20, 3).itkMesh());
+    MeshSliceIndex index(mesh);
+
+    for (double z = -21; z <= 21; z += 0.7) {
+        std::vector<std::size_t> expected;
+        for (std::size_t f = 0; f < mesh.faces.size(); f++) {
+            const auto& face = mesh.faces[f];
+            auto z0 = mesh.vertices[face[0]][2];
+            auto z1 = mesh.vertices[face[1]][2];
+            auto z2 = mesh.vertices[face[2]][2];
+            if (std::min({z0, z1, z2}) <= z and z <= std::max({z0, z1, z2})) {
+                expected.push_back(f);
+            }
+        }
+        auto faces = index.faces(z);
+        std::sort(faces.begin(), faces.end());
+        EXPECT_EQ(faces, expected);
+
+        // Every segment lies on the plane
+        for (const auto& seg : index.intersect(z)) {
+            EXPECT_NEAR(seg.points[0][2], z, 1e-9);
+            EXPECT_NEAR(seg.points[1][2], z, 1e-9);
+        }
+    }
+}
+
+TEST(MeshSliceIndex, ClosedPolyline)
+{
+    shapes::Sphere sphere(20, 3);
+    MeshSliceIndex index(sphere.itkMesh());
+
+    // A sphere is cut into a single closed loop
+    auto segs = index.intersect(0.5);
+    auto lines = index.polylines(0.5);
+    ASSERT_EQ(lines.size(), 1);
+    const auto& line = lines.front();
+    EXPECT_EQ(line.size(), segs.size() + 1);
+    EXPECT_EQ(line.front(), line.back());
+    for (const auto& p : line) {
+        EXPECT_NEAR(cv::norm(p), 20, 1);
+    }
+
+    // Two copies of the same mesh produce two loops
+    std::vector<ITKMesh::Pointer> meshes{sphere.itkMesh(), sphere.itkMesh()};
+    MeshSliceIndex both(meshes);
+    EXPECT_EQ(both.polylines(0.5).size(), 2);
+}
@@ -67,4 +67,27 @@ TEST_F(Metadata_Filled, IOMetadata)
     EXPECT_EQ(read.get<int>("int"), meta.get<int>("int"));
     EXPECT_EQ(read.get<double>("double"), meta.get<double>("double"));
     EXPECT_EQ(read.get<std::string>("string"), meta.get<std::string>("string"));
-}
\ No newline at end of file
+}
+
+// Cached, typed fields
+TEST_F(Metadata_Filled, MetadataField)
+{
+    volcart::MetadataField<double> field("double");
+    EXPECT_FALSE(field.hasValue());
+    EXPECT_THROW(field.get(), std::runtime_error);
+
+    // Load from the metadata
+    field.load(meta);
+    EXPECT_EQ(field.get(), d);
+
+    // Writes go through to the metadata
+    field.set(meta, 2.5);
+    EXPECT_EQ(field.get(), 2.5);
+    EXPECT_EQ(meta.get<double>("double"), 2.5);
+
+    // Missing keys clear the field
+    volcart::MetadataField<int> missing("missing");
+    missing.load(meta);
+    EXPECT_FALSE(missing.hasValue());
+    EXPECT_THROW(missing.get(), std::runtime_error);
+}
@@ -54,4 +54,39 @@ TEST_F(OrderedPointSetIO, WriteReadASCII)
     EXPECT_EQ(read(0, 0), ps(0, 0));
     EXPECT_EQ(read(0, 1), ps(0, 1));
     EXPECT_EQ(read(0, 2), ps(0, 2));
-}
\ No newline at end of file
+}
+TEST_F(OrderedPointSetIO, ReadRegion)
+{
+    // Larger point set
+    OrderedPointSet<cv::Vec3i> grid{5};
+    for (int y = 0; y < 4; y++) {
+        std::vector<cv::Vec3i> row;
+        for (int x = 0; x < 5; x++) {
+            row.emplace_back(x, y, 0);
+        }
+        grid.pushRow(row);
+    }
+    path += "ReadRegion.vcps";
+    PointSetIO<cv::Vec3i>::WriteOrderedPointSet(path, grid);
+
+    // Read a region which is clamped to the bounds
+    auto read =
+        PointSetIO<cv::Vec3i>::ReadOrderedPointSetRegion(path, 1, 2, 10, 2);
+    ASSERT_EQ(read.height(), 3);
+    ASSERT_EQ(read.width(), 2);
+    for (std::size_t y = 0; y < read.height(); y++) {
+        for (std::size_t x = 0; x < read.width(); x++) {
+            EXPECT_EQ(read(y, x), grid(y + 1, x + 2));
+        }
+    }
+
+    // Header only
+    auto header = PointSetIO<cv::Vec3i>::ReadHeader(path);
+    EXPECT_EQ(header.height, 4);
+    EXPECT_EQ(header.width, 5);
+
+    // Out-of-bounds origin
+    EXPECT_THROW(
+        PointSetIO<cv::Vec3i>::ReadOrderedPointSetRegion(path, 4, 0, 1, 1),
+        IOException);
+}
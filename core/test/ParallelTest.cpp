@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "vc/core/util/Parallel.hpp"
+
+using namespace volcart;
+
+TEST(Parallel, NumWorkerThreads)
+{
+    EXPECT_GE(NumWorkerThreads(), 1);
+    EXPECT_EQ(NumWorkerThreads(3), 3);
+}
+
+TEST(Parallel, ScopedThreadLimit)
+{
+    auto hw = NumWorkerThreads();
+    {
+        ScopedThreadLimit limit(1);
+        EXPECT_EQ(NumWorkerThreads(), 1);
+        EXPECT_EQ(NumWorkerThreads(3), 3);
+        {
+            ScopedThreadLimit none(0);
+            EXPECT_EQ(NumWorkerThreads(), hw);
+        }
+        EXPECT_EQ(NumWorkerThreads(), 1);
+    }
+    EXPECT_EQ(NumWorkerThreads(), hw);
+}
+
+TEST(Parallel, ParallelForVisitsEveryIndexOnce)
+{
+    std::vector<int> visits(10007, 0);
+    ParallelFor(0, visits.size(), [&](std::size_t i) { visits[i]++; }, 4);
+    for (const auto& v : visits) {
+        EXPECT_EQ(v, 1);
+    }
+}
+
+TEST(Parallel, ParallelForSubRange)
+{
+    std::vector<int> visits(100, 0);
+    ParallelFor(10, 20, [&](std::size_t i) { visits[i]++; }, 4, 3);
+    for (std::size_t i = 0; i < visits.size(); i++) {
+        EXPECT_EQ(visits[i], (i >= 10 and i < 20) ? 1 : 0);
+    }
+}
+
+TEST(Parallel, ParallelForEmptyRange)
+{
+    std::size_t calls{0};
+    ParallelFor(5, 5, [&](std::size_t) { calls++; });
+    ParallelFor(6, 5, [&](std::size_t) { calls++; });
+    EXPECT_EQ(calls, 0);
+}
+
+TEST(Parallel, ParallelForChunksThreadIndex)
+{
+    static constexpr std::size_t NUM_THREADS{4};
+    std::vector<std::size_t> sums(NUM_THREADS, 0);
+    std::atomic<bool> badIdx{false};
+    ParallelForChunks(
+        0, 1000,
+        [&](std::size_t b, std::size_t e, std::size_t t) {
+            if (t >= NUM_THREADS) {
+                badIdx = true;
+                return;
+            }
+            for (auto i = b; i < e; i++) {
+                sums[t] += i;
+            }
+        },
+        NUM_THREADS, 7);
+    EXPECT_FALSE(badIdx);
+    auto sum = std::accumulate(sums.begin(), sums.end(), std::size_t{0});
+    EXPECT_EQ(sum, 499500);
+}
+
+TEST(Parallel, ParallelForRethrows)
+{
+    auto fn = [](std::size_t i) {
+        if (i == 50) {
+            throw std::runtime_error("test");
+        }
+    };
+    EXPECT_THROW(ParallelFor(0, 100, fn, 4), std::runtime_error);
+    EXPECT_THROW(ParallelFor(0, 100, fn, 1), std::runtime_error);
+}
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "vc/core/filesystem.hpp"
+#include "vc/core/io/PointSetBuckets.hpp"
+#include "vc/core/util/Parallel.hpp"
+
+using namespace volcart;
+namespace fs = volcart::filesystem;
+
+namespace
+{
+void TestBuckets(std::size_t maxBuffered)
+{
+    const fs::path dir{"vc_core_PointSetBuckets"};
+    fs::create_directories(dir);
+
+    // Points of 7 slices in interleaved order
+    std::vector<std::vector<cv::Vec3i>> expected(7);
+    {
+        PointSetBuckets<cv::Vec3i> buckets(dir, maxBuffered);
+        for (int i = 0; i < 700; i++) {
+            cv::Vec3i p{i, 2 * i, (i * 3) % 7};
+            buckets.add(p[2], p);
+            expected[p[2]].push_back(p);
+        }
+
+        ASSERT_EQ(buckets.buckets().size(), 7);
+        EXPECT_EQ(buckets.size(3), 100);
+        EXPECT_EQ(buckets.size(10), 0);
+        EXPECT_TRUE(buckets.read(10).empty());
+
+        // Buckets can be read in parallel
+        std::vector<std::vector<cv::Vec3i>> read(7);
+        ParallelFor(
+            0, 7, [&](std::size_t z) { read[z] = buckets.read(z); }, 4);
+        EXPECT_EQ(read, expected);
+    }
+
+    // Spill files are removed
+    EXPECT_TRUE(fs::is_empty(dir));
+}
+}  // namespace
+
+TEST(PointSetBuckets, InMemory) { TestBuckets(10000); }
+
+TEST(PointSetBuckets, Spilled) { TestBuckets(64); }
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "vc/core/filesystem.hpp"
+#include "vc/core/io/PointSetIO.hpp"
+#include "vc/core/io/PointSetStream.hpp"
+#include "vc/core/types/PointSet.hpp"
+
+using namespace volcart;
+namespace fs = volcart::filesystem;
+
+TEST(PointSetStream, WriterMatchesPointSetIO)
+{
+    PointSet<cv::Vec3i> ps;
+    for (int i = 0; i < 1000; i++) {
+        ps.push_back({i, -i, 2 * i});
+    }
+
+    // Write in uneven pieces
+    const fs::path path{"vc_core_PointSetStream_Writer.vcps"};
+    {
+        PointSetWriter<cv::Vec3i> writer(path);
+        writer.write(ps[0]);
+        writer.write(ps.data() + 1, 499);
+        std::vector<cv::Vec3i> rest(ps.begin() + 500, ps.end());
+        writer.write(rest);
+        EXPECT_EQ(writer.size(), ps.size());
+        writer.close();
+    }
+
+    // Header length is unchanged by rewriting the final size
+    auto headerBytes = fs::file_size(path) - ps.size() * sizeof(cv::Vec3i);
+    EXPECT_EQ(headerBytes % PointSetIO<cv::Vec3i>::HEADER_ALIGNMENT, 0);
+
+    auto read = PointSetIO<cv::Vec3i>::ReadPointSet(path);
+    ASSERT_EQ(read.size(), ps.size());
+    EXPECT_TRUE(std::equal(read.begin(), read.end(), ps.begin()));
+}
+
+TEST(PointSetStream, ReaderChunks)
+{
+    PointSet<cv::Vec3d> ps;
+    for (int i = 0; i < 250; i++) {
+        ps.push_back({0.5 * i, 1, -2.0 * i});
+    }
+    const fs::path path{"vc_core_PointSetStream_Reader.vcps"};
+    PointSetIO<cv::Vec3d>::WritePointSet(path, ps);
+
+    PointSetReader<cv::Vec3d> reader(path);
+    EXPECT_EQ(reader.size(), ps.size());
+
+    std::vector<cv::Vec3d> chunk;
+    std::vector<cv::Vec3d> all;
+    std::size_t chunks{0};
+    while (reader.read(chunk, 100) > 0) {
+        all.insert(all.end(), chunk.begin(), chunk.end());
+        chunks++;
+    }
+    EXPECT_EQ(chunks, 3);
+    EXPECT_EQ(reader.remaining(), 0);
+    ASSERT_EQ(all.size(), ps.size());
+    EXPECT_TRUE(std::equal(all.begin(), all.end(), ps.begin()));
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include "vc/core/filesystem.hpp"
+#include "vc/core/types/SlicePyramid.hpp"
+#include "vc/core/types/Volume.hpp"
+#include "vc/testing/TestingUtils.hpp"
+
+using namespace volcart;
+namespace fs = volcart::filesystem;
+namespace vctest = volcart::testing;
+
+namespace
+{
+// A small volume of gradient slices
+auto MakeVolume(const fs::path& path, int width, int height, int slices)
+    -> Volume::Pointer
+{
+    return vctest::WriteTestVolume(
+        path, {width, height, slices}, vctest::LinearSlices(1, 1, 100));
+}
+}  // namespace
+
+TEST(SlicePyramid, LevelSizes)
+{
+    auto vol = MakeVolume("vc_core_SlicePyramid_Sizes", 1025, 300, 1);
+    SlicePyramid pyramid(vol);
+
+    ASSERT_EQ(pyramid.numLevels(), 4);
+    EXPECT_EQ(pyramid.levelSize(0), cv::Size(1025, 300));
+    EXPECT_EQ(pyramid.levelSize(1), cv::Size(513, 150));
+    EXPECT_EQ(pyramid.levelSize(2), cv::Size(257, 75));
+    EXPECT_EQ(pyramid.levelSize(3), cv::Size(129, 38));
+    EXPECT_FALSE(pyramid.isPrecomputed(1));
+
+    EXPECT_EQ(pyramid.levelForScale(2), 0);
+    EXPECT_EQ(pyramid.levelForScale(1), 0);
+    EXPECT_EQ(pyramid.levelForScale(0.6), 0);
+    EXPECT_EQ(pyramid.levelForScale(0.5), 1);
+    EXPECT_EQ(pyramid.levelForScale(0.3), 1);
+    EXPECT_EQ(pyramid.levelForScale(0.25), 2);
+    EXPECT_EQ(pyramid.levelForScale(0.01), 3);
+}
+
+TEST(SlicePyramid, DownsampledSlices)
+{
+    auto vol = MakeVolume("vc_core_SlicePyramid_Slices", 600, 520, 2);
+    SlicePyramid pyramid(vol);
+    ASSERT_EQ(pyramid.numLevels(), 3);
+
+    for (int z = 0; z < 2; z++) {
+        cv::Mat expected = vol->getSliceDataCopy(z);
+        for (int level = 1; level < pyramid.numLevels(); level++) {
+            cv::resize(
+                expected, expected, pyramid.levelSize(level), 0, 0,
+                cv::INTER_AREA);
+            auto slice = pyramid.getSliceData(z, level);
+            ASSERT_EQ(slice.size(), pyramid.levelSize(level));
+            EXPECT_EQ(cv::norm(slice, expected, cv::NORM_INF), 0);
+        }
+    }
+
+    // Tiles are views into the level and are clipped to its bounds
+    auto level = pyramid.getSliceData(1, 1);
+    auto tile = pyramid.getTile(1, 1, {256, 256, 256, 256});
+    EXPECT_EQ(tile.size(), cv::Size(44, 4));
+    EXPECT_EQ(tile.at<std::uint16_t>(0, 0), level.at<std::uint16_t>(256, 256));
+    EXPECT_TRUE(pyramid.getTile(1, 1, {400, 0, 10, 10}).empty());
+}
@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
 #include "vc/core/types/Transforms.hpp"
 #include "vc/core/util/Iteration.hpp"
 #include "vc/testing/TestingUtils.hpp"
@@ -608,4 +612,102 @@ TEST(Transforms, CompositeReset)
 
     tfm->reset();
     EXPECT_EQ(tfm->size(), 0);
-}
\ No newline at end of file
+}
+
+TEST(Transforms, CompositeApplyVector)
+{
+    auto tfm = CompositeTransform::New();
+    auto affine = AffineTransform::New();
+    affine->rotate(90, 0, 0, 1);
+    tfm->push_back(affine);
+    affine->reset();
+    affine->translate(1, 2, 3);
+    tfm->push_back(affine);
+
+    // Vectors are rotated, but not translated
+    SmallOrClose(tfm->applyVector({0, 1, 0}), {-1., 0., 0.});
+}
+
+TEST(Transforms, AffineMatrix)
+{
+    auto affine = AffineTransform::New();
+    affine->scale(2);
+    ASSERT_TRUE(affine->affineMatrix().has_value());
+    EXPECT_EQ(affine->affineMatrix()->val[0], 2);
+
+    auto tfm = CompositeTransform::New();
+    EXPECT_TRUE(*tfm->affineMatrix() == cv::Matx44d::eye());
+    tfm->push_back(affine);
+    affine->reset();
+    affine->translate(1, 0, 0);
+    tfm->push_back(affine);
+    tfm->push_back(IdentityTransform::New());
+
+    // Scale, then translate
+    auto m = *tfm->affineMatrix();
+    auto p = m * cv::Vec4d{1, 1, 1, 1};
+    SmallOrClose(cv::Vec3d{p[0], p[1], p[2]}, tfm->applyPoint({1, 1, 1}));
+}
+
+TEST(Transforms, ApplyBatch)
+{
+    auto tfm = CompositeTransform::New();
+    auto affine = AffineTransform::New();
+    affine->scale(2, 3, 4);
+    tfm->push_back(affine);
+    affine->reset();
+    affine->rotate(30, 1, 1, 0);
+    tfm->push_back(affine);
+    affine->reset();
+    affine->translate(-5, 10, 2.5);
+    tfm->push_back(affine);
+
+    // Enough interleaved values to be split across threads
+    std::vector<cv::Vec6d> values;
+    for (int i = 0; i < 50000; i++) {
+        auto d = static_cast<double>(i);
+        values.emplace_back(d, -0.5 * d, 2, std::sin(d), std::cos(d), 1);
+    }
+    values[10] = {1, 2, 3, 0, 0, 0};
+
+    for (auto normalize : {true, false}) {
+        auto batch = values;
+        tfm->applyBatch(
+            batch[0].val, batch[0].val + 3, batch.size(), 6, normalize, 4);
+        for (std::size_t i = 0; i < values.size(); i++) {
+            SmallOrClose(
+                batch[i], tfm->applyPointAndNormal(values[i], normalize));
+        }
+    }
+
+    // Points only, with a contiguous array
+    auto points = ApplyTransform(PointSet<cv::Vec3d>(10, {1, 2, 3}), tfm);
+    for (const auto& p : points) {
+        SmallOrClose(p, tfm->applyPoint({1, 2, 3}));
+    }
+}
+
+TEST(Transforms, ApplyTransformPPM)
+{
+    PerPixelMap ppm(2, 3);
+    cv::Mat mask = cv::Mat::zeros(2, 3, CV_8UC1);
+    for (const auto [y, x] : range2D(2, 3)) {
+        ppm(y, x) = {1. * x, 1. * y, 0, 0, 0, 1};
+        if (x != 1) {
+            mask.at<std::uint8_t>(y, x) = 255;
+        }
+    }
+    ppm.setMask(mask);
+
+    auto tfm = AffineTransform::New();
+    tfm->translate(0, 0, 10);
+    auto result = ApplyTransform(ppm, tfm);
+    for (const auto [y, x] : range2D(2, 3)) {
+        if (x == 1) {
+            // Unmapped pixels are not transformed
+            EXPECT_EQ(result(y, x), ppm(y, x));
+        } else {
+            EXPECT_EQ(result(y, x), cv::Vec6d(1. * x, 1. * y, 10, 0, 0, 1));
+        }
+    }
+}
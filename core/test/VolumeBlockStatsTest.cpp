@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <opencv2/core.hpp>
+
+#include "vc/core/filesystem.hpp"
+#include "vc/core/neighborhood/LineGenerator.hpp"
+#include "vc/core/types/Volume.hpp"
+#include "vc/core/types/VolumeBlockStats.hpp"
+#include "vc/testing/TestingUtils.hpp"
+
+using namespace volcart;
+namespace fs = volcart::filesystem;
+namespace vctest = volcart::testing;
+
+namespace
+{
+// A dark volume with a single bright cube in [20, 28)^3
+auto MakeVolume(const fs::path& path) -> Volume::Pointer
+{
+    return vctest::WriteTestVolume(
+        path, {40, 40, 40}, vctest::CubeSlices(10, {20, 20, 20}, 8, 1000));
+}
+}  // namespace
+
+TEST(VolumeBlockStats, ComputeMatchesAddSlice)
+{
+    auto vol = MakeVolume("vc_core_VolumeBlockStats_Compute");
+    auto computed = VolumeBlockStats::Compute(*vol, 8);
+    auto added = VolumeBlockStats::New({40, 40, 40}, 8);
+    for (int z = 0; z < 40; z++) {
+        added->addSlice(z, vol->getSliceData(z));
+    }
+
+    ASSERT_EQ(computed->numBlocks(), cv::Vec3i(5, 5, 5));
+    for (int bz = 0; bz < 5; bz++) {
+        for (int by = 0; by < 5; by++) {
+            for (int bx = 0; bx < 5; bx++) {
+                EXPECT_EQ(computed->min(bx, by, bz), added->min(bx, by, bz));
+                EXPECT_EQ(computed->max(bx, by, bz), added->max(bx, by, bz));
+            }
+        }
+    }
+
+    // Both blocks which overlap the cube see it
+    EXPECT_EQ(computed->max(1, 1, 1), 10);
+    EXPECT_EQ(computed->max(2, 2, 1), 10);
+    EXPECT_EQ(computed->max(2, 2, 2), 1000);
+    EXPECT_EQ(computed->max(3, 3, 3), 1000);
+    EXPECT_EQ(computed->min(2, 2, 2), 10);
+    EXPECT_EQ(computed->maxAt({-1, 0, 0}), 0);
+}
+
+TEST(VolumeBlockStats, BoundsInterpolation)
+{
+    auto vol = MakeVolume("vc_core_VolumeBlockStats_Bounds");
+    auto stats = VolumeBlockStats::Compute(*vol, 8);
+    for (double z = 0; z < 40; z += 0.7) {
+        for (double y = 0; y < 40; y += 1.3) {
+            for (double x = 0; x < 40; x += 0.9) {
+                cv::Vec3d p{x, y, z};
+                ASSERT_GE(stats->maxAt(p), vol->interpolateAt(p));
+            }
+        }
+    }
+}
+
+TEST(VolumeBlockStats, WriteAndRead)
+{
+    auto vol = MakeVolume("vc_core_VolumeBlockStats_IO");
+    auto stats = VolumeBlockStats::Compute(*vol, 16);
+    stats->write(vol->blockStatsPath());
+
+    auto read = VolumeBlockStats::Read(vol->blockStatsPath());
+    EXPECT_EQ(read->volumeSize(), stats->volumeSize());
+    EXPECT_EQ(read->blockSize(), 16);
+    ASSERT_EQ(read->numBlocks(), stats->numBlocks());
+    for (int bz = 0; bz < 3; bz++) {
+        for (int by = 0; by < 3; by++) {
+            for (int bx = 0; bx < 3; bx++) {
+                EXPECT_EQ(read->min(bx, by, bz), stats->min(bx, by, bz));
+                EXPECT_EQ(read->max(bx, by, bz), stats->max(bx, by, bz));
+            }
+        }
+    }
+
+    // Volumes pick up the stored summary
+    auto reloaded = Volume::New(vol->path());
+    ASSERT_TRUE(reloaded->blockStats());
+    EXPECT_EQ(reloaded->blockStats()->blockSize(), 16);
+
+    EXPECT_THROW(
+        VolumeBlockStats::Read(vol->path() / "meta.json"), IOException);
+}
+
+TEST(VolumeBlockStats, LineGeneratorSkipsDarkBlocks)
+{
+    auto vol = MakeVolume("vc_core_VolumeBlockStats_Skip");
+    vol->setBlockStats(VolumeBlockStats::Compute(*vol, 8));
+
+    auto gen = LineGenerator::New();
+    gen->setSamplingRadius(3);
+    gen->setSamplingInterval(1);
+
+    // Without a threshold, every sample is read
+    auto dark = gen->compute(vol, {5, 5, 5}, {{0, 0, 1}});
+    ASSERT_EQ(dark.size(), 7U);
+    for (std::size_t i = 0; i < dark.size(); i++) {
+        EXPECT_EQ(dark(i), 10);
+    }
+
+    // Dark lines are skipped entirely
+    gen->setSkipThreshold(100);
+    dark = gen->compute(vol, {5, 5, 5}, {{0, 0, 1}});
+    for (std::size_t i = 0; i < dark.size(); i++) {
+        EXPECT_EQ(dark(i), 0);
+    }
+
+    // Lines which reach a bright block only skip their dark samples
+    auto mixed = gen->compute(vol, {24, 24, 14}, {{0, 0, 1}});
+    EXPECT_EQ(mixed(0), 0);
+    EXPECT_EQ(mixed(4), 0);
+    EXPECT_EQ(mixed(5), 10);
+    EXPECT_EQ(mixed(6), 10);
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <opencv2/core.hpp>
+
+#include "vc/core/filesystem.hpp"
+#include "vc/core/types/Exceptions.hpp"
+#include "vc/core/types/VolumeChunks.hpp"
+#include "vc/core/util/Parallel.hpp"
+
+using namespace volcart;
+namespace fs = volcart::filesystem;
+
+namespace
+{
+auto Voxel(int x, int y, int z) -> std::uint16_t
+{
+    return static_cast<std::uint16_t>(1000 * z + 30 * y + x);
+}
+
+auto MakeSlice(int width, int height, int z) -> cv::Mat
+{
+    cv::Mat slice(height, width, CV_16UC1);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            slice.at<std::uint16_t>(y, x) = Voxel(x, y, z);
+        }
+    }
+    return slice;
+}
+}  // namespace
+
+TEST(VolumeChunks, Layout)
+{
+    VolumeChunks chunks("vc_core_VolumeChunks_Layout", {40, 30, 20}, 16);
+    EXPECT_EQ(chunks.numChunks(), cv::Vec3i(3, 2, 2));
+    EXPECT_EQ(chunks.chunkExtent(0, 0, 0), cv::Vec3i(16, 16, 16));
+    EXPECT_EQ(chunks.chunkExtent(2, 1, 1), cv::Vec3i(8, 14, 4));
+    EXPECT_EQ(
+        chunks.chunkPath(2, 1, 0),
+        fs::path("vc_core_VolumeChunks_Layout") / "0" / "1_2.raw");
+    EXPECT_THROW(chunks.chunkExtent(3, 0, 0), std::out_of_range);
+}
+
+TEST(VolumeChunks, WriteAndRead)
+{
+    const fs::path dir{"vc_core_VolumeChunks_IO"};
+    fs::remove_all(dir);
+    VolumeChunks chunks(dir, {40, 30, 20}, 16);
+
+    // Slices arrive out of order from multiple threads
+    ParallelFor(
+        0, 20,
+        [&](std::size_t i) {
+            auto z = 19 - static_cast<int>(i);
+            chunks.addSlice(z, MakeSlice(40, 30, z));
+        },
+        4);
+
+    auto n = chunks.numChunks();
+    for (int cz = 0; cz < n[2]; cz++) {
+        for (int cy = 0; cy < n[1]; cy++) {
+            for (int cx = 0; cx < n[0]; cx++) {
+                auto chunk = chunks.readChunk(cx, cy, cz);
+                auto extent = chunks.chunkExtent(cx, cy, cz);
+                ASSERT_EQ(
+                    chunk.size(),
+                    static_cast<std::size_t>(
+                        extent[0] * extent[1] * extent[2]));
+                for (int z = 0; z < extent[2]; z++) {
+                    for (int y = 0; y < extent[1]; y++) {
+                        for (int x = 0; x < extent[0]; x++) {
+                            ASSERT_EQ(
+                                chunk(z, y, x),
+                                Voxel(cx * 16 + x, cy * 16 + y, cz * 16 + z));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    EXPECT_THROW(
+        chunks.addSlice(0, cv::Mat(30, 40, CV_8UC1)), std::invalid_argument);
+}
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+
+#include <opencv2/core.hpp>
+
+#include "vc/core/filesystem.hpp"
+#include "vc/core/types/Volume.hpp"
+#include "vc/core/types/VolumeHistogram.hpp"
+#include "vc/testing/TestingUtils.hpp"
+
+using namespace volcart;
+namespace fs = volcart::filesystem;
+namespace vctest = volcart::testing;
+
+namespace
+{
+// A dark volume with a single bright cube in [20, 28)^3
+auto MakeVolume(const fs::path& path) -> Volume::Pointer
+{
+    return vctest::WriteTestVolume(
+        path, {40, 40, 40}, vctest::CubeSlices(10, {20, 20, 20}, 8, 1000));
+}
+
+auto Total(const VolumeHistogram::Histogram& h) -> std::uint64_t
+{
+    return std::accumulate(h.begin(), h.end(), std::uint64_t{0});
+}
+}  // namespace
+
+TEST(VolumeHistogram, ComputeMatchesAddSlice)
+{
+    auto vol = MakeVolume("vc_core_VolumeHistogram_Compute");
+    auto computed = VolumeHistogram::Compute(*vol, 10);
+    auto added = VolumeHistogram::New({40, 40, 40}, 10);
+    for (int z = 39; z >= 0; z--) {
+        added->addSlice(z, vol->getSliceData(z));
+    }
+
+    ASSERT_EQ(computed->numBlocks(), cv::Vec3i(4, 4, 4));
+    EXPECT_EQ(computed->histogram(), added->histogram());
+    for (int z = 0; z < 40; z += 5) {
+        EXPECT_EQ(computed->histogram(z, z + 7), added->histogram(z, z + 7));
+        cv::Rect roi{z, 5, 10, 20};
+        EXPECT_EQ(
+            computed->histogram(roi, z, z + 7),
+            added->histogram(roi, z, z + 7));
+    }
+}
+
+TEST(VolumeHistogram, SliceRanges)
+{
+    auto vol = MakeVolume("vc_core_VolumeHistogram_Slices");
+    auto hist = VolumeHistogram::Compute(*vol);
+
+    auto all = hist->histogram();
+    ASSERT_EQ(all.size(), std::size_t{VolumeHistogram::NUM_BINS});
+    EXPECT_EQ(Total(all), 40U * 40 * 40);
+    EXPECT_EQ(all[1000 / VolumeHistogram::BIN_WIDTH], 8U * 8 * 8);
+
+    auto dark = hist->histogram(0, 19);
+    EXPECT_EQ(Total(dark), 20U * 40 * 40);
+    EXPECT_EQ(dark[0], 20U * 40 * 40);
+
+    auto bright = hist->histogram(20, 27);
+    EXPECT_EQ(bright[1000 / VolumeHistogram::BIN_WIDTH], 8U * 8 * 8);
+
+    // Ranges are clamped to the volume
+    EXPECT_EQ(hist->histogram(-5, 100), all);
+    EXPECT_EQ(Total(hist->histogram(50, 60)), 0U);
+    EXPECT_EQ(Total(hist->histogram(10, 5)), 0U);
+}
+
+TEST(VolumeHistogram, RegionOfInterest)
+{
+    auto vol = MakeVolume("vc_core_VolumeHistogram_ROI");
+    auto hist = VolumeHistogram::Compute(*vol, 10);
+
+    // A region within the cube covers the whole block around it
+    auto h = hist->histogram(cv::Rect(22, 22, 2, 2), 22, 23);
+    EXPECT_EQ(Total(h), 10U * 10 * 10);
+    EXPECT_EQ(h[1000 / VolumeHistogram::BIN_WIDTH], 8U * 8 * 8);
+    EXPECT_GT(hist->percentile(50, cv::Rect(22, 22, 2, 2), 22, 23), 768);
+
+    // Regions away from the cube are dark
+    EXPECT_LE(
+        hist->percentile(100, cv::Rect(0, 0, 20, 20), 0, 39),
+        VolumeHistogram::BIN_WIDTH);
+
+    // Regions are clamped to the volume
+    EXPECT_EQ(
+        hist->histogram(cv::Rect(-10, -10, 100, 100), 0, 39),
+        hist->histogram());
+    EXPECT_EQ(Total(hist->histogram(cv::Rect(50, 50, 5, 5), 0, 39)), 0U);
+}
+
+TEST(VolumeHistogram, Percentile)
+{
+    VolumeHistogram::Histogram h(VolumeHistogram::NUM_BINS, 0);
+    EXPECT_EQ(VolumeHistogram::Percentile(h, 50), 0);
+
+    h[0] = 50;
+    h[3] = 50;
+    constexpr double W{VolumeHistogram::BIN_WIDTH};
+    EXPECT_DOUBLE_EQ(VolumeHistogram::Percentile(h, 0), 0);
+    EXPECT_DOUBLE_EQ(VolumeHistogram::Percentile(h, 25), 0.5 * W);
+    EXPECT_DOUBLE_EQ(VolumeHistogram::Percentile(h, 50), 1 * W);
+    EXPECT_DOUBLE_EQ(VolumeHistogram::Percentile(h, 75), 3.5 * W);
+    EXPECT_DOUBLE_EQ(VolumeHistogram::Percentile(h, 100), 4 * W);
+    EXPECT_DOUBLE_EQ(VolumeHistogram::Percentile(h, 150), 4 * W);
+
+    // Never past the largest intensity
+    h[VolumeHistogram::NUM_BINS - 1] = 1;
+    EXPECT_DOUBLE_EQ(VolumeHistogram::Percentile(h, 100), 65535);
+}
+
+TEST(VolumeHistogram, AddSliceChecksInput)
+{
+    auto hist = VolumeHistogram::New({4, 4, 4}, 2);
+    cv::Mat slice(4, 4, CV_16UC1, cv::Scalar(0));
+    EXPECT_THROW(hist->addSlice(4, slice), std::invalid_argument);
+    EXPECT_THROW(
+        hist->addSlice(0, cv::Mat(4, 4, CV_8UC1)), std::invalid_argument);
+    EXPECT_THROW(
+        hist->addSlice(0, cv::Mat(3, 4, CV_16UC1)), std::invalid_argument);
+    EXPECT_THROW(VolumeHistogram::New({4, 4, 4}, 0), std::invalid_argument);
+    EXPECT_THROW(
+        VolumeHistogram::New({4, 4, 4}, VolumeHistogram::MAX_BLOCK_SIZE + 1),
+        std::invalid_argument);
+
+    // Queries see slices added after earlier queries
+    EXPECT_EQ(Total(hist->histogram()), 0U);
+    hist->addSlice(0, slice);
+    EXPECT_EQ(Total(hist->histogram()), 16U);
+}
+
+TEST(VolumeHistogram, WriteAndRead)
+{
+    auto vol = MakeVolume("vc_core_VolumeHistogram_IO");
+    auto hist = VolumeHistogram::Compute(*vol, 16);
+    hist->write(vol->histogramPath());
+
+    auto read = VolumeHistogram::Read(vol->histogramPath());
+    EXPECT_EQ(read->volumeSize(), hist->volumeSize());
+    EXPECT_EQ(read->blockSize(), 16);
+    ASSERT_EQ(read->numBlocks(), hist->numBlocks());
+    for (int z = 0; z < 40; z += 4) {
+        EXPECT_EQ(read->histogram(z, z + 3), hist->histogram(z, z + 3));
+        cv::Rect roi{z, z, 16, 16};
+        EXPECT_EQ(read->histogram(roi, 0, z), hist->histogram(roi, 0, z));
+    }
+
+    // Volumes pick up the stored histograms
+    auto reloaded = Volume::New(vol->path());
+    ASSERT_TRUE(reloaded->histogram());
+    EXPECT_EQ(reloaded->histogram()->histogram(), hist->histogram());
+
+    EXPECT_THROW(VolumeHistogram::Read(vol->path() / "meta.json"), IOException);
+}
+
+TEST(VolumeHistogram, CorruptFileIsIgnored)
+{
+    auto vol = MakeVolume("vc_core_VolumeHistogram_Corrupt");
+    auto hist = VolumeHistogram::Compute(*vol, 16);
+    hist->write(vol->histogramPath());
+    fs::resize_file(vol->histogramPath(), 100);
+
+    // The truncated file is treated as missing, and not read again
+    auto reloaded = Volume::New(vol->path());
+    EXPECT_NO_THROW(EXPECT_FALSE(reloaded->histogram()));
+    EXPECT_FALSE(reloaded->histogram());
+}
@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+
+#include "vc/core/filesystem.hpp"
+#include "vc/core/types/Volume.hpp"
+#include "vc/testing/TestingUtils.hpp"
+
+using namespace volcart;
+namespace fs = volcart::filesystem;
+namespace vctest = volcart::testing;
+
+namespace
+{
+// A volume whose intensities are linear in x, y, and z
+auto MakeVolume(const fs::path& path) -> Volume::Pointer
+{
+    return vctest::WriteTestVolume(
+        path, {16, 16, 16}, vctest::LinearSlices(10, 20, 30));
+}
+}  // namespace
+
+TEST(VolumeInterpolation, VoxelCenters)
+{
+    auto vol = MakeVolume("vc_core_VolumeInterpolation_Centers");
+    for (int z = 0; z < 15; z += 3) {
+        for (int y = 0; y < 15; y += 2) {
+            for (int x = 0; x < 15; x++) {
+                EXPECT_EQ(
+                    vol->interpolateAt(x, y, z), vol->intensityAt(x, y, z));
+            }
+        }
+    }
+}
+
+TEST(VolumeInterpolation, Trilinear)
+{
+    // Trilinear interpolation of a linear field is exact. Each position
+    // weights the (x1, y1, z0) corner differently.
+    auto vol = MakeVolume("vc_core_VolumeInterpolation_Trilinear");
+    EXPECT_EQ(vol->interpolateAt(1.5, 2.5, 3.5), 170);
+    EXPECT_EQ(vol->interpolateAt(10.25, 4.75, 0.25), 205);
+    EXPECT_EQ(vol->interpolateAt(4.5, 6.5, 2), 235);
+    EXPECT_EQ(vol->interpolateAt(7.5, 0.25, 9), 350);
+}
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "vc/core/filesystem.hpp"
+#include "vc/core/types/Volume.hpp"
+#include "vc/testing/TestingUtils.hpp"
+
+using namespace volcart;
+namespace fs = volcart::filesystem;
+namespace vctest = volcart::testing;
+
+namespace
+{
+// A volume whose intensities are linear in x, y, and z
+auto MakeVolume(const fs::path& path) -> Volume::Pointer
+{
+    return vctest::WriteTestVolume(
+        path, {40, 40, 40}, vctest::LinearSlices(10, 20, 30));
+}
+
+// Planes at several orientations, including some which leave the volume
+auto MakePlanes() -> std::vector<Volume::ReslicePlane>
+{
+    std::vector<Volume::ReslicePlane> planes;
+    for (int i = 0; i < 12; i++) {
+        auto angle = 0.5 * i;
+        cv::Vec3d center{3.0 * i + 0.25, 20.5, 4.0 + 3 * i};
+        cv::Vec3d xvec{std::cos(angle), std::sin(angle), 0};
+        planes.push_back({center, xvec, {0, 0, 1}});
+    }
+    return planes;
+}
+}  // namespace
+
+TEST(VolumeReslice, BatchMatchesSingle)
+{
+    auto vol = MakeVolume("vc_core_VolumeReslice_Batch");
+    auto planes = MakePlanes();
+    auto batch = vol->reslice(planes, 16, 16, 4);
+    ASSERT_EQ(batch.size(), planes.size());
+
+    std::atomic<std::size_t> calls{0};
+    std::vector<cv::Mat> each(planes.size());
+    vol->resliceEach(
+        planes,
+        [&](std::size_t i, const Reslice& r) {
+            each[i] = r.sliceData().clone();
+            calls++;
+        },
+        16, 16, 4);
+    EXPECT_EQ(calls, planes.size());
+
+    for (std::size_t i = 0; i < planes.size(); i++) {
+        const auto& p = planes[i];
+        auto single = vol->reslice(p.center, p.xvec, p.yvec, 16, 16);
+        EXPECT_EQ(cv::norm(single.sliceData(), batch[i].sliceData()), 0);
+        EXPECT_EQ(cv::norm(single.sliceData(), each[i]), 0);
+        EXPECT_EQ(
+            single.sliceToVoxelCoord<int>({3, 5}),
+            batch[i].sliceToVoxelCoord<int>({3, 5}));
+    }
+}
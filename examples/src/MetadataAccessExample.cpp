@@ -0,0 +1,66 @@
+/*
+ * Purpose: Compare the cost of reading a value through Metadata::get() with
+ *          reading it through a cached MetadataField, as done by
+ *          Volume::voxelSize(), min(), and max().
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+
+#include "vc/core/types/Metadata.hpp"
+#include "vc/core/types/Volume.hpp"
+
+using namespace volcart;
+
+namespace
+{
+constexpr std::size_t NUM_READS{10'000'000};
+
+// Time NUM_READS calls of fn and report the average time per call
+template <typename Fn>
+void Time(const char* label, Fn fn)
+{
+    double sum{0};
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < NUM_READS; i++) {
+        sum += fn();
+    }
+    std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    // Print the sum so the reads are not optimized away
+    std::cout << label << ": " << elapsed.count() / NUM_READS
+              << " ns/read (sum: " << sum << ")" << std::endl;
+}
+}  // namespace
+
+auto main() -> int
+{
+    // Metadata with a typical number of keys
+    Metadata meta;
+    meta.set("uuid", "20230101000000");
+    meta.set("name", "example");
+    meta.set("type", "vol");
+    meta.set("width", 8096);
+    meta.set("height", 7888);
+    meta.set("slices", 14376);
+    meta.set("voxelsize", 7.91);
+    meta.set("min", 0.0);
+    meta.set("max", 65535.0);
+
+    MetadataField<double> voxelSize("voxelsize");
+    voxelSize.load(meta);
+
+    Time("Metadata::get<double>()", [&meta]() {
+        return meta.get<double>("voxelsize");
+    });
+    Time("MetadataField<double>::get()", [&voxelSize]() {
+        return voxelSize.get();
+    });
+
+    // The Volume accessors use cached fields
+    auto volume = Volume::New("metadata_access_example.volpkg", "vol", "vol");
+    volume->setVoxelSize(7.91);
+    Time("Volume::voxelSize()", [&volume]() { return volume->voxelSize(); });
+}
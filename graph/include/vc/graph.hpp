@@ -4,6 +4,8 @@
 
 #include <opencv2/core.hpp>
 
+#include "vc/graph/GraphExecutor.hpp"
+#include "vc/graph/MemoCache.hpp"
 #include "vc/graph/core.hpp"
 #include "vc/graph/meshing.hpp"
 #include "vc/graph/texturing.hpp"
@@ -0,0 +1,105 @@
+#pragma once
+
+/** @file */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <smgl/Graph.hpp>
+#include <smgl/Node.hpp>
+
+namespace volcart
+{
+
+/**
+ * @brief Parallel update of an smgl::Graph with per-node profiling
+ *
+ * smgl::Graph::update() updates nodes one at a time in a topological order,
+ * even when branches of the graph are independent. GraphExecutor instead
+ * tracks the dependencies between nodes and updates every node whose
+ * upstream nodes have finished on a pool of worker threads. A node is never
+ * updated concurrently with any of its upstream nodes, so port values are
+ * only read from nodes which have finished updating.
+ *
+ * For every node, the executor records the wall time of the update, the
+ * increase in the process's peak resident set size (RSS) during the update,
+ * and an estimate of the memory held by the node's connected outputs. Since
+ * peak RSS is a process-wide measure, the RSS delta of nodes which run
+ * concurrently includes the allocations of their neighbors.
+ *
+ * Nodes which parallelize internally with the default thread count share
+ * the hardware threads: each node is limited (see ScopedThreadLimit) to the
+ * hardware thread count divided by the number of nodes running when it
+ * starts.
+ *
+ * If the graph has caching enabled, the graph is saved after each node
+ * finishes, as with smgl::Graph::update(). Saving serializes every node, so
+ * no new node is started while a save waits for the running nodes to
+ * finish. After the update, the profile is added to the graph's project
+ * metadata under the `profile` key and the graph is saved again.
+ *
+ * @ingroup Graph
+ */
+class GraphExecutor
+{
+public:
+    /** @brief Per-node update profile */
+    struct NodeProfile {
+        /** Node UUID */
+        std::string uuid;
+        /** Seconds from the start of the update to the start of the node */
+        double start{0};
+        /** Wall time of the node update, in seconds */
+        double seconds{0};
+        /** Increase in the peak resident set size, in bytes */
+        std::int64_t peakRSSDelta{0};
+        /** Estimated size of the node's connected outputs, in bytes */
+        std::size_t outputBytes{0};
+        /** Index of the worker thread which updated the node */
+        std::size_t thread{0};
+        /** Default thread count available to the node's update */
+        std::size_t threadLimit{0};
+    };
+
+    /**
+     * @brief Set the number of worker threads
+     *
+     * If 0 (default), uses the number of available hardware threads. If 1,
+     * nodes are updated serially, but are still profiled.
+     */
+    void setNumThreads(std::size_t n);
+
+    /** @copydoc setNumThreads(std::size_t) */
+    [[nodiscard]] auto numThreads() const -> std::size_t;
+
+    /**
+     * @brief Update all nodes in the graph
+     *
+     * If a node fails to update, no new nodes are started and the graph
+     * returns smgl::Graph::State::Error after the running nodes finish.
+     * Returns smgl::Graph::State::Updating without updating any nodes if the
+     * graph is already being updated by a GraphExecutor.
+     */
+    auto update(smgl::Graph& graph) -> smgl::Graph::State;
+
+    /** @brief Get the profile of every node from the last update() */
+    [[nodiscard]] auto profile() const -> const std::vector<NodeProfile>&;
+
+    /** @brief Total wall time of the last update(), in seconds */
+    [[nodiscard]] auto totalSeconds() const -> double;
+
+    /** @brief Convert the profile of the last update() to metadata */
+    [[nodiscard]] auto profileMetadata() const -> smgl::Metadata;
+
+private:
+    /** Number of worker threads */
+    std::size_t numThreads_{0};
+    /** Node profiles */
+    std::vector<NodeProfile> profile_;
+    /** Total update time */
+    double totalSeconds_{0};
+};
+
+}  // namespace volcart
@@ -0,0 +1,221 @@
+#pragma once
+
+/** @file */
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <type_traits>
+
+#include <smgl/Metadata.hpp>
+
+#include "vc/core/filesystem.hpp"
+#include "vc/core/types/ITKMesh.hpp"
+#include "vc/core/types/UVMap.hpp"
+
+namespace volcart
+{
+
+/**
+ * @brief Content-addressed store for the results of expensive graph nodes
+ *
+ * Results are keyed by a hash of the node type, the node's parameters, and
+ * the contents of its inputs, so a node whose inputs and parameters have not
+ * changed since a previous run (e.g. when re-running vc_render with only a
+ * different texturing method) can load its result instead of recomputing it.
+ *
+ * Every entry is a directory named by its key inside root(). Entries are
+ * written to a temporary directory and renamed into place, so a partially
+ * written entry is never found. When the total size of all entries exceeds
+ * maxBytes(), the least recently used entries are removed.
+ *
+ * Memoization is opt-in: supported nodes only use the cache if one has been
+ * installed with SetGlobalMemoCache(). All member functions are thread-safe.
+ *
+ * @ingroup Graph
+ */
+class MemoCache
+{
+public:
+    /** Pointer type */
+    using Pointer = std::shared_ptr<MemoCache>;
+
+    /** Default cache size limit, in bytes */
+    static constexpr std::size_t DEFAULT_MAX_BYTES{10'000'000'000};
+
+    /**
+     * @brief Incremental hash of a node's type, parameters, and inputs
+     *
+     * Produces a 128-bit key as a hexadecimal string. Variable length values
+     * are prefixed with their length so that the concatenation of different
+     * values never produces the same stream.
+     */
+    class KeyBuilder
+    {
+    public:
+        /** @brief Start a key for the given node type */
+        explicit KeyBuilder(const std::string& nodeType);
+
+        /** @brief Add raw bytes */
+        auto add(const void* data, std::size_t bytes) -> KeyBuilder&;
+
+        /** @brief Add an arithmetic or enum value */
+        template <
+            typename T,
+            std::enable_if_t<
+                std::is_arithmetic_v<T> or std::is_enum_v<T>,
+                bool> = true>
+        auto add(T val) -> KeyBuilder&
+        {
+            return add(&val, sizeof(T));
+        }
+
+        /** @brief Add a string */
+        auto add(const std::string& s) -> KeyBuilder&;
+
+        /** @brief Add node parameters */
+        auto add(const smgl::Metadata& meta) -> KeyBuilder&;
+
+        /** @brief Add the vertices, normals, and faces of a mesh */
+        auto add(const ITKMesh::Pointer& mesh) -> KeyBuilder&;
+
+        /** @brief Add the UVs, origin, and ratio of a UVMap */
+        auto add(const UVMap::Pointer& uvMap) -> KeyBuilder&;
+
+        /** @brief Get the key */
+        [[nodiscard]] auto key() const -> std::string;
+
+    private:
+        /** Hash lanes */
+        std::array<std::uint64_t, 2> state_;
+    };
+
+    /** Callback which writes or reads an entry's files in a directory */
+    using EntryFn = std::function<void(const filesystem::path&)>;
+
+    /** @brief Construct a cache in the given directory */
+    explicit MemoCache(
+        filesystem::path root, std::size_t maxBytes = DEFAULT_MAX_BYTES);
+
+    /** @copydoc MemoCache(filesystem::path, std::size_t) */
+    static auto New(
+        filesystem::path root, std::size_t maxBytes = DEFAULT_MAX_BYTES)
+        -> Pointer;
+
+    /** @brief Get the cache directory */
+    [[nodiscard]] auto root() const -> filesystem::path;
+
+    /**
+     * @brief Set the maximum total size of the cache entries, in bytes
+     *
+     * The most recently stored entry is never removed, even if it alone
+     * exceeds the limit.
+     */
+    void setMaxBytes(std::size_t b);
+
+    /** @copydoc setMaxBytes(std::size_t) */
+    [[nodiscard]] auto maxBytes() const -> std::size_t;
+
+    /**
+     * @brief Find an entry
+     *
+     * If found, marks the entry as most recently used and returns its
+     * directory.
+     */
+    auto find(const std::string& key) -> std::optional<filesystem::path>;
+
+    /**
+     * @brief Store an entry
+     *
+     * Calls `writer` with an empty directory into which the entry's files
+     * should be written, then adds the entry to the cache and removes least
+     * recently used entries until the cache fits in maxBytes(). If `writer`
+     * throws, nothing is added to the cache.
+     */
+    void store(const std::string& key, const EntryFn& writer);
+
+    /**
+     * @brief Load a memoized result or compute and store it
+     *
+     * If the entry for `key` exists, calls `load` with its directory.
+     * Otherwise, or if loading fails, calls `compute` and then stores the
+     * result with `save`. Failures to store the result are logged, but are
+     * not fatal.
+     */
+    void memoize(
+        const std::string& key,
+        const EntryFn& load,
+        const std::function<void()>& compute,
+        const EntryFn& save);
+
+    /** @brief Total size of the cache entries, in bytes */
+    [[nodiscard]] auto size() const -> std::size_t;
+
+    /** @brief Number of entries found since construction */
+    [[nodiscard]] auto hits() const -> std::size_t;
+
+    /** @brief Number of entries not found since construction */
+    [[nodiscard]] auto misses() const -> std::size_t;
+
+    /** @brief Write a mesh into an entry directory without loss */
+    static void SaveMesh(
+        const filesystem::path& dir,
+        const std::string& name,
+        const ITKMesh::Pointer& mesh);
+
+    /** @brief Read a mesh written by SaveMesh() */
+    static auto LoadMesh(const filesystem::path& dir, const std::string& name)
+        -> ITKMesh::Pointer;
+
+private:
+    /** Remove LRU entries until the cache fits, keeping `keep` */
+    void evict_(const std::string& keep);
+    /** Total size of the entries. Caller must hold the lock. */
+    [[nodiscard]] auto size_() const -> std::size_t;
+    /**
+     * Strictly increasing use time, in ms since the epoch. Caller must hold
+     * the lock.
+     */
+    auto stamp_() -> std::int64_t;
+
+    /** Cache directory */
+    filesystem::path root_;
+    /** Size limit */
+    std::size_t maxBytes_;
+    /** Protects the entry directories */
+    mutable std::mutex mutex_;
+    /** Last use time returned by stamp_() */
+    std::int64_t lastStamp_{0};
+    /** Counter for unique temporary directories */
+    std::atomic<std::size_t> tmpCount_{0};
+    /** Lookup counters */
+    std::atomic<std::size_t> hits_{0};
+    /** @copydoc hits_ */
+    std::atomic<std::size_t> misses_{0};
+};
+
+/**
+ * @brief Install the cache used by memoizing graph nodes
+ *
+ * Pass `nullptr` to disable memoization (default).
+ *
+ * @ingroup Graph
+ */
+void SetGlobalMemoCache(MemoCache::Pointer cache);
+
+/**
+ * @brief Get the cache used by memoizing graph nodes
+ *
+ * Returns `nullptr` if memoization is disabled.
+ *
+ * @ingroup Graph
+ */
+auto GlobalMemoCache() -> MemoCache::Pointer;
+
+}  // namespace volcart
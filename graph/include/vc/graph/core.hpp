@@ -16,6 +16,7 @@
 #include "vc/core/types/Transforms.hpp"
 #include "vc/core/types/UVMap.hpp"
 #include "vc/core/types/Volume.hpp"
+#include "vc/core/types/VolumeBlockStats.hpp"
 #include "vc/core/types/VolumePkg.hpp"
 #include "vc/core/types/VolumetricMask.hpp"
 
@@ -162,6 +163,51 @@ private:
         const filesystem::path& /*cacheDir*/) override;
 };
 
+/**
+ * @brief Attach a VolumeBlockStats summary to a Volume
+ *
+ * Uses the summary stored in the volume directory if it matches the
+ * requested block size. Otherwise, the summary is computed and saved to the
+ * volume directory for later runs.
+ *
+ * @see NeighborhoodGenerator::setSkipThreshold
+ * @ingroup Graph
+ */
+class VolumeBlockStatsNode : public smgl::Node
+{
+private:
+    /** Input volume */
+    Volume::Pointer volume_{nullptr};
+    /** Block edge length */
+    int blockSize_{VolumeBlockStats::DEFAULT_BLOCK_SIZE};
+
+public:
+    /** @brief Input Volume */
+    smgl::InputPort<Volume::Pointer> volumeIn;
+    /** @brief Block edge length, in voxels */
+    smgl::InputPort<int> blockSize;
+    /**
+     * @brief Output Volume
+     *
+     * @warning After update, volumeIn and volumeOut are pointers to the same
+     * Volume object.
+     */
+    smgl::OutputPort<Volume::Pointer> volumeOut;
+
+    /** Constructor */
+    VolumeBlockStatsNode();
+
+private:
+    /** smgl custom serialization */
+    auto serialize_(bool /*useCache*/, const filesystem::path& /*cacheDir*/)
+        -> smgl::Metadata override;
+
+    /** smgl custom deserialization */
+    void deserialize_(
+        const smgl::Metadata& meta,
+        const filesystem::path& /*cacheDir*/) override;
+};
+
 /**
  * @copydoc VolumePkg::segmentation(const Segmentation::Identifier&) const
  *
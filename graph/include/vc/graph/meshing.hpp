@@ -159,8 +159,13 @@ private:
     ITKMesh::Pointer mesh_;
 
 public:
+    /** @copydoc meshing::LaplacianSmooth::Engine */
+    using Engine = Smoother::Engine;
+
     /** @brief Input mesh */
     smgl::InputPort<ITKMesh::Pointer> input;
+    /** @copybrief meshing::LaplacianSmooth::setEngine() */
+    smgl::InputPort<Engine> engine;
     /**@brief Output mesh */
     smgl::OutputPort<ITKMesh::Pointer> output;
 
@@ -180,6 +185,8 @@ private:
 /**
  * @copybrief meshing::ACVD
  *
+ * Results are memoized if a cache is installed with SetGlobalMemoCache().
+ *
  * @see meshing::ACVD
  * @ingroup Graph
  */
@@ -190,6 +197,8 @@ private:
     using ACVD = meshing::ACVD;
     /** Mesh resampler */
     ACVD acvd_;
+    /** Input mesh */
+    ITKMesh::Pointer input_;
     /** Output mesh */
     ITKMesh::Pointer mesh_;
 
@@ -4,6 +4,7 @@
 
 #include <cstdint>
 #include <limits>
+#include <vector>
 
 #include <opencv2/core.hpp>
 #include <smgl/Node.hpp>
@@ -21,6 +22,7 @@
 #include "vc/texturing/IntegralTexture.hpp"
 #include "vc/texturing/IntersectionTexture.hpp"
 #include "vc/texturing/LayerTexture.hpp"
+#include "vc/texturing/MultiOutputTexture.hpp"
 #include "vc/texturing/OrthographicProjectionFlattening.hpp"
 #include "vc/texturing/PPMGenerator.hpp"
 #include "vc/texturing/ThicknessTexture.hpp"
@@ -31,6 +33,8 @@ namespace volcart
 /**
  * @copybrief texturing::AngleBasedFlattening
  *
+ * Results are memoized if a cache is installed with SetGlobalMemoCache().
+ *
  * @see texturing::AngleBasedFlattening
  * @ingroup Graph
  */
@@ -41,20 +45,43 @@ private:
     using ABF = texturing::AngleBasedFlattening;
     /** Flattening class */
     ABF abf_{};
+    /** Input mesh */
+    ITKMesh::Pointer inputMesh_{nullptr};
+    /** Input initial UV Map */
+    UVMap::Pointer initialUVMap_{};
     /** Output UV Map */
     UVMap::Pointer uvMap_{};
     /** Output flattened mesh */
     ITKMesh::Pointer mesh_{nullptr};
+    /** Output per-patch metrics */
+    std::vector<ABF::PatchMetrics> patchMetrics_;
 
 public:
+    /** @copydoc ABF::Solver */
+    using Solver = ABF::Solver;
+    /** @copydoc ABF::PatchMetrics */
+    using PatchMetrics = ABF::PatchMetrics;
+
     /** @brief Input mesh */
     smgl::InputPort<ITKMesh::Pointer> input;
     /** @copydoc ABF::setUseABF(bool) */
     smgl::InputPort<bool> useABF;
+    /** @copydoc ABF::setSolver(Solver) */
+    smgl::InputPort<Solver> solver;
+    /** @copydoc ABF::setInitialUVMap(const UVMap::Pointer&) */
+    smgl::InputPort<UVMap::Pointer> initialUVMap;
+    /** @copydoc ABF::setMaxPatchFaces(std::size_t) */
+    smgl::InputPort<std::size_t> maxPatchFaces;
+    /** @copydoc ABF::setPatchOverlap(std::size_t) */
+    smgl::InputPort<std::size_t> patchOverlap;
+    /** @copydoc ABF::setMemoryLimit(std::size_t) */
+    smgl::InputPort<std::size_t> memoryLimit;
     /** @brief Flattened mesh */
     smgl::OutputPort<ITKMesh::Pointer> output;
     /** @brief UVMap generated from flattened mesh */
     smgl::OutputPort<UVMap::Pointer> uvMap;
+    /** @copydoc ABF::patchMetrics() */
+    smgl::OutputPort<std::vector<PatchMetrics>> patchMetrics;
 
     /** Constructor */
     ABFNode();
@@ -202,6 +229,8 @@ private:
 /**
  * @copybrief texturing::PPMGenerator
  *
+ * Results are memoized if a cache is installed with SetGlobalMemoCache().
+ *
  * @see texturing::PPMGenerator
  * @ingroup Graph
  */
@@ -214,6 +243,10 @@ private:
     PPMGen ppmGen_;
     /** Shading method */
     PPMGen::Shading shading_{PPMGen::Shading::Smooth};
+    /** Input mesh */
+    ITKMesh::Pointer mesh_;
+    /** Input UVMap */
+    UVMap::Pointer uvMap_;
     /** Output PPM */
     PerPixelMap::Pointer ppm_;
 
@@ -313,6 +346,8 @@ private:
     double interval_{1};
     /** Sampling direction */
     Direction dir_{Direction::Bidirectional};
+    /** Skip threshold */
+    std::uint16_t skipThreshold_{0};
     /** Generator */
     Generator::Pointer gen_;
 
@@ -328,6 +363,8 @@ public:
      * @see Direction
      */
     smgl::InputPort<Direction> direction;
+    /** @copydoc NeighborhoodGenerator::setSkipThreshold */
+    smgl::InputPort<std::uint16_t> skipThreshold;
     /** @brief Configured neighborhood generator */
     smgl::OutputPort<Generator::Pointer> generator;
 
@@ -579,6 +616,59 @@ public:
     /** Constructor */
     LayerTextureNode();
 
+private:
+    /** smgl custom serialization */
+    auto serialize_(bool useCache, const filesystem::path& cacheDir)
+        -> smgl::Metadata override;
+
+    /** smgl custom deserialization */
+    void deserialize_(
+        const smgl::Metadata& meta, const filesystem::path& cacheDir) override;
+};
+
+/**
+ * @copybrief texturing::MultiOutputTexture
+ * @see texturing::MultiOutputTexture
+ * @ingroup Graph
+ */
+class MultiOutputTextureNode : public smgl::Node
+{
+private:
+    /** Image list type */
+    using ImageList = std::vector<cv::Mat>;
+    /** Algorithm class type */
+    using TAlgo = texturing::MultiOutputTexture;
+    /** Generator class type */
+    using Generator = NeighborhoodGenerator::Pointer;
+    /** Texturing algorithm */
+    TAlgo textureGen_;
+    /** Output composite images */
+    ImageList textures_;
+    /** Output layer images */
+    ImageList layers_;
+
+public:
+    /** @copydoc texturing::CompositeTexture::Filter */
+    using Filter = TAlgo::Filter;
+
+    /** @brief Input PerPixelMap */
+    smgl::InputPort<PerPixelMap::Pointer> ppm;
+    /** @brief Input Volume */
+    smgl::InputPort<Volume::Pointer> volume;
+    /** @brief Neighborhood generator */
+    smgl::InputPort<Generator> generator;
+    /** @copybrief texturing::MultiOutputTexture::setFilters() */
+    smgl::InputPort<std::vector<Filter>> filters;
+    /** @copybrief texturing::MultiOutputTexture::setGenerateLayers() */
+    smgl::InputPort<bool> generateLayers;
+    /** @brief Composite texture images, one per requested filter */
+    smgl::OutputPort<ImageList> textures;
+    /** @brief Layer images */
+    smgl::OutputPort<ImageList> layers;
+
+    /** Constructor */
+    MultiOutputTextureNode();
+
 private:
     /** smgl custom serialization */
     auto serialize_(bool useCache, const filesystem::path& cacheDir)
@@ -0,0 +1,329 @@
+#include "vc/graph/GraphExecutor.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include <opencv2/core.hpp>
+#include <smgl/Ports.hpp>
+
+#include "vc/core/types/ITKMesh.hpp"
+#include "vc/core/types/PerPixelMap.hpp"
+#include "vc/core/types/UVMap.hpp"
+#include "vc/core/util/Logging.hpp"
+#include "vc/core/util/Parallel.hpp"
+
+using namespace volcart;
+
+using Clock = std::chrono::steady_clock;
+using Seconds = std::chrono::duration<double>;
+
+namespace
+{
+// Peak resident set size of the process in bytes, or 0 if unavailable
+auto PeakRSS() -> std::int64_t
+{
+#if defined(__APPLE__)
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<std::int64_t>(usage.ru_maxrss);
+#elif defined(__unix__)
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<std::int64_t>(usage.ru_maxrss) * 1024;
+#else
+    return 0;
+#endif
+}
+
+auto MatBytes(const cv::Mat& m) -> std::size_t
+{
+    return m.total() * m.elemSize();
+}
+
+// Estimate the memory held by an output port's value. Only the common VC
+// types are recognized. Other ports are reported as 0 bytes.
+auto OutputBytes(smgl::Output* port) -> std::size_t
+{
+    if (auto* p = dynamic_cast<smgl::OutputPort<cv::Mat>*>(port)) {
+        return MatBytes(p->val());
+    }
+    if (auto* p = dynamic_cast<smgl::OutputPort<std::vector<cv::Mat>>*>(port)) {
+        std::size_t bytes{0};
+        for (const auto& m : p->val()) {
+            bytes += MatBytes(m);
+        }
+        return bytes;
+    }
+    if (auto* p = dynamic_cast<smgl::OutputPort<ITKMesh::Pointer>*>(port)) {
+        auto mesh = p->val();
+        if (not mesh) {
+            return 0;
+        }
+        return mesh->GetNumberOfPoints() * sizeof(ITKPoint) +
+               mesh->GetNumberOfCells() * 3 * sizeof(ITKMesh::PointIdentifier);
+    }
+    if (auto* p = dynamic_cast<smgl::OutputPort<PerPixelMap::Pointer>*>(port)) {
+        auto ppm = p->val();
+        if (not ppm) {
+            return 0;
+        }
+        return ppm->height() * ppm->width() * sizeof(cv::Vec6d) +
+               MatBytes(ppm->mask()) + MatBytes(ppm->cellMap());
+    }
+    if (auto* p = dynamic_cast<smgl::OutputPort<UVMap::Pointer>*>(port)) {
+        auto uv = p->val();
+        return (uv) ? uv->size() * sizeof(cv::Vec2d) : 0;
+    }
+    return 0;
+}
+
+// Graphs which are being updated by an executor
+std::mutex ActiveMutex;
+std::set<const smgl::Graph*> ActiveGraphs;
+
+// Marks a graph as updating for the lifetime of the object
+class ActiveGraph
+{
+public:
+    explicit ActiveGraph(const smgl::Graph& g) : graph_{&g}
+    {
+        std::unique_lock<std::mutex> lock(ActiveMutex);
+        acquired_ = ActiveGraphs.insert(graph_).second;
+    }
+
+    ActiveGraph(const ActiveGraph&) = delete;
+    auto operator=(const ActiveGraph&) -> ActiveGraph& = delete;
+
+    ~ActiveGraph()
+    {
+        if (acquired_) {
+            std::unique_lock<std::mutex> lock(ActiveMutex);
+            ActiveGraphs.erase(graph_);
+        }
+    }
+
+    // Whether the graph was not already updating
+    [[nodiscard]] auto acquired() const -> bool { return acquired_; }
+
+private:
+    const smgl::Graph* graph_;
+    bool acquired_{false};
+};
+
+// Save the graph and its node caches, logging failures
+void SaveCache(smgl::Graph& graph)
+{
+    try {
+        smgl::Graph::Save(graph.cacheFile(), graph, true);
+    } catch (const std::exception& e) {
+        Logger()->error("Failed to save graph cache: {}", e.what());
+    }
+}
+}  // namespace
+
+void GraphExecutor::setNumThreads(std::size_t n) { numThreads_ = n; }
+
+auto GraphExecutor::numThreads() const -> std::size_t { return numThreads_; }
+
+auto GraphExecutor::profile() const -> const std::vector<NodeProfile>&
+{
+    return profile_;
+}
+
+auto GraphExecutor::totalSeconds() const -> double { return totalSeconds_; }
+
+auto GraphExecutor::update(smgl::Graph& graph) -> smgl::Graph::State
+{
+    ActiveGraph active(graph);
+    if (not active.acquired()) {
+        return smgl::Graph::State::Updating;
+    }
+
+    // Topological order and dependencies
+    auto nodes = smgl::Graph::Schedule(graph);
+    std::unordered_map<const smgl::Node*, std::size_t> index;
+    for (std::size_t i = 0; i < nodes.size(); i++) {
+        index[nodes[i].get()] = i;
+    }
+    std::vector<std::size_t> waitingOn(nodes.size(), 0);
+    std::vector<std::vector<std::size_t>> downstream(nodes.size());
+    for (std::size_t i = 0; i < nodes.size(); i++) {
+        std::set<std::size_t> upstream;
+        for (const auto& c : nodes[i]->getInputConnections()) {
+            auto it = index.find(c.srcNode);
+            if (it != index.end()) {
+                upstream.insert(it->second);
+            }
+        }
+        waitingOn[i] = upstream.size();
+        for (const auto& u : upstream) {
+            downstream[u].push_back(i);
+        }
+    }
+
+    // Nodes with no dependencies are ready, in schedule order
+    std::deque<std::size_t> ready;
+    for (std::size_t i = 0; i < nodes.size(); i++) {
+        if (waitingOn[i] == 0) {
+            ready.push_back(i);
+        }
+    }
+
+    profile_.assign(nodes.size(), {});
+    auto threads = NumWorkerThreads(numThreads_);
+    threads = std::min(threads, std::max<std::size_t>(nodes.size(), 1));
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::size_t finished{0};
+    std::size_t running{0};
+    bool failed{false};
+    const auto saveCache = graph.cacheEnabled();
+    bool savePending{false};
+    const auto hardware = NumWorkerThreads();
+    const auto updateStart = Clock::now();
+
+    auto worker = [&](std::size_t tid) {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            // Wait for a ready node or for all running nodes to finish. No
+            // node starts while a cache save waits for running nodes.
+            cv.wait(lock, [&] {
+                return (not ready.empty() and not savePending) or
+                       running == 0;
+            });
+            if (failed or ready.empty()) {
+                cv.notify_all();
+                return;
+            }
+            auto idx = ready.front();
+            ready.pop_front();
+            running++;
+
+            // Share the hardware threads between the running nodes
+            auto threadLimit = std::max<std::size_t>(hardware / running, 1);
+            lock.unlock();
+
+            // Update the node
+            auto& node = nodes[idx];
+            auto& prof = profile_[idx];
+            prof.uuid = node->uuid().string();
+            prof.thread = tid;
+            prof.threadLimit = threadLimit;
+            auto rss = PeakRSS();
+            auto start = Clock::now();
+            prof.start = Seconds(start - updateStart).count();
+            auto ok{true};
+            try {
+                ScopedThreadLimit limit(threadLimit);
+                ok = node->update() != smgl::Node::State::Error;
+            } catch (const std::exception& e) {
+                Logger()->error("Node {} failed: {}", prof.uuid, e.what());
+                ok = false;
+            }
+            prof.seconds = Seconds(Clock::now() - start).count();
+            prof.peakRSSDelta = PeakRSS() - rss;
+
+            // Outputs which are consumed downstream
+            std::set<smgl::Output*> outputs;
+            for (const auto& c : node->getOutputConnections()) {
+                outputs.insert(c.srcPort);
+            }
+            for (auto* o : outputs) {
+                prof.outputBytes += OutputBytes(o);
+            }
+
+            lock.lock();
+            running--;
+            finished++;
+            if (ok) {
+                for (const auto& d : downstream[idx]) {
+                    if (--waitingOn[d] == 0) {
+                        ready.push_back(d);
+                    }
+                }
+            } else {
+                failed = true;
+            }
+
+            // Save the cache once no node is updating, so that the results
+            // of finished nodes survive a crash later in the update. The
+            // final save is made after the update.
+            if (saveCache and finished < nodes.size()) {
+                savePending = true;
+                if (running == 0) {
+                    SaveCache(graph);
+                    savePending = false;
+                }
+            }
+            cv.notify_all();
+        }
+    };
+
+    if (threads == 1) {
+        worker(0);
+    } else {
+        std::vector<std::thread> pool;
+        for (std::size_t t = 0; t < threads; t++) {
+            pool.emplace_back(worker, t);
+        }
+        for (auto& t : pool) {
+            t.join();
+        }
+    }
+    totalSeconds_ = Seconds(Clock::now() - updateStart).count();
+    if (not failed and finished < nodes.size()) {
+        Logger()->error(
+            "Graph update stalled: {}/{} nodes updated", finished,
+            nodes.size());
+        failed = true;
+    }
+
+    // Drop the profiles of nodes which never ran
+    std::vector<NodeProfile> ran;
+    for (auto& p : profile_) {
+        if (not p.uuid.empty()) {
+            ran.emplace_back(std::move(p));
+        }
+    }
+    profile_ = std::move(ran);
+
+    // Save the profile with the graph
+    if (graph.cacheEnabled()) {
+        auto meta = graph.projectMetadata();
+        meta["profile"] = profileMetadata();
+        graph.setProjectMetadata(meta);
+        SaveCache(graph);
+    }
+
+    return (failed) ? smgl::Graph::State::Error : smgl::Graph::State::Idle;
+}
+
+auto GraphExecutor::profileMetadata() const -> smgl::Metadata
+{
+    smgl::Metadata nodes = smgl::Metadata::array();
+    for (const auto& p : profile_) {
+        nodes.push_back(
+            {{"uuid", p.uuid},
+             {"start", p.start},
+             {"seconds", p.seconds},
+             {"peakRSSDelta", p.peakRSSDelta},
+             {"outputBytes", p.outputBytes},
+             {"thread", p.thread},
+             {"threadLimit", p.threadLimit}});
+    }
+    return {
+        {"threads", NumWorkerThreads(numThreads_)},
+        {"seconds", totalSeconds_},
+        {"nodes", nodes}};
+}
@@ -0,0 +1,408 @@
+#include "vc/graph/MemoCache.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "vc/core/io/PointSetIO.hpp"
+#include "vc/core/types/MeshArrays.hpp"
+#include "vc/core/types/Metadata.hpp"
+#include "vc/core/types/PointSet.hpp"
+#include "vc/core/util/Logging.hpp"
+
+using namespace volcart;
+namespace fs = volcart::filesystem;
+
+namespace
+{
+// Bump to invalidate all existing entries when an entry format changes
+constexpr std::uint64_t MEMO_FORMAT_VERSION{1};
+
+// Entry metadata file. Written last, so its presence marks a complete entry.
+constexpr auto ENTRY_META = "memo.json";
+
+// Global cache
+std::mutex GLOBAL_MUTEX;
+MemoCache::Pointer GLOBAL_CACHE{nullptr};
+
+// splitmix64 finalizer
+auto Mix(std::uint64_t h) -> std::uint64_t
+{
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    return h;
+}
+
+auto NowMS() -> std::int64_t
+{
+    using namespace std::chrono;
+    auto now = system_clock::now().time_since_epoch();
+    return duration_cast<milliseconds>(now).count();
+}
+
+auto IsTmpDir(const fs::path& p) -> bool
+{
+    return p.filename().string().find(".tmp") != std::string::npos;
+}
+
+auto DirBytes(const fs::path& dir) -> std::size_t
+{
+    std::size_t bytes{0};
+    for (const auto& f : fs::recursive_directory_iterator(dir)) {
+        if (fs::is_regular_file(f)) {
+            bytes += fs::file_size(f);
+        }
+    }
+    return bytes;
+}
+
+// Mark an entry as used at the given time
+void Touch(const fs::path& dir, std::int64_t stamp)
+{
+    Metadata meta(dir / ENTRY_META);
+    meta.set("lastUsed", stamp);
+    meta.save();
+}
+}  // namespace
+
+///// KeyBuilder /////
+MemoCache::KeyBuilder::KeyBuilder(const std::string& nodeType)
+    : state_{0xCBF29CE484222325ULL, 0x9E3779B97F4A7C15ULL}
+{
+    add(MEMO_FORMAT_VERSION);
+    add(nodeType);
+}
+
+auto MemoCache::KeyBuilder::add(const void* data, std::size_t bytes)
+    -> KeyBuilder&
+{
+    // Two independent lanes: FNV-1a and a multiply-xorshift accumulator
+    const auto* b = static_cast<const unsigned char*>(data);
+    auto h0 = state_[0];
+    auto h1 = state_[1];
+    for (std::size_t i = 0; i < bytes; i++) {
+        h0 = (h0 ^ b[i]) * 0x100000001B3ULL;
+        h1 = (h1 + b[i] + 1) * 0xFF51AFD7ED558CCDULL;
+        h1 ^= h1 >> 32;
+    }
+    state_ = {h0, h1};
+    return *this;
+}
+
+auto MemoCache::KeyBuilder::add(const std::string& s) -> KeyBuilder&
+{
+    add(static_cast<std::uint64_t>(s.size()));
+    return add(s.data(), s.size());
+}
+
+auto MemoCache::KeyBuilder::add(const smgl::Metadata& meta) -> KeyBuilder&
+{
+    return add(meta.dump());
+}
+
+auto MemoCache::KeyBuilder::add(const ITKMesh::Pointer& mesh) -> KeyBuilder&
+{
+    add(static_cast<bool>(mesh));
+    if (not mesh) {
+        return *this;
+    }
+
+    add(static_cast<std::uint64_t>(mesh->GetNumberOfPoints()));
+    ITKPixel n;
+    for (auto pt = mesh->GetPoints()->Begin(); pt != mesh->GetPoints()->End();
+         ++pt) {
+        add(pt->Value().GetDataPointer(), 3 * sizeof(double));
+        auto hasNormal = mesh->GetPointData(pt.Index(), &n);
+        add(hasNormal);
+        if (hasNormal) {
+            add(n.GetDataPointer(), 3 * sizeof(double));
+        }
+    }
+
+    add(static_cast<std::uint64_t>(mesh->GetNumberOfCells()));
+    for (auto cell = mesh->GetCells()->Begin(); cell != mesh->GetCells()->End();
+         ++cell) {
+        add(static_cast<std::uint64_t>(cell.Value()->GetNumberOfPoints()));
+        for (auto id = cell.Value()->PointIdsBegin();
+             id != cell.Value()->PointIdsEnd(); ++id) {
+            add(static_cast<std::uint64_t>(*id));
+        }
+    }
+    return *this;
+}
+
+auto MemoCache::KeyBuilder::add(const UVMap::Pointer& uvMap) -> KeyBuilder&
+{
+    add(static_cast<bool>(uvMap));
+    if (not uvMap) {
+        return *this;
+    }
+
+    auto ratio = uvMap->ratio();
+    add(uvMap->origin());
+    add(ratio.width);
+    add(ratio.height);
+    add(static_cast<std::uint64_t>(uvMap->size()));
+    for (const auto& [id, uv] : uvMap->as_map()) {
+        add(static_cast<std::uint64_t>(id));
+        add(uv.val, 2 * sizeof(double));
+    }
+    return *this;
+}
+
+auto MemoCache::KeyBuilder::key() const -> std::string
+{
+    std::ostringstream ss;
+    ss << std::hex << std::setfill('0');
+    ss << std::setw(16) << Mix(state_[0]);
+    ss << std::setw(16) << Mix(state_[1] ^ state_[0]);
+    return ss.str();
+}
+
+///// MemoCache /////
+MemoCache::MemoCache(fs::path root, std::size_t maxBytes)
+    : root_{std::move(root)}, maxBytes_{maxBytes}
+{
+    fs::create_directories(root_);
+}
+
+auto MemoCache::New(fs::path root, std::size_t maxBytes) -> Pointer
+{
+    return std::make_shared<MemoCache>(std::move(root), maxBytes);
+}
+
+auto MemoCache::root() const -> fs::path { return root_; }
+
+void MemoCache::setMaxBytes(std::size_t b)
+{
+    std::unique_lock lock(mutex_);
+    maxBytes_ = b;
+}
+
+auto MemoCache::maxBytes() const -> std::size_t
+{
+    std::unique_lock lock(mutex_);
+    return maxBytes_;
+}
+
+auto MemoCache::find(const std::string& key) -> std::optional<fs::path>
+{
+    std::unique_lock lock(mutex_);
+    auto dir = root_ / key;
+    if (not fs::exists(dir / ENTRY_META)) {
+        ++misses_;
+        return std::nullopt;
+    }
+    Touch(dir, stamp_());
+    ++hits_;
+    return dir;
+}
+
+void MemoCache::store(const std::string& key, const EntryFn& writer)
+{
+    // Write the entry outside of the lock
+    auto tmp = root_ / (key + ".tmp" + std::to_string(tmpCount_++));
+    fs::remove_all(tmp);
+    fs::create_directories(tmp);
+    try {
+        writer(tmp);
+        Metadata meta;
+        meta.set("created", NowMS());
+        meta.set("lastUsed", NowMS());
+        meta.save(tmp / ENTRY_META);
+    } catch (...) {
+        fs::remove_all(tmp);
+        throw;
+    }
+
+    // Move into place. An existing entry for the same key is equivalent.
+    std::unique_lock lock(mutex_);
+    auto dir = root_ / key;
+    if (fs::exists(dir)) {
+        fs::remove_all(tmp);
+    } else {
+        fs::rename(tmp, dir);
+    }
+    Touch(dir, stamp_());
+    evict_(key);
+}
+
+void MemoCache::memoize(
+    const std::string& key,
+    const EntryFn& load,
+    const std::function<void()>& compute,
+    const EntryFn& save)
+{
+    if (auto dir = find(key)) {
+        try {
+            load(*dir);
+            Logger()->debug("[graph.memo] loaded memoized result: {}", key);
+            return;
+        } catch (const std::exception& e) {
+            Logger()->warn(
+                "[graph.memo] failed to load memoized result {}: {}", key,
+                e.what());
+            std::unique_lock lock(mutex_);
+            fs::remove_all(*dir);
+        }
+    }
+
+    compute();
+
+    try {
+        store(key, save);
+    } catch (const std::exception& e) {
+        Logger()->warn(
+            "[graph.memo] failed to store result {}: {}", key, e.what());
+    }
+}
+
+auto MemoCache::size() const -> std::size_t
+{
+    std::unique_lock lock(mutex_);
+    return size_();
+}
+
+auto MemoCache::size_() const -> std::size_t
+{
+    std::size_t bytes{0};
+    for (const auto& entry : fs::directory_iterator(root_)) {
+        if (fs::is_directory(entry) and not IsTmpDir(entry.path())) {
+            bytes += DirBytes(entry.path());
+        }
+    }
+    return bytes;
+}
+
+auto MemoCache::hits() const -> std::size_t { return hits_; }
+
+auto MemoCache::misses() const -> std::size_t { return misses_; }
+
+auto MemoCache::stamp_() -> std::int64_t
+{
+    lastStamp_ = std::max(NowMS(), lastStamp_ + 1);
+    return lastStamp_;
+}
+
+void MemoCache::evict_(const std::string& keep)
+{
+    struct Entry {
+        fs::path dir;
+        std::int64_t lastUsed{0};
+        std::size_t bytes{0};
+    };
+
+    // Collect complete entries. Incomplete ones are always removed first.
+    std::vector<Entry> entries;
+    std::size_t total{0};
+    for (const auto& e : fs::directory_iterator(root_)) {
+        if (not fs::is_directory(e) or IsTmpDir(e.path())) {
+            continue;
+        }
+        Entry entry{e.path(), 0, DirBytes(e.path())};
+        try {
+            Metadata meta(e.path() / ENTRY_META);
+            entry.lastUsed = meta.get<std::int64_t>("lastUsed");
+        } catch (const std::exception&) {
+            entry.lastUsed = -1;
+        }
+        total += entry.bytes;
+        entries.emplace_back(std::move(entry));
+    }
+    if (total <= maxBytes_) {
+        return;
+    }
+
+    // Remove LRU entries
+    std::sort(entries.begin(), entries.end(), [](auto& a, auto& b) {
+        return a.lastUsed < b.lastUsed;
+    });
+    for (const auto& e : entries) {
+        if (total <= maxBytes_) {
+            break;
+        }
+        if (e.dir.filename().string() == keep) {
+            continue;
+        }
+        Logger()->debug(
+            "[graph.memo] evicting {}", e.dir.filename().string());
+        fs::remove_all(e.dir);
+        total -= e.bytes;
+    }
+}
+
+void MemoCache::SaveMesh(
+    const fs::path& dir, const std::string& name, const ITKMesh::Pointer& mesh)
+{
+    auto hasNormals = mesh->GetPointData() != nullptr and
+                      mesh->GetPointData()->Size() == mesh->GetNumberOfPoints();
+    auto arrays = ToMeshArrays(mesh, hasNormals);
+
+    PointSet<cv::Vec3d> vertices(arrays.vertices.size());
+    for (const auto& v : arrays.vertices) {
+        vertices.push_back(v);
+    }
+    PointSetIO<cv::Vec3d>::WritePointSet(
+        dir / (name + "_vertices.vcps"), vertices);
+
+    if (hasNormals) {
+        PointSet<cv::Vec3d> normals(arrays.normals.size());
+        for (const auto& n : arrays.normals) {
+            normals.push_back(n);
+        }
+        PointSetIO<cv::Vec3d>::WritePointSet(
+            dir / (name + "_normals.vcps"), normals);
+    }
+
+    PointSet<cv::Vec3i> faces(arrays.faces.size());
+    for (const auto& f : arrays.faces) {
+        faces.push_back(cv::Vec3i(
+            static_cast<int>(f[0]), static_cast<int>(f[1]),
+            static_cast<int>(f[2])));
+    }
+    PointSetIO<cv::Vec3i>::WritePointSet(dir / (name + "_faces.vcps"), faces);
+}
+
+auto MemoCache::LoadMesh(const fs::path& dir, const std::string& name)
+    -> ITKMesh::Pointer
+{
+    MeshArrays arrays;
+    auto vertices =
+        PointSetIO<cv::Vec3d>::ReadPointSet(dir / (name + "_vertices.vcps"));
+    arrays.vertices.assign(vertices.begin(), vertices.end());
+
+    auto normalsPath = dir / (name + "_normals.vcps");
+    if (fs::exists(normalsPath)) {
+        auto normals = PointSetIO<cv::Vec3d>::ReadPointSet(normalsPath);
+        arrays.normals.assign(normals.begin(), normals.end());
+    }
+
+    auto faces =
+        PointSetIO<cv::Vec3i>::ReadPointSet(dir / (name + "_faces.vcps"));
+    arrays.faces.reserve(faces.size());
+    for (const auto& f : faces) {
+        arrays.faces.push_back(
+            {static_cast<std::size_t>(f[0]), static_cast<std::size_t>(f[1]),
+             static_cast<std::size_t>(f[2])});
+    }
+    return ToITKMesh(arrays);
+}
+
+void volcart::SetGlobalMemoCache(MemoCache::Pointer cache)
+{
+    std::unique_lock lock(GLOBAL_MUTEX);
+    GLOBAL_CACHE = std::move(cache);
+}
+
+auto volcart::GlobalMemoCache() -> MemoCache::Pointer
+{
+    std::unique_lock lock(GLOBAL_MUTEX);
+    return GLOBAL_CACHE;
+}
@@ -4,6 +4,7 @@
 
 #include "vc/core/io/PointSetIO.hpp"
 #include "vc/core/io/UVMapIO.hpp"
+#include "vc/core/types/Exceptions.hpp"
 #include "vc/core/util/FloatComparison.hpp"
 #include "vc/core/util/Logging.hpp"
 
@@ -133,6 +134,49 @@ void VolumePropertiesNode::deserialize_(
     cacheMem_ = meta["cacheMemory"].get<std::size_t>();
 }
 
+VolumeBlockStatsNode::VolumeBlockStatsNode()
+    : volumeIn{&volume_}, blockSize{&blockSize_}, volumeOut{&volume_}
+{
+    registerInputPort("volumeIn", volumeIn);
+    registerInputPort("blockSize", blockSize);
+    registerOutputPort("volumeOut", volumeOut);
+
+    compute = [&]() {
+        if (not volume_) {
+            Logger()->debug("[graph.core] volume is nullptr");
+            return;
+        }
+
+        auto stats = volume_->blockStats();
+        if (stats and stats->blockSize() == blockSize_) {
+            Logger()->debug("[graph.core] using stored block statistics");
+            return;
+        }
+
+        Logger()->info("Computing volume block statistics...");
+        stats = VolumeBlockStats::Compute(*volume_, blockSize_);
+        try {
+            stats->write(volume_->blockStatsPath());
+        } catch (const IOException& e) {
+            Logger()->warn(
+                "[graph.core] could not save block statistics: {}", e.what());
+        }
+        volume_->setBlockStats(stats);
+    };
+}
+
+auto VolumeBlockStatsNode::serialize_(
+    bool /*useCache*/, const filesystem::path& /*cacheDir*/) -> smgl::Metadata
+{
+    return {{"blockSize", blockSize_}};
+}
+
+void VolumeBlockStatsNode::deserialize_(
+    const smgl::Metadata& meta, const filesystem::path& /*cacheDir*/)
+{
+    blockSize_ = meta["blockSize"].get<int>();
+}
+
 SegmentationSelectorNode::SegmentationSelectorNode()
     : volpkg{&vpkg_}, id{&id_}, segmentation{&seg_}
 {
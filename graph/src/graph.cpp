@@ -17,6 +17,7 @@ auto RegisterNodesImpl() -> bool
         VolumePkgPropertiesNode,
         VolumeSelectorNode,
         VolumePropertiesNode,
+        VolumeBlockStatsNode,
         SegmentationSelectorNode,
         SegmentationPropertiesNode,
         MeshPropertiesNode,
@@ -64,7 +65,8 @@ auto RegisterNodesImpl() -> bool
         IntersectionTextureNode,
         IntegralTextureNode,
         ThicknessTextureNode,
-        LayerTextureNode
+        LayerTextureNode,
+        MultiOutputTextureNode
     >();
     // clang-format on
 
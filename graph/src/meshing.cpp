@@ -5,6 +5,7 @@
 #include "vc/core/io/MeshIO.hpp"
 #include "vc/core/util/Json.hpp"
 #include "vc/core/util/Logging.hpp"
+#include "vc/graph/MemoCache.hpp"
 #include "vc/meshing/ScaleMesh.hpp"
 
 using namespace volcart;
@@ -21,6 +22,12 @@ NLOHMANN_JSON_SERIALIZE_ENUM(ResampleMode, {
     {ResampleMode::Anisotropic, "anisotropic"}
 })
 
+using SmoothEngine = LaplacianSmooth::Engine;
+NLOHMANN_JSON_SERIALIZE_ENUM(SmoothEngine, {
+    {SmoothEngine::Native, "native"},
+    {SmoothEngine::VTK, "vtk"}
+})
+
 using ReferenceMode = OrientNormalsNode::ReferenceMode;
 NLOHMANN_JSON_SERIALIZE_ENUM(ReferenceMode , {
     {ReferenceMode::Centroid, "centroid"},
@@ -138,9 +145,13 @@ void CalculateNumVertsNode::deserialize_(
 }
 
 LaplacianSmoothMeshNode::LaplacianSmoothMeshNode()
-    : Node{true}, input{&smoother_, &Smoother::setInputMesh}, output{&mesh_}
+    : Node{true}
+    , input{&smoother_, &Smoother::setInputMesh}
+    , engine{&smoother_, &Smoother::setEngine}
+    , output{&mesh_}
 {
     registerInputPort("input", input);
+    registerInputPort("engine", engine);
     registerOutputPort("output", output);
     compute = [&]() {
         Logger()->debug("[graph.meshing] smoothing mesh");
@@ -157,7 +168,8 @@ auto LaplacianSmoothMeshNode::serialize_(
         {"featureEdgeSmoothing", smoother_.featureEdgeSmoothing()},
         {"featureAngle", smoother_.featureAngle()},
         {"edgeAngle", smoother_.edgeAngle()},
-        {"boundarySmoothing", smoother_.boundarySmoothing()}};
+        {"boundarySmoothing", smoother_.boundarySmoothing()},
+        {"engine", smoother_.engine()}};
     if (useCache and mesh_) {
         WriteMesh(cacheDir / "smoothed.obj", mesh_);
         meta["mesh"] = "smoothed.obj";
@@ -174,6 +186,11 @@ void LaplacianSmoothMeshNode::deserialize_(
     smoother_.setFeatureAngle(meta["featureAngle"].get<double>());
     smoother_.setEdgeAngle(meta["edgeAngle"].get<double>());
     smoother_.setBoundarySmoothing(meta["boundarySmoothing"].get<bool>());
+    // Graphs saved before the engine option used VTK
+    smoother_.setEngine(Smoother::Engine::VTK);
+    if (meta.contains("engine")) {
+        smoother_.setEngine(meta["engine"].get<Smoother::Engine>());
+    }
 
     if (meta.contains("mesh")) {
         auto meshFile = meta["mesh"].get<std::string>();
@@ -183,7 +200,10 @@ void LaplacianSmoothMeshNode::deserialize_(
 
 ResampleMeshNode::ResampleMeshNode()
     : Node{true}
-    , input{&acvd_, &ACVD::setInputMesh}
+    , input{[&](const auto& m) {
+        input_ = m;
+        acvd_.setInputMesh(m);
+    }}
     , mode{&acvd_, &ACVD::setMode}
     , numVertices{&acvd_, &ACVD::setNumberOfClusters}
     , gradation{&acvd_, &ACVD::setGradation}
@@ -199,10 +219,31 @@ ResampleMeshNode::ResampleMeshNode()
     registerInputPort("quadricsOptimizationLevel", quadricsOptimizationLevel);
     registerOutputPort("output", output);
     compute = [&]() {
-        Logger()->debug(
-            "[graph.meshing] resampling mesh to {} vertices",
-            acvd_.numberOfClusters());
-        mesh_ = acvd_.compute();
+        auto resample = [&]() {
+            Logger()->debug(
+                "[graph.meshing] resampling mesh to {} vertices",
+                acvd_.numberOfClusters());
+            mesh_ = acvd_.compute();
+        };
+
+        auto memo = GlobalMemoCache();
+        if (not memo) {
+            resample();
+            return;
+        }
+        auto key = MemoCache::KeyBuilder("ResampleMeshNode")
+                       .add(serialize_(false, {}))
+                       .add(input_)
+                       .key();
+        memo->memoize(
+            key,
+            [&](const fs::path& dir) {
+                mesh_ = MemoCache::LoadMesh(dir, "output");
+            },
+            resample,
+            [&](const fs::path& dir) {
+                MemoCache::SaveMesh(dir, "output", mesh_);
+            });
     };
 }
 
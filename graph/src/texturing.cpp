@@ -1,7 +1,10 @@
 #include "vc/graph/texturing.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
@@ -11,9 +14,11 @@
 #include "vc/core/io/UVMapIO.hpp"
 #include "vc/core/neighborhood/CuboidGenerator.hpp"
 #include "vc/core/neighborhood/LineGenerator.hpp"
+#include "vc/core/types/Metadata.hpp"
 #include "vc/core/types/PointSet.hpp"
 #include "vc/core/util/FloatComparison.hpp"
 #include "vc/core/util/Logging.hpp"
+#include "vc/graph/MemoCache.hpp"
 
 using namespace volcart;
 using namespace volcart::texturing;
@@ -40,6 +45,12 @@ NLOHMANN_JSON_SERIALIZE_ENUM(Direction, {
 namespace volcart::texturing
 {
 // clang-format off
+using ABFSolver = ABFNode::Solver;
+NLOHMANN_JSON_SERIALIZE_ENUM(ABFSolver, {
+    {ABFSolver::OpenABF, "openabf"},
+    {ABFSolver::Sparse, "sparse"}
+})
+
 using Shading = PPMGeneratorNode::Shading;
 NLOHMANN_JSON_SERIALIZE_ENUM(Shading, {
     {Shading::Flat, "flat"},
@@ -75,24 +86,97 @@ NLOHMANN_JSON_SERIALIZE_ENUM(ExpoDiffBaseMethod, {
     {ExpoDiffBaseMethod::Manual, "manual"}
 })
 // clang-format on
+
+void to_json(nlohmann::json& j, const ChunkedFlattening::PatchMetrics& m)
+{
+    j = {{"coreFaces", m.coreFaces},
+         {"faces", m.faces},
+         {"vertices", m.vertices},
+         {"abf", m.abf},
+         {"iterations", m.iterations},
+         {"l2", m.l2},
+         {"lInf", m.lInf},
+         {"alignmentError", m.alignmentError}};
+}
+
+void from_json(const nlohmann::json& j, ChunkedFlattening::PatchMetrics& m)
+{
+    j.at("coreFaces").get_to(m.coreFaces);
+    j.at("faces").get_to(m.faces);
+    j.at("vertices").get_to(m.vertices);
+    j.at("abf").get_to(m.abf);
+    j.at("iterations").get_to(m.iterations);
+    j.at("l2").get_to(m.l2);
+    j.at("lInf").get_to(m.lInf);
+    j.at("alignmentError").get_to(m.alignmentError);
+}
 }  // namespace volcart::texturing
 
 ABFNode::ABFNode()
     : Node{true}
-    , input{&abf_, &ABF::setMesh}
+    , input{[&](const auto& m) {
+        inputMesh_ = m;
+        abf_.setMesh(m);
+    }}
     , useABF{&abf_, &ABF::setUseABF}
+    , solver{&abf_, &ABF::setSolver}
+    , initialUVMap{[&](const auto& uv) {
+        initialUVMap_ = uv;
+        abf_.setInitialUVMap(uv);
+    }}
+    , maxPatchFaces{&abf_, &ABF::setMaxPatchFaces}
+    , patchOverlap{&abf_, &ABF::setPatchOverlap}
+    , memoryLimit{&abf_, &ABF::setMemoryLimit}
     , output{&mesh_}
     , uvMap{&uvMap_}
+    , patchMetrics{&patchMetrics_}
 {
     registerInputPort("input", input);
     registerInputPort("useABF", useABF);
+    registerInputPort("solver", solver);
+    registerInputPort("initialUVMap", initialUVMap);
+    registerInputPort("maxPatchFaces", maxPatchFaces);
+    registerInputPort("patchOverlap", patchOverlap);
+    registerInputPort("memoryLimit", memoryLimit);
     registerOutputPort("output", output);
     registerOutputPort("uvMap", uvMap);
+    registerOutputPort("patchMetrics", patchMetrics);
 
     compute = [&]() {
-        Logger()->debug("[graph.texturing] flattening mesh with ABF/LSCM");
-        mesh_ = abf_.compute();
-        uvMap_ = abf_.getUVMap();
+        auto flatten = [&]() {
+            Logger()->debug("[graph.texturing] flattening mesh with ABF/LSCM");
+            mesh_ = abf_.compute();
+            uvMap_ = abf_.getUVMap();
+            patchMetrics_ = abf_.patchMetrics();
+        };
+
+        auto memo = GlobalMemoCache();
+        if (not memo) {
+            flatten();
+            return;
+        }
+        auto key = MemoCache::KeyBuilder("ABFNode")
+                       .add(serialize_(false, {}))
+                       .add(inputMesh_)
+                       .add(initialUVMap_)
+                       .key();
+        memo->memoize(
+            key,
+            [&](const fs::path& dir) {
+                mesh_ = MemoCache::LoadMesh(dir, "output");
+                uvMap_ = UVMap::New(io::ReadUVMap(dir / "uvMap.uvm"));
+                Metadata metrics(dir / "patchMetrics.json");
+                patchMetrics_ = metrics.get<std::vector<PatchMetrics>>(
+                    "patchMetrics");
+            },
+            flatten,
+            [&](const fs::path& dir) {
+                MemoCache::SaveMesh(dir, "output", mesh_);
+                io::WriteUVMap(dir / "uvMap.uvm", *uvMap_);
+                Metadata metrics;
+                metrics.set("patchMetrics", patchMetrics_);
+                metrics.save(dir / "patchMetrics.json");
+            });
     };
 }
 
@@ -101,7 +185,11 @@ auto ABFNode::serialize_(bool useCache, const fs::path& cacheDir)
 {
     smgl::Metadata meta{
         {"useABF", abf_.useABF()},
-        {"abfMaxIterations", abf_.abfMaxIterations()}};
+        {"abfMaxIterations", abf_.abfMaxIterations()},
+        {"solver", abf_.solver()},
+        {"maxPatchFaces", abf_.maxPatchFaces()},
+        {"patchOverlap", abf_.patchOverlap()},
+        {"memoryLimit", abf_.memoryLimit()}};
 
     if (useCache and uvMap_ and not uvMap_->empty()) {
         io::WriteUVMap(cacheDir / "uvMap.uvm", *uvMap_);
@@ -116,6 +204,14 @@ void ABFNode::deserialize_(const smgl::Metadata& meta, const fs::path& cacheDir)
 {
     abf_.setUseABF(meta["useABF"].get<bool>());
     abf_.setABFMaxIterations(meta["abfMaxIterations"].get<std::size_t>());
+    if (meta.contains("solver")) {
+        abf_.setSolver(meta["solver"].get<Solver>());
+    }
+    if (meta.contains("maxPatchFaces")) {
+        abf_.setMaxPatchFaces(meta["maxPatchFaces"].get<std::size_t>());
+        abf_.setPatchOverlap(meta["patchOverlap"].get<std::size_t>());
+        abf_.setMemoryLimit(meta["memoryLimit"].get<std::size_t>());
+    }
 
     if (meta.contains("uvMap")) {
         auto file = meta["uvMap"].get<std::string>();
@@ -197,6 +293,9 @@ auto FlatteningErrorNode::serialize_(
     if (mesh3D_ and mesh2D_) {
         meta["l2"] = error_.l2;
         meta["lInf"] = error_.lInf;
+        meta["minL2"] = error_.minL2;
+        meta["maxL2"] = error_.maxL2;
+        meta["minLInf"] = error_.minLInf;
         meta["faceL2"] = error_.faceL2;
         meta["faceLInf"] = error_.faceLInf;
     }
@@ -212,8 +311,20 @@ void FlatteningErrorNode::deserialize_(
 
     error_.l2 = meta["l2"].get<double>();
     error_.lInf = meta["lInf"].get<double>();
-    error_.faceL2 = meta["faceL2"].get<std::vector<double>>();
-    error_.faceLInf = meta["faceLInf"].get<std::vector<double>>();
+    error_.faceL2 = meta["faceL2"].get<std::vector<float>>();
+    error_.faceLInf = meta["faceLInf"].get<std::vector<float>>();
+    if (meta.contains("minL2")) {
+        error_.minL2 = meta["minL2"].get<double>();
+        error_.maxL2 = meta["maxL2"].get<double>();
+        error_.minLInf = meta["minLInf"].get<double>();
+    } else if (not error_.faceL2.empty()) {
+        auto l2 = std::minmax_element(
+            error_.faceL2.begin(), error_.faceL2.end());
+        error_.minL2 = *l2.first;
+        error_.maxL2 = *l2.second;
+        error_.minLInf =
+            *std::min_element(error_.faceLInf.begin(), error_.faceLInf.end());
+    }
 }
 
 PlotLStretchErrorNode::PlotLStretchErrorNode()
@@ -273,8 +384,12 @@ void PlotLStretchErrorNode::deserialize_(
 
 PPMGeneratorNode::PPMGeneratorNode()
     : Node{true}
-    , mesh{&ppmGen_, &PPMGen::setMesh}
+    , mesh{[&](const auto& m) {
+        mesh_ = m;
+        ppmGen_.setMesh(m);
+    }}
     , uvMap{[&](const auto& uv) {
+        uvMap_ = uv;
         auto width = static_cast<std::size_t>(std::ceil(uv->ratio().width));
         auto height = static_cast<std::size_t>(std::ceil(uv->ratio().height));
         ppmGen_.setUVMap(uv);
@@ -291,8 +406,31 @@ PPMGeneratorNode::PPMGeneratorNode()
     registerInputPort("shading", shading);
     registerOutputPort("ppm", ppm);
     compute = [&]() {
-        Logger()->debug("[graph.texturing] generating PPM");
-        ppm_ = ppmGen_.compute();
+        auto generate = [&]() {
+            Logger()->debug("[graph.texturing] generating PPM");
+            ppm_ = ppmGen_.compute();
+        };
+
+        auto memo = GlobalMemoCache();
+        if (not memo) {
+            generate();
+            return;
+        }
+        auto key = MemoCache::KeyBuilder("PPMGeneratorNode")
+                       .add(serialize_(false, {}))
+                       .add(mesh_)
+                       .add(uvMap_)
+                       .key();
+        memo->memoize(
+            key,
+            [&](const fs::path& dir) {
+                ppm_ = PerPixelMap::New(
+                    PerPixelMap::ReadPPM(dir / "PerPixelMap.ppm"));
+            },
+            generate,
+            [&](const fs::path& dir) {
+                PerPixelMap::WritePPM(dir / "PerPixelMap.ppm", *ppm_);
+            });
     };
 }
 
@@ -353,12 +491,14 @@ NeighborhoodGeneratorNode::NeighborhoodGeneratorNode()
     , radius{&radius_}
     , interval{&interval_}
     , direction{&dir_}
+    , skipThreshold{&skipThreshold_}
     , generator{&gen_}
 {
     registerInputPort("shape", shape);
     registerInputPort("radius", radius);
     registerInputPort("interval", interval);
     registerInputPort("direction", direction);
+    registerInputPort("skipThreshold", skipThreshold);
     registerOutputPort("generator", generator);
 
     compute = [&]() {
@@ -372,6 +512,7 @@ NeighborhoodGeneratorNode::NeighborhoodGeneratorNode()
         gen_->setSamplingRadius(radius_);
         gen_->setSamplingInterval(interval_);
         gen_->setSamplingDirection(dir_);
+        gen_->setSkipThreshold(skipThreshold_);
     };
 }
 
@@ -383,6 +524,7 @@ auto NeighborhoodGeneratorNode::serialize_(
     meta["radius"] = {radius_[0], radius_[1], radius_[2]};
     meta["interval"] = interval_;
     meta["direction"] = dir_;
+    meta["skipThreshold"] = skipThreshold_;
     return meta;
 }
 
@@ -399,6 +541,9 @@ void NeighborhoodGeneratorNode::deserialize_(
 
     interval_ = meta["interval"].get<double>();
     dir_ = meta["direction"].get<Direction>();
+    if (meta.contains("skipThreshold")) {
+        skipThreshold_ = meta["skipThreshold"].get<std::uint16_t>();
+    }
 }
 
 CompositeTextureNode::CompositeTextureNode()
@@ -651,3 +796,68 @@ void LayerTextureNode::deserialize_(
         // texture_ = ReadImage(cacheDir / imgFile);
     }
 }
+
+MultiOutputTextureNode::MultiOutputTextureNode()
+    : Node{true}
+    , ppm{&textureGen_, &TAlgo::setPerPixelMap}
+    , volume{&textureGen_, &TAlgo::setVolume}
+    , generator{&textureGen_, &TAlgo::setGenerator}
+    , filters{&textureGen_, &TAlgo::setFilters}
+    , generateLayers{&textureGen_, &TAlgo::setGenerateLayers}
+    , textures{&textures_}
+    , layers{&layers_}
+{
+    registerInputPort("ppm", ppm);
+    registerInputPort("volume", volume);
+    registerInputPort("generator", generator);
+    registerInputPort("filters", filters);
+    registerInputPort("generateLayers", generateLayers);
+    registerOutputPort("textures", textures);
+    registerOutputPort("layers", layers);
+
+    compute = [&]() {
+        Logger()->debug("[graph.texturing] generating multi-output texture");
+        textureGen_.compute();
+        textures_ = textureGen_.filterTextures();
+        layers_ = textureGen_.layerTextures();
+    };
+}
+
+auto MultiOutputTextureNode::serialize_(
+    bool useCache, const fs::path& cacheDir) -> smgl::Metadata
+{
+    smgl::Metadata meta{
+        {"filters", textureGen_.filters()},
+        {"generateLayers", textureGen_.generateLayers()}};
+    if (useCache) {
+        auto writeList = [&](const ImageList& images, const std::string& key) {
+            std::vector<std::string> files;
+            for (std::size_t i = 0; i < images.size(); i++) {
+                files.emplace_back(key + "_" + std::to_string(i) + ".tif");
+                WriteImage(cacheDir / files.back(), images[i]);
+            }
+            meta[key] = files;
+        };
+        writeList(textures_, "textures");
+        writeList(layers_, "layers");
+    }
+    return meta;
+}
+
+void MultiOutputTextureNode::deserialize_(
+    const smgl::Metadata& meta, const fs::path& cacheDir)
+{
+    textureGen_.setFilters(meta["filters"].get<std::vector<Filter>>());
+    textureGen_.setGenerateLayers(meta["generateLayers"].get<bool>());
+
+    auto readList = [&](ImageList& images, const std::string& key) {
+        images.clear();
+        if (meta.contains(key)) {
+            for (const auto& f : meta[key].get<std::vector<std::string>>()) {
+                images.emplace_back(ReadImage(cacheDir / f));
+            }
+        }
+    };
+    readList(textures_, "textures");
+    readList(layers_, "layers");
+}
@@ -0,0 +1,282 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <smgl/Graph.hpp>
+#include <smgl/Node.hpp>
+
+#include "vc/core/filesystem.hpp"
+#include "vc/core/util/Parallel.hpp"
+#include "vc/graph/GraphExecutor.hpp"
+
+using namespace volcart;
+namespace fs = volcart::filesystem;
+
+namespace
+{
+// Names of the nodes in the order they finished
+std::mutex OrderMutex;
+std::vector<std::string> Order;
+
+// Adds its inputs and records its name when it finishes
+class AddNode : public smgl::Node
+{
+private:
+    int a_{0};
+    int b_{0};
+    int sum_{0};
+    std::string name_;
+
+public:
+    smgl::InputPort<int> a{&a_};
+    smgl::InputPort<int> b{&b_};
+    smgl::InputPort<std::string> name{&name_};
+    smgl::OutputPort<int> sum{&sum_};
+
+    // If set, waits for this many nodes to reach the barrier
+    std::atomic<int>* barrier{nullptr};
+    // Default thread count seen by the update
+    std::size_t threads{0};
+
+    AddNode()
+    {
+        registerInputPort("a", a);
+        registerInputPort("b", b);
+        registerInputPort("name", name);
+        registerOutputPort("sum", sum);
+        compute = [&]() {
+            threads = NumWorkerThreads();
+            if (barrier) {
+                ++(*barrier);
+                auto timeout = std::chrono::steady_clock::now() +
+                               std::chrono::seconds(5);
+                while (*barrier < 2 and
+                       std::chrono::steady_clock::now() < timeout) {
+                    std::this_thread::yield();
+                }
+            }
+            sum_ = a_ + b_;
+            std::unique_lock<std::mutex> lock(OrderMutex);
+            Order.push_back(name_);
+        };
+    }
+};
+
+// Always fails to update
+class FailNode : public smgl::Node
+{
+private:
+    int in_{0};
+    int out_{0};
+
+public:
+    smgl::InputPort<int> input{&in_};
+    smgl::OutputPort<int> output{&out_};
+
+    // If set, called before failing
+    std::function<void()> onUpdate;
+
+    FailNode()
+    {
+        registerInputPort("input", input);
+        registerOutputPort("output", output);
+        compute = [&]() {
+            if (onUpdate) {
+                onUpdate();
+            }
+            throw std::runtime_error("expected failure");
+        };
+    }
+};
+
+// Insert an AddNode
+auto Add(smgl::Graph& g, const std::string& name) -> std::shared_ptr<AddNode>
+{
+    auto n = g.insertNode<AddNode>();
+    n->name = name;
+    return n;
+}
+
+// Profile of every node which ran, by UUID
+auto Profiles(const GraphExecutor& executor)
+    -> std::map<std::string, GraphExecutor::NodeProfile>
+{
+    std::map<std::string, GraphExecutor::NodeProfile> profiles;
+    for (const auto& p : executor.profile()) {
+        profiles[p.uuid] = p;
+    }
+    return profiles;
+}
+
+// Seconds from the start of the update to the end of a node
+auto End(const GraphExecutor::NodeProfile& p) -> double
+{
+    return p.start + p.seconds;
+}
+}  // namespace
+
+TEST(GraphExecutor, DiamondRunsInDependencyOrder)
+{
+    for (std::size_t threads : {1, 4}) {
+        Order.clear();
+        smgl::Graph g;
+        auto src = Add(g, "src");
+        src->a = 1;
+        src->b = 0;
+        auto left = Add(g, "left");
+        left->a = src->sum;
+        left->b = 1;
+        auto right = Add(g, "right");
+        right->a = src->sum;
+        right->b = 2;
+        auto join = Add(g, "join");
+        join->a = left->sum;
+        join->b = right->sum;
+
+        GraphExecutor executor;
+        executor.setNumThreads(threads);
+        EXPECT_EQ(executor.update(g), smgl::Graph::State::Idle);
+        EXPECT_EQ(join->sum.val(), 5);
+
+        ASSERT_EQ(Order.size(), 4);
+        EXPECT_EQ(Order.front(), "src");
+        EXPECT_EQ(Order.back(), "join");
+
+        // No node starts before its upstream nodes end
+        auto profiles = Profiles(executor);
+        ASSERT_EQ(profiles.size(), 4);
+        const auto& pSrc = profiles.at(src->uuid().string());
+        const auto& pLeft = profiles.at(left->uuid().string());
+        const auto& pRight = profiles.at(right->uuid().string());
+        const auto& pJoin = profiles.at(join->uuid().string());
+        EXPECT_GE(pLeft.start, End(pSrc));
+        EXPECT_GE(pRight.start, End(pSrc));
+        EXPECT_GE(pJoin.start, End(pLeft));
+        EXPECT_GE(pJoin.start, End(pRight));
+        for (const auto& [uuid, p] : profiles) {
+            EXPECT_LT(p.thread, threads);
+        }
+    }
+}
+
+TEST(GraphExecutor, ConcurrentNodesShareThreads)
+{
+    smgl::Graph g;
+    std::atomic<int> barrier{0};
+    auto src = Add(g, "src");
+    src->a = 1;
+    auto left = Add(g, "left");
+    left->a = src->sum;
+    left->barrier = &barrier;
+    auto right = Add(g, "right");
+    right->a = src->sum;
+    right->barrier = &barrier;
+
+    GraphExecutor executor;
+    executor.setNumThreads(2);
+    ASSERT_EQ(executor.update(g), smgl::Graph::State::Idle);
+    ASSERT_EQ(barrier.load(), 2);
+
+    // A node which runs alone gets every thread. The second of two
+    // concurrent nodes gets half.
+    auto hw = NumWorkerThreads();
+    EXPECT_EQ(src->threads, hw);
+    EXPECT_EQ(std::max(left->threads, right->threads), hw);
+    EXPECT_EQ(
+        std::min(left->threads, right->threads),
+        std::max<std::size_t>(hw / 2, 1));
+    auto profiles = Profiles(executor);
+    EXPECT_EQ(profiles.at(left->uuid().string()).threadLimit, left->threads);
+
+    // The executor's limit does not leak out of the update
+    EXPECT_EQ(NumWorkerThreads(), hw);
+}
+
+TEST(GraphExecutor, FailureStopsDownstreamNodes)
+{
+    for (std::size_t threads : {1, 4}) {
+        Order.clear();
+        smgl::Graph g;
+        auto src = Add(g, "src");
+        src->a = 1;
+        auto fail = g.insertNode<FailNode>();
+        fail->input = src->sum;
+        auto after = Add(g, "after");
+        after->a = fail->output;
+
+        GraphExecutor executor;
+        executor.setNumThreads(threads);
+        EXPECT_EQ(executor.update(g), smgl::Graph::State::Error);
+        EXPECT_EQ(Order, std::vector<std::string>{"src"});
+
+        // Only the nodes which ran are profiled
+        auto profiles = Profiles(executor);
+        EXPECT_EQ(profiles.size(), 2);
+        EXPECT_EQ(profiles.count(after->uuid().string()), 0);
+    }
+}
+
+TEST(GraphExecutor, ProfileMetadata)
+{
+    smgl::Graph g;
+    auto src = Add(g, "src");
+    src->a = 1;
+    auto next = Add(g, "next");
+    next->a = src->sum;
+
+    GraphExecutor executor;
+    executor.setNumThreads(3);
+    ASSERT_EQ(executor.update(g), smgl::Graph::State::Idle);
+
+    auto meta = executor.profileMetadata();
+    EXPECT_EQ(meta["threads"].get<std::size_t>(), 3);
+    EXPECT_DOUBLE_EQ(meta["seconds"].get<double>(), executor.totalSeconds());
+    ASSERT_EQ(meta["nodes"].size(), executor.profile().size());
+    for (std::size_t i = 0; i < executor.profile().size(); i++) {
+        const auto& p = executor.profile()[i];
+        const auto& n = meta["nodes"][i];
+        EXPECT_EQ(n["uuid"].get<std::string>(), p.uuid);
+        EXPECT_DOUBLE_EQ(n["start"].get<double>(), p.start);
+        EXPECT_DOUBLE_EQ(n["seconds"].get<double>(), p.seconds);
+        EXPECT_EQ(n["thread"].get<std::size_t>(), p.thread);
+        EXPECT_EQ(n["threadLimit"].get<std::size_t>(), p.threadLimit);
+        EXPECT_TRUE(n.contains("peakRSSDelta"));
+        EXPECT_TRUE(n.contains("outputBytes"));
+    }
+}
+
+TEST(GraphExecutor, CacheSavedBeforeFailure)
+{
+    smgl::RegisterNode<AddNode, FailNode>();
+    const fs::path dir{"vc_graph_GraphExecutor_cache"};
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    smgl::Graph g;
+    g.setEnableCache(true);
+    g.setCacheFile(dir / "graph.json");
+    auto src = Add(g, "src");
+    src->a = 1;
+    auto fail = g.insertNode<FailNode>();
+    fail->input = src->sum;
+
+    // The graph is saved after each node finishes, so the cache exists
+    // before the failing node starts
+    bool saved{false};
+    fail->onUpdate = [&]() { saved = fs::exists(g.cacheFile()); };
+
+    GraphExecutor executor;
+    EXPECT_EQ(executor.update(g), smgl::Graph::State::Error);
+    EXPECT_TRUE(saved);
+    EXPECT_TRUE(fs::exists(g.cacheFile()));
+}
@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include <smgl/Graph.hpp>
+
+#include "vc/core/filesystem.hpp"
+#include "vc/core/shapes/Plane.hpp"
+#include "vc/graph/meshing.hpp"
+
+using namespace volcart;
+namespace fs = volcart::filesystem;
+
+using Engine = LaplacianSmoothMeshNode::Engine;
+
+TEST(LaplacianSmoothMeshNode, EngineIsSerialized)
+{
+    const fs::path cacheDir{"vc_graph_LaplacianSmoothMeshNode"};
+    fs::remove_all(cacheDir);
+    fs::create_directories(cacheDir);
+
+    smgl::Graph g;
+    auto node = g.insertNode<LaplacianSmoothMeshNode>();
+    node->input = shapes::Plane().itkMesh();
+    node->engine = Engine::Native;
+    ASSERT_EQ(g.update(), smgl::Graph::State::Idle);
+    ASSERT_NE(node->output.val(), nullptr);
+
+    auto settings = node->serialize(false, cacheDir);
+    EXPECT_NE(settings.dump().find("\"native\""), std::string::npos);
+
+    // The restored node reports the same engine
+    auto restored = std::make_shared<LaplacianSmoothMeshNode>();
+    restored->deserialize(settings, cacheDir);
+    auto restoredSettings = restored->serialize(false, cacheDir);
+    restoredSettings.erase("uuid");
+    settings.erase("uuid");
+    EXPECT_EQ(restoredSettings, settings);
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+
+#include "vc/core/filesystem.hpp"
+#include "vc/core/shapes/Plane.hpp"
+#include "vc/graph/MemoCache.hpp"
+
+using namespace volcart;
+namespace fs = volcart::filesystem;
+
+namespace
+{
+// Write an entry file of the given size
+void WriteBytes(const fs::path& path, std::size_t bytes)
+{
+    std::ofstream f{path.string(), std::ios::binary};
+    f << std::string(bytes, 'x');
+}
+}  // namespace
+
+TEST(MemoCache, KeysDependOnInputs)
+{
+    auto mesh = shapes::Plane(5, 5).itkMesh();
+    auto a = MemoCache::KeyBuilder("Node").add(mesh).add(1.0).key();
+    auto b = MemoCache::KeyBuilder("Node").add(mesh).add(1.0).key();
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(a.size(), 32);
+
+    auto other = MemoCache::KeyBuilder("Other").add(mesh).add(1.0).key();
+    auto param = MemoCache::KeyBuilder("Node").add(mesh).add(2.0).key();
+    ITKPoint p = mesh->GetPoint(0);
+    p[0] += 1e-9;
+    mesh->SetPoint(0, p);
+    auto input = MemoCache::KeyBuilder("Node").add(mesh).add(1.0).key();
+    EXPECT_NE(a, other);
+    EXPECT_NE(a, param);
+    EXPECT_NE(a, input);
+}
+
+TEST(MemoCache, MemoizeComputesOnce)
+{
+    const fs::path root{"vc_graph_MemoCache_memoize"};
+    fs::remove_all(root);
+    auto cache = MemoCache::New(root);
+
+    auto mesh = shapes::Plane(5, 5).itkMesh();
+    auto key = MemoCache::KeyBuilder("Node").add(mesh).key();
+    std::size_t computed{0};
+    ITKMesh::Pointer result;
+    for (int i = 0; i < 2; i++) {
+        result = nullptr;
+        cache->memoize(
+            key,
+            [&](const fs::path& dir) {
+                result = MemoCache::LoadMesh(dir, "mesh");
+            },
+            [&]() {
+                computed++;
+                result = mesh;
+            },
+            [&](const fs::path& dir) {
+                MemoCache::SaveMesh(dir, "mesh", result);
+            });
+    }
+    EXPECT_EQ(computed, 1);
+    EXPECT_EQ(cache->hits(), 1);
+    EXPECT_EQ(cache->misses(), 1);
+
+    // Loaded mesh is identical to the computed one
+    ASSERT_NE(result, mesh);
+    EXPECT_EQ(MemoCache::KeyBuilder("Node").add(result).key(), key);
+
+    fs::remove_all(root);
+}
+
+TEST(MemoCache, EvictsLeastRecentlyUsed)
+{
+    const fs::path root{"vc_graph_MemoCache_evict"};
+    fs::remove_all(root);
+    auto cache = MemoCache::New(root, 2500);
+
+    auto writer = [](const fs::path& dir) { WriteBytes(dir / "data", 1000); };
+    cache->store("a", writer);
+    cache->store("b", writer);
+    EXPECT_TRUE(cache->find("a"));
+
+    // "b" is least recently used
+    cache->store("c", writer);
+    EXPECT_TRUE(cache->find("a"));
+    EXPECT_FALSE(cache->find("b"));
+    EXPECT_TRUE(cache->find("c"));
+    EXPECT_LE(cache->size(), 2500);
+
+    // The newest entry is kept even if it exceeds the limit
+    cache->setMaxBytes(10);
+    cache->store("d", writer);
+    EXPECT_TRUE(cache->find("d"));
+    EXPECT_FALSE(cache->find("a"));
+    EXPECT_FALSE(cache->find("c"));
+
+    fs::remove_all(root);
+}
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <opencv2/core.hpp>
+#include <smgl/Graph.hpp>
+
+#include "vc/core/filesystem.hpp"
+#include "vc/core/neighborhood/LineGenerator.hpp"
+#include "vc/core/types/PerPixelMap.hpp"
+#include "vc/core/types/Volume.hpp"
+#include "vc/graph/texturing.hpp"
+#include "vc/testing/TestingUtils.hpp"
+#include "vc/texturing/MultiOutputTexture.hpp"
+
+using namespace volcart;
+namespace fs = volcart::filesystem;
+namespace vctest = volcart::testing;
+
+using Filter = MultiOutputTextureNode::Filter;
+using Texture = texturing::MultiOutputTexture::Texture;
+
+namespace
+{
+constexpr int SIZE{16};
+
+// A volume of random intensities
+auto MakeVolume(const fs::path& path) -> Volume::Pointer
+{
+    return vctest::WriteTestVolume(
+        path, {SIZE, SIZE, SIZE}, vctest::RandomSlices(910));
+}
+
+// A plane through the middle of the volume
+auto MakePPM() -> PerPixelMap::Pointer
+{
+    auto ppm = PerPixelMap::New(SIZE - 4, SIZE - 4);
+    cv::Mat mask(SIZE - 4, SIZE - 4, CV_8UC1, cv::Scalar(255));
+    for (int y = 0; y < SIZE - 4; y++) {
+        for (int x = 0; x < SIZE - 4; x++) {
+            (*ppm)(y, x) = {x + 2.5, y + 2.25, SIZE / 2.0, 0, 0, 1};
+        }
+    }
+    ppm->setMask(mask);
+    return ppm;
+}
+
+void ExpectIdentical(const Texture& actual, const Texture& expected)
+{
+    ASSERT_EQ(actual.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); i++) {
+        ASSERT_EQ(actual[i].size(), expected[i].size());
+        ASSERT_EQ(actual[i].type(), expected[i].type());
+        EXPECT_EQ(cv::countNonZero(actual[i] != expected[i]), 0);
+    }
+}
+}  // namespace
+
+TEST(MultiOutputTextureNode, SerializeRoundTrip)
+{
+    const fs::path dir{"vc_graph_MultiOutputTextureNode"};
+    auto vol = MakeVolume(dir / "volume");
+    auto line = LineGenerator::New();
+    line->setSamplingRadius(3);
+    NeighborhoodGenerator::Pointer gen = line;
+
+    smgl::Graph g;
+    auto node = g.insertNode<MultiOutputTextureNode>();
+    node->ppm = MakePPM();
+    node->volume = vol;
+    node->generator = gen;
+    node->filters = std::vector<Filter>{Filter::Median, Filter::Maximum};
+    node->generateLayers = true;
+    ASSERT_EQ(g.update(), smgl::Graph::State::Idle);
+    ASSERT_EQ(node->textures.val().size(), 2);
+    ASSERT_EQ(node->layers.val().size(), line->size());
+
+    // Restore the settings and the cached images into a new node
+    const auto cacheDir = dir / "cache";
+    fs::remove_all(cacheDir);
+    fs::create_directories(cacheDir);
+    auto meta = node->serialize(true, cacheDir);
+    auto restored = std::make_shared<MultiOutputTextureNode>();
+    restored->deserialize(meta, cacheDir);
+    ExpectIdentical(restored->textures.val(), node->textures.val());
+    ExpectIdentical(restored->layers.val(), node->layers.val());
+
+    // Without the cache, only the settings are stored and restored
+    auto settings = node->serialize(false, cacheDir);
+    auto settingsOnly = std::make_shared<MultiOutputTextureNode>();
+    settingsOnly->deserialize(settings, cacheDir);
+    EXPECT_TRUE(settingsOnly->textures.val().empty());
+    EXPECT_TRUE(settingsOnly->layers.val().empty());
+    for (const auto& n : {restored, settingsOnly}) {
+        auto restoredSettings = n->serialize(false, cacheDir);
+        auto expected = settings;
+        restoredSettings.erase("uuid");
+        expected.erase("uuid");
+        EXPECT_EQ(restoredSettings, expected);
+    }
+}
@@ -12,11 +12,24 @@ namespace volcart::meshing
 /**
  * @brief Apply Laplacian smoothing to a mesh
  *
- * A wrapper around vtkSmoothPolyDataFilter
+ * By default, smoothing is performed with vtkSmoothPolyDataFilter.
+ *
+ * Engine::Native selects a multithreaded engine which operates directly on
+ * a compressed (CSR) vertex adjacency built from the input mesh. Each
+ * iteration is a Jacobi-style update, so every vertex can be updated in
+ * parallel. Vertex classification follows that of vtkSmoothPolyDataFilter:
+ * boundary and non-manifold edges, and optionally sharp feature edges,
+ * constrain their vertices to be smoothed only along the edge, and vertices
+ * with more than two such edges or with a sharp edge angle are held fixed.
+ * Because vtkSmoothPolyDataFilter updates vertices in place, the results of
+ * the two engines differ slightly.
  */
 class LaplacianSmooth
 {
 public:
+    /** @brief Smoothing implementations */
+    enum class Engine { Native, VTK };
+
     /** @brief Set the input mesh */
     void setInputMesh(const ITKMesh::Pointer& m);
 
@@ -32,6 +45,10 @@ public:
     void setEdgeAngle(double a);
     /** @copydoc boundarySmoothing() const */
     void setBoundarySmoothing(bool b);
+    /** @copydoc engine() const */
+    void setEngine(Engine e);
+    /** @copydoc numThreads() const */
+    void setNumThreads(std::size_t n);
 
     /** @brief The number of smoothing interations */
     [[nodiscard]] auto iterations() const -> std::size_t;
@@ -45,6 +62,14 @@ public:
     [[nodiscard]] auto edgeAngle() const -> double;
     /** @brief Smoothing vertices on the mesh boundary */
     [[nodiscard]] auto boundarySmoothing() const -> bool;
+    /** @brief Smoothing implementation */
+    [[nodiscard]] auto engine() const -> Engine;
+    /**
+     * @brief Number of worker threads used by the native engine
+     *
+     * If 0 (default), uses the number of available hardware threads.
+     */
+    [[nodiscard]] auto numThreads() const -> std::size_t;
 
     /** @brief Compute the smoothed mesh */
     auto compute() -> ITKMesh::Pointer;
@@ -53,6 +78,11 @@ public:
     auto getOutputMesh() -> ITKMesh::Pointer;
 
 private:
+    /** Smooth using the native engine */
+    void compute_native_();
+    /** Smooth using vtkSmoothPolyDataFilter */
+    void compute_vtk_();
+
     /** Input mesh */
     ITKMesh::Pointer input_{nullptr};
     /** Output mesh */
@@ -69,5 +99,9 @@ private:
     double edgeAngle_{15};
     /** Smooth boundary vertices */
     bool boundarySmooth_{true};
+    /** Smoothing implementation */
+    Engine engine_{Engine::VTK};
+    /** Number of worker threads */
+    std::size_t numThreads_{0};
 };
 }  // namespace volcart::meshing
\ No newline at end of file
@@ -1,13 +1,43 @@
 #include "vc/meshing/LaplacianSmooth.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <opencv2/core.hpp>
 #include <vtkSmoothPolyDataFilter.h>
 
+#include "vc/core/types/MeshArrays.hpp"
+#include "vc/core/util/Parallel.hpp"
 #include "vc/meshing/CalculateNormals.hpp"
 #include "vc/meshing/ITK2VTK.hpp"
 
 using namespace volcart;
 using namespace volcart::meshing;
 
+namespace
+{
+/** Smoothing classification of mesh edges and vertices */
+enum class SmoothType : std::uint8_t { Simple, Edge, Fixed };
+
+/** Face edge, stored with a < b */
+struct FaceEdge {
+    std::size_t a;
+    std::size_t b;
+    std::size_t face;
+};
+
+/** Unique mesh edge, stored with a < b */
+struct UniqueEdge {
+    std::size_t a;
+    std::size_t b;
+    SmoothType type;
+};
+
+auto DegToRad(double deg) -> double { return deg * M_PI / 180.0; }
+}  // namespace
+
 void LaplacianSmooth::setInputMesh(const ITKMesh::Pointer& m) { input_ = m; }
 void LaplacianSmooth::setIterations(std::size_t i) { iters_ = i; }
 void LaplacianSmooth::setRelaxationFactor(double f) { relax_ = f; }
@@ -15,6 +45,8 @@ void LaplacianSmooth::setFeatureEdgeSmoothing(bool b) { edgeSmooth_ = b; }
 void LaplacianSmooth::setFeatureAngle(double a) { featureAngle_ = a; }
 void LaplacianSmooth::setEdgeAngle(double a) { edgeAngle_ = a; }
 void LaplacianSmooth::setBoundarySmoothing(bool b) { boundarySmooth_ = b; }
+void LaplacianSmooth::setEngine(Engine e) { engine_ = e; }
+void LaplacianSmooth::setNumThreads(std::size_t n) { numThreads_ = n; }
 
 auto LaplacianSmooth::iterations() const -> std::size_t { return iters_; }
 auto LaplacianSmooth::relaxationFactor() const -> double { return relax_; }
@@ -28,8 +60,28 @@ auto LaplacianSmooth::boundarySmoothing() const -> bool
 {
     return boundarySmooth_;
 }
+auto LaplacianSmooth::engine() const -> Engine { return engine_; }
+auto LaplacianSmooth::numThreads() const -> std::size_t { return numThreads_; }
 
 auto LaplacianSmooth::compute() -> ITKMesh::Pointer
+{
+    if (engine_ == Engine::VTK) {
+        compute_vtk_();
+    } else {
+        compute_native_();
+    }
+
+    // Recalculate the normals on the mesh
+    CalculateNormals normals;
+    normals.setMesh(output_);
+    output_ = normals.compute();
+
+    return output_;
+}
+
+auto LaplacianSmooth::getOutputMesh() -> ITKMesh::Pointer { return output_; }
+
+void LaplacianSmooth::compute_vtk_()
 {
     auto vtkMesh = ITK2VTK(input_);
     auto smoother = vtkSmartPointer<vtkSmoothPolyDataFilter>::New();
@@ -42,13 +94,201 @@ auto LaplacianSmooth::compute() -> ITKMesh::Pointer
     smoother->SetBoundarySmoothing(static_cast<vtkTypeBool>(boundarySmooth_));
     smoother->Update();
     output_ = VTK2ITK(smoother->GetOutput());
+}
 
-    // Recalculate the normals on the mesh
-    CalculateNormals normals;
-    normals.setMesh(output_);
-    output_ = normals.compute();
+void LaplacianSmooth::compute_native_()
+{
+    // Copy the vertices and faces into contiguous storage
+    auto arrays = ToMeshArrays(input_);
+    auto& pts = arrays.vertices;
+    const auto& faces = arrays.faces;
+    auto numPts = pts.size();
 
-    return output_;
-}
+    // Face normals are only needed to detect feature edges
+    std::vector<cv::Vec3d> faceNormals;
+    if (edgeSmooth_) {
+        faceNormals.resize(faces.size());
+        ParallelFor(
+            0, faces.size(),
+            [&](std::size_t f) {
+                const auto& v = faces[f];
+                auto n = (pts[v[1]] - pts[v[0]]).cross(pts[v[2]] - pts[v[0]]);
+                auto len = cv::norm(n);
+                faceNormals[f] = (len > 0) ? n / len : n;
+            },
+            numThreads_);
+    }
 
-auto LaplacianSmooth::getOutputMesh() -> ITKMesh::Pointer { return output_; }
+    // Bucket the face edges by their smallest vertex ID (counting sort)
+    std::vector<std::size_t> bucketOffsets(numPts + 1, 0);
+    for (const auto& f : faces) {
+        for (std::size_t i = 0; i < 3; i++) {
+            auto a = f[i];
+            auto b = f[(i + 1) % 3];
+            if (a != b) {
+                bucketOffsets[std::min(a, b) + 1]++;
+            }
+        }
+    }
+    for (std::size_t v = 0; v < numPts; v++) {
+        bucketOffsets[v + 1] += bucketOffsets[v];
+    }
+    std::vector<FaceEdge> faceEdges(bucketOffsets.back());
+    std::vector<std::size_t> cursor(bucketOffsets.begin(), bucketOffsets.end());
+    for (std::size_t fIdx = 0; fIdx < faces.size(); fIdx++) {
+        const auto& f = faces[fIdx];
+        for (std::size_t i = 0; i < 3; i++) {
+            auto a = f[i];
+            auto b = f[(i + 1) % 3];
+            if (a != b) {
+                auto lo = std::min(a, b);
+                faceEdges[cursor[lo]++] = {lo, std::max(a, b), fIdx};
+            }
+        }
+    }
+
+    // Sort within each bucket so that duplicate edges are adjacent
+    ParallelFor(
+        0, numPts,
+        [&](std::size_t v) {
+            std::sort(
+                faceEdges.begin() + bucketOffsets[v],
+                faceEdges.begin() + bucketOffsets[v + 1],
+                [](const auto& l, const auto& r) { return l.b < r.b; });
+        },
+        numThreads_);
+
+    // Classify the unique edges
+    auto cosFeature = std::cos(DegToRad(featureAngle_));
+    std::vector<UniqueEdge> edges;
+    edges.reserve(faceEdges.size() / 2 + 1);
+    for (auto first = faceEdges.begin(); first != faceEdges.end();) {
+        auto last = first + 1;
+        while (last != faceEdges.end() and last->a == first->a and
+               last->b == first->b) {
+            ++last;
+        }
+
+        // Boundary and non-manifold edges
+        auto type = SmoothType::Simple;
+        if (last - first != 2) {
+            type = boundarySmooth_ ? SmoothType::Edge : SmoothType::Fixed;
+        }
+        // Sharp feature edges
+        else if (
+            edgeSmooth_ and faceNormals[first->face].dot(
+                                faceNormals[(first + 1)->face]) <= cosFeature) {
+            type = SmoothType::Edge;
+        }
+        edges.push_back({first->a, first->b, type});
+        first = last;
+    }
+    std::vector<FaceEdge>().swap(faceEdges);
+    std::vector<std::size_t>().swap(bucketOffsets);
+    std::vector<std::size_t>().swap(cursor);
+
+    // Classify the vertices. Vertices on constrained edges are only smoothed
+    // along those edges.
+    std::vector<SmoothType> vertTypes(numPts, SmoothType::Simple);
+    std::vector<std::size_t> simpleCnt(numPts, 0);
+    std::vector<std::size_t> edgeCnt(numPts, 0);
+    for (const auto& e : edges) {
+        if (e.type == SmoothType::Fixed) {
+            vertTypes[e.a] = vertTypes[e.b] = SmoothType::Fixed;
+        } else if (e.type == SmoothType::Edge) {
+            edgeCnt[e.a]++;
+            edgeCnt[e.b]++;
+        } else {
+            simpleCnt[e.a]++;
+            simpleCnt[e.b]++;
+        }
+    }
+
+    // Build the CSR adjacency of smoothing neighbors
+    std::vector<std::size_t> offsets(numPts + 1, 0);
+    for (std::size_t v = 0; v < numPts; v++) {
+        auto& type = vertTypes[v];
+        if (type != SmoothType::Fixed and edgeCnt[v] > 0) {
+            type = (edgeCnt[v] == 2) ? SmoothType::Edge : SmoothType::Fixed;
+        }
+
+        std::size_t cnt{0};
+        if (type == SmoothType::Edge) {
+            cnt = edgeCnt[v];
+        } else if (type == SmoothType::Simple) {
+            cnt = simpleCnt[v];
+        }
+        offsets[v + 1] = offsets[v] + cnt;
+    }
+    std::vector<std::size_t>().swap(simpleCnt);
+    std::vector<std::size_t>().swap(edgeCnt);
+
+    std::vector<std::size_t> neighbors(offsets.back());
+    cursor.assign(offsets.begin(), offsets.end() - 1);
+    auto addNeighbor = [&](std::size_t v, std::size_t n, SmoothType t) {
+        if (vertTypes[v] != SmoothType::Fixed and vertTypes[v] == t) {
+            neighbors[cursor[v]++] = n;
+        }
+    };
+    for (const auto& e : edges) {
+        addNeighbor(e.a, e.b, e.type);
+        addNeighbor(e.b, e.a, e.type);
+    }
+    std::vector<UniqueEdge>().swap(edges);
+    std::vector<std::size_t>().swap(cursor);
+
+    // Fix edge vertices at sharp corners
+    auto cosEdge = std::cos(DegToRad(edgeAngle_));
+    ParallelFor(
+        0, numPts,
+        [&](std::size_t v) {
+            if (vertTypes[v] != SmoothType::Edge) {
+                return;
+            }
+            cv::Vec3d l1 = pts[v] - pts[neighbors[offsets[v]]];
+            cv::Vec3d l2 = pts[neighbors[offsets[v] + 1]] - pts[v];
+            auto n1 = cv::norm(l1);
+            auto n2 = cv::norm(l2);
+            if (n1 > 0 and n2 > 0 and l1.dot(l2) / (n1 * n2) < cosEdge) {
+                vertTypes[v] = SmoothType::Fixed;
+            }
+        },
+        numThreads_);
+
+    // Jacobi iterations: every vertex reads from the previous iteration's
+    // positions, so all vertices can be updated in parallel
+    std::vector<cv::Vec3d> next(numPts);
+    for (std::size_t it = 0; it < iters_; it++) {
+        ParallelFor(
+            0, numPts,
+            [&](std::size_t v) {
+                auto b = offsets[v];
+                auto e = offsets[v + 1];
+                if (vertTypes[v] == SmoothType::Fixed or b == e) {
+                    next[v] = pts[v];
+                    return;
+                }
+                cv::Vec3d avg{0, 0, 0};
+                for (auto n = b; n < e; n++) {
+                    avg += pts[neighbors[n]];
+                }
+                avg /= static_cast<double>(e - b);
+                next[v] = pts[v] + relax_ * (avg - pts[v]);
+            },
+            numThreads_);
+        std::swap(pts, next);
+    }
+
+    // Construct the output mesh
+    output_ = ITKMesh::New();
+    DeepCopy(input_, output_, false, true);
+    ITKPoint p;
+    for (auto pt = input_->GetPoints()->Begin();
+         pt != input_->GetPoints()->End(); ++pt) {
+        const auto& v = pts[pt.Index()];
+        p[0] = v[0];
+        p[1] = v[1];
+        p[2] = v[2];
+        output_->SetPoint(pt.Index(), p);
+    }
+}
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "vc/core/shapes/Arch.hpp"
+#include "vc/core/shapes/Cone.hpp"
+#include "vc/core/shapes/Plane.hpp"
+#include "vc/meshing/LaplacianSmooth.hpp"
+
+using namespace volcart;
+using namespace volcart::shapes;
+using namespace volcart::meshing;
+
+namespace
+{
+// Smooth a mesh with both engines and check that the native result is
+// within a small fraction of the VTK displacement of every vertex
+void ExpectEnginesAgree(const ITKMesh::Pointer& input, LaplacianSmooth& s)
+{
+    s.setInputMesh(input);
+    s.setEngine(LaplacianSmooth::Engine::VTK);
+    auto vtk = s.compute();
+    s.setEngine(LaplacianSmooth::Engine::Native);
+    auto native = s.compute();
+    ASSERT_EQ(native->GetNumberOfPoints(), vtk->GetNumberOfPoints());
+
+    // VTK updates vertices in place while the native engine uses Jacobi
+    // updates, so the results differ by a small, second-order amount
+    double maxMoved{0};
+    double maxDiff{0};
+    for (auto it = input->GetPoints()->Begin(); it != input->GetPoints()->End();
+         ++it) {
+        auto orig = it->Value();
+        auto v = vtk->GetPoint(it.Index());
+        auto n = native->GetPoint(it.Index());
+        maxMoved = std::max(maxMoved, orig.EuclideanDistanceTo(v));
+        maxDiff = std::max(maxDiff, n.EuclideanDistanceTo(v));
+    }
+    ASSERT_GT(maxMoved, 0);
+    EXPECT_LE(maxDiff, 0.1 * maxMoved);
+}
+}  // namespace
+
+TEST(LaplacianSmooth, NativeZeroIterations)
+{
+    auto input = Arch().itkMesh();
+
+    LaplacianSmooth smoother;
+    smoother.setEngine(LaplacianSmooth::Engine::Native);
+    smoother.setInputMesh(input);
+    smoother.setIterations(0);
+    auto output = smoother.compute();
+
+    EXPECT_EQ(output->GetNumberOfPoints(), input->GetNumberOfPoints());
+    EXPECT_EQ(output->GetNumberOfCells(), input->GetNumberOfCells());
+    for (auto it = input->GetPoints()->Begin(); it != input->GetPoints()->End();
+         ++it) {
+        auto expected = it->Value();
+        auto result = output->GetPoint(it.Index());
+        EXPECT_DOUBLE_EQ(result[0], expected[0]);
+        EXPECT_DOUBLE_EQ(result[1], expected[1]);
+        EXPECT_DOUBLE_EQ(result[2], expected[2]);
+    }
+}
+
+TEST(LaplacianSmooth, NativePlaneStaysPlanar)
+{
+    auto input = Plane(10, 10).itkMesh();
+
+    LaplacianSmooth smoother;
+    smoother.setEngine(LaplacianSmooth::Engine::Native);
+    smoother.setInputMesh(input);
+    smoother.setIterations(50);
+    smoother.setRelaxationFactor(0.5);
+    auto output = smoother.compute();
+
+    for (auto it = output->GetPoints()->Begin();
+         it != output->GetPoints()->End(); ++it) {
+        EXPECT_DOUBLE_EQ(it->Value()[1], 0);
+    }
+}
+
+TEST(LaplacianSmooth, NativeFixedBoundary)
+{
+    static constexpr double MAX_COORD{9};
+    auto input = Plane(10, 10).itkMesh();
+
+    LaplacianSmooth smoother;
+    smoother.setEngine(LaplacianSmooth::Engine::Native);
+    smoother.setInputMesh(input);
+    smoother.setIterations(20);
+    smoother.setRelaxationFactor(0.5);
+    smoother.setBoundarySmoothing(false);
+    auto output = smoother.compute();
+
+    for (auto it = input->GetPoints()->Begin(); it != input->GetPoints()->End();
+         ++it) {
+        auto expected = it->Value();
+        auto onBoundary = expected[0] == 0 or expected[0] == MAX_COORD or
+                          expected[2] == 0 or expected[2] == MAX_COORD;
+        if (onBoundary) {
+            auto result = output->GetPoint(it.Index());
+            EXPECT_DOUBLE_EQ(result[0], expected[0]);
+            EXPECT_DOUBLE_EQ(result[2], expected[2]);
+        }
+    }
+}
+
+TEST(LaplacianSmooth, NativeThreadCountInvariant)
+{
+    auto input = Arch().itkMesh();
+
+    LaplacianSmooth smoother;
+    smoother.setEngine(LaplacianSmooth::Engine::Native);
+    smoother.setInputMesh(input);
+    smoother.setIterations(10);
+    smoother.setRelaxationFactor(0.2);
+    smoother.setFeatureEdgeSmoothing(true);
+    smoother.setNumThreads(1);
+    auto expected = smoother.compute();
+    smoother.setNumThreads(4);
+    auto result = smoother.compute();
+
+    for (auto it = expected->GetPoints()->Begin();
+         it != expected->GetPoints()->End(); ++it) {
+        auto r = result->GetPoint(it.Index());
+        EXPECT_DOUBLE_EQ(r[0], it->Value()[0]);
+        EXPECT_DOUBLE_EQ(r[1], it->Value()[1]);
+        EXPECT_DOUBLE_EQ(r[2], it->Value()[2]);
+    }
+}
+
+TEST(LaplacianSmooth, DefaultEngineIsVTK)
+{
+    EXPECT_EQ(LaplacianSmooth().engine(), LaplacianSmooth::Engine::VTK);
+}
+
+TEST(LaplacianSmooth, NativeMatchesVTKWithBoundaries)
+{
+    // Open surface: boundary vertices are smoothed along the boundary
+    LaplacianSmooth smoother;
+    smoother.setIterations(20);
+    smoother.setRelaxationFactor(0.05);
+    ExpectEnginesAgree(Arch(20, 20).itkMesh(), smoother);
+
+    // Fixed boundary
+    smoother.setBoundarySmoothing(false);
+    ExpectEnginesAgree(Arch(20, 20).itkMesh(), smoother);
+}
+
+TEST(LaplacianSmooth, NativeMatchesVTKWithFeatureEdges)
+{
+    // The rim of a closed cone is a sharp feature edge
+    LaplacianSmooth smoother;
+    smoother.setIterations(20);
+    smoother.setRelaxationFactor(0.05);
+    smoother.setFeatureEdgeSmoothing(true);
+    smoother.setFeatureAngle(45);
+    ExpectEnginesAgree(Cone(2, 5, 3).itkMesh(), smoother);
+}
@@ -5,11 +5,13 @@
 #include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <vector>
 
 #include "vc/core/types/Mixins.hpp"
 #include "vc/core/types/PointSet.hpp"
 #include "vc/core/types/Volume.hpp"
 #include "vc/core/types/VolumetricMask.hpp"
+#include "vc/core/util/Signals.hpp"
 
 namespace volcart::segmentation
 {
@@ -21,6 +23,11 @@ namespace volcart::segmentation
  * compute a per-voxel mask for a segmented layer in a volume. For each slice
  * in the Z-range of the input PointSet, the points which intersect that slice
  * are used as the seeds for running the flood fill algorithm.
+ *
+ * The voxels of each slice's mask are emitted by sliceMasked as soon as the
+ * slice is computed. Masks of large segmentations can be streamed to disk by
+ * connecting to this signal and disabling setStoreMask(), which keeps the
+ * full VolumetricMask from being held in memory.
  */
 class ComputeVolumetricMask : public IterationsProgress
 {
@@ -28,6 +35,12 @@ public:
     /** PointSet type */
     using PointSet = volcart::PointSet<cv::Vec3d>;
 
+    /**
+     * @brief Emitted with the slice index and the unique mask voxels of each
+     * slice, in row-major order
+     */
+    Signal<std::size_t, const std::vector<cv::Vec3i>&> sliceMasked;
+
     /** @brief Set the input PointSet */
     void setPointSet(const PointSet& ps);
 
@@ -62,6 +75,12 @@ public:
      */
     void setMaxRadius(std::size_t radius);
 
+    /**
+     * @brief If disabled, the mask voxels are only emitted by sliceMasked and
+     * the VolumetricMask returned by compute() is empty. Default: enabled
+     */
+    void setStoreMask(bool b);
+
     /** @brief Computes the segmentation. */
     VolumetricMask::Pointer compute();
 
@@ -88,6 +107,8 @@ private:
     bool measureVertically_{false};
     /** Maximum layer thickness to consider for a single seed point */
     std::size_t maxRadius_{std::numeric_limits<std::size_t>::max()};
+    /** Store the mask voxels in mask_ */
+    bool storeMask_{true};
     /** Mask */
     VolumetricMask::Pointer mask_;
 };
@@ -37,6 +37,14 @@ public:
     /** Pointer */
     using Pointer = std::shared_ptr<LocalResliceSegmentation>;
 
+    /** @brief Chain energy minimized when choosing the next positions */
+    enum class Energy {
+        /** EnergyMetrics::TotalEnergy() of a refit FittedCurve */
+        Refit,
+        /** Incrementally updated ChainEnergy. Faster on long chains. */
+        Incremental
+    };
+
     /** @brief Default constructor */
     LocalResliceSegmentation() = default;
 
@@ -63,9 +71,23 @@ public:
     /** @brief Get the target z-index */
     int getTargetZIndex() { return endIndex_; }
 
-    /** @brief Set the number of curve optimization iterations per step */
+    /**
+     * @brief Set the number of curve optimization iterations per step
+     *
+     * With Energy::Incremental, this is the maximum number of sweeps, each of
+     * which tries every candidate position of every particle.
+     */
     void setOptimizationIterations(int n) { numIters_ = n; }
 
+    /**
+     * @brief Set the chain energy used by the optimization
+     *
+     * Default: Energy::Refit
+     *
+     * @see OptimizeChainRefit(), OptimizeChainIncremental()
+     */
+    void setEnergy(Energy e) { energy_ = e; }
+
     /**
      * @brief Set the weight for the Active Contour metric
      * @see double ActiveContourInternal()
@@ -113,6 +135,15 @@ public:
      */
     void setConsiderPrevious(bool b) { considerPrevious_ = b; }
 
+    /**
+     * @brief Set the number of threads used to generate candidate positions
+     *
+     * The normal estimation, reslicing, and maxima search of each particle
+     * are independent and are distributed across this many threads. If 0,
+     * uses all hardware threads. Default: 1
+     */
+    void setNumThreads(std::size_t n) { numThreads_ = n; }
+
     /** @brief Compute the segmentation */
     auto compute() -> PointSet override;
 
@@ -178,9 +209,13 @@ private:
     bool visualize_{false};
     /** Number of curve optimization iterations */
     int numIters_{15};
+    /** Chain energy */
+    Energy energy_{Energy::Refit};
     /** Estimated material thickness in um */
     double materialThickness_{100};
     /** Window size for reslice */
     int resliceSize_{32};
+    /** Number of candidate generation threads */
+    std::size_t numThreads_{1};
 };
 }  // namespace volcart::segmentation
\ No newline at end of file
@@ -0,0 +1,104 @@
+#pragma once
+
+/** @file */
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "vc/segmentation/lrps/Common.hpp"
+
+namespace volcart::segmentation
+{
+/**
+ * @class ChainEnergy
+ * @brief Energy of a particle chain which can be updated one particle at a
+ * time
+ *
+ * Evaluates the metrics of EnergyMetrics::TotalEnergy() directly on the
+ * particle positions of a chain: the active contour internal energy, the
+ * absolute curvature, and the windowed arc length (window size 3). Every
+ * metric is a sum of per-particle terms, and the term of a particle only
+ * depends on the particles within two positions of it. Moving a single
+ * particle therefore only re-evaluates five terms, regardless of the length
+ * of the chain.
+ *
+ * EnergyMetrics min-max normalizes its terms across the whole chain, which
+ * makes every term depend on every particle. Instead, ChainEnergy makes the
+ * terms scale invariant by measuring distances in units of a fixed reference
+ * spacing, usually the particle spacing of the previous, evenly spaced
+ * chain. Chains with fewer than three particles have zero energy.
+ *
+ * @ingroup lrps
+ */
+class ChainEnergy
+{
+public:
+    /**
+     * @brief Construct the energy of a chain
+     *
+     * @param vs Particle positions
+     * @param spacing Reference distance between neighboring particles
+     * @param alpha Active contour internal energy total weight factor
+     * @param k1 Active contour stretch weight factor
+     * @param k2 Active contour curvature weight factor
+     * @param beta Absolute curvature total weight factor
+     * @param delta Windowed arc length total weight factor
+     * @throws std::invalid_argument if spacing is not positive
+     */
+    ChainEnergy(
+        std::vector<Voxel> vs,
+        double spacing,
+        double alpha,
+        double k1,
+        double k2,
+        double beta,
+        double delta);
+
+    /** @brief Get the current particle positions */
+    [[nodiscard]] auto points() const -> const std::vector<Voxel>&;
+
+    /** @brief Get the number of particles */
+    [[nodiscard]] auto size() const -> std::size_t;
+
+    /** @brief Get the mean energy of the chain */
+    [[nodiscard]] auto total() const -> double;
+
+    /**
+     * @brief Get the change in total() if particle i were moved to v
+     *
+     * Only re-evaluates the terms affected by particle i.
+     */
+    [[nodiscard]] auto moveDelta(std::size_t i, const Voxel& v) -> double;
+
+    /** @brief Move particle i to v and update the energy */
+    void move(std::size_t i, const Voxel& v);
+
+private:
+    /** Energy term of the particle at index i */
+    [[nodiscard]] auto term_(std::size_t i) const -> double;
+
+    /** First and last index of the terms affected by particle i */
+    [[nodiscard]] auto affected_range_(std::size_t i) const
+        -> std::pair<std::size_t, std::size_t>;
+
+    /** Particle positions */
+    std::vector<Voxel> vs_;
+    /** Per-particle energy terms */
+    std::vector<double> terms_;
+    /** Sum of terms_ */
+    double sum_{0};
+    /** Reference spacing */
+    double spacing_;
+    /** Internal energy weight */
+    double alpha_;
+    /** Stretch weight */
+    double k1_;
+    /** Curvature weight */
+    double k2_;
+    /** Abs. curvature weight */
+    double beta_;
+    /** Arc length weight */
+    double delta_;
+};
+}  // namespace volcart::segmentation
@@ -0,0 +1,99 @@
+#pragma once
+
+/** @file */
+
+#include <deque>
+#include <vector>
+
+#include "vc/segmentation/lrps/Common.hpp"
+
+namespace volcart::segmentation
+{
+/**
+ * @brief Candidate positions for each particle of a chain, in order of
+ * preference
+ *
+ * @ingroup lrps
+ */
+using ChainCandidates = std::vector<std::deque<Voxel>>;
+
+/**
+ * @brief Choose the next position of each particle by refitting the chain
+ *
+ * Every particle starts at its first candidate. Each iteration takes the
+ * particle which is farthest from its current position and tries each of its
+ * remaining candidates in order. A candidate is kept if it lowers
+ * EnergyMetrics::TotalEnergy() of a FittedCurve refit through the candidate
+ * chain. Stops after maxIters iterations or when the change in energy levels
+ * off.
+ *
+ * Every candidate refits and evaluates the whole chain, so the cost of an
+ * iteration is proportional to the length of the chain.
+ *
+ * @ingroup lrps
+ *
+ * @param currentVs Current particle positions
+ * @param candidates Candidate positions of each particle. Every particle must
+ * have at least one candidate.
+ * @param zIndex Z-index of the candidate chain
+ * @param maxIters Maximum number of iterations
+ * @param minEnergyGradient Minimum change in energy between iterations
+ * @param alpha Active contour internal energy total weight factor
+ * @param k1 Active contour stretch weight factor
+ * @param k2 Active contour curvature weight factor
+ * @param beta Absolute curvature total weight factor
+ * @param delta Windowed arc length total weight factor
+ * @return Index of the chosen candidate of each particle
+ */
+auto OptimizeChainRefit(
+    const std::vector<Voxel>& currentVs,
+    const ChainCandidates& candidates,
+    int zIndex,
+    int maxIters,
+    double minEnergyGradient,
+    double alpha,
+    double k1,
+    double k2,
+    double beta,
+    double delta) -> std::vector<int>;
+
+/**
+ * @brief Choose the next position of each particle with an incrementally
+ * updated ChainEnergy
+ *
+ * Every particle starts at its first candidate. Each sweep visits the
+ * particles in order of decreasing distance from their current positions and
+ * moves each one to the candidate which lowers the ChainEnergy the most.
+ * Stops after maxIters sweeps, after a sweep which moves no particle, or
+ * when the change in energy levels off.
+ *
+ * ChainEnergy measures distances relative to the mean particle spacing of
+ * currentVs rather than min-max normalizing its terms like EnergyMetrics.
+ * Evaluating a candidate is constant time, but the chosen chain may differ
+ * from that of OptimizeChainRefit().
+ *
+ * @ingroup lrps
+ *
+ * @param currentVs Current, evenly spaced particle positions
+ * @param candidates Candidate positions of each particle. Every particle must
+ * have at least one candidate.
+ * @param maxIters Maximum number of sweeps
+ * @param minEnergyGradient Minimum change in energy between sweeps
+ * @param alpha Active contour internal energy total weight factor
+ * @param k1 Active contour stretch weight factor
+ * @param k2 Active contour curvature weight factor
+ * @param beta Absolute curvature total weight factor
+ * @param delta Windowed arc length total weight factor
+ * @return Index of the chosen candidate of each particle
+ */
+auto OptimizeChainIncremental(
+    const std::vector<Voxel>& currentVs,
+    const ChainCandidates& candidates,
+    int maxIters,
+    double minEnergyGradient,
+    double alpha,
+    double k1,
+    double k2,
+    double beta,
+    double delta) -> std::vector<int>;
+}  // namespace volcart::segmentation
@@ -0,0 +1,119 @@
+#include "vc/segmentation/lrps/ChainEnergy.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "vc/segmentation/lrps/Derivative.hpp"
+
+using namespace volcart::segmentation;
+
+// Terms depend on particles up to this many positions away, the width of the
+// five-point derivative stencils
+static constexpr std::size_t TERM_RADIUS{2};
+
+ChainEnergy::ChainEnergy(
+    std::vector<Voxel> vs,
+    double spacing,
+    double alpha,
+    double k1,
+    double k2,
+    double beta,
+    double delta)
+    : vs_{std::move(vs)}
+    , spacing_{spacing}
+    , alpha_{alpha}
+    , k1_{k1}
+    , k2_{k2}
+    , beta_{beta}
+    , delta_{delta}
+{
+    if (not(spacing_ > 0)) {
+        throw std::invalid_argument("reference spacing must be positive");
+    }
+
+    terms_.resize(vs_.size());
+    for (std::size_t i = 0; i < vs_.size(); i++) {
+        terms_[i] = term_(i);
+        sum_ += terms_[i];
+    }
+}
+
+auto ChainEnergy::points() const -> const std::vector<Voxel>& { return vs_; }
+
+auto ChainEnergy::size() const -> std::size_t { return vs_.size(); }
+
+auto ChainEnergy::total() const -> double
+{
+    if (vs_.empty()) {
+        return 0;
+    }
+    return sum_ / static_cast<double>(vs_.size());
+}
+
+auto ChainEnergy::moveDelta(std::size_t i, const Voxel& v) -> double
+{
+    auto old = vs_[i];
+    vs_[i] = v;
+    double delta{0};
+    auto [first, last] = affected_range_(i);
+    for (auto k = first; k <= last; k++) {
+        delta += term_(k) - terms_[k];
+    }
+    vs_[i] = old;
+    return delta / static_cast<double>(vs_.size());
+}
+
+void ChainEnergy::move(std::size_t i, const Voxel& v)
+{
+    vs_[i] = v;
+    auto [first, last] = affected_range_(i);
+    for (auto k = first; k <= last; k++) {
+        auto t = term_(k);
+        sum_ += t - terms_[k];
+        terms_[k] = t;
+    }
+}
+
+auto ChainEnergy::affected_range_(std::size_t i) const
+    -> std::pair<std::size_t, std::size_t>
+{
+    auto first = (i > TERM_RADIUS) ? i - TERM_RADIUS : 0;
+    auto last = std::min(i + TERM_RADIUS, vs_.size() - 1);
+    return {first, last};
+}
+
+auto ChainEnergy::term_(std::size_t i) const -> double
+{
+    if (vs_.size() < 3) {
+        return 0;
+    }
+    auto idx = static_cast<int>(i);
+    auto last = vs_.size() - 1;
+
+    // Derivatives in units of the reference spacing
+    Voxel d1 = D1At(vs_, idx) / spacing_;
+    Voxel d2 = D2At(vs_, idx) / spacing_;
+
+    // Active contour internal energy
+    auto internal = 0.5 * (k1_ * d1.dot(d1) + k2_ * d2.dot(d2));
+
+    // Curvature in the slice plane, relative to the reference spacing
+    double curvature{0};
+    auto speed = std::sqrt(d1[0] * d1[0] + d1[1] * d1[1]);
+    if (speed > 0) {
+        curvature = std::abs(d1[0] * d2[1] - d1[1] * d2[0]) /
+                    (speed * speed * speed);
+    }
+
+    // Arc length of the segments on either side of the particle. The end
+    // particles reflect their only segment, like
+    // EnergyMetrics::LocalWindowedArcLength().
+    auto before = (i > 0) ? cv::norm(vs_[i], vs_[i - 1])
+                          : cv::norm(vs_[1], vs_[0]);
+    auto after = (i < last) ? cv::norm(vs_[i + 1], vs_[i])
+                            : cv::norm(vs_[last], vs_[last - 1]);
+    auto arcLength = (before + after) / spacing_;
+
+    return alpha_ * internal + beta_ * curvature + delta_ * arcLength;
+}
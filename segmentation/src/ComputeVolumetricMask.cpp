@@ -30,6 +30,8 @@ void ComputeVolumetricMask::setMaxRadius(std::size_t radius)
     maxRadius_ = radius;
 }
 
+void ComputeVolumetricMask::setStoreMask(bool b) { storeMask_ = b; }
+
 auto ComputeVolumetricMask::compute() -> VolumetricMask::Pointer
 {
     // Setup the output
@@ -82,27 +84,35 @@ auto ComputeVolumetricMask::compute() -> VolumetricMask::Pointer
         // Do flood-fill with the given seed points to the estimated thickness.
         auto sliceMask = DoFloodFill(seedPoints, bound, slice, low_, high_);
 
+        // Convert the mask to a binary image. This merges the duplicate
+        // voxels produced by duplicate seeds.
+        cv::Mat binaryImg = cv::Mat::zeros(slice.size(), CV_8UC1);
+        for (const Voxel& v : sliceMask) {
+            binaryImg.at<std::uint8_t>(v[1], v[0]) = 255;
+        }
+
         // Apply closing to fill holes and gaps.
         if (enableClosing_) {
-            // Convert mask to a binary image so we can apply closing
-            cv::Mat binaryImg = cv::Mat::zeros(slice.size(), CV_8UC1);
-            for (const Voxel& v : sliceMask) {
-                binaryImg.at<std::uint8_t>(v[1], v[0]) = 255;
-            }
-
             cv::Mat kernel = cv::Mat::ones(kernel_, kernel_, CV_8U);
             cv::Mat closedImg;
             cv::morphologyEx(binaryImg, closedImg, cv::MORPH_CLOSE, kernel);
+            binaryImg = closedImg;
+        }
 
-            // Save to the full volume mask
-            for (const auto p : range2D(closedImg.rows, closedImg.cols)) {
-                const auto& x = p.second;
-                const auto& y = p.first;
-                if (closedImg.at<std::uint8_t>(y, x) > 0) {
-                    mask_->setIn({x, y, zIndex});
-                }
+        // Replace the slice mask with the unique voxels of the image
+        sliceMask.clear();
+        auto z = static_cast<int>(zIndex);
+        for (const auto p : range2D(binaryImg.rows, binaryImg.cols)) {
+            const auto& x = p.second;
+            const auto& y = p.first;
+            if (binaryImg.at<std::uint8_t>(y, x) > 0) {
+                sliceMask.emplace_back(x, y, z);
             }
-        } else {
+        }
+
+        // Report and save to the full volume mask
+        sliceMasked(zIndex, sliceMask);
+        if (storeMask_) {
             mask_->setIn(sliceMask);
         }
     }
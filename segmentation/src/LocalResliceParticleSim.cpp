@@ -3,6 +3,7 @@
 #include <iomanip>
 #include <limits>
 #include <list>
+#include <optional>
 #include <tuple>
 
 #include <opencv2/core.hpp>
@@ -12,12 +13,13 @@
 
 #include "vc/core/filesystem.hpp"
 #include "vc/core/math/StructureTensor.hpp"
+#include "vc/core/util/Parallel.hpp"
 #include "vc/segmentation/LocalResliceParticleSim.hpp"
 #include "vc/segmentation/lrps/Common.hpp"
 #include "vc/segmentation/lrps/Derivative.hpp"
-#include "vc/segmentation/lrps/EnergyMetrics.hpp"
 #include "vc/segmentation/lrps/FittedCurve.hpp"
 #include "vc/segmentation/lrps/IntensityMap.hpp"
+#include "vc/segmentation/lrps/OptimizeChain.hpp"
 
 using namespace volcart::segmentation;
 namespace fs = volcart::filesystem;
@@ -107,128 +109,81 @@ auto LocalResliceSegmentation::compute() -> LocalResliceSegmentation::PointSet
         }
 
         /////////////////////////////////////////////////////////
-        // 1. Generate all candidate positions for all particles
-        std::vector<std::deque<Voxel>> nextPositions;
-        nextPositions.reserve(currentCurve.size());
-        // XXX DEBUG
-        std::vector<IntensityMap> maps;
-        std::vector<Reslice> reslices;
-        maps.reserve(currentCurve.size());
-        reslices.reserve(currentCurve.size());
-        // XXX DEBUG
-        for (int i = 0; i < int(currentCurve.size()); ++i) {
-            // Estimate normal and reslice along it
-            const auto normal = estimate_normal_at_index_(currentCurve, i);
-            const auto reslice = vol_->reslice(
-                currentCurve(i), normal, {0, 0, 1}, resliceSize_, resliceSize_);
-            reslices.push_back(reslice);
-            auto resliceIntensities = reslice.sliceData();
-
-            // Make the intensity map `stepSize_` layers down from current
-            // position and find the maxima
-            const cv::Point2i center{
-                resliceIntensities.cols / 2, resliceIntensities.rows / 2};
-            const int nextLayerIndex = center.y + static_cast<int>(stepSize_);
-            IntensityMap map(
-                resliceIntensities, static_cast<int>(stepSize_),
-                peakDistanceWeight_, considerPrevious_);
-            const auto allMaxima = map.sortedMaxima();
-            maps.push_back(map);
-
-            // Handle case where there's no maxima - go straight down
-            if (allMaxima.empty()) {
-                nextPositions.emplace_back(
-                    std::deque<Voxel>{reslice.sliceToVoxelCoord<int>(
-                        {center.x, nextLayerIndex})});
-                continue;
-            }
+        // 1. Generate all candidate positions for all particles. Particles
+        // are independent, so this runs on numThreads_ threads.
+        const auto numParticles = currentCurve.size();
+
+        // Estimate normals and reslice along them
+        std::vector<volcart::Volume::ReslicePlane> planes(numParticles);
+        volcart::ParallelFor(
+            0, numParticles,
+            [&](std::size_t i) {
+                auto idx = static_cast<int>(i);
+                planes[i] = {
+                    currentCurve(idx),
+                    estimate_normal_at_index_(currentCurve, idx),
+                    {0, 0, 1}};
+            },
+            numThreads_);
+
+        std::vector<std::deque<Voxel>> nextPositions(numParticles);
+        std::vector<std::optional<IntensityMap>> maps(numParticles);
+        std::vector<cv::Mat> resliceVis(dumpVis_ ? numParticles : 0);
+        vol_->resliceEach(
+            planes,
+            [&](std::size_t i, const volcart::Reslice& reslice) {
+                // The reslice image is a per-thread scratch buffer
+                const auto& resliceIntensities = reslice.sliceData();
+                if (dumpVis_) {
+                    resliceVis[i] = reslice.draw();
+                }
 
-            // Convert maxima to voxel positions
-            std::deque<Voxel> maximaQueue;
-            for (auto&& maxima : allMaxima) {
-                maximaQueue.emplace_back(reslice.sliceToVoxelCoord<double>(
-                    {maxima.first, nextLayerIndex}));
-            }
-            nextPositions.push_back(maximaQueue);
-        }
+                // Make the intensity map `stepSize_` layers down from current
+                // position and find the maxima
+                const cv::Point2i center{
+                    resliceIntensities.cols / 2, resliceIntensities.rows / 2};
+                const int nextLayerIndex =
+                    center.y + static_cast<int>(stepSize_);
+                maps[i].emplace(
+                    resliceIntensities, static_cast<int>(stepSize_),
+                    peakDistanceWeight_, considerPrevious_);
+                const auto allMaxima = maps[i]->sortedMaxima();
+
+                // Handle case where there's no maxima - go straight down
+                if (allMaxima.empty()) {
+                    nextPositions[i].emplace_back(
+                        reslice.sliceToVoxelCoord<int>(
+                            {center.x, nextLayerIndex}));
+                    return;
+                }
+
+                // Convert maxima to voxel positions
+                for (auto&& maxima : allMaxima) {
+                    nextPositions[i].emplace_back(
+                        reslice.sliceToVoxelCoord<double>(
+                            {maxima.first, nextLayerIndex}));
+                }
+            },
+            resliceSize_, resliceSize_, numThreads_);
 
         /////////////////////////////////////////////////////////
-        // 2. Construct initial guess using top maxima for each next position
+        // 2. Choose the next position of each particle, starting from the top
+        // maxima of every particle
+        std::vector<int> chosen;
+        if (energy_ == Energy::Incremental) {
+            chosen = OptimizeChainIncremental(
+                currentVs, nextPositions, numIters_,
+                DEFAULT_MIN_ENERGY_GRADIENT, alpha_, k1_, k2_, beta_, delta_);
+        } else {
+            chosen = OptimizeChainRefit(
+                currentVs, nextPositions, zIndex + 1, numIters_,
+                DEFAULT_MIN_ENERGY_GRADIENT, alpha_, k1_, k2_, beta_, delta_);
+        }
         std::vector<Voxel> nextVs;
         nextVs.reserve(currentVs.size());
-        for (int i = 0; i < int(nextPositions.size()); ++i) {
-            nextVs.push_back(nextPositions[i].front());
-            maps[i].setChosenMaximaIndex(0);
-        }
-        FittedCurve nextCurve(nextVs, zIndex + 1);
-
-        // Calculate energy of the current curve
-        double minEnergy = std::numeric_limits<double>::max();
-
-        // Derivative of energy measure - keeps the previous three measurements
-        // and will evaluate the central difference (when there's enough
-        // measurements)
-        std::deque<double> dEnergy;
-        dEnergy.push_back(minEnergy);
-
-        /////////////////////////////////////////////////////////
-        // 3. Optimize
-        std::vector<int> indices(currentVs.size());
-        std::iota(begin(indices), end(indices), 0);
-
-        // - Go until either some hard limit or change in energy is minimal
-        int n = 0;
-
-    iters_start:
-        while (n++ < numIters_) {
-
-            // Break if our energy gradient is leveling off
-            dEnergy.push_back(minEnergy);
-            if (dEnergy.size() > 3) {
-                dEnergy.pop_front();
-            }
-            if (dEnergy.size() == 3 &&
-                0.5 * (dEnergy[0] - dEnergy[2]) < DEFAULT_MIN_ENERGY_GRADIENT) {
-                break;
-            }
-
-            // - Sort paired index-Voxel in increasing local internal energy
-            auto pairs = Zip(indices, SquareDiff(currentVs, nextVs));
-            std::sort(begin(pairs), end(pairs), [](auto p1, auto p2) {
-                return p1.second < p2.second;
-            });
-
-            // - Go through the sorted list in reverse order, optimizing each
-            // particle. If we find an optimum, then start over with the new
-            // optimal positions. Do this until convergence or we hit a cap on
-            // number of iterations.
-            while (!pairs.empty()) {
-                int maxDiffIdx;
-                double _;
-                std::tie(maxDiffIdx, _) = pairs.back();
-                pairs.pop_back();
-
-                // Go through each combination for the maximal difference
-                // particle, iterate until you find a new optimum or don't find
-                // anything.
-                while (!nextPositions[maxDiffIdx].empty()) {
-                    std::vector<Voxel> combVs(begin(nextVs), end(nextVs));
-                    combVs[maxDiffIdx] = nextPositions[maxDiffIdx].front();
-                    nextPositions[maxDiffIdx].pop_front();
-                    FittedCurve combCurve(combVs, zIndex + 1);
-
-                    // Found a new optimum?
-                    double newE = EnergyMetrics::TotalEnergy(
-                        combCurve, alpha_, k1_, k2_, beta_, delta_);
-                    if (newE < minEnergy) {
-                        minEnergy = newE;
-                        maps[maxDiffIdx].incrementMaximaIndex();
-                        nextVs = combVs;
-                        nextCurve = combCurve;
-                    }
-                }
-                goto iters_start;
-            }
+        for (std::size_t i = 0; i < nextPositions.size(); ++i) {
+            nextVs.push_back(nextPositions[i][chosen[i]]);
+            maps[i]->setChosenMaximaIndex(chosen[i]);
         }
 
         /////////////////////////////////////////////////////////
@@ -307,14 +262,13 @@ auto LocalResliceSegmentation::compute() -> LocalResliceSegmentation::PointSet
             for (std::size_t i = 0; i < nextVs.size(); ++i) {
                 cv::Mat chain =
                     draw_particle_on_slice_(currentCurve, zIndex, i);
-                cv::Mat resliceMat = reslices[i].draw();
-                cv::Mat map = maps[i].draw();
+                cv::Mat map = maps[i]->draw();
                 std::stringstream stream;
                 stream << std::setw(nchars) << std::setfill('0') << zIndex
                        << "_" << std::setw(nchars) << std::setfill('0') << i;
                 const fs::path base = zIdxDir / stream.str();
                 cv::imwrite(base.string() + "_chain.png", chain);
-                cv::imwrite(base.string() + "_reslice.png", resliceMat);
+                cv::imwrite(base.string() + "_reslice.png", resliceVis[i]);
                 cv::imwrite(base.string() + "_map.png", map);
             }
         }
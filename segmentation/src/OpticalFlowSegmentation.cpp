@@ -38,6 +38,29 @@ std::size_t OpticalFlowSegmentationClass::progressIterations() const
     return static_cast<std::size_t>((std::abs(endIndex_ - startIndexChain) + smoothness_interpolation_distance_ + smoothness_interpolation_window_) / stepSize_);
 }
 
+namespace
+{
+// Normalize a slice region to 8 bits. If the volume has intensity
+// histograms, the min-max window is looked up from the blocks around the
+// region instead of scanning it.
+cv::Mat NormalizeROI(const volcart::Volume& vol, const cv::Mat& roiSlice, const cv::Rect& roi, int z)
+{
+    cv::Mat gray;
+    auto hist = vol.histogram();
+    if (hist && roiSlice.depth() == CV_16U) {
+        auto lo = hist->percentile(0, roi, z, z);
+        auto hi = hist->percentile(100, roi, z, z);
+        if (hi > lo) {
+            auto scale = 255.0 / (hi - lo);
+            roiSlice.convertTo(gray, CV_8U, scale, -lo * scale);
+            return gray;
+        }
+    }
+    cv::normalize(roiSlice, gray, 0, 255, cv::NORM_MINMAX, CV_8UC1);
+    return gray;
+}
+}  // namespace
+
 // print curve points with the help of this function
 static std::ostream& operator<<(std::ostream& os, const Voxel& voxel) {
     os << "(" << voxel[0] << ", " << voxel[1] << ", " << voxel[2] << ")";
@@ -281,9 +304,8 @@ std::vector<Voxel> OpticalFlowSegmentationClass::computeCurve(
     cv::Mat roiSlice2 = vol_->getSliceDataRect(nextZIndex, roi);
 
     // Convert to grayscale and normalize the slices
-    cv::Mat gray1, gray2;
-    cv::normalize(roiSlice1, gray1, 0, 255, cv::NORM_MINMAX, CV_8UC1);
-    cv::normalize(roiSlice2, gray2, 0, 255, cv::NORM_MINMAX, CV_8UC1);
+    cv::Mat gray1 = NormalizeROI(*vol_, roiSlice1, roi, zIndex);
+    cv::Mat gray2 = NormalizeROI(*vol_, roiSlice2, roi, nextZIndex);
 
     cv::Mat integral_img;
     cv::integral(gray2, integral_img, CV_32S);
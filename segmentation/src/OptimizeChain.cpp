@@ -0,0 +1,175 @@
+#include "vc/segmentation/lrps/OptimizeChain.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+
+#include "vc/segmentation/lrps/ChainEnergy.hpp"
+#include "vc/segmentation/lrps/EnergyMetrics.hpp"
+#include "vc/segmentation/lrps/FittedCurve.hpp"
+
+using namespace volcart::segmentation;
+
+namespace
+{
+// The first candidate of every particle
+auto FirstCandidates(const ChainCandidates& candidates) -> std::vector<Voxel>
+{
+    std::vector<Voxel> vs;
+    vs.reserve(candidates.size());
+    for (const auto& c : candidates) {
+        vs.push_back(c.front());
+    }
+    return vs;
+}
+
+// Record the energy of an iteration. Keeps the previous three measurements
+// and returns true when their central difference drops below the minimum
+// gradient.
+auto LevelingOff(std::deque<double>& dEnergy, double e, double minGradient)
+    -> bool
+{
+    dEnergy.push_back(e);
+    if (dEnergy.size() > 3) {
+        dEnergy.pop_front();
+    }
+    return dEnergy.size() == 3 and
+           0.5 * (dEnergy[0] - dEnergy[2]) < minGradient;
+}
+}  // namespace
+
+auto volcart::segmentation::OptimizeChainRefit(
+    const std::vector<Voxel>& currentVs,
+    const ChainCandidates& candidates,
+    int zIndex,
+    int maxIters,
+    double minEnergyGradient,
+    double alpha,
+    double k1,
+    double k2,
+    double beta,
+    double delta) -> std::vector<int>
+{
+    auto nextVs = FirstCandidates(candidates);
+    std::vector<int> chosen(candidates.size(), 0);
+    // Index of the next untried candidate of each particle
+    std::vector<std::size_t> untried(candidates.size(), 0);
+
+    double minEnergy = std::numeric_limits<double>::max();
+    std::deque<double> dEnergy{minEnergy};
+
+    std::vector<int> indices(currentVs.size());
+    std::iota(std::begin(indices), std::end(indices), 0);
+
+    // - Go until either some hard limit or change in energy is minimal
+    for (int n = 0; n < maxIters; n++) {
+        if (LevelingOff(dEnergy, minEnergy, minEnergyGradient)) {
+            break;
+        }
+
+        // - Take the particle with the maximal difference from its current
+        // position
+        auto pairs = Zip(indices, SquareDiff(currentVs, nextVs));
+        auto maxDiffIdx = std::max_element(
+                              std::begin(pairs), std::end(pairs),
+                              [](auto p1, auto p2) {
+                                  return p1.second < p2.second;
+                              })
+                              ->first;
+
+        // - Go through each of its remaining candidates, keeping those which
+        // are a new optimum
+        const auto& cands = candidates[maxDiffIdx];
+        auto& next = untried[maxDiffIdx];
+        for (; next < cands.size(); next++) {
+            auto combVs = nextVs;
+            combVs[maxDiffIdx] = cands[next];
+            FittedCurve combCurve(combVs, zIndex);
+
+            auto newE = EnergyMetrics::TotalEnergy(
+                combCurve, alpha, k1, k2, beta, delta);
+            if (newE < minEnergy) {
+                minEnergy = newE;
+                chosen[maxDiffIdx] = static_cast<int>(next);
+                nextVs = combVs;
+            }
+        }
+    }
+    return chosen;
+}
+
+auto volcart::segmentation::OptimizeChainIncremental(
+    const std::vector<Voxel>& currentVs,
+    const ChainCandidates& candidates,
+    int maxIters,
+    double minEnergyGradient,
+    double alpha,
+    double k1,
+    double k2,
+    double beta,
+    double delta) -> std::vector<int>
+{
+    std::vector<int> chosen(candidates.size(), 0);
+
+    // Terms are measured relative to the spacing of the current chain
+    double spacing{0};
+    for (std::size_t i = 1; i < currentVs.size(); i++) {
+        spacing += cv::norm(currentVs[i], currentVs[i - 1]);
+    }
+    if (currentVs.size() > 1) {
+        spacing /= static_cast<double>(currentVs.size() - 1);
+    }
+    if (not(spacing > 0)) {
+        spacing = 1.0;
+    }
+    ChainEnergy energy(
+        FirstCandidates(candidates), spacing, alpha, k1, k2, beta, delta);
+
+    std::deque<double> dEnergy{std::numeric_limits<double>::max()};
+
+    std::vector<int> indices(currentVs.size());
+    std::iota(std::begin(indices), std::end(indices), 0);
+
+    // - Sweep over the particles until either some hard limit, a sweep
+    // which moves no particle, or the change in energy is minimal
+    for (int n = 0; n < maxIters; n++) {
+        if (LevelingOff(dEnergy, energy.total(), minEnergyGradient)) {
+            break;
+        }
+
+        // - Visit the particles in order of decreasing difference from
+        // their current positions
+        auto pairs = Zip(indices, SquareDiff(currentVs, energy.points()));
+        std::sort(std::begin(pairs), std::end(pairs), [](auto p1, auto p2) {
+            return p1.second > p2.second;
+        });
+
+        // - Move each particle to the candidate which lowers the energy
+        // the most. Only the terms near the particle are re-evaluated.
+        bool moved = false;
+        for (const auto& pair : pairs) {
+            auto idx = pair.first;
+            const auto& cands = candidates[idx];
+            int best = -1;
+            double bestDelta = 0;
+            for (std::size_t c = 0; c < cands.size(); c++) {
+                auto d = energy.moveDelta(idx, cands[c]);
+                if (d < bestDelta) {
+                    bestDelta = d;
+                    best = static_cast<int>(c);
+                }
+            }
+            if (best >= 0) {
+                energy.move(idx, cands[best]);
+                chosen[idx] = best;
+                moved = true;
+            }
+        }
+
+        if (not moved) {
+            break;
+        }
+    }
+    return chosen;
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "vc/segmentation/lrps/ChainEnergy.hpp"
+
+using namespace volcart::segmentation;
+
+// Testing constants
+const double tol = 1e-9;
+const double kAlpha = 1.0 / 3.0;
+const double kBeta = 1.0 / 3.0;
+const double kDelta = 1.0 / 3.0;
+const double kK1 = 0.5;
+const double kK2 = 0.5;
+
+namespace
+{
+auto Line(std::size_t n, double spacing) -> std::vector<Voxel>
+{
+    std::vector<Voxel> vs;
+    for (std::size_t i = 0; i < n; i++) {
+        vs.emplace_back(spacing * static_cast<double>(i), 1, 0);
+    }
+    return vs;
+}
+
+auto Wave(std::size_t n) -> std::vector<Voxel>
+{
+    std::vector<Voxel> vs;
+    for (std::size_t i = 0; i < n; i++) {
+        auto x = static_cast<double>(i);
+        vs.emplace_back(2 * x, 3 * std::sin(0.7 * x), 10);
+    }
+    return vs;
+}
+
+auto Energy(const std::vector<Voxel>& vs, double spacing) -> ChainEnergy
+{
+    return {vs, spacing, kAlpha, kK1, kK2, kBeta, kDelta};
+}
+}  // namespace
+
+TEST(ChainEnergy, StraightLine)
+{
+    // Unit first derivative, no second derivative or curvature, and two
+    // reference spacings of arc length around every particle
+    auto energy = Energy(Line(10, 2.5), 2.5);
+    EXPECT_NEAR(energy.total(), kAlpha * 0.5 * kK1 + kDelta * 2, tol);
+
+    // Stretching the chain raises the energy
+    EXPECT_GT(Energy(Line(10, 2.5), 1.0).total(), energy.total());
+}
+
+TEST(ChainEnergy, DisplacementRaisesEnergy)
+{
+    auto energy = Energy(Line(10, 1.0), 1.0);
+    EXPECT_GT(energy.moveDelta(5, {5, 2, 0}), 0);
+    EXPECT_NEAR(energy.moveDelta(5, {5, 1, 0}), 0, tol);
+}
+
+TEST(ChainEnergy, IncrementalMatchesFullEvaluation)
+{
+    auto vs = Wave(12);
+    auto energy = Energy(vs, 2.0);
+
+    // Every particle, including the stencil-limited ones near the ends
+    for (std::size_t i = 0; i < vs.size(); i++) {
+        Voxel v = vs[i] + Voxel{0.5, -1.5, 0};
+
+        auto moved = vs;
+        moved[i] = v;
+        auto expected = Energy(moved, 2.0).total() - energy.total();
+        EXPECT_NEAR(energy.moveDelta(i, v), expected, tol);
+
+        energy.move(i, v);
+        vs = moved;
+        EXPECT_NEAR(energy.total(), Energy(vs, 2.0).total(), tol);
+        EXPECT_EQ(energy.points()[i], v);
+    }
+}
+
+TEST(ChainEnergy, ShortChains)
+{
+    EXPECT_EQ(Energy({}, 1.0).total(), 0);
+    EXPECT_EQ(Energy(Line(2, 1.0), 1.0).total(), 0);
+    EXPECT_THROW(Energy(Line(5, 1.0), 0.0), std::invalid_argument);
+}
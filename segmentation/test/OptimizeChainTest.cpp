@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "vc/segmentation/lrps/OptimizeChain.hpp"
+
+using namespace volcart::segmentation;
+
+// Testing constants
+const int kNumIters = 15;
+const double kMinEnergyGradient = 1e-7;
+const double kAlpha = 1.0 / 3.0;
+const double kK1 = 0.5;
+const double kK2 = 0.5;
+const double kBeta = 1.0 / 3.0;
+// The windowed arc length metrics of the two energies reward different
+// chains, so only compare the shape metrics
+const double kDelta = 0;
+
+namespace
+{
+constexpr std::size_t NUM_PARTICLES{12};
+constexpr int Z_INDEX{5};
+
+// A straight, evenly spaced chain
+auto Line(double z) -> std::vector<Voxel>
+{
+    std::vector<Voxel> vs;
+    for (std::size_t i = 0; i < NUM_PARTICLES; i++) {
+        vs.emplace_back(2.0 * static_cast<double>(i), 10, z);
+    }
+    return vs;
+}
+
+// Candidates which continue the current chain straight down, except for two
+// particles whose top candidate is an outlier
+auto Candidates() -> ChainCandidates
+{
+    ChainCandidates candidates;
+    for (const auto& v : Line(Z_INDEX + 1)) {
+        candidates.push_back({v});
+    }
+    candidates[3].push_front(candidates[3].front() + Voxel{0, 5, 0});
+    candidates[8].push_front(candidates[8].front() + Voxel{0, -4, 0});
+    return candidates;
+}
+
+auto Refit(const ChainCandidates& candidates) -> std::vector<int>
+{
+    return OptimizeChainRefit(
+        Line(Z_INDEX), candidates, Z_INDEX + 1, kNumIters, kMinEnergyGradient,
+        kAlpha, kK1, kK2, kBeta, kDelta);
+}
+
+auto Incremental(const ChainCandidates& candidates) -> std::vector<int>
+{
+    return OptimizeChainIncremental(
+        Line(Z_INDEX), candidates, kNumIters, kMinEnergyGradient, kAlpha, kK1,
+        kK2, kBeta, kDelta);
+}
+}  // namespace
+
+TEST(OptimizeChain, SingleCandidates)
+{
+    ChainCandidates candidates;
+    for (const auto& v : Line(Z_INDEX + 1)) {
+        candidates.push_back({v});
+    }
+    const std::vector<int> expected(NUM_PARTICLES, 0);
+    EXPECT_EQ(Refit(candidates), expected);
+    EXPECT_EQ(Incremental(candidates), expected);
+}
+
+TEST(OptimizeChain, IncrementalMatchesRefit)
+{
+    // Both optimizers reject the outliers in favor of the straight chain
+    std::vector<int> expected(NUM_PARTICLES, 0);
+    expected[3] = 1;
+    expected[8] = 1;
+
+    auto candidates = Candidates();
+    EXPECT_EQ(Refit(candidates), expected);
+    EXPECT_EQ(Incremental(candidates), expected);
+}
@@ -3,9 +3,14 @@
 /** @file */
 
 #include <algorithm>
+#include <cstdint>
+#include <functional>
 
 #include <opencv2/core.hpp>
 
+#include "vc/core/filesystem.hpp"
+#include "vc/core/types/Volume.hpp"
+
 namespace volcart::testing
 {
 
@@ -50,4 +55,47 @@ bool CvMatEqual(const cv::Mat& a, const cv::Mat& b)
         a.template begin<T>(), a.template end<T>(), b.template begin<T>());
 }
 
+/**
+ * @brief Fills slice `z` of a test Volume
+ *
+ * The slice is a zero-initialized, CV_16UC1 image of the volume's slice size.
+ */
+using SliceFiller = std::function<void(int z, cv::Mat& slice)>;
+
+/**
+ * @brief Write a Volume to disk and load it back
+ *
+ * Any existing directory at `path` is replaced. Slices are filled in
+ * ascending order.
+ *
+ * @param size Volume size as (width, height, slices)
+ */
+auto WriteTestVolume(
+    const filesystem::path& path,
+    const cv::Vec3i& size,
+    const SliceFiller& fill) -> Volume::Pointer;
+
+/**
+ * @brief Fill slices with intensities which are linear in x, y, and z
+ *
+ * Voxel (x, y, z) has the intensity `dx * x + dy * y + dz * z`, truncated to
+ * 16 bits.
+ */
+auto LinearSlices(int dx, int dy, int dz) -> SliceFiller;
+
+/**
+ * @brief Fill slices with a constant background and a single bright cube
+ *
+ * Voxels in [origin, origin + edge) along every axis have the intensity
+ * `value`. All others have the intensity `background`.
+ */
+auto CubeSlices(
+    std::uint16_t background,
+    const cv::Vec3i& origin,
+    int edge,
+    std::uint16_t value) -> SliceFiller;
+
+/** @brief Fill slices with uniformly distributed, seeded random intensities */
+auto RandomSlices(std::uint64_t seed) -> SliceFiller;
+
 }  // namespace volcart::testing
@@ -35,4 +35,60 @@ void vctest::AssertNear(
     double absError =
         std::fabs(((observed + expected) / 2) + (pctDiffTolerance / 100));
     ASSERT_NEAR(observed, expected, absError);
-}
\ No newline at end of file
+}
+auto vctest::WriteTestVolume(
+    const volcart::filesystem::path& path,
+    const cv::Vec3i& size,
+    const SliceFiller& fill) -> volcart::Volume::Pointer
+{
+    namespace fs = volcart::filesystem;
+    fs::remove_all(path);
+    fs::create_directories(path);
+    auto name = path.filename().string();
+    auto vol = volcart::Volume::New(path, name, name);
+    vol->setSliceWidth(size[0]);
+    vol->setSliceHeight(size[1]);
+    vol->setNumberOfSlices(size[2]);
+    for (int z = 0; z < size[2]; z++) {
+        cv::Mat slice = cv::Mat::zeros(size[1], size[0], CV_16UC1);
+        fill(z, slice);
+        vol->setSliceData(z, slice);
+    }
+    vol->saveMetadata();
+    return volcart::Volume::New(path);
+}
+
+auto vctest::LinearSlices(int dx, int dy, int dz) -> SliceFiller
+{
+    return [dx, dy, dz](int z, cv::Mat& slice) {
+        for (int y = 0; y < slice.rows; y++) {
+            auto* row = slice.ptr<std::uint16_t>(y);
+            for (int x = 0; x < slice.cols; x++) {
+                row[x] = static_cast<std::uint16_t>(dx * x + dy * y + dz * z);
+            }
+        }
+    };
+}
+
+auto vctest::CubeSlices(
+    std::uint16_t background,
+    const cv::Vec3i& origin,
+    int edge,
+    std::uint16_t value) -> SliceFiller
+{
+    return [=](int z, cv::Mat& slice) {
+        slice.setTo(background);
+        if (z >= origin[2] and z < origin[2] + edge) {
+            auto roi = cv::Rect(origin[0], origin[1], edge, edge) &
+                       cv::Rect(0, 0, slice.cols, slice.rows);
+            slice(roi).setTo(value);
+        }
+    };
+}
+
+auto vctest::RandomSlices(std::uint64_t seed) -> SliceFiller
+{
+    return [rng = cv::RNG(seed)](int /*z*/, cv::Mat& slice) mutable {
+        rng.fill(slice, cv::RNG::UNIFORM, 0, 65536);
+    };
+}
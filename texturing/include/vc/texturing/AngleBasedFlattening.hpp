@@ -4,11 +4,13 @@
 
 #include <cstddef>
 #include <memory>
+#include <vector>
 
 #include <opencv2/core.hpp>
 
 #include "vc/core/types/ITKMesh.hpp"
 #include "vc/core/types/UVMap.hpp"
+#include "vc/texturing/ChunkedFlattening.hpp"
 #include "vc/texturing/FlatteningAlgorithm.hpp"
 
 namespace volcart::texturing
@@ -24,6 +26,16 @@ namespace volcart::texturing
  * Implementation provided by the
  * [OpenABF library](https://gitlab.com/educelab/OpenABF).
  *
+ * Alternatively, the LSCM stage can be computed with SparseLSCM, a
+ * multithreaded, iterative solver which works directly on the mesh's vertex
+ * and face arrays and which can be warm-started from a previous UV map (see
+ * Solver::Sparse). If ABF++ is enabled, its optimized angles are passed to
+ * the sparse solver.
+ *
+ * Meshes which are too large to be flattened in a single solve can be
+ * flattened in overlapping patches by setting setMaxPatchFaces(). See
+ * ChunkedFlattening.
+ *
  * @ingroup UV
  */
 class AngleBasedFlattening : public FlatteningAlgorithm
@@ -35,6 +47,12 @@ public:
     /** Pointer */
     using Pointer = std::shared_ptr<AngleBasedFlattening>;
 
+    /** @brief LSCM solvers */
+    enum class Solver { OpenABF, Sparse };
+
+    /** @copydoc ChunkedFlattening::PatchMetrics */
+    using PatchMetrics = ChunkedFlattening::PatchMetrics;
+
     /**@{*/
     /** @brief Default constructor */
     AngleBasedFlattening() = default;
@@ -71,17 +89,91 @@ public:
 
     /** @copydoc setABFMaxIterations(std::size_t) */
     [[nodiscard]] auto abfMaxIterations() const -> std::size_t;
+
+    /** @brief The solver used to compute the LSCM parameterization */
+    void setSolver(Solver s);
+
+    /** @copydoc setSolver(Solver) */
+    [[nodiscard]] auto solver() const -> Solver;
+
+    /**
+     * @brief UV map used to warm-start the LSCM solver
+     *
+     * Only used by Solver::Sparse. UV map vertex IDs must correspond to the
+     * vertex IDs of the input mesh.
+     */
+    void setInitialUVMap(const UVMap::Pointer& uvMap);
+
+    /**
+     * @brief Number of worker threads used by Solver::Sparse
+     *
+     * If 0 (default), uses the number of available hardware threads.
+     */
+    void setNumThreads(std::size_t n);
+
+    /**
+     * @brief Flatten the mesh in patches of approximately this many faces
+     *
+     * If 0 (default), or if the mesh has fewer faces, the mesh is flattened
+     * in a single solve. Otherwise, the mesh is flattened with
+     * ChunkedFlattening using the sparse solver. Warm starts are not
+     * supported when flattening in patches.
+     */
+    void setMaxPatchFaces(std::size_t n);
+
+    /** @copydoc setMaxPatchFaces(std::size_t) */
+    [[nodiscard]] auto maxPatchFaces() const -> std::size_t;
+
+    /** @copydoc ChunkedFlattening::setPatchOverlap(std::size_t) */
+    void setPatchOverlap(std::size_t rings);
+
+    /** @copydoc setPatchOverlap(std::size_t) */
+    [[nodiscard]] auto patchOverlap() const -> std::size_t;
+
+    /** @copydoc ChunkedFlattening::setMemoryLimit(std::size_t) */
+    void setMemoryLimit(std::size_t bytes);
+
+    /** @copydoc setMemoryLimit(std::size_t) */
+    [[nodiscard]] auto memoryLimit() const -> std::size_t;
     /**@}*/
 
     /**@{*/
     /** @brief Compute the parameterization */
     auto compute() -> ITKMesh::Pointer override;
+
+    /**
+     * @brief Get the flattening metrics of each patch
+     *
+     * Empty if the mesh was not flattened in patches.
+     */
+    [[nodiscard]] auto patchMetrics() const -> const std::vector<PatchMetrics>&;
     /**@}*/
 
 private:
+    /** Flatten using OpenABF's LSCM */
+    void compute_openabf_();
+    /** Flatten using SparseLSCM */
+    void compute_sparse_();
+    /** Flatten in patches using ChunkedFlattening */
+    void compute_chunked_();
+
     /** Whether to use ABF minimization */
     bool useABF_{true};
     /** Maximum number of ABF minimization iterations */
     std::size_t maxABFIterations_{DEFAULT_ITERATIONS};
+    /** LSCM solver */
+    Solver solver_{Solver::OpenABF};
+    /** Warm start UV map */
+    UVMap::Pointer initUV_;
+    /** Number of worker threads */
+    std::size_t numThreads_{0};
+    /** Max faces per patch */
+    std::size_t maxPatchFaces_{0};
+    /** Patch overlap */
+    std::size_t overlap_{ChunkedFlattening::DEFAULT_PATCH_OVERLAP};
+    /** Patch solver memory budget */
+    std::size_t memLimit_{0};
+    /** Per-patch metrics */
+    std::vector<PatchMetrics> patchMetrics_;
 };
 }  // namespace volcart::texturing
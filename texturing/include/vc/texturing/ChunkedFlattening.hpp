@@ -0,0 +1,186 @@
+#pragma once
+
+/** @file */
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "vc/core/types/ITKMesh.hpp"
+#include "vc/texturing/FlatteningAlgorithm.hpp"
+
+namespace volcart::texturing
+{
+/**
+ * @brief Parameterize a large mesh by flattening overlapping patches
+ *
+ * Divide-and-conquer flattening for meshes which are too large to be
+ * flattened in a single ABF++/LSCM solve. The mesh is partitioned into
+ * connected patches of approximately setMaxPatchFaces() faces, and each
+ * patch is grown by setPatchOverlap() rings of neighboring faces. Patches are
+ * flattened independently and in parallel using (optionally) ABF++ and
+ * SparseLSCM. Afterwards, a 2D similarity transform is computed for every
+ * patch by minimizing the distance between the flattened positions of the
+ * vertices shared by overlapping patches. Only neighboring patches are
+ * coupled, so the transforms are found with a sparse solve whose size grows
+ * linearly with the number of patches. The final UV position of each vertex
+ * is the average of its aligned positions.
+ *
+ * Only the per-patch solver workspaces scale with the patch size, so peak
+ * memory is bounded by the patch size and the number of patches which are
+ * flattened concurrently. The latter can be limited with setMemoryLimit().
+ *
+ * Like AngleBasedFlattening, the output mesh lies on the XZ plane and is
+ * scaled to have the same surface area as the input mesh. Flattening error
+ * metrics for every patch are available from patchMetrics() after compute()
+ * has been called.
+ *
+ * @ingroup UV
+ */
+class ChunkedFlattening : public FlatteningAlgorithm
+{
+public:
+    /** Pointer */
+    using Pointer = std::shared_ptr<ChunkedFlattening>;
+
+    /** Default number of faces in a patch (excluding overlap) */
+    static constexpr std::size_t DEFAULT_PATCH_FACES{250000};
+    /** Default number of overlapping face rings */
+    static constexpr std::size_t DEFAULT_PATCH_OVERLAP{4};
+    /** Default maximum number of ABF iterations */
+    static constexpr std::size_t DEFAULT_ITERATIONS{10};
+
+    /** @brief Per-patch flattening metrics */
+    struct PatchMetrics {
+        /** Number of faces assigned to the patch */
+        std::size_t coreFaces{0};
+        /** Number of faces in the patch, including the overlap */
+        std::size_t faces{0};
+        /** Number of vertices in the patch */
+        std::size_t vertices{0};
+        /** Whether the ABF++ angles were used for this patch */
+        bool abf{false};
+        /** Number of LSCM solver iterations */
+        std::size_t iterations{0};
+        /** Global L2 stretch (3D-to-2D) of the patch flattening */
+        double l2{0};
+        /** Global LInf stretch (3D-to-2D) of the patch flattening */
+        double lInf{0};
+        /**
+         * RMS distance between the patch's aligned vertex positions and the
+         * final vertex positions, in output units
+         */
+        double alignmentError{0};
+    };
+
+    /**@{*/
+    /** @brief Default constructor */
+    ChunkedFlattening() = default;
+
+    /** @brief Construct and set the input mesh */
+    explicit ChunkedFlattening(const ITKMesh::Pointer& m);
+
+    /** Make a new shared instance */
+    template <typename... Args>
+    static auto New(Args... args) -> Pointer
+    {
+        return std::make_shared<ChunkedFlattening>(
+            std::forward<Args>(args)...);
+    }
+
+    /** Default destructor */
+    ~ChunkedFlattening() override = default;
+    /**@}*/
+
+    /**@{*/
+    /** @brief Whether to compute the ABF++ angles of each patch */
+    void setUseABF(bool a);
+
+    /** @copydoc setUseABF(bool) */
+    [[nodiscard]] auto useABF() const -> bool;
+
+    /** @brief The max number of ABF minimization iterations per patch */
+    void setABFMaxIterations(std::size_t i);
+
+    /** @copydoc setABFMaxIterations(std::size_t) */
+    [[nodiscard]] auto abfMaxIterations() const -> std::size_t;
+
+    /**
+     * @brief Approximate number of faces assigned to each patch
+     *
+     * Patches smaller than a quarter of this size are merged into a
+     * neighboring patch.
+     */
+    void setMaxPatchFaces(std::size_t n);
+
+    /** @copydoc setMaxPatchFaces(std::size_t) */
+    [[nodiscard]] auto maxPatchFaces() const -> std::size_t;
+
+    /**
+     * @brief Number of rings of neighboring faces added to each patch
+     *
+     * The vertices in the overlap are used to align neighboring patches.
+     */
+    void setPatchOverlap(std::size_t rings);
+
+    /** @copydoc setPatchOverlap(std::size_t) */
+    [[nodiscard]] auto patchOverlap() const -> std::size_t;
+
+    /**
+     * @brief Memory budget for the patch solvers, in bytes
+     *
+     * Limits the number of patches which are flattened concurrently so that
+     * their estimated solver memory (see EstimatePatchMemory()) fits in the
+     * budget. At least one patch is always flattened. If 0 (default), the
+     * number of concurrent patches is only limited by the number of threads.
+     */
+    void setMemoryLimit(std::size_t bytes);
+
+    /** @copydoc setMemoryLimit(std::size_t) */
+    [[nodiscard]] auto memoryLimit() const -> std::size_t;
+
+    /**
+     * @brief Number of worker threads
+     *
+     * If 0 (default), uses the number of available hardware threads.
+     */
+    void setNumThreads(std::size_t n);
+
+    /** @copydoc setNumThreads(std::size_t) */
+    [[nodiscard]] auto numThreads() const -> std::size_t;
+    /**@}*/
+
+    /**@{*/
+    /** @brief Compute the parameterization */
+    auto compute() -> ITKMesh::Pointer override;
+
+    /** @brief Get the flattening metrics of each patch */
+    [[nodiscard]] auto patchMetrics() const -> const std::vector<PatchMetrics>&;
+    /**@}*/
+
+    /**
+     * @brief Estimate the solver memory required to flatten a patch
+     *
+     * Conservative estimate, in bytes, of the workspace used by ABF++ and
+     * SparseLSCM for a patch of the given number of faces.
+     */
+    static auto EstimatePatchMemory(std::size_t faces, bool useABF)
+        -> std::size_t;
+
+private:
+    /** Whether to use ABF minimization */
+    bool useABF_{true};
+    /** Maximum number of ABF minimization iterations */
+    std::size_t maxABFIterations_{DEFAULT_ITERATIONS};
+    /** Patch size */
+    std::size_t maxPatchFaces_{DEFAULT_PATCH_FACES};
+    /** Patch overlap */
+    std::size_t overlap_{DEFAULT_PATCH_OVERLAP};
+    /** Solver memory budget */
+    std::size_t memLimit_{0};
+    /** Number of worker threads */
+    std::size_t numThreads_{0};
+    /** Per-patch metrics */
+    std::vector<PatchMetrics> metrics_;
+};
+}  // namespace volcart::texturing
@@ -2,6 +2,9 @@
 
 /** @file */
 
+#include <cstddef>
+#include <cstdint>
+
 #include "vc/texturing/TexturingAlgorithm.hpp"
 
 namespace volcart::texturing
@@ -19,6 +22,11 @@ namespace volcart::texturing
  * - Mean: Filter a neighborhood by averaging the intensities.
  * - Median + Averaging: Filter a neighborhood by averaging the median 70%.
  *
+ * Neighborhoods are sampled into reusable, per-thread buffers using
+ * NeighborhoodGenerator::sample() and reduced by a filter kernel which is
+ * specialized at compile-time for each filter, so no memory is allocated per
+ * pixel. Pixels are processed in parallel.
+ *
  * @ingroup Texture
  */
 class CompositeTexture : public TexturingAlgorithm
@@ -71,6 +79,16 @@ public:
      * Default: Maximum
      */
     void setFilter(Filter f);
+
+    /**
+     * @brief Set the number of worker threads
+     *
+     * If 0 (default), uses the number of available hardware threads.
+     */
+    void setNumThreads(std::size_t n);
+
+    /** @copydoc setNumThreads(std::size_t) */
+    [[nodiscard]] auto numThreads() const -> std::size_t;
     /**@}*/
 
     /**@{*/
@@ -78,11 +96,23 @@ public:
     auto compute() -> Texture override;
     /**@}*/
 
+    /**
+     * @brief Reduce a flattened neighborhood with a composite filter
+     *
+     * The samples in `n` may be reordered, but the multiset of values is
+     * preserved, so several filters may be applied to the same buffer.
+     */
+    static auto ApplyFilter(Filter f, std::uint16_t* n, std::size_t size)
+        -> std::uint16_t;
+
 private:
     /** Neighborhood shape */
     NeighborhoodGenerator::Pointer gen_;
 
     /** Filter method */
     Filter filter_{Filter::Maximum};
+
+    /** Number of worker threads */
+    std::size_t numThreads_{0};
 };
 }  // namespace volcart::texturing
@@ -2,12 +2,15 @@
 
 /** @file */
 #include <cstdint>
+#include <vector>
 
 #include <opencv2/core.hpp>
 
 #include "vc/core/types/ITKMesh.hpp"
+#include "vc/core/types/MeshArrays.hpp"
 #include "vc/core/util/ColorMaps.hpp"
 #include "vc/core/util/Iteration.hpp"
+#include "vc/core/util/Parallel.hpp"
 
 namespace volcart::texturing
 {
@@ -31,13 +34,16 @@ cv::Mat PlotPerFaceError(
 {
     cv::Mat output(cellMap.rows, cellMap.cols, CV_32FC1);
     output = cv::Scalar::all(defaultValue);
-    for (const auto& [y, x] : range2D(cellMap.rows, cellMap.cols)) {
-        auto cell = cellMap.at<std::int32_t>(y, x);
-        if (cell >= 0) {
-            auto error = errorMap.at(cell);
-            output.at<float>(y, x) = static_cast<float>(error);
+    ParallelFor(0, static_cast<std::size_t>(cellMap.rows), [&](auto row) {
+        auto y = static_cast<int>(row);
+        const auto* cells = cellMap.ptr<std::int32_t>(y);
+        auto* out = output.ptr<float>(y);
+        for (int x = 0; x < cellMap.cols; x++) {
+            if (cells[x] >= 0) {
+                out[x] = static_cast<float>(errorMap.at(cells[x]));
+            }
         }
-    }
+    });
     return output;
 }
 
@@ -76,10 +82,16 @@ struct LStretchMetrics {
     double l2{0};
     /** @brief Global LInf error */
     double lInf{0};
+    /** @brief Minimum per-face L2 error */
+    double minL2{0};
+    /** @brief Maximum per-face L2 error */
+    double maxL2{0};
+    /** @brief Minimum per-face LInf error */
+    double minLInf{0};
     /** @brief Per-face L2 error */
-    std::vector<double> faceL2;
+    std::vector<float> faceL2;
     /** @brief Per-face LInf error */
-    std::vector<double> faceLInf;
+    std::vector<float> faceLInf;
 };
 
 /**
@@ -95,6 +107,18 @@ struct LStretchMetrics {
 LStretchMetrics LStretch(
     const ITKMesh::Pointer& mesh3D, const ITKMesh::Pointer& mesh2D);
 
+/**
+ * @copybrief LStretch(const ITKMesh::Pointer&, const ITKMesh::Pointer&)
+ *
+ * Overload for meshes stored in contiguous arrays. Flattened vertex positions
+ * are read from the XZ plane. Faces are processed in parallel and the global
+ * metrics are reduced over fixed-size blocks of faces, so results do not
+ * depend on the number of threads.
+ *
+ * @ingroup UV Parameterization
+ */
+LStretchMetrics LStretch(const MeshArrays& mesh3D, const MeshArrays& mesh2D);
+
 /**
  * @brief Calculates the inverse LStretchMetrics plotting error relative to the
  * 3D mesh
@@ -0,0 +1,122 @@
+#pragma once
+
+/** @file */
+
+#include <cstddef>
+#include <vector>
+
+#include "vc/texturing/CompositeTexture.hpp"
+#include "vc/texturing/TexturingAlgorithm.hpp"
+
+namespace volcart::texturing
+{
+
+/**
+ * @brief Generate several composite and layer textures from one sampling pass
+ *
+ * Producing, for example, a maximum composite, a mean composite, and a layer
+ * stack with CompositeTexture and LayerTexture resamples the same
+ * neighborhoods along every PPM normal once per algorithm. This class samples
+ * each pixel's neighborhood once and produces every requested output from
+ * that sample.
+ *
+ * The computed Texture contains one image for each filter passed to
+ * setFilters(), in the order provided, followed by the layer images if
+ * setGenerateLayers() is enabled. Composite images are identical to those
+ * produced by CompositeTexture, and layer images are identical to those
+ * produced by LayerTexture.
+ *
+ * @ingroup Texture
+ */
+class MultiOutputTexture : public TexturingAlgorithm
+{
+public:
+    /** Pointer type */
+    using Pointer = std::shared_ptr<MultiOutputTexture>;
+
+    /** @copydoc CompositeTexture::Filter */
+    using Filter = CompositeTexture::Filter;
+
+    /** Make shared pointer */
+    static auto New() -> Pointer;
+
+    /** Default constructor */
+    MultiOutputTexture() = default;
+    /** Default destructor */
+    ~MultiOutputTexture() override = default;
+    /** Default copy constructor */
+    MultiOutputTexture(MultiOutputTexture&) = default;
+    /** Default move constructor */
+    MultiOutputTexture(MultiOutputTexture&&) = default;
+    /** Default copy operator */
+    auto operator=(const MultiOutputTexture&) -> MultiOutputTexture& = default;
+    /** Default move operator */
+    auto operator=(MultiOutputTexture&&) -> MultiOutputTexture& = default;
+
+    /**@{*/
+    /**
+     * @brief Set the Neighborhood generator
+     *
+     * Composite filters support generators of dimension >= 1. Layer
+     * generation requires a generator of dimension 1 (i.e. LineGenerator).
+     */
+    void setGenerator(NeighborhoodGenerator::Pointer g);
+
+    /**
+     * @brief Set the composite filters to compute
+     *
+     * One output image is generated for each filter. Default: None
+     */
+    void setFilters(std::vector<Filter> f);
+
+    /** @copydoc setFilters() */
+    [[nodiscard]] auto filters() const -> const std::vector<Filter>&;
+
+    /**
+     * @brief Whether to generate an image for every neighborhood layer
+     *
+     * Default: false
+     */
+    void setGenerateLayers(bool b);
+
+    /** @copydoc setGenerateLayers() */
+    [[nodiscard]] auto generateLayers() const -> bool;
+
+    /**
+     * @brief Set the number of worker threads
+     *
+     * If 0 (default), uses the number of available hardware threads.
+     */
+    void setNumThreads(std::size_t n);
+
+    /** @copydoc setNumThreads(std::size_t) */
+    [[nodiscard]] auto numThreads() const -> std::size_t;
+    /**@}*/
+
+    /**@{*/
+    /**
+     * @brief Compute the Texture
+     *
+     * @throws std::invalid_argument If no outputs were requested, or if
+     * layers were requested with a generator of dimension other than 1.
+     */
+    auto compute() -> Texture override;
+
+    /** @brief Get the composite filter images, in setFilters() order */
+    [[nodiscard]] auto filterTextures() const -> Texture;
+
+    /** @brief Get the layer images */
+    [[nodiscard]] auto layerTextures() const -> Texture;
+    /**@}*/
+
+private:
+    /** Neighborhood shape */
+    NeighborhoodGenerator::Pointer gen_;
+    /** Composite filters */
+    std::vector<Filter> filters_;
+    /** Generate layer images */
+    bool layers_{false};
+    /** Number of worker threads */
+    std::size_t numThreads_{0};
+};
+}  // namespace volcart::texturing
@@ -2,6 +2,8 @@
 
 /** @file */
 
+#include <cstddef>
+
 #include <itkCompositeTransform.h>
 
 #include "vc/core/types/ITKMesh.hpp"
@@ -32,7 +34,12 @@ namespace volcart::texturing
  * By default, the last mesh intersection point is used for each ray, optionally
  * this may be changed to the first intersection point.
  *
- * This class uses raytracing functionality provided by the
+ * Without a registration transform, the projection is orthographic and the
+ * mesh is rasterized directly: faces are binned into square image tiles and
+ * the tiles are scan converted in parallel, keeping the first or last surface
+ * along the projection axis in a per-tile depth buffer. With a registration
+ * transform, rays are cast for every pixel in parallel using the raytracing
+ * functionality provided by the
  * [bvh library](https://github.com/madmann91/bvh).
  *
  * @see volcart::PerPixelMap
@@ -82,6 +89,13 @@ public:
     /**@{*/
     /** @brief Use the first mesh intersection rather than the last */
     void setUseFirstIntersection(bool useFirstIntersection);
+
+    /**
+     * @brief Number of worker threads
+     *
+     * If 0 (default), uses the number of available hardware threads.
+     */
+    void setNumThreads(std::size_t n);
     /**@}*/
 
     /**@{*/
@@ -116,6 +130,8 @@ private:
     double sampleRateY_{1.0};
 
     /** Use the first mesh intersection rather than the last */
-    bool useFirstIntersection_;
+    bool useFirstIntersection_{false};
+    /** Number of worker threads */
+    std::size_t numThreads_{0};
 };
 }  // namespace volcart::texturing
@@ -0,0 +1,128 @@
+#pragma once
+
+/** @file */
+
+#include <cstddef>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "vc/core/types/MeshArrays.hpp"
+#include "vc/core/types/UVMap.hpp"
+
+namespace volcart::texturing
+{
+/**
+ * @brief Multithreaded, sparse Least Squares Conformal Maps solver
+ *
+ * Computes a free-boundary LSCM parameterization of a triangle mesh. The
+ * least-squares normal equations are assembled directly from the mesh's
+ * contiguous vertex and face arrays into a block-sparse matrix (one 2x2 block
+ * per pair of adjacent vertices) and solved with a multithreaded,
+ * block-Jacobi preconditioned conjugate gradient solver. Two vertices are
+ * pinned to remove the similarity-transform null space.
+ *
+ * By default, the local triangle geometry is taken from the 3D mesh. If
+ * per-face interior angles are provided (e.g. from ABF++), triangles are
+ * instead laid out using those angles, producing an angle-based LSCM.
+ *
+ * Because the solver is iterative, it can be warm-started from a previous
+ * parameterization of the same mesh (e.g. when a segmentation has grown by a
+ * few slices and its vertex IDs are otherwise unchanged). Vertices which are
+ * missing from the initial UV map are initialized from their neighbors.
+ * Without a warm start, the solver is initialized with a projection of the
+ * mesh onto its best-fit plane.
+ *
+ * Reference: Lévy, Bruno, et al. "Least squares conformal maps for automatic
+ * texture atlas generation." ACM Transactions on Graphics (TOG) 21.3 (2002).
+ *
+ * @ingroup UV
+ */
+class SparseLSCM
+{
+public:
+    /** Per-face interior angles, ordered by face vertex */
+    using FaceAngles = cv::Vec3d;
+
+    /** @brief Set the input mesh */
+    void setMesh(const MeshArrays& mesh);
+
+    /**
+     * @brief Set the per-face interior angles used to lay out each triangle
+     *
+     * If empty (default), angles are derived from the 3D mesh.
+     */
+    void setFaceAngles(std::vector<FaceAngles> angles);
+
+    /**
+     * @brief Set the UV map used to warm-start the solver
+     *
+     * UV map vertex IDs must correspond to the IDs of the input mesh. Set to
+     * `nullptr` (default) to disable warm starts.
+     */
+    void setInitialUVMap(const UVMap::Pointer& uvMap);
+
+    /**
+     * @brief Number of worker threads
+     *
+     * If 0 (default), uses the number of available hardware threads.
+     */
+    void setNumThreads(std::size_t n);
+
+    /** @brief Max number of conjugate gradient iterations */
+    void setMaxIterations(std::size_t i);
+
+    /** @brief Relative residual at which the solver terminates */
+    void setTolerance(double t);
+
+    /**
+     * @brief Compute the parameterization
+     *
+     * @return Per-vertex UV positions. The parameterization is not normalized
+     * and is approximately in the units of the input mesh.
+     */
+    auto compute() -> std::vector<cv::Vec2d>;
+
+    /** @brief Number of iterations performed by the last call to compute() */
+    [[nodiscard]] auto iterations() const -> std::size_t;
+
+    /** @brief Final relative residual of the last call to compute() */
+    [[nodiscard]] auto residual() const -> double;
+
+private:
+    /** Build the vertex adjacency and assemble the normal equations */
+    void assemble_();
+    /** Compute the initial solution and select the pinned vertices */
+    void initialize_();
+    /** Solve the normal equations with preconditioned CG */
+    void solve_();
+
+    /** Input mesh */
+    const MeshArrays* mesh_{nullptr};
+    /** Face angles */
+    std::vector<FaceAngles> angles_;
+    /** Warm start UV map */
+    UVMap::Pointer initUV_;
+    /** Worker threads */
+    std::size_t numThreads_{0};
+    /** Max CG iterations */
+    std::size_t maxIters_{20000};
+    /** CG tolerance */
+    double tol_{1e-8};
+
+    /** CSR row offsets into neighbors_ and blocks_ */
+    std::vector<std::size_t> offsets_;
+    /** Sorted neighbors of each vertex (including itself) */
+    std::vector<std::size_t> neighbors_;
+    /** Row-major 2x2 normal equation blocks, parallel to neighbors_ */
+    std::vector<cv::Matx22d> blocks_;
+    /** Pinned vertex flags */
+    std::vector<bool> pinned_;
+    /** Current solution */
+    std::vector<cv::Vec2d> uvs_;
+    /** Last iteration count */
+    std::size_t iters_{0};
+    /** Last residual */
+    double residual_{0};
+};
+}  // namespace volcart::texturing
@@ -0,0 +1,168 @@
+#pragma once
+
+/** @file */
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+
+#include <opencv2/core.hpp>
+
+#include "vc/core/filesystem.hpp"
+#include "vc/core/types/Mixins.hpp"
+#include "vc/core/types/PerPixelMap.hpp"
+#include "vc/texturing/TexturingAlgorithm.hpp"
+
+namespace volcart::texturing
+{
+
+/**
+ * @brief Generate a Texture in tiles which are checkpointed to disk
+ *
+ * Texturing a large PerPixelMap can take many hours, and the non-tiled
+ * texturing algorithms hold both the PerPixelMap and the output Texture in
+ * memory until they finish. This class instead divides the PPM into square
+ * tiles of setTileSize() pixels. For each tile, only that region of the PPM
+ * file is read from disk (see PerPixelMap::ReadPPMRegion()) and textured.
+ * Each output image of the tile is then immediately written to the tile
+ * directory and the tile is recorded as complete in a manifest file.
+ *
+ * If compute() is interrupted, calling it again with the same PPM, tile size,
+ * and parameter string resumes from the manifest and skips every completed
+ * tile. If the manifest does not match the current settings, all tiles are
+ * regenerated. After all tiles are complete, assemble() stitches the tiles of
+ * one output image into a full-size image.
+ *
+ * Tiles are textured independently of one another, so only texturing
+ * algorithms whose value at a pixel depends solely on that pixel's mapping
+ * produce the same result as non-tiled texturing. In particular,
+ * IntegralTexture and normalized ThicknessTexture results depend on the
+ * contents of the whole PPM.
+ *
+ * Memory use is bounded by the tile size, the full-size pixel mask, and the
+ * memory used by the texturing algorithm for a single tile.
+ *
+ * @ingroup Texture
+ */
+class TiledTexturing : public IterationsProgress
+{
+public:
+    /** Pointer type */
+    using Pointer = std::shared_ptr<TiledTexturing>;
+
+    /**
+     * @brief Texturing algorithm factory
+     *
+     * Called once per tile with the tile's PerPixelMap. Returns a fully
+     * configured texturing algorithm (including the PPM and Volume) for that
+     * tile. Per-tile PPM preprocessing, such as applying a Transform3D, should
+     * be done here.
+     */
+    using AlgorithmFactory = std::function<TexturingAlgorithm::Pointer(
+        const PerPixelMap::Pointer&)>;
+
+    /** Tile index: (row, column) */
+    using TileIndex = std::pair<std::size_t, std::size_t>;
+
+    /** Default tile size */
+    static constexpr std::size_t DEFAULT_TILE_SIZE{1024};
+
+    /** Name of the manifest file in the tile directory */
+    static constexpr const char* MANIFEST_FILE{"manifest.json"};
+
+    /** Make shared pointer */
+    static auto New() -> Pointer;
+
+    /**@{*/
+    /** @brief Set the path to the input PPM file */
+    void setPPMPath(const filesystem::path& path);
+
+    /** @brief Set the texturing algorithm factory */
+    void setAlgorithmFactory(AlgorithmFactory f);
+
+    /** @brief Set the tile edge length in pixels */
+    void setTileSize(std::size_t s);
+
+    /** @copydoc setTileSize() */
+    [[nodiscard]] auto tileSize() const -> std::size_t;
+
+    /**
+     * @brief Set the directory for the tile images and manifest
+     *
+     * The directory is created if it does not exist.
+     */
+    void setTileDirectory(const filesystem::path& dir);
+
+    /**
+     * @brief Set a string which identifies the texturing parameters
+     *
+     * Stored in the manifest. A previous run is only resumed if its parameter
+     * string matches this value.
+     */
+    void setParameterString(std::string params);
+    /**@}*/
+
+    /**@{*/
+    /**
+     * @brief Generate every tile which has not already been completed
+     *
+     * @throws std::runtime_error If the texturing algorithm produces a
+     * different number of output images for different tiles.
+     */
+    void compute();
+
+    /**
+     * @brief Stitch the tiles of an output image into a full-size image
+     *
+     * @param output Index of the image in the Texture returned by the
+     * texturing algorithm.
+     * @throws std::runtime_error If any tile is missing.
+     */
+    [[nodiscard]] auto assemble(std::size_t output = 0) const -> cv::Mat;
+
+    /** @brief Number of images in each tile's Texture */
+    [[nodiscard]] auto numOutputs() const -> std::size_t;
+
+    /** @brief Total number of tiles */
+    [[nodiscard]] auto numTiles() const -> std::size_t;
+
+    /** @brief Number of tiles which have been completed */
+    [[nodiscard]] auto numCompletedTiles() const -> std::size_t;
+
+    /** @brief Returns the maximum progress value */
+    [[nodiscard]] auto progressIterations() const -> std::size_t override;
+    /**@}*/
+
+private:
+    /** Load the manifest, discarding it if it doesn't match the settings */
+    void load_manifest_();
+    /** Atomically write the manifest */
+    void save_manifest_() const;
+    /** Path to a tile image */
+    [[nodiscard]] auto tile_path_(const TileIndex& t, std::size_t output) const
+        -> filesystem::path;
+
+    /** Input PPM path */
+    filesystem::path ppmPath_;
+    /** Texturing algorithm factory */
+    AlgorithmFactory factory_;
+    /** Tile size */
+    std::size_t tileSize_{DEFAULT_TILE_SIZE};
+    /** Tile directory */
+    filesystem::path tileDir_;
+    /** Parameter string */
+    std::string params_;
+    /** PPM height */
+    std::size_t height_{0};
+    /** PPM width */
+    std::size_t width_{0};
+    /** Number of output images per tile */
+    std::size_t numOutputs_{0};
+    /** Completed tiles */
+    std::set<TileIndex> completed_;
+};
+
+}  // namespace volcart::texturing
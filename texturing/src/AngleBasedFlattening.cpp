@@ -1,10 +1,16 @@
 #include "vc/texturing/AngleBasedFlattening.hpp"
 
+#include <algorithm>
+#include <numeric>
+
 #include <OpenABF/OpenABF.hpp>
 
+#include "vc/core/types/MeshArrays.hpp"
 #include "vc/core/util/Logging.hpp"
 #include "vc/core/util/MeshMath.hpp"
+#include "vc/core/util/Parallel.hpp"
 #include "vc/meshing/ScaleMesh.hpp"
+#include "vc/texturing/SparseLSCM.hpp"
 
 using namespace volcart;
 using namespace volcart::meshmath;
@@ -15,20 +21,9 @@ using ABF = OpenABF::ABFPlusPlus<double>;
 using HalfEdgeMesh = ABF::Mesh;
 using LSCM = OpenABF::AngleBasedLSCM<double, HalfEdgeMesh>;
 
-AngleBasedFlattening::AngleBasedFlattening(const ITKMesh::Pointer& m)
-    : FlatteningAlgorithm(m)
+namespace
 {
-}
-
-void AngleBasedFlattening::setUseABF(bool a) { useABF_ = a; }
-
-void AngleBasedFlattening::setABFMaxIterations(std::size_t i)
-{
-    maxABFIterations_ = i;
-}
-
-///// Process //////
-auto AngleBasedFlattening::compute() -> ITKMesh::Pointer
+auto BuildHalfEdgeMesh(const ITKMesh::Pointer& mesh) -> HalfEdgeMesh::Pointer
 {
     // Construct HEM
     auto hem = HalfEdgeMesh::New();
@@ -36,7 +31,7 @@ auto AngleBasedFlattening::compute() -> ITKMesh::Pointer
     // Copy the points
     Logger()->debug("Inserting vertices into half-edge mesh");
     OpenABF::Vec3d p;
-    for (auto pt = mesh_->GetPoints()->Begin(); pt != mesh_->GetPoints()->End();
+    for (auto pt = mesh->GetPoints()->Begin(); pt != mesh->GetPoints()->End();
          ++pt) {
         p[0] = pt->Value()[0];
         p[1] = pt->Value()[1];
@@ -47,8 +42,8 @@ auto AngleBasedFlattening::compute() -> ITKMesh::Pointer
     // Copy the faces
     Logger()->debug("Inserting faces into half-edge mesh");
     OpenABF::Vec<std::size_t, 3> indices;
-    for (auto cell = mesh_->GetCells()->Begin();
-         cell != mesh_->GetCells()->End(); ++cell) {
+    for (auto cell = mesh->GetCells()->Begin(); cell != mesh->GetCells()->End();
+         ++cell) {
 
         indices[0] = cell.Value()->GetPointIdsContainer()[0];
         indices[1] = cell.Value()->GetPointIdsContainer()[1];
@@ -62,19 +57,84 @@ auto AngleBasedFlattening::compute() -> ITKMesh::Pointer
         throw std::runtime_error("Input mesh is not manifold.");
     }
 
+    return hem;
+}
+
+auto SolveABF(HalfEdgeMesh::Pointer& hem, std::size_t maxIters) -> bool
+{
+    Logger()->info("Solving ABF++");
+    std::size_t iters{0};
+    double grad{0};
+    bool success{true};
+    try {
+        ABF::Compute(hem, iters, grad, maxIters);
+    } catch (const OpenABF::SolverException& e) {
+        Logger()->warn("Failed to solve ABF++. Falling back to LSCM.");
+        Logger()->debug("SolverException: {}", e.what());
+        success = false;
+    }
+    Logger()->info("ABF++ Iterations: {} || Final norm: {:.5g}", iters, grad);
+    return success;
+}
+}  // namespace
+
+AngleBasedFlattening::AngleBasedFlattening(const ITKMesh::Pointer& m)
+    : FlatteningAlgorithm(m)
+{
+}
+
+void AngleBasedFlattening::setUseABF(bool a) { useABF_ = a; }
+
+void AngleBasedFlattening::setABFMaxIterations(std::size_t i)
+{
+    maxABFIterations_ = i;
+}
+
+void AngleBasedFlattening::setSolver(Solver s) { solver_ = s; }
+
+void AngleBasedFlattening::setInitialUVMap(const UVMap::Pointer& uvMap)
+{
+    initUV_ = uvMap;
+}
+
+void AngleBasedFlattening::setNumThreads(std::size_t n) { numThreads_ = n; }
+
+void AngleBasedFlattening::setMaxPatchFaces(std::size_t n)
+{
+    maxPatchFaces_ = n;
+}
+
+void AngleBasedFlattening::setPatchOverlap(std::size_t rings)
+{
+    overlap_ = rings;
+}
+
+void AngleBasedFlattening::setMemoryLimit(std::size_t bytes)
+{
+    memLimit_ = bytes;
+}
+
+///// Process //////
+auto AngleBasedFlattening::compute() -> ITKMesh::Pointer
+{
+    patchMetrics_.clear();
+    if (maxPatchFaces_ > 0 and mesh_->GetNumberOfCells() > maxPatchFaces_) {
+        compute_chunked_();
+    } else if (solver_ == Solver::Sparse) {
+        compute_sparse_();
+    } else {
+        compute_openabf_();
+    }
+    return output_;
+}
+
+void AngleBasedFlattening::compute_openabf_()
+{
+    auto hem = BuildHalfEdgeMesh(mesh_);
+
     // ABF
     if (useABF_) {
-        Logger()->info("Solving ABF++");
-        std::size_t iters{0};
-        double grad{0};
-        try {
-            ABF::Compute(hem, iters, grad, maxABFIterations_);
-        } catch (const OpenABF::SolverException& e) {
-            Logger()->warn("Failed to solve ABF++. Falling back to LSCM.");
-            Logger()->debug("SolverException: {}", e.what());
-        }
-        Logger()->info(
-            "ABF++ Iterations: {} || Final norm: {:.5g}", iters, grad);
+        SolveABF(hem, maxABFIterations_);
     }
 
     // LSCM
@@ -101,8 +161,91 @@ auto AngleBasedFlattening::compute() -> ITKMesh::Pointer
     Logger()->debug("Scaling output mesh by scale factor {:.5g}", scale);
     output_ = ITKMesh::New();
     ScaleMesh(flatMesh, output_, scale);
+}
 
-    return output_;
+void AngleBasedFlattening::compute_sparse_()
+{
+    auto arrays = ToMeshArrays(mesh_);
+
+    // Get the optimized interior angles from ABF++
+    std::vector<SparseLSCM::FaceAngles> angles;
+    if (useABF_) {
+        auto hem = BuildHalfEdgeMesh(mesh_);
+        if (SolveABF(hem, maxABFIterations_)) {
+            angles.resize(arrays.faces.size());
+            std::size_t faceIdx{0};
+            for (const auto& f : hem->faces()) {
+                const auto& face = arrays.faces[faceIdx];
+                for (const auto& e : *f) {
+                    auto vIdx = std::find(
+                                    face.begin(), face.end(), e->vertex->idx) -
+                                face.begin();
+                    angles[faceIdx][static_cast<int>(vIdx)] = e->alpha;
+                }
+                faceIdx++;
+            }
+        }
+    }
+
+    // LSCM
+    Logger()->info("Solving LSCM (sparse)");
+    SparseLSCM lscm;
+    lscm.setMesh(arrays);
+    lscm.setFaceAngles(std::move(angles));
+    lscm.setInitialUVMap(initUV_);
+    lscm.setNumThreads(numThreads_);
+    auto uvs = lscm.compute();
+    Logger()->info(
+        "LSCM Iterations: {} || Final residual: {:.5g}", lscm.iterations(),
+        lscm.residual());
+
+    // Scale mesh surface area to same as original
+    std::vector<double> areas3D(arrays.faces.size());
+    std::vector<double> areas2D(arrays.faces.size());
+    ParallelFor(
+        0, arrays.faces.size(),
+        [&](std::size_t f) {
+            const auto& face = arrays.faces[f];
+            const auto& v = arrays.vertices;
+            areas3D[f] =
+                0.5 * cv::norm((v[face[1]] - v[face[0]])
+                                   .cross(v[face[2]] - v[face[0]]));
+            auto a = uvs[face[1]] - uvs[face[0]];
+            auto b = uvs[face[2]] - uvs[face[0]];
+            areas2D[f] = 0.5 * std::abs(a[0] * b[1] - a[1] * b[0]);
+        },
+        numThreads_);
+    auto area3D = std::accumulate(areas3D.begin(), areas3D.end(), 0.0);
+    auto area2D = std::accumulate(areas2D.begin(), areas2D.end(), 0.0);
+    auto scale = std::sqrt(area3D / area2D);
+    Logger()->debug("Scaling output mesh by scale factor {:.5g}", scale);
+
+    // Fill output
+    // Flatten to the XZ plane
+    for (std::size_t v = 0; v < uvs.size(); v++) {
+        arrays.vertices[v] = {uvs[v][0] * scale, 0.0, uvs[v][1] * scale};
+    }
+    arrays.normals.assign(arrays.vertices.size(), {0.0, 1.0, 0.0});
+    output_ = ToITKMesh(arrays);
+}
+
+void AngleBasedFlattening::compute_chunked_()
+{
+    if (initUV_) {
+        Logger()->warn(
+            "Warm starts are not supported when flattening in patches. "
+            "Ignoring initial UV map.");
+    }
+
+    ChunkedFlattening chunked(mesh_);
+    chunked.setUseABF(useABF_);
+    chunked.setABFMaxIterations(maxABFIterations_);
+    chunked.setMaxPatchFaces(maxPatchFaces_);
+    chunked.setPatchOverlap(overlap_);
+    chunked.setMemoryLimit(memLimit_);
+    chunked.setNumThreads(numThreads_);
+    output_ = chunked.compute();
+    patchMetrics_ = chunked.patchMetrics();
 }
 
 auto AngleBasedFlattening::useABF() const -> bool { return useABF_; }
@@ -111,3 +254,26 @@ auto AngleBasedFlattening::abfMaxIterations() const -> std::size_t
 {
     return maxABFIterations_;
 }
+
+auto AngleBasedFlattening::solver() const -> Solver { return solver_; }
+
+auto AngleBasedFlattening::maxPatchFaces() const -> std::size_t
+{
+    return maxPatchFaces_;
+}
+
+auto AngleBasedFlattening::patchOverlap() const -> std::size_t
+{
+    return overlap_;
+}
+
+auto AngleBasedFlattening::memoryLimit() const -> std::size_t
+{
+    return memLimit_;
+}
+
+auto AngleBasedFlattening::patchMetrics() const
+    -> const std::vector<PatchMetrics>&
+{
+    return patchMetrics_;
+}
@@ -0,0 +1,672 @@
+#include "vc/texturing/ChunkedFlattening.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+
+#include <Eigen/SparseCholesky>
+#include <Eigen/SparseCore>
+#include <OpenABF/OpenABF.hpp>
+#include <opencv2/core.hpp>
+
+#include "vc/core/types/MeshArrays.hpp"
+#include "vc/core/util/Logging.hpp"
+#include "vc/core/util/Parallel.hpp"
+#include "vc/texturing/FlatteningError.hpp"
+#include "vc/texturing/SparseLSCM.hpp"
+
+using namespace volcart;
+using namespace volcart::texturing;
+
+using ABF = OpenABF::ABFPlusPlus<double>;
+using HalfEdgeMesh = ABF::Mesh;
+
+namespace
+{
+/** Label of faces which have not been assigned to a patch */
+constexpr auto UNASSIGNED = std::numeric_limits<std::size_t>::max();
+
+/** Number of parameters of a 2D similarity transform */
+constexpr int SIM_PARAMS{4};
+
+/** Approximate solver bytes per face */
+constexpr std::size_t LSCM_BYTES_PER_FACE{512};
+constexpr std::size_t ABF_BYTES_PER_FACE{4096};
+
+/** Vertex to face adjacency in CSR format */
+struct VertexFaces {
+    std::vector<std::size_t> offsets;
+    std::vector<std::size_t> faces;
+};
+
+/** A flattened patch */
+struct FlatPatch {
+    /** Sorted global vertex IDs */
+    std::vector<std::size_t> vertices;
+    /** UV positions, parallel to vertices */
+    std::vector<cv::Vec2d> uvs;
+};
+
+/** A vertex's flattened position in one patch */
+struct PatchUV {
+    std::size_t patch;
+    cv::Vec2d uv;
+};
+
+auto BuildVertexFaces(const MeshArrays& mesh) -> VertexFaces
+{
+    VertexFaces vf;
+    vf.offsets.assign(mesh.vertices.size() + 1, 0);
+    for (const auto& f : mesh.faces) {
+        for (const auto& v : f) {
+            vf.offsets[v + 1]++;
+        }
+    }
+    std::partial_sum(vf.offsets.begin(), vf.offsets.end(), vf.offsets.begin());
+    vf.faces.resize(vf.offsets.back());
+    std::vector<std::size_t> cursor(vf.offsets.begin(), vf.offsets.end() - 1);
+    for (std::size_t f = 0; f < mesh.faces.size(); f++) {
+        for (const auto& v : mesh.faces[f]) {
+            vf.faces[cursor[v]++] = f;
+        }
+    }
+    return vf;
+}
+
+/** Call fn(g) for every face g which shares an edge with face f */
+template <typename Fn>
+void ForEachEdgeNeighbor(
+    const MeshArrays& mesh, const VertexFaces& vf, std::size_t f, Fn fn)
+{
+    const auto& face = mesh.faces[f];
+    for (std::size_t i = 0; i < 3; i++) {
+        auto a = face[i];
+        auto b = face[(i + 1) % 3];
+        for (auto k = vf.offsets[a]; k < vf.offsets[a + 1]; k++) {
+            auto g = vf.faces[k];
+            const auto& other = mesh.faces[g];
+            if (g != f and std::find(other.begin(), other.end(), b) !=
+                               other.end()) {
+                fn(g);
+            }
+        }
+    }
+}
+
+/**
+ * Partition the faces into connected patches by breadth-first region growing
+ * and merge small leftover patches into their neighbors
+ */
+auto PartitionFaces(
+    const MeshArrays& mesh, const VertexFaces& vf, std::size_t maxFaces)
+    -> std::vector<std::vector<std::size_t>>
+{
+    auto numFaces = mesh.faces.size();
+    std::vector<std::size_t> labels(numFaces, UNASSIGNED);
+    std::vector<std::vector<std::size_t>> patches;
+    std::vector<std::size_t> queue;
+    for (std::size_t seed = 0; seed < numFaces; seed++) {
+        if (labels[seed] != UNASSIGNED) {
+            continue;
+        }
+
+        auto id = patches.size();
+        patches.emplace_back();
+        auto& patch = patches.back();
+        queue.clear();
+        queue.push_back(seed);
+        labels[seed] = id;
+        std::size_t head{0};
+        while (head < queue.size() and patch.size() < maxFaces) {
+            auto f = queue[head++];
+            patch.push_back(f);
+            ForEachEdgeNeighbor(mesh, vf, f, [&](std::size_t g) {
+                if (labels[g] == UNASSIGNED) {
+                    labels[g] = id;
+                    queue.push_back(g);
+                }
+            });
+        }
+
+        // Release the faces which were queued but not added
+        for (auto i = head; i < queue.size(); i++) {
+            labels[queue[i]] = UNASSIGNED;
+        }
+    }
+
+    // Merge small patches into a neighboring patch
+    auto minFaces = std::max<std::size_t>(maxFaces / 4, 1);
+    for (std::size_t p = 0; p < patches.size(); p++) {
+        if (patches[p].empty() or patches[p].size() >= minFaces) {
+            continue;
+        }
+        auto target = UNASSIGNED;
+        for (auto f : patches[p]) {
+            ForEachEdgeNeighbor(mesh, vf, f, [&](std::size_t g) {
+                if (target == UNASSIGNED and labels[g] != p) {
+                    target = labels[g];
+                }
+            });
+            if (target != UNASSIGNED) {
+                break;
+            }
+        }
+        if (target == UNASSIGNED) {
+            continue;
+        }
+        for (auto f : patches[p]) {
+            labels[f] = target;
+        }
+        auto& dst = patches[target];
+        dst.insert(dst.end(), patches[p].begin(), patches[p].end());
+        std::vector<std::size_t>().swap(patches[p]);
+    }
+    patches.erase(
+        std::remove_if(
+            patches.begin(), patches.end(),
+            [](const auto& p) { return p.empty(); }),
+        patches.end());
+
+    return patches;
+}
+
+/** Grow a patch by rings of faces which share a vertex with the patch */
+auto GrowPatch(
+    const MeshArrays& mesh,
+    const VertexFaces& vf,
+    const std::vector<std::size_t>& core,
+    std::size_t rings) -> std::vector<std::size_t>
+{
+    std::vector<std::size_t> faces(core);
+    std::unordered_set<std::size_t> member(core.begin(), core.end());
+    auto frontBegin = std::size_t{0};
+    for (std::size_t r = 0; r < rings; r++) {
+        auto frontEnd = faces.size();
+        for (auto i = frontBegin; i < frontEnd; i++) {
+            for (const auto& v : mesh.faces[faces[i]]) {
+                for (auto k = vf.offsets[v]; k < vf.offsets[v + 1]; k++) {
+                    auto g = vf.faces[k];
+                    if (member.insert(g).second) {
+                        faces.push_back(g);
+                    }
+                }
+            }
+        }
+        if (faces.size() == frontEnd) {
+            break;
+        }
+        frontBegin = frontEnd;
+    }
+    return faces;
+}
+
+/** Compute the ABF++ interior angles of a patch. Empty on failure. */
+auto PatchAngles(const MeshArrays& patch, std::size_t maxIters)
+    -> std::vector<SparseLSCM::FaceAngles>
+{
+    std::vector<SparseLSCM::FaceAngles> angles;
+    try {
+        auto hem = HalfEdgeMesh::New();
+        OpenABF::Vec3d p;
+        for (const auto& v : patch.vertices) {
+            p[0] = v[0];
+            p[1] = v[1];
+            p[2] = v[2];
+            hem->insert_vertex(p);
+        }
+        OpenABF::Vec<std::size_t, 3> indices;
+        for (const auto& f : patch.faces) {
+            indices[0] = f[0];
+            indices[1] = f[1];
+            indices[2] = f[2];
+            hem->insert_face(indices);
+        }
+        if (not OpenABF::IsManifold(hem)) {
+            return angles;
+        }
+
+        std::size_t iters{0};
+        double grad{0};
+        ABF::Compute(hem, iters, grad, maxIters);
+
+        angles.resize(patch.faces.size());
+        std::size_t faceIdx{0};
+        for (const auto& f : hem->faces()) {
+            const auto& face = patch.faces[faceIdx];
+            for (const auto& e : *f) {
+                auto vIdx =
+                    std::find(face.begin(), face.end(), e->vertex->idx) -
+                    face.begin();
+                angles[faceIdx][static_cast<int>(vIdx)] = e->alpha;
+            }
+            faceIdx++;
+        }
+    } catch (const std::exception& e) {
+        Logger()->debug("Patch ABF++ failed: {}", e.what());
+        angles.clear();
+    }
+    return angles;
+}
+
+/** Surface area of a 3D mesh and of its parameterization */
+auto PatchAreas(const MeshArrays& mesh, const std::vector<cv::Vec2d>& uvs)
+    -> std::pair<double, double>
+{
+    double area3D{0};
+    double area2D{0};
+    const auto& v = mesh.vertices;
+    for (const auto& f : mesh.faces) {
+        area3D += 0.5 * cv::norm((v[f[1]] - v[f[0]]).cross(v[f[2]] - v[f[0]]));
+        auto a = uvs[f[1]] - uvs[f[0]];
+        auto b = uvs[f[2]] - uvs[f[0]];
+        area2D += 0.5 * std::abs(a[0] * b[1] - a[1] * b[0]);
+    }
+    return {area3D, area2D};
+}
+
+/** Apply the similarity transform with parameters t to uv */
+auto Transform(const double* t, const cv::Vec2d& uv) -> cv::Vec2d
+{
+    return {
+        t[0] * uv[0] - t[1] * uv[1] + t[2], t[1] * uv[0] + t[0] * uv[1] + t[3]};
+}
+
+/** Find the root of a union-find set */
+auto FindRoot(std::vector<std::size_t>& parents, std::size_t i) -> std::size_t
+{
+    while (parents[i] != i) {
+        parents[i] = parents[parents[i]];
+        i = parents[i];
+    }
+    return i;
+}
+}  // namespace
+
+ChunkedFlattening::ChunkedFlattening(const ITKMesh::Pointer& m)
+    : FlatteningAlgorithm(m)
+{
+}
+
+void ChunkedFlattening::setUseABF(bool a) { useABF_ = a; }
+
+auto ChunkedFlattening::useABF() const -> bool { return useABF_; }
+
+void ChunkedFlattening::setABFMaxIterations(std::size_t i)
+{
+    maxABFIterations_ = i;
+}
+
+auto ChunkedFlattening::abfMaxIterations() const -> std::size_t
+{
+    return maxABFIterations_;
+}
+
+void ChunkedFlattening::setMaxPatchFaces(std::size_t n)
+{
+    maxPatchFaces_ = std::max<std::size_t>(n, 1);
+}
+
+auto ChunkedFlattening::maxPatchFaces() const -> std::size_t
+{
+    return maxPatchFaces_;
+}
+
+void ChunkedFlattening::setPatchOverlap(std::size_t rings) { overlap_ = rings; }
+
+auto ChunkedFlattening::patchOverlap() const -> std::size_t
+{
+    return overlap_;
+}
+
+void ChunkedFlattening::setMemoryLimit(std::size_t bytes)
+{
+    memLimit_ = bytes;
+}
+
+auto ChunkedFlattening::memoryLimit() const -> std::size_t
+{
+    return memLimit_;
+}
+
+void ChunkedFlattening::setNumThreads(std::size_t n) { numThreads_ = n; }
+
+auto ChunkedFlattening::numThreads() const -> std::size_t
+{
+    return numThreads_;
+}
+
+auto ChunkedFlattening::patchMetrics() const
+    -> const std::vector<PatchMetrics>&
+{
+    return metrics_;
+}
+
+auto ChunkedFlattening::EstimatePatchMemory(std::size_t faces, bool useABF)
+    -> std::size_t
+{
+    return faces * (useABF ? ABF_BYTES_PER_FACE : LSCM_BYTES_PER_FACE);
+}
+
+auto ChunkedFlattening::compute() -> ITKMesh::Pointer
+{
+    auto mesh = ToMeshArrays(mesh_);
+    if (mesh.faces.empty()) {
+        throw std::runtime_error("Input mesh is empty.");
+    }
+    auto numVerts = mesh.vertices.size();
+
+    // Partition the mesh
+    Logger()->debug("Partitioning mesh into patches");
+    auto vf = BuildVertexFaces(mesh);
+    auto cores = PartitionFaces(mesh, vf, maxPatchFaces_);
+    auto numPatches = cores.size();
+
+    // Limit the number of patches in flight to the memory budget
+    auto threads = NumWorkerThreads(numThreads_);
+    auto inFlight = std::min(threads, numPatches);
+    if (memLimit_ > 0) {
+        auto ringFaces = static_cast<std::size_t>(
+            8 * std::ceil(std::sqrt(static_cast<double>(maxPatchFaces_))));
+        auto patchMem =
+            EstimatePatchMemory(maxPatchFaces_ + overlap_ * ringFaces, useABF_);
+        inFlight = std::clamp<std::size_t>(memLimit_ / patchMem, 1, inFlight);
+    }
+    auto innerThreads = std::max<std::size_t>(threads / inFlight, 1);
+    Logger()->info(
+        "Flattening {} patches ({} concurrent, {} threads each)", numPatches,
+        inFlight, innerThreads);
+
+    // Flatten each patch
+    std::vector<FlatPatch> flat(numPatches);
+    metrics_.assign(numPatches, {});
+    ParallelFor(
+        0, numPatches,
+        [&](std::size_t p) {
+            auto faces = GrowPatch(mesh, vf, cores[p], overlap_);
+
+            // Build the patch's local arrays
+            auto& result = flat[p];
+            result.vertices.reserve(3 * faces.size());
+            for (auto f : faces) {
+                const auto& face = mesh.faces[f];
+                result.vertices.insert(
+                    result.vertices.end(), face.begin(), face.end());
+            }
+            std::sort(result.vertices.begin(), result.vertices.end());
+            result.vertices.erase(
+                std::unique(result.vertices.begin(), result.vertices.end()),
+                result.vertices.end());
+            result.vertices.shrink_to_fit();
+
+            MeshArrays patch;
+            patch.vertices.reserve(result.vertices.size());
+            for (auto v : result.vertices) {
+                patch.vertices.push_back(mesh.vertices[v]);
+            }
+            patch.faces.reserve(faces.size());
+            for (auto f : faces) {
+                MeshArrays::Face local;
+                for (std::size_t i = 0; i < 3; i++) {
+                    local[i] = static_cast<std::size_t>(
+                        std::lower_bound(
+                            result.vertices.begin(), result.vertices.end(),
+                            mesh.faces[f][i]) -
+                        result.vertices.begin());
+                }
+                patch.faces.push_back(local);
+            }
+
+            // Flatten
+            auto& m = metrics_[p];
+            std::vector<SparseLSCM::FaceAngles> angles;
+            if (useABF_) {
+                angles = PatchAngles(patch, maxABFIterations_);
+                m.abf = not angles.empty();
+                if (not m.abf) {
+                    Logger()->warn(
+                        "Failed to solve ABF++ for patch {}. Falling back to "
+                        "LSCM.",
+                        p);
+                }
+            }
+            SparseLSCM lscm;
+            lscm.setMesh(patch);
+            lscm.setFaceAngles(std::move(angles));
+            lscm.setNumThreads(innerThreads);
+            result.uvs = lscm.compute();
+
+            // Scale to the surface area of the patch
+            auto [area3D, area2D] = PatchAreas(patch, result.uvs);
+            auto scale = std::sqrt(area3D / area2D);
+            for (auto& uv : result.uvs) {
+                uv *= scale;
+            }
+
+            // Patch flattening error
+            MeshArrays patch2D;
+            patch2D.faces = patch.faces;
+            patch2D.vertices.reserve(result.uvs.size());
+            for (const auto& uv : result.uvs) {
+                patch2D.vertices.emplace_back(uv[0], 0.0, uv[1]);
+            }
+            auto error = InvertLStretchMetrics(LStretch(patch, patch2D));
+
+            m.coreFaces = cores[p].size();
+            m.faces = faces.size();
+            m.vertices = result.vertices.size();
+            m.iterations = lscm.iterations();
+            m.l2 = error.l2;
+            m.lInf = error.lInf;
+            Logger()->debug(
+                "Flattened patch {}: {} faces, L2: {:.5g}, LInf: {:.5g}", p,
+                m.faces, m.l2, m.lInf);
+        },
+        inFlight, 1);
+    std::vector<std::vector<std::size_t>>().swap(cores);
+    vf = VertexFaces{};
+
+    // Gather every vertex's positions in the patches which contain it
+    std::vector<std::size_t> offsets(numVerts + 1, 0);
+    for (const auto& patch : flat) {
+        for (auto v : patch.vertices) {
+            offsets[v + 1]++;
+        }
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::vector<PatchUV> entries(offsets.back());
+    {
+        std::vector<std::size_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (std::size_t p = 0; p < numPatches; p++) {
+            for (std::size_t i = 0; i < flat[p].vertices.size(); i++) {
+                entries[cursor[flat[p].vertices[i]]++] = {p, flat[p].uvs[i]};
+            }
+        }
+    }
+    std::vector<FlatPatch>().swap(flat);
+
+    // Find the groups of patches which are connected by shared vertices. The
+    // first patch of each group is the group's reference frame.
+    std::vector<std::size_t> parents(numPatches);
+    std::iota(parents.begin(), parents.end(), 0);
+    for (std::size_t v = 0; v < numVerts; v++) {
+        for (auto i = offsets[v] + 1; i < offsets[v + 1]; i++) {
+            auto a = FindRoot(parents, entries[offsets[v]].patch);
+            auto b = FindRoot(parents, entries[i].patch);
+            parents[std::max(a, b)] = std::min(a, b);
+        }
+    }
+    std::size_t numGroups{0};
+    for (std::size_t p = 0; p < numPatches; p++) {
+        if (FindRoot(parents, p) == p) {
+            numGroups++;
+        }
+    }
+    if (numGroups > 1) {
+        Logger()->warn(
+            "Mesh has {} disconnected components. Components may overlap in "
+            "the parameterization.",
+            numGroups);
+    }
+
+    // Assemble the normal equations of the alignment problem:
+    // min sum |T_p(u_p) - T_q(u_q)|^2 over the vertices shared by p and q.
+    // The system is block-sparse: only patches which share a vertex are
+    // coupled, so accumulate one block per pair of coupled patches.
+    Logger()->debug("Aligning patches");
+    using Block = std::array<double, SIM_PARAMS * SIM_PARAMS>;
+    std::map<std::pair<std::size_t, std::size_t>, Block> blocks;
+    std::array<std::array<double, 2 * SIM_PARAMS>, 2> jac{};
+    for (std::size_t v = 0; v < numVerts; v++) {
+        for (auto i = offsets[v]; i < offsets[v + 1]; i++) {
+            for (auto j = i + 1; j < offsets[v + 1]; j++) {
+                const auto& ep = entries[i];
+                const auto& eq = entries[j];
+                const auto& u = ep.uv;
+                const auto& w = eq.uv;
+                jac[0] = {u[0], -u[1], 1, 0, -w[0], w[1], -1, 0};
+                jac[1] = {u[1], u[0], 0, 1, -w[1], -w[0], 0, -1};
+                std::array<std::size_t, 2> pair{ep.patch, eq.patch};
+                for (std::size_t bi = 0; bi < 2; bi++) {
+                    for (std::size_t bj = 0; bj < 2; bj++) {
+                        auto& blk = blocks[{pair[bi], pair[bj]}];
+                        for (int r = 0; r < SIM_PARAMS; r++) {
+                            auto jr = bi * SIM_PARAMS + r;
+                            for (int c = 0; c < SIM_PARAMS; c++) {
+                                auto jc = bj * SIM_PARAMS + c;
+                                blk[r * SIM_PARAMS + c] +=
+                                    jac[0][jr] * jac[0][jc] +
+                                    jac[1][jr] * jac[1][jc];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Fix each reference frame to the identity transform by eliminating its
+    // parameters from the other patches' equations
+    static const std::array<double, SIM_PARAMS> IDENTITY{1, 0, 0, 0};
+    auto n = static_cast<Eigen::Index>(numPatches) * SIM_PARAMS;
+    Eigen::VectorXd b = Eigen::VectorXd::Zero(n);
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(blocks.size() * SIM_PARAMS * SIM_PARAMS);
+    double trace{0};
+    for (const auto& [key, blk] : blocks) {
+        auto [p, q] = key;
+        if (FindRoot(parents, p) == p) {
+            continue;
+        }
+        auto row = static_cast<Eigen::Index>(p) * SIM_PARAMS;
+        auto col = static_cast<Eigen::Index>(q) * SIM_PARAMS;
+        auto fixed = FindRoot(parents, q) == q;
+        for (int r = 0; r < SIM_PARAMS; r++) {
+            for (int c = 0; c < SIM_PARAMS; c++) {
+                auto val = blk[r * SIM_PARAMS + c];
+                if (fixed) {
+                    b[row + r] -= val * IDENTITY[c];
+                } else {
+                    triplets.emplace_back(row + r, col + c, val);
+                }
+            }
+            if (p == q) {
+                trace += blk[r * SIM_PARAMS + r];
+            }
+        }
+    }
+    decltype(blocks)().swap(blocks);
+    for (std::size_t p = 0; p < numPatches; p++) {
+        if (FindRoot(parents, p) != p) {
+            continue;
+        }
+        for (int k = 0; k < SIM_PARAMS; k++) {
+            auto row = static_cast<Eigen::Index>(p) * SIM_PARAMS + k;
+            triplets.emplace_back(row, row, 1);
+            b[row] = IDENTITY[k];
+            trace += 1;
+        }
+    }
+
+    // Weakly regularize towards the identity so that patches which are only
+    // connected by a single vertex remain well-posed
+    auto lambda = 1e-9 * std::max(trace / static_cast<double>(n), 1.0);
+    for (Eigen::Index r = 0; r < n; r++) {
+        triplets.emplace_back(r, r, lambda);
+        b[r] += lambda * IDENTITY[r % SIM_PARAMS];
+    }
+
+    Eigen::SparseMatrix<double> a(n, n);
+    a.setFromTriplets(triplets.begin(), triplets.end());
+    std::vector<Eigen::Triplet<double>>().swap(triplets);
+
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> solver(a);
+    if (solver.info() != Eigen::Success) {
+        throw std::runtime_error("Failed to align flattened patches.");
+    }
+    Eigen::VectorXd x = solver.solve(b);
+    if (solver.info() != Eigen::Success) {
+        throw std::runtime_error("Failed to align flattened patches.");
+    }
+    const auto* params = x.data();
+
+    // Each vertex's final position is the average of its aligned positions
+    std::vector<cv::Vec2d> uvs(numVerts, {0, 0});
+    ParallelFor(
+        0, numVerts,
+        [&](std::size_t v) {
+            auto cnt = offsets[v + 1] - offsets[v];
+            if (cnt == 0) {
+                return;
+            }
+            cv::Vec2d sum{0, 0};
+            for (auto i = offsets[v]; i < offsets[v + 1]; i++) {
+                const auto& e = entries[i];
+                sum += Transform(params + e.patch * SIM_PARAMS, e.uv);
+            }
+            uvs[v] = sum / static_cast<double>(cnt);
+        },
+        numThreads_);
+
+    // Scale mesh surface area to same as original
+    auto [area3D, area2D] = PatchAreas(mesh, uvs);
+    auto scale = std::sqrt(area3D / area2D);
+    Logger()->debug("Scaling output mesh by scale factor {:.5g}", scale);
+
+    // Alignment error of each patch
+    std::vector<double> sqErr(numPatches, 0);
+    for (std::size_t v = 0; v < numVerts; v++) {
+        for (auto i = offsets[v]; i < offsets[v + 1]; i++) {
+            const auto& e = entries[i];
+            auto d = Transform(params + e.patch * SIM_PARAMS, e.uv) - uvs[v];
+            sqErr[e.patch] += d.dot(d);
+        }
+    }
+    double worstL2{0};
+    double worstAlign{0};
+    for (std::size_t p = 0; p < numPatches; p++) {
+        auto& m = metrics_[p];
+        m.alignmentError =
+            scale * std::sqrt(sqErr[p] / static_cast<double>(m.vertices));
+        worstL2 = std::max(worstL2, m.l2);
+        worstAlign = std::max(worstAlign, m.alignmentError);
+    }
+    Logger()->info(
+        "Patch flattening || Max patch L2: {:.5g} || Max alignment error: "
+        "{:.5g}",
+        worstL2, worstAlign);
+
+    // Fill output
+    // Flatten to the XZ plane
+    for (std::size_t v = 0; v < numVerts; v++) {
+        mesh.vertices[v] = {uvs[v][0] * scale, 0.0, uvs[v][1] * scale};
+    }
+    mesh.normals.assign(numVerts, {0.0, 1.0, 0.0});
+    output_ = ToITKMesh(mesh);
+    return output_;
+}
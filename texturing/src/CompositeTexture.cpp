@@ -1,11 +1,16 @@
 #include "vc/texturing/CompositeTexture.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
 
 #include "vc/core/util/FloatComparison.hpp"
-#include "vc/core/util/Iteration.hpp"
+#include "vc/core/util/Parallel.hpp"
 
 using namespace volcart;
 using namespace volcart::texturing;
@@ -17,69 +22,199 @@ namespace
 {
 constexpr double MEDIAN_MEAN_PERCENT_RANGE{0.70};
 
-auto FilterMin(Neighborhood n) -> std::uint16_t
-{
-    return *std::min_element(n.begin(), n.end());
-}
+// Neighborhoods up to this size are sorted with a sorting network
+constexpr std::size_t MAX_NETWORK_SIZE{64};
+
+// Number of mappings processed by a worker at a time
+constexpr std::size_t MAPPINGS_GRAIN_SIZE{2048};
 
-auto FilterMax(Neighborhood n) -> std::uint16_t
+// Branchless compare-exchange
+inline void CompareExchange(std::uint16_t& a, std::uint16_t& b)
 {
-    return *std::max_element(n.begin(), n.end());
+    const auto lo = std::min(a, b);
+    const auto hi = std::max(a, b);
+    a = lo;
+    b = hi;
 }
 
-auto FilterMedian(Neighborhood n) -> std::uint16_t
+// Batcher's merge-exchange sorting network (Knuth, TAOCP 5.2.2, Algorithm M).
+// The sequence of comparisons only depends on n, so small neighborhoods are
+// sorted without the branch mispredictions of a comparison sort.
+void SortingNetwork(std::uint16_t* n, std::size_t size)
 {
-    std::nth_element(n.begin(), n.begin() + n.size() / 2, n.end());
-    return n(n.size() / 2);
+    if (size < 2) {
+        return;
+    }
+
+    std::size_t t{1};
+    while ((std::size_t{1} << t) < size) {
+        t++;
+    }
+
+    for (auto p = std::size_t{1} << (t - 1); p > 0; p >>= 1) {
+        auto q = std::size_t{1} << (t - 1);
+        std::size_t r{0};
+        auto d = p;
+        while (true) {
+            for (std::size_t i = 0; i + d < size; i++) {
+                if ((i & p) == r) {
+                    CompareExchange(n[i], n[i + d]);
+                }
+            }
+            if (q == p) {
+                break;
+            }
+            d = q - p;
+            q >>= 1;
+            r = p;
+        }
+    }
 }
 
-auto FilterMean(Neighborhood n) -> std::uint16_t
+// Sort a neighborhood in place
+void Sort(std::uint16_t* n, std::size_t size)
 {
-    auto sum = std::accumulate(std::begin(n), std::end(n), double{0});
-    return static_cast<std::uint16_t>(std::round(sum / n.size()));
+    if (size <= MAX_NETWORK_SIZE) {
+        SortingNetwork(n, size);
+    } else {
+        std::sort(n, n + size);
+    }
 }
 
-auto FilterMedianMean(Neighborhood n, double range) -> std::uint16_t
-{
-    // If the range is 1.0, it's just a normal mean operation
-    if (AlmostEqual<double>(range, 1.0)) {
-        return FilterMean(n);
+// Compile-time specialized neighborhood reductions. Apply() may reorder the
+// samples in the neighborhood buffer.
+template <Filter F>
+struct FilterKernel;
+
+template <>
+struct FilterKernel<Filter::Minimum> {
+    static auto Apply(std::uint16_t* n, std::size_t size) -> std::uint16_t
+    {
+        auto v = n[0];
+        for (std::size_t i = 1; i < size; i++) {
+            v = std::min(v, n[i]);
+        }
+        return v;
+    }
+};
+
+template <>
+struct FilterKernel<Filter::Maximum> {
+    static auto Apply(std::uint16_t* n, std::size_t size) -> std::uint16_t
+    {
+        auto v = n[0];
+        for (std::size_t i = 1; i < size; i++) {
+            v = std::max(v, n[i]);
+        }
+        return v;
     }
-    if (AlmostEqual<double>(range, 0.0)) {
-        return 0;
+};
+
+template <>
+struct FilterKernel<Filter::Mean> {
+    static auto Apply(std::uint16_t* n, std::size_t size) -> std::uint16_t
+    {
+        std::uint64_t sum{0};
+        for (std::size_t i = 0; i < size; i++) {
+            sum += n[i];
+        }
+        return static_cast<std::uint16_t>(
+            std::round(static_cast<double>(sum) / size));
     }
+};
 
-    // Sort
-    std::sort(n.begin(), n.end());
+template <>
+struct FilterKernel<Filter::Median> {
+    static auto Apply(std::uint16_t* n, std::size_t size) -> std::uint16_t
+    {
+        if (size <= MAX_NETWORK_SIZE) {
+            SortingNetwork(n, size);
+        } else {
+            std::nth_element(n, n + size / 2, n + size);
+        }
+        return n[size / 2];
+    }
+};
 
-    // The number of things we're going to sum
-    auto count = static_cast<std::size_t>(std::ceil(n.size() * range));
-    // The number of things before we start summing
-    auto offset =
-        static_cast<std::size_t>(std::floor((n.size() - count) / 2.0));
+template <>
+struct FilterKernel<Filter::MedianAverage> {
+    static auto Apply(std::uint16_t* n, std::size_t size) -> std::uint16_t
+    {
+        // If the range is 1.0, it's just a normal mean operation
+        constexpr auto range = MEDIAN_MEAN_PERCENT_RANGE;
+        if (AlmostEqual<double>(range, 1.0)) {
+            return FilterKernel<Filter::Mean>::Apply(n, size);
+        }
+        if (AlmostEqual<double>(range, 0.0)) {
+            return 0;
+        }
 
-    // Sum
-    auto sum = std::accumulate(
-        n.begin() + offset, n.begin() + offset + count, double{0});
+        // Sort
+        Sort(n, size);
 
-    // Average
-    return static_cast<std::uint16_t>(std::round(sum / count));
-}
+        // The number of things we're going to sum
+        auto count = static_cast<std::size_t>(std::ceil(size * range));
+        // The number of things before we start summing
+        auto offset =
+            static_cast<std::size_t>(std::floor((size - count) / 2.0));
 
-auto ApplyFilter(const Neighborhood& n, Filter filter) -> std::uint16_t
-{
-    switch (filter) {
-        case Filter::Minimum:
-            return FilterMin(n);
-        case Filter::Maximum:
-            return FilterMax(n);
-        case Filter::Median:
-            return FilterMedian(n);
-        case Filter::Mean:
-            return FilterMean(n);
-        case Filter::MedianAverage:
-            return FilterMedianMean(n, MEDIAN_MEAN_PERCENT_RANGE);
+        // Sum
+        std::uint64_t sum{0};
+        for (auto i = offset; i < offset + count; i++) {
+            sum += n[i];
+        }
+
+        // Average
+        return static_cast<std::uint16_t>(
+            std::round(static_cast<double>(sum) / count));
     }
+};
+
+using Mappings = std::vector<PerPixelMap::Coord2D>;
+
+// Sample and filter the neighborhood of every mapping. Each worker samples
+// into its own reusable buffer, so the per-pixel cost is the sampling itself.
+template <Filter F>
+void Composite(
+    const PerPixelMap& ppm,
+    const Volume::Pointer& vol,
+    NeighborhoodGenerator& gen,
+    const Mappings& mappings,
+    cv::Mat& image,
+    std::size_t threads,
+    const std::function<void(std::size_t)>& progress)
+{
+    threads = NumWorkerThreads(threads);
+    const auto size = gen.size();
+    std::vector<std::vector<std::uint16_t>> buffers(
+        threads, std::vector<std::uint16_t>(size));
+
+    std::mutex progressMutex;
+    std::size_t done{0};
+    ParallelForChunks(
+        0, mappings.size(),
+        [&](auto b, auto e, auto tid) {
+            auto* buffer = buffers[tid].data();
+            for (auto idx = b; idx < e; idx++) {
+                // Generate the neighborhood
+                const auto [y, x] = mappings[idx];
+                const auto& m = ppm.getMapping(y, x);
+                const cv::Vec3d pos{m[0], m[1], m[2]};
+                const cv::Vec3d normal{m[3], m[4], m[5]};
+                gen.sample(vol, pos, normal, buffer);
+
+                // Assign the intensity value at the UV position
+                const auto v = static_cast<int>(y);
+                const auto u = static_cast<int>(x);
+                image.at<std::uint16_t>(v, u) =
+                    FilterKernel<F>::Apply(buffer, size);
+            }
+
+            std::lock_guard<std::mutex> lock(progressMutex);
+            done += e - b;
+            progress(done);
+        },
+        threads, MAPPINGS_GRAIN_SIZE);
 }
 
 }  // namespace
@@ -96,6 +231,31 @@ void CompositeTexture::setGenerator(NeighborhoodGenerator::Pointer g)
 
 void CompositeTexture::setFilter(CompositeTexture::Filter f) { filter_ = f; }
 
+void CompositeTexture::setNumThreads(std::size_t n) { numThreads_ = n; }
+
+auto CompositeTexture::numThreads() const -> std::size_t
+{
+    return numThreads_;
+}
+
+auto CompositeTexture::ApplyFilter(
+    Filter f, std::uint16_t* n, std::size_t size) -> std::uint16_t
+{
+    switch (f) {
+        case Filter::Minimum:
+            return FilterKernel<Filter::Minimum>::Apply(n, size);
+        case Filter::Maximum:
+            return FilterKernel<Filter::Maximum>::Apply(n, size);
+        case Filter::Median:
+            return FilterKernel<Filter::Median>::Apply(n, size);
+        case Filter::Mean:
+            return FilterKernel<Filter::Mean>::Apply(n, size);
+        case Filter::MedianAverage:
+            return FilterKernel<Filter::MedianAverage>::Apply(n, size);
+    }
+    throw std::invalid_argument("Unknown composite filter");
+}
+
 auto CompositeTexture::compute() -> Texture
 {
     if (gen_->dim() < 1) {
@@ -122,21 +282,28 @@ auto CompositeTexture::compute() -> Texture
 
     // Iterate through the mappings
     progressStarted();
-    for (const auto [idx, coord] : enumerate(mappings)) {
-        progressUpdated(idx);
-
-        // Generate the neighborhood
-        const auto [y, x] = coord;
-        const auto& m = ppm_->getMapping(y, x);
-        const cv::Vec3d pos{m[0], m[1], m[2]};
-        const cv::Vec3d normal{m[3], m[4], m[5]};
-        auto neighborhood = gen_->compute(vol_, pos, {normal});
-        Neighborhood::Flatten(neighborhood, 1);
-
-        // Assign the intensity value at the UV position
-        const auto v = static_cast<int>(y);
-        const auto u = static_cast<int>(x);
-        image.at<std::uint16_t>(v, u) = ::ApplyFilter(neighborhood, filter_);
+    auto progress = [this](std::size_t n) { progressUpdated(n); };
+    switch (filter_) {
+        case Filter::Minimum:
+            ::Composite<Filter::Minimum>(
+                *ppm_, vol_, *gen_, mappings, image, numThreads_, progress);
+            break;
+        case Filter::Maximum:
+            ::Composite<Filter::Maximum>(
+                *ppm_, vol_, *gen_, mappings, image, numThreads_, progress);
+            break;
+        case Filter::Median:
+            ::Composite<Filter::Median>(
+                *ppm_, vol_, *gen_, mappings, image, numThreads_, progress);
+            break;
+        case Filter::Mean:
+            ::Composite<Filter::Mean>(
+                *ppm_, vol_, *gen_, mappings, image, numThreads_, progress);
+            break;
+        case Filter::MedianAverage:
+            ::Composite<Filter::MedianAverage>(
+                *ppm_, vol_, *gen_, mappings, image, numThreads_, progress);
+            break;
     }
     progressComplete();
 
@@ -1,6 +1,7 @@
 #include "vc/texturing/FlatteningError.hpp"
 
 #include <algorithm>
+#include <limits>
 
 #include <opencv2/imgproc.hpp>
 
@@ -9,28 +10,58 @@
 #include "vc/core/util/FloatComparison.hpp"
 #include "vc/core/util/Logging.hpp"
 #include "vc/core/util/MeshMath.hpp"
+#include "vc/core/util/Parallel.hpp"
 
 using namespace volcart;
 using namespace volcart::texturing;
 namespace vct = volcart::texturing;
 
-auto GetCellVertices(
-    const ITKMesh::Pointer& mesh,
-    const ITKCell::PointIdentifierContainerType& ids) -> std::vector<cv::Vec3d>
+namespace
 {
+/** Number of faces reduced by each task */
+constexpr std::size_t REDUCE_BLOCK{4096};
 
-    // Output vector
-    std::vector<cv::Vec3d> pts;
-
-    // For each id, add a new vec3d
-    for (const auto& id : ids) {
-        auto p = mesh->GetPoint(id);
-        pts.emplace_back(p[0], p[1], p[2]);
+/** Partial reduction of the metrics of a block of faces */
+struct FaceReduction {
+    double sumL2{0};
+    double area{0};
+    double minL2{std::numeric_limits<double>::max()};
+    double maxL2{std::numeric_limits<double>::lowest()};
+    double minLInf{std::numeric_limits<double>::max()};
+    double maxLInf{std::numeric_limits<double>::lowest()};
+
+    void add(double l2, double lInf)
+    {
+        minL2 = std::min(minL2, l2);
+        maxL2 = std::max(maxL2, l2);
+        minLInf = std::min(minLInf, lInf);
+        maxLInf = std::max(maxLInf, lInf);
     }
+};
 
-    return pts;
+auto NumBlocks(std::size_t numFaces) -> std::size_t
+{
+    return (numFaces + REDUCE_BLOCK - 1) / REDUCE_BLOCK;
 }
 
+/** Combine the block reductions in block order */
+auto Reduce(const std::vector<FaceReduction>& blocks) -> FaceReduction
+{
+    FaceReduction total;
+    if (blocks.empty()) {
+        total.minL2 = total.maxL2 = total.minLInf = total.maxLInf = 0;
+        return total;
+    }
+    for (const auto& b : blocks) {
+        total.sumL2 += b.sumL2;
+        total.area += b.area;
+        total.add(b.minL2, b.minLInf);
+        total.add(b.maxL2, b.maxLInf);
+    }
+    return total;
+}
+}  // namespace
+
 static auto CalculateGammas(
     const cv::Vec3d& p1,
     const cv::Vec3d& p2,
@@ -97,43 +128,63 @@ auto vct::LStretch(
             "Original and flattened meshes have mismatched number of vertices");
     }
 
-    // Iterate over the faces
-    auto cell = mesh3D->GetCells()->Begin();
-    auto end = mesh3D->GetCells()->End();
+    return LStretch(ToMeshArrays(mesh3D), ToMeshArrays(mesh2D));
+}
 
-    // Calculate metrics
-    LStretchMetrics metrics;
-    double sumL2{0};
-    double area3DTotal{0};
-    for (; cell != end; ++cell) {
-        // Get the vertices
-        auto vIds = cell.Value()->GetPointIdsContainer();
-        auto p = GetCellVertices(mesh2D, vIds);
-        auto q = GetCellVertices(mesh3D, vIds);
-
-        // Calculate LStretch(T) for this face
-        const auto& [l2, lInf] =
-            TriLStretch(p[0], p[1], p[2], q[0], q[1], q[2]);
-        metrics.faceL2.push_back(l2);
-        metrics.faceLInf.push_back(lInf);
-
-        // Update global LInf
-        metrics.lInf = std::max(metrics.lInf, lInf);
-
-        // A'(T)
-        auto a = cv::norm(q[1] - q[0]);
-        auto b = cv::norm(q[2] - q[0]);
-        auto c = cv::norm(q[2] - q[1]);
-        auto area3D = meshmath::TriangleArea(a, b, c);
-
-        // sum L2Stretch(T)^2 * A'(T)
-        sumL2 += l2 * l2 * area3D;
-        // sum A'(T)
-        area3DTotal += area3D;
+auto vct::LStretch(const MeshArrays& mesh3D, const MeshArrays& mesh2D)
+    -> LStretchMetrics
+{
+    if (mesh3D.faces.size() != mesh2D.faces.size()) {
+        throw std::runtime_error(
+            "Original and flattened meshes have mismatched number of faces");
+    }
+
+    if (mesh3D.vertices.size() != mesh2D.vertices.size()) {
+        throw std::runtime_error(
+            "Original and flattened meshes have mismatched number of vertices");
     }
 
-    // Calculate global L2
-    metrics.l2 = std::sqrt(sumL2 / area3DTotal);
+    // Calculate the per-face metrics and reduce each block of faces
+    const auto& faces = mesh3D.faces;
+    const auto& p = mesh2D.vertices;
+    const auto& q = mesh3D.vertices;
+    LStretchMetrics metrics;
+    metrics.faceL2.resize(faces.size());
+    metrics.faceLInf.resize(faces.size());
+    std::vector<FaceReduction> blocks(NumBlocks(faces.size()));
+    ParallelFor(0, blocks.size(), [&](std::size_t blk) {
+        auto& r = blocks[blk];
+        auto end = std::min((blk + 1) * REDUCE_BLOCK, faces.size());
+        for (auto f = blk * REDUCE_BLOCK; f < end; f++) {
+            const auto& v = faces[f];
+
+            // Calculate LStretch(T) for this face
+            const auto& [l2, lInf] = TriLStretch(
+                p[v[0]], p[v[1]], p[v[2]], q[v[0]], q[v[1]], q[v[2]]);
+            metrics.faceL2[f] = static_cast<float>(l2);
+            metrics.faceLInf[f] = static_cast<float>(lInf);
+
+            // A'(T)
+            auto a = cv::norm(q[v[1]] - q[v[0]]);
+            auto b = cv::norm(q[v[2]] - q[v[0]]);
+            auto c = cv::norm(q[v[2]] - q[v[1]]);
+            auto area3D = meshmath::TriangleArea(a, b, c);
+
+            // sum L2Stretch(T)^2 * A'(T)
+            r.sumL2 += l2 * l2 * area3D;
+            // sum A'(T)
+            r.area += area3D;
+            r.add(l2, lInf);
+        }
+    });
+    auto total = Reduce(blocks);
+
+    // Calculate global L2 and LInf
+    metrics.l2 = std::sqrt(total.sumL2 / total.area);
+    metrics.lInf = total.maxLInf;
+    metrics.minL2 = total.minL2;
+    metrics.maxL2 = total.maxL2;
+    metrics.minLInf = total.minLInf;
 
     // Return L2Stretch
     return metrics;
@@ -148,15 +199,26 @@ auto vct::InvertLStretchMetrics(const LStretchMetrics& metrics)
     out.l2 = 1.0 / metrics.l2;
 
     // Invert each per-face metric
-    std::transform(
-        metrics.faceL2.begin(), metrics.faceL2.end(),
-        std::back_inserter(out.faceL2), [](auto& v) { return 1.0 / v; });
-    std::transform(
-        metrics.faceLInf.begin(), metrics.faceLInf.end(),
-        std::back_inserter(out.faceLInf), [](auto& v) { return 1.0 / v; });
+    auto numFaces = metrics.faceL2.size();
+    out.faceL2.resize(numFaces);
+    out.faceLInf.resize(numFaces);
+    std::vector<FaceReduction> blocks(NumBlocks(numFaces));
+    ParallelFor(0, blocks.size(), [&](std::size_t blk) {
+        auto& r = blocks[blk];
+        auto end = std::min((blk + 1) * REDUCE_BLOCK, numFaces);
+        for (auto f = blk * REDUCE_BLOCK; f < end; f++) {
+            out.faceL2[f] = 1.F / metrics.faceL2[f];
+            out.faceLInf[f] = 1.F / metrics.faceLInf[f];
+            r.add(out.faceL2[f], out.faceLInf[f]);
+        }
+    });
+    auto total = Reduce(blocks);
 
     // Get the global LInf metric
-    out.lInf = *std::max_element(out.faceLInf.begin(), out.faceLInf.end());
+    out.lInf = total.maxLInf;
+    out.minL2 = total.minL2;
+    out.maxL2 = total.maxL2;
+    out.minLInf = total.minLInf;
 
     return out;
 }
@@ -259,29 +321,40 @@ auto vct::PlotLStretchError(
     const auto& faceL2 = metrics.faceL2;
     const auto& faceLInf = metrics.faceLInf;
 
-    // Plot raw L stretch
-    auto l2Plot = PlotPerFaceError(cellMap, faceL2, 1);
-    auto lInfPlot = PlotPerFaceError(cellMap, faceLInf, 1);
-
-    // Generate mask
-    cv::Mat mask;
-    cellMap.convertTo(mask, CV_32F);
-    cv::threshold(mask, mask, -1, 255, cv::THRESH_BINARY);
-    mask.convertTo(mask, CV_8U);
+    // Plot raw L stretch and generate the mask in a single pass
+    cv::Mat l2Plot(cellMap.rows, cellMap.cols, CV_32FC1);
+    cv::Mat lInfPlot(cellMap.rows, cellMap.cols, CV_32FC1);
+    cv::Mat mask(cellMap.rows, cellMap.cols, CV_8UC1);
+    ParallelFor(0, static_cast<std::size_t>(cellMap.rows), [&](auto row) {
+        auto y = static_cast<int>(row);
+        const auto* cells = cellMap.ptr<std::int32_t>(y);
+        auto* l2 = l2Plot.ptr<float>(y);
+        auto* lInf = lInfPlot.ptr<float>(y);
+        auto* m = mask.ptr<std::uint8_t>(y);
+        for (int x = 0; x < cellMap.cols; x++) {
+            auto cell = cells[x];
+            if (cell >= 0) {
+                l2[x] = faceL2[cell];
+                lInf[x] = faceLInf[cell];
+                m[x] = 255;
+            } else {
+                l2[x] = lInf[x] = 1;
+                m[x] = 0;
+            }
+        }
+    });
 
     // Apply LUT
     auto lut = GetColorMapLUT(cm);
-    auto minMax = std::minmax_element(faceL2.begin(), faceL2.end());
-    auto l2Min = static_cast<float>(*minMax.first);
-    auto l2Max = static_cast<float>(*minMax.second);
+    auto l2Min = static_cast<float>(metrics.minL2);
+    auto l2Max = static_cast<float>(metrics.maxL2);
     if (AlmostEqual(l2Min, 1.F) or AlmostEqual(l2Max, 1.F)) {
         l2Plot = ApplyLUT(l2Plot, lut, l2Min, l2Max);
     } else {
         l2Plot = ApplyLUT(l2Plot, lut, l2Min, 1.F, l2Max);
     }
 
-    auto lInfMin =
-        static_cast<float>(*std::min_element(faceLInf.begin(), faceLInf.end()));
+    auto lInfMin = static_cast<float>(metrics.minLInf);
     auto lInfMax = static_cast<float>(metrics.lInf);
     if (AlmostEqual(lInfMin, 1.F) or AlmostEqual(lInfMax, 1.F)) {
         lInfPlot = ApplyLUT(lInfPlot, lut, lInfMin, lInfMax);
@@ -0,0 +1,149 @@
+#include "vc/texturing/MultiOutputTexture.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "vc/core/util/Parallel.hpp"
+
+using namespace volcart;
+using namespace volcart::texturing;
+
+using Texture = MultiOutputTexture::Texture;
+using Filter = MultiOutputTexture::Filter;
+
+namespace
+{
+// Number of mappings processed by a worker at a time
+constexpr std::size_t MAPPINGS_GRAIN_SIZE{2048};
+}  // namespace
+
+auto MultiOutputTexture::New() -> Pointer
+{
+    return std::make_shared<MultiOutputTexture>();
+}
+
+void MultiOutputTexture::setGenerator(NeighborhoodGenerator::Pointer g)
+{
+    gen_ = std::move(g);
+}
+
+void MultiOutputTexture::setFilters(std::vector<Filter> f)
+{
+    filters_ = std::move(f);
+}
+
+auto MultiOutputTexture::filters() const -> const std::vector<Filter>&
+{
+    return filters_;
+}
+
+void MultiOutputTexture::setGenerateLayers(bool b) { layers_ = b; }
+
+auto MultiOutputTexture::generateLayers() const -> bool { return layers_; }
+
+void MultiOutputTexture::setNumThreads(std::size_t n) { numThreads_ = n; }
+
+auto MultiOutputTexture::numThreads() const -> std::size_t
+{
+    return numThreads_;
+}
+
+auto MultiOutputTexture::compute() -> Texture
+{
+    if (filters_.empty() and not layers_) {
+        throw std::invalid_argument("No texture outputs requested");
+    }
+    if (gen_->dim() < 1) {
+        throw std::invalid_argument("Generator dimension below required");
+    }
+    if (layers_ and gen_->dim() != 1) {
+        throw std::invalid_argument("Layer generation requires a 1D generator");
+    }
+
+    // Setup
+    result_.clear();
+    auto height = static_cast<int>(ppm_->height());
+    auto width = static_cast<int>(ppm_->width());
+    const auto size = gen_->size();
+    const auto numLayers = (layers_) ? size : std::size_t{0};
+
+    // Output images: filters, then layers
+    for (std::size_t i = 0; i < filters_.size() + numLayers; i++) {
+        result_.emplace_back(cv::Mat::zeros(height, width, CV_16UC1));
+    }
+
+    // Get the mappings
+    auto mappings = ppm_->getMappingCoords();
+
+    // Sort the mappings by Z-value
+    std::sort(
+        mappings.begin(), mappings.end(),
+        [&](const auto& lhs, const auto& rhs) {
+            return (*ppm_)(lhs.y, lhs.x)[2] < (*ppm_)(rhs.y, rhs.x)[2];
+        });
+
+    // Per-thread neighborhood buffers
+    auto threads = NumWorkerThreads(numThreads_);
+    std::vector<std::vector<std::uint16_t>> buffers(
+        threads, std::vector<std::uint16_t>(size));
+
+    // Iterate through the mappings
+    progressStarted();
+    std::mutex progressMutex;
+    std::size_t done{0};
+    ParallelForChunks(
+        0, mappings.size(),
+        [&](auto b, auto e, auto tid) {
+            auto* buffer = buffers[tid].data();
+            for (auto idx = b; idx < e; idx++) {
+                // Sample the neighborhood once
+                const auto [y, x] = mappings[idx];
+                const auto& m = ppm_->getMapping(y, x);
+                const cv::Vec3d pos{m[0], m[1], m[2]};
+                const cv::Vec3d normal{m[3], m[4], m[5]};
+                gen_->sample(vol_, pos, normal, buffer);
+
+                const auto v = static_cast<int>(y);
+                const auto u = static_cast<int>(x);
+
+                // Layers first: the filters may reorder the samples
+                auto* layer = result_.data() + filters_.size();
+                for (std::size_t l = 0; l < numLayers; l++) {
+                    layer[l].at<std::uint16_t>(v, u) = buffer[l];
+                }
+
+                // Composite filters
+                for (std::size_t f = 0; f < filters_.size(); f++) {
+                    result_[f].at<std::uint16_t>(v, u) =
+                        CompositeTexture::ApplyFilter(
+                            filters_[f], buffer, size);
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(progressMutex);
+            done += e - b;
+            progressUpdated(done);
+        },
+        threads, MAPPINGS_GRAIN_SIZE);
+    progressComplete();
+
+    return result_;
+}
+
+auto MultiOutputTexture::filterTextures() const -> Texture
+{
+    auto end = std::min(filters_.size(), result_.size());
+    return {result_.begin(), result_.begin() + end};
+}
+
+auto MultiOutputTexture::layerTextures() const -> Texture
+{
+    auto begin = std::min(filters_.size(), result_.size());
+    return {result_.begin() + begin, result_.end()};
+}
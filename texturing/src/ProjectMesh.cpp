@@ -1,7 +1,11 @@
 #include "vc/texturing/ProjectMesh.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <limits>
 #include <utility>
+#include <vector>
 
 #include <bvh/bvh.hpp>
 #include <bvh/primitive_intersectors.hpp>
@@ -11,14 +15,18 @@
 #include <bvh/triangle.hpp>
 #include <bvh/vector.hpp>
 #include <vtkOBBTree.h>
-#include <vtkPointData.h>
 
+#include "vc/core/types/MeshArrays.hpp"
 #include "vc/core/util/BarycentricCoordinates.hpp"
-#include "vc/core/util/Iteration.hpp"
+#include "vc/core/util/Parallel.hpp"
+#include "vc/meshing/CalculateNormals.hpp"
 #include "vc/meshing/ITK2VTK.hpp"
 
 static constexpr std::uint8_t MASK_TRUE{255};
 
+// Rasterizer tile width and height in pixels
+static constexpr int TILE_SIZE{64};
+
 using Scalar = double;
 using Vector3 = bvh::Vector3<Scalar>;
 using Triangle = bvh::Triangle<Scalar>;
@@ -70,6 +78,18 @@ void vct::ProjectMesh::setUseFirstIntersection(bool useFirstIntersection)
     useFirstIntersection_ = useFirstIntersection;
 }
 
+void vct::ProjectMesh::setNumThreads(std::size_t n) { numThreads_ = n; }
+
+namespace
+{
+// Signed double area of the 2D triangle (a, b, p)
+auto EdgeFunction(
+    const cv::Vec3d& a, const cv::Vec3d& b, double x, double y) -> double
+{
+    return (b[0] - a[0]) * (y - a[1]) - (b[1] - a[1]) * (x - a[0]);
+}
+}  // namespace
+
 auto vct::ProjectMesh::compute() -> vc::PerPixelMap
 {
     if (!inputMesh_) {
@@ -84,17 +104,25 @@ auto vct::ProjectMesh::compute() -> vc::PerPixelMap
         }
     }
 
-    // Convert input mesh to VTK
-    auto vtkMesh = vtkSmartPointer<vtkPolyData>::New();
-    vcm::ITK2VTK(inputMesh_, vtkMesh);
+    // Vertex normals are interpolated into the PPM
+    auto mesh = inputMesh_;
+    if (mesh->GetPointData()->Size() != mesh->GetNumberOfPoints()) {
+        vcm::CalculateNormals normCalc(mesh);
+        mesh = normCalc.compute();
+    }
+    auto arrays = ToMeshArrays(mesh, true);
+    const auto& verts = arrays.vertices;
+    const auto& normals = arrays.normals;
+    const auto& faces = arrays.faces;
 
     // Computes the OBB and returns the 3 axes relative to the box
+    auto vtkMesh = vtkSmartPointer<vtkPolyData>::New();
+    vcm::ITK2VTK(mesh, vtkMesh);
     cv::Vec3d origin, b0, b1, b2;
     double size[3];
     auto obbTree = vtkSmartPointer<vtkOBBTree>::New();
     obbTree->ComputeOBB(vtkMesh, origin.val, b0.val, b1.val, b2.val, size);
-    obbTree->SetDataSet(vtkMesh);
-    obbTree->BuildLocator();
+    vtkMesh = nullptr;
 
     // Set the marching parameters
     if (mode_ == SampleMode::Rate) {
@@ -117,17 +145,182 @@ auto vct::ProjectMesh::compute() -> vc::PerPixelMap
         b2 = normedY.cross(normedX);
     }
 
+    // Write a surface point into the outputs
+    auto assign = [&](int y, int x, std::size_t f, const cv::Vec3d& xyz) {
+        const auto& face = faces[f];
+        const auto& a = verts[face[0]];
+        const auto& b = verts[face[1]];
+        const auto& c = verts[face[2]];
+
+        // Interpolate the vertex normal for this point
+        auto bary = CartesianToBarycentric(xyz, a, b, c);
+        auto xyzNorm = BarycentricNormalInterpolation(
+            bary, normals[face[0]], normals[face[1]], normals[face[2]]);
+
+        // Assign the cell index to the cell map
+        cellMap.at<std::int32_t>(y, x) = static_cast<std::int32_t>(f);
+
+        // Assign 3D position to the lookup map and update the mask
+        outputPPM_(y, x) = cv::Vec6d{xyz(0),     xyz(1),     xyz(2),
+                                     xyzNorm(0), xyzNorm(1), xyzNorm(2)};
+        mask.at<std::uint8_t>(y, x) = MASK_TRUE;
+    };
+
+    ///// Orthographic projection: rasterize the faces /////
+    if (not tfm_) {
+        // Project the vertices into (pixel x, pixel y, depth along b2)
+        auto normedZ = b2 / cv::norm(b2);
+        std::vector<cv::Vec3d> proj(verts.size());
+        ParallelFor(
+            0, verts.size(),
+            [&](std::size_t v) {
+                auto d = verts[v] - origin;
+                proj[v] = {
+                    d.dot(normedX) / sampleRateX_,
+                    d.dot(normedY) / sampleRateY_, d.dot(normedZ)};
+            },
+            numThreads_);
+
+        // Pixel bounds of each face, or an empty range if it's off-image
+        auto pixelBounds = [&](std::size_t f) -> cv::Vec4i {
+            const auto& a = proj[faces[f][0]];
+            const auto& b = proj[faces[f][1]];
+            const auto& c = proj[faces[f][2]];
+            auto x0 = std::ceil(std::min({a[0], b[0], c[0]}));
+            auto x1 = std::floor(std::max({a[0], b[0], c[0]}));
+            auto y0 = std::ceil(std::min({a[1], b[1], c[1]}));
+            auto y1 = std::floor(std::max({a[1], b[1], c[1]}));
+            x0 = std::max(x0, 0.0);
+            y0 = std::max(y0, 0.0);
+            x1 = std::min(x1, ppmWidth_ - 1.0);
+            y1 = std::min(y1, ppmHeight_ - 1.0);
+            if (not(x0 <= x1 and y0 <= y1)) {
+                return {0, -1, 0, -1};
+            }
+            return {
+                static_cast<int>(x0), static_cast<int>(x1),
+                static_cast<int>(y0), static_cast<int>(y1)};
+        };
+
+        // Bin the faces into the tiles they overlap
+        auto tilesX = (ppmWidth_ + TILE_SIZE - 1) / TILE_SIZE;
+        auto tilesY = (ppmHeight_ + TILE_SIZE - 1) / TILE_SIZE;
+        auto numTiles = static_cast<std::size_t>(tilesX) * tilesY;
+        std::vector<std::size_t> binOffsets(numTiles + 1, 0);
+        auto forEachTile = [&](const cv::Vec4i& px, auto fn) {
+            if (px[1] < px[0]) {
+                return;
+            }
+            for (auto ty = px[2] / TILE_SIZE; ty <= px[3] / TILE_SIZE; ty++) {
+                for (auto tx = px[0] / TILE_SIZE; tx <= px[1] / TILE_SIZE;
+                     tx++) {
+                    fn(static_cast<std::size_t>(ty) * tilesX + tx);
+                }
+            }
+        };
+        for (std::size_t f = 0; f < faces.size(); f++) {
+            forEachTile(pixelBounds(f), [&](auto t) { binOffsets[t + 1]++; });
+        }
+        for (std::size_t t = 0; t < numTiles; t++) {
+            binOffsets[t + 1] += binOffsets[t];
+        }
+        std::vector<std::size_t> bins(binOffsets.back());
+        {
+            std::vector<std::size_t> cursor(
+                binOffsets.begin(), binOffsets.end() - 1);
+            for (std::size_t f = 0; f < faces.size(); f++) {
+                forEachTile(
+                    pixelBounds(f), [&](auto t) { bins[cursor[t]++] = f; });
+            }
+        }
+
+        // Scan convert each tile with its own depth buffer
+        static constexpr auto NO_FACE = std::numeric_limits<std::size_t>::max();
+        static constexpr double EDGE_EPS{1e-9};
+        ParallelFor(
+            0, numTiles,
+            [&](std::size_t t) {
+                if (binOffsets[t] == binOffsets[t + 1]) {
+                    return;
+                }
+                auto tx0 = static_cast<int>(t % tilesX) * TILE_SIZE;
+                auto ty0 = static_cast<int>(t / tilesX) * TILE_SIZE;
+                auto tw = std::min(TILE_SIZE, ppmWidth_ - tx0);
+                auto th = std::min(TILE_SIZE, ppmHeight_ - ty0);
+                std::vector<std::size_t> best(tw * th, NO_FACE);
+                std::vector<double> depth(tw * th, 0);
+                std::vector<cv::Vec3d> weights(tw * th);
+
+                for (auto i = binOffsets[t]; i < binOffsets[t + 1]; i++) {
+                    auto f = bins[i];
+                    const auto& a = proj[faces[f][0]];
+                    const auto& b = proj[faces[f][1]];
+                    const auto& c = proj[faces[f][2]];
+                    auto area = EdgeFunction(a, b, c[0], c[1]);
+                    if (area == 0) {
+                        continue;
+                    }
+
+                    auto px = pixelBounds(f);
+                    auto x0 = std::max(px[0], tx0);
+                    auto x1 = std::min(px[1], tx0 + tw - 1);
+                    auto y0 = std::max(px[2], ty0);
+                    auto y1 = std::min(px[3], ty0 + th - 1);
+                    for (auto y = y0; y <= y1; y++) {
+                        for (auto x = x0; x <= x1; x++) {
+                            auto w0 = EdgeFunction(b, c, x, y) / area;
+                            auto w1 = EdgeFunction(c, a, x, y) / area;
+                            auto w2 = 1.0 - w0 - w1;
+                            if (w0 < -EDGE_EPS or w1 < -EDGE_EPS or
+                                w2 < -EDGE_EPS) {
+                                continue;
+                            }
+
+                            // Keep the first or last surface along b2
+                            auto d = w0 * a[2] + w1 * b[2] + w2 * c[2];
+                            auto idx = (y - ty0) * tw + (x - tx0);
+                            auto closer = useFirstIntersection_
+                                              ? d < depth[idx]
+                                              : d > depth[idx];
+                            if (best[idx] == NO_FACE or closer) {
+                                best[idx] = f;
+                                depth[idx] = d;
+                                weights[idx] = {w0, w1, w2};
+                            }
+                        }
+                    }
+                }
+
+                for (int y = 0; y < th; y++) {
+                    for (int x = 0; x < tw; x++) {
+                        auto idx = y * tw + x;
+                        auto f = best[idx];
+                        if (f == NO_FACE) {
+                            continue;
+                        }
+                        const auto& face = faces[f];
+                        auto xyz = BarycentricToCartesian(
+                            weights[idx], verts[face[0]], verts[face[1]],
+                            verts[face[2]]);
+                        assign(ty0 + y, tx0 + x, f, xyz);
+                    }
+                }
+            },
+            numThreads_, 1);
+
+        outputPPM_.setMask(mask);
+        outputPPM_.setCellMap(cellMap);
+        return outputPPM_;
+    }
+
+    ///// Registered projection: cast a ray for each pixel /////
     // Create BVH for mesh
     std::vector<Triangle> triangles;
-    for (auto cell = inputMesh_->GetCells()->Begin();
-         cell != inputMesh_->GetCells()->End(); ++cell) {
-        auto aIdx = cell.Value()->GetPointIdsContainer()[0];
-        auto bIdx = cell.Value()->GetPointIdsContainer()[1];
-        auto cIdx = cell.Value()->GetPointIdsContainer()[2];
-
-        auto a = inputMesh_->GetPoint(aIdx);
-        auto b = inputMesh_->GetPoint(bIdx);
-        auto c = inputMesh_->GetPoint(cIdx);
+    triangles.reserve(faces.size());
+    for (const auto& f : faces) {
+        const auto& a = verts[f[0]];
+        const auto& b = verts[f[1]];
+        const auto& c = verts[f[2]];
 
         // Add the face to the BVH tree
         triangles.emplace_back(
@@ -141,8 +334,6 @@ auto vct::ProjectMesh::compute() -> vc::PerPixelMap
     auto meshBBox =
         bvh::compute_bounding_boxes_union(bboxes.get(), triangles.size());
     builder.build(meshBBox, bboxes.get(), centers.get(), triangles.size());
-    Intersector intersector(bvh, triangles.data());
-    Traverser traverser(bvh);
 
     auto tfm = tfm_;
     if (useInverse_) {
@@ -150,83 +341,50 @@ auto vct::ProjectMesh::compute() -> vc::PerPixelMap
             tfm_->GetInverseTransform().GetPointer());
     }
 
-    // Loop over every pixel of the image
-    for (const auto uv : vc::range2D(ppmHeight_, ppmWidth_)) {
-        const auto& u = uv.second;
-        const auto& v = uv.first;
-
-        cv::Vec3d uOffset;
-        cv::Vec3d vOffset;
-        if (tfm) {
-            Point p;
-            p[0] = u;
-            p[1] = v;
-            auto pT = tfm->TransformPoint(p);
-            uOffset = pT[0] / textureWidth_ * b0;
-            vOffset = pT[1] / textureHeight_ * b1;
-        } else {
-            // Convert pixel position to offset in mesh's XY space
-            uOffset = u * sampleRateX_ * normedX;
-            vOffset = v * sampleRateY_ * normedY;
-        }
-
-        auto a0 = origin + uOffset + vOffset;
-        auto a1 = b2;
-        if (not useFirstIntersection_) {
-            a0 += b2 * cv::norm(b2);
-            a1 *= -1;
-        }
-
-        // Intersect a ray with the data structure
-        Vector3 start(a0[0], a0[1], a0[2]);
-        Vector3 dir(a1[0], a1[1], a1[2]);
-        Ray ray(start, dir, 0.0, cv::norm(b2) * 2);
-        auto hit = traverser.traverse(ray, intersector);
-        if (not hit) {
-            continue;
-        }
-
-        // Cell info
-        auto cellId = static_cast<vtkIdType>(hit->primitive_index);
-        auto pointIds = vtkSmartPointer<vtkIdList>::New();
-        vtkMesh->GetCellPoints(cellId, pointIds);
-
-        // Make sure we only have three vertices
-        assert(pointIds->GetNumberOfIds() == 3);
-        auto v_id0 = pointIds->GetId(0);
-        auto v_id1 = pointIds->GetId(1);
-        auto v_id2 = pointIds->GetId(2);
-
-        // Get the 3D positions of each vertex
-        cv::Vec3d A{vtkMesh->GetPoint(v_id0)};
-        cv::Vec3d B{vtkMesh->GetPoint(v_id1)};
-        cv::Vec3d C{vtkMesh->GetPoint(v_id2)};
-
-        // Intersection point UV coords
-        auto inter = hit->intersection;
-        cv::Vec3d bCoord{inter.u, inter.v, 1 - inter.u - inter.v};
-
-        // Get the 3D position of the intersection pt
-        auto xyz = BarycentricToCartesian(bCoord, A, B, C);
-
-        // Interpolate the vertex normal for this point
-        cv::Vec3d n0, n1, n2;
-        auto bary = CartesianToBarycentric(xyz, A, B, C);
-        vtkMesh->GetPointData()->GetNormals()->GetTuple(v_id0, n0.val);
-        vtkMesh->GetPointData()->GetNormals()->GetTuple(v_id1, n1.val);
-        vtkMesh->GetPointData()->GetNormals()->GetTuple(v_id2, n2.val);
-        auto xyzNorm = BarycentricNormalInterpolation(bary, n0, n1, n2);
-
-        // Assign the cell index to the cell map
-        auto intU = static_cast<int>(u);
-        auto intV = static_cast<int>(v);
-        cellMap.at<std::int32_t>(intV, intU) = static_cast<int>(cellId);
-
-        // Assign 3D position to the lookup map and update the mask
-        outputPPM_(v, u) = cv::Vec6d{xyz(0),     xyz(1),     xyz(2),
-                                     xyzNorm(0), xyzNorm(1), xyzNorm(2)};
-        mask.at<std::uint8_t>(v, u) = MASK_TRUE;
-    }
+    // Loop over every row of the image
+    ParallelForChunks(
+        0, static_cast<std::size_t>(ppmHeight_),
+        [&](std::size_t rowBegin, std::size_t rowEnd, std::size_t) {
+            Intersector intersector(bvh, triangles.data());
+            Traverser traverser(bvh);
+            for (auto v = rowBegin; v < rowEnd; v++) {
+                for (int u = 0; u < ppmWidth_; u++) {
+                    Point p;
+                    p[0] = u;
+                    p[1] = static_cast<double>(v);
+                    auto pT = tfm->TransformPoint(p);
+                    auto uOffset = pT[0] / textureWidth_ * b0;
+                    auto vOffset = pT[1] / textureHeight_ * b1;
+
+                    auto a0 = origin + uOffset + vOffset;
+                    auto a1 = b2;
+                    if (not useFirstIntersection_) {
+                        a0 += b2 * cv::norm(b2);
+                        a1 *= -1;
+                    }
+
+                    // Intersect a ray with the data structure
+                    Vector3 start(a0[0], a0[1], a0[2]);
+                    Vector3 dir(a1[0], a1[1], a1[2]);
+                    Ray ray(start, dir, 0.0, cv::norm(b2) * 2);
+                    auto hit = traverser.traverse(ray, intersector);
+                    if (not hit) {
+                        continue;
+                    }
+
+                    // Get the 3D position of the intersection pt
+                    auto f = hit->primitive_index;
+                    const auto& face = faces[f];
+                    auto inter = hit->intersection;
+                    cv::Vec3d bCoord{inter.u, inter.v, 1 - inter.u - inter.v};
+                    auto xyz = BarycentricToCartesian(
+                        bCoord, verts[face[0]], verts[face[1]],
+                        verts[face[2]]);
+                    assign(static_cast<int>(v), u, f, xyz);
+                }
+            }
+        },
+        numThreads_);
 
     outputPPM_.setMask(mask);
     outputPPM_.setCellMap(cellMap);
@@ -0,0 +1,447 @@
+#include "vc/texturing/SparseLSCM.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+
+#include "vc/core/util/Logging.hpp"
+#include "vc/core/util/Parallel.hpp"
+
+using namespace volcart;
+using namespace volcart::texturing;
+
+using UVs = std::vector<cv::Vec2d>;
+
+namespace
+{
+/** Block size for deterministic parallel reductions */
+constexpr std::size_t REDUCE_BLOCK{4096};
+
+/** Deterministic parallel dot product */
+auto Dot(const UVs& a, const UVs& b, std::size_t threads) -> double
+{
+    auto numBlocks = (a.size() + REDUCE_BLOCK - 1) / REDUCE_BLOCK;
+    std::vector<double> partials(numBlocks, 0);
+    ParallelFor(
+        0, numBlocks,
+        [&](std::size_t blk) {
+            auto end = std::min((blk + 1) * REDUCE_BLOCK, a.size());
+            double sum{0};
+            for (auto i = blk * REDUCE_BLOCK; i < end; i++) {
+                sum += a[i].dot(b[i]);
+            }
+            partials[blk] = sum;
+        },
+        threads);
+    return std::accumulate(partials.begin(), partials.end(), 0.0);
+}
+
+/** Lay out a 3D triangle in its local 2D frame */
+auto LocalTriangle(
+    const cv::Vec3d& p0, const cv::Vec3d& p1, const cv::Vec3d& p2)
+    -> std::array<cv::Vec2d, 3>
+{
+    auto e01 = p1 - p0;
+    auto l01 = cv::norm(e01);
+    if (l01 == 0) {
+        return {};
+    }
+    cv::Vec3d x = e01 / l01;
+    auto e02 = p2 - p0;
+    return {
+        cv::Vec2d{0, 0}, cv::Vec2d{l01, 0},
+        cv::Vec2d{e02.dot(x), cv::norm(e02.cross(x))}};
+}
+
+/** Lay out a triangle with the given interior angles */
+auto LocalTriangle(const cv::Vec3d& angles) -> std::array<cv::Vec2d, 3>
+{
+    auto l02 = std::sin(angles[1]);
+    return {
+        cv::Vec2d{0, 0}, cv::Vec2d{std::sin(angles[2]), 0},
+        cv::Vec2d{l02 * std::cos(angles[0]), l02 * std::sin(angles[0])}};
+}
+}  // namespace
+
+void SparseLSCM::setMesh(const MeshArrays& mesh) { mesh_ = &mesh; }
+
+void SparseLSCM::setFaceAngles(std::vector<FaceAngles> angles)
+{
+    angles_ = std::move(angles);
+}
+
+void SparseLSCM::setInitialUVMap(const UVMap::Pointer& uvMap)
+{
+    initUV_ = uvMap;
+}
+
+void SparseLSCM::setNumThreads(std::size_t n) { numThreads_ = n; }
+
+void SparseLSCM::setMaxIterations(std::size_t i) { maxIters_ = i; }
+
+void SparseLSCM::setTolerance(double t) { tol_ = t; }
+
+auto SparseLSCM::iterations() const -> std::size_t { return iters_; }
+
+auto SparseLSCM::residual() const -> double { return residual_; }
+
+auto SparseLSCM::compute() -> std::vector<cv::Vec2d>
+{
+    if (mesh_ == nullptr or mesh_->faces.empty()) {
+        throw std::runtime_error("Input mesh is empty.");
+    }
+    if (not angles_.empty() and angles_.size() != mesh_->faces.size()) {
+        throw std::invalid_argument("Face angles do not match input mesh.");
+    }
+
+    Logger()->debug("Assembling LSCM system");
+    assemble_();
+    initialize_();
+    Logger()->debug("Solving LSCM system");
+    solve_();
+
+    // Release the system
+    std::vector<std::size_t>().swap(offsets_);
+    std::vector<std::size_t>().swap(neighbors_);
+    std::vector<cv::Matx22d>().swap(blocks_);
+    std::vector<bool>().swap(pinned_);
+
+    return std::move(uvs_);
+}
+
+void SparseLSCM::assemble_()
+{
+    const auto& verts = mesh_->vertices;
+    const auto& faces = mesh_->faces;
+    auto numVerts = verts.size();
+
+    // Vertex to face adjacency
+    std::vector<std::size_t> vfOffsets(numVerts + 1, 0);
+    for (const auto& f : faces) {
+        for (const auto& v : f) {
+            vfOffsets[v + 1]++;
+        }
+    }
+    std::partial_sum(vfOffsets.begin(), vfOffsets.end(), vfOffsets.begin());
+    std::vector<std::size_t> vfFaces(vfOffsets.back());
+    std::vector<std::size_t> cursor(vfOffsets.begin(), vfOffsets.end() - 1);
+    for (std::size_t f = 0; f < faces.size(); f++) {
+        for (const auto& v : faces[f]) {
+            vfFaces[cursor[v]++] = f;
+        }
+    }
+
+    // Vertex neighbors (including the vertex itself). Each face contributes
+    // at most two neighbors, so fill an upper bound and then compact.
+    std::vector<std::size_t> counts(numVerts);
+    std::vector<std::size_t> scratch(2 * vfOffsets.back() + numVerts);
+    ParallelFor(
+        0, numVerts,
+        [&](std::size_t v) {
+            auto begin = scratch.begin() + 2 * vfOffsets[v] + v;
+            auto end = begin;
+            *end++ = v;
+            for (auto i = vfOffsets[v]; i < vfOffsets[v + 1]; i++) {
+                for (const auto& n : faces[vfFaces[i]]) {
+                    if (n != v) {
+                        *end++ = n;
+                    }
+                }
+            }
+            std::sort(begin, end);
+            auto last = std::unique(begin, end);
+            counts[v] = static_cast<std::size_t>(last - begin);
+        },
+        numThreads_);
+    offsets_.assign(numVerts + 1, 0);
+    std::partial_sum(counts.begin(), counts.end(), offsets_.begin() + 1);
+    neighbors_.resize(offsets_.back());
+    ParallelFor(
+        0, numVerts,
+        [&](std::size_t v) {
+            auto begin = scratch.begin() + 2 * vfOffsets[v] + v;
+            std::copy(
+                begin, begin + counts[v], neighbors_.begin() + offsets_[v]);
+        },
+        numThreads_);
+    std::vector<std::size_t>().swap(scratch);
+    std::vector<std::size_t>().swap(counts);
+
+    // Per-face LSCM coefficients, pre-scaled by 1 / sqrt(2 * area)
+    std::vector<std::array<cv::Vec2d, 3>> coeffs(faces.size());
+    ParallelFor(
+        0, faces.size(),
+        [&](std::size_t f) {
+            const auto& face = faces[f];
+            auto q = angles_.empty()
+                         ? LocalTriangle(
+                               verts[face[0]], verts[face[1]], verts[face[2]])
+                         : LocalTriangle(angles_[f]);
+            auto d = q[1][0] * q[2][1] - q[1][1] * q[2][0];
+            if (not(d > 0) or not std::isfinite(d)) {
+                coeffs[f] = {};
+                return;
+            }
+            auto s = 1.0 / std::sqrt(d);
+            coeffs[f] = {
+                s * (q[2] - q[1]), s * (q[0] - q[2]), s * (q[1] - q[0])};
+        },
+        numThreads_);
+
+    // Assemble the normal equations row-by-row so that each vertex's blocks
+    // are only written by one thread
+    blocks_.assign(neighbors_.size(), cv::Matx22d::zeros());
+    ParallelFor(
+        0, numVerts,
+        [&](std::size_t v) {
+            auto nBegin = neighbors_.begin() + offsets_[v];
+            auto nEnd = neighbors_.begin() + offsets_[v + 1];
+            for (auto i = vfOffsets[v]; i < vfOffsets[v + 1]; i++) {
+                auto f = vfFaces[i];
+                const auto& face = faces[f];
+                const auto& w = coeffs[f];
+                auto j = static_cast<std::size_t>(
+                    std::find(face.begin(), face.end(), v) - face.begin());
+                for (std::size_t k = 0; k < 3; k++) {
+                    auto a = w[j].dot(w[k]);
+                    auto b = w[j][1] * w[k][0] - w[j][0] * w[k][1];
+                    auto slot = std::lower_bound(nBegin, nEnd, face[k]) -
+                                neighbors_.begin();
+                    blocks_[slot] += cv::Matx22d(a, b, -b, a);
+                }
+            }
+        },
+        numThreads_);
+}
+
+void SparseLSCM::initialize_()
+{
+    const auto& verts = mesh_->vertices;
+    auto numVerts = verts.size();
+    uvs_.assign(numVerts, {0, 0});
+    std::vector<std::uint8_t> known(numVerts, 0);
+
+    // Warm start from a previous parameterization
+    std::size_t numKnown{0};
+    if (initUV_ and not initUV_->empty()) {
+        auto ratio = initUV_->ratio();
+        for (std::size_t v = 0; v < numVerts; v++) {
+            if (initUV_->contains(v)) {
+                auto uv = initUV_->get(v, UVMap::Origin::TopLeft);
+                uvs_[v] = {uv[0] * ratio.width, uv[1] * ratio.height};
+                known[v] = 1;
+                numKnown++;
+            }
+        }
+
+        if (numKnown < 2) {
+            Logger()->warn(
+                "Initial UV map does not match input mesh. Ignoring.");
+            std::fill(known.begin(), known.end(), 0);
+            numKnown = 0;
+        }
+    }
+
+    // Initialize new vertices from their known neighbors
+    if (numKnown > 0 and numKnown < numVerts) {
+        auto filled = known;
+        auto next = uvs_;
+        bool changed{true};
+        while (changed) {
+            changed = false;
+            for (std::size_t v = 0; v < numVerts; v++) {
+                if (filled[v] != 0) {
+                    continue;
+                }
+                cv::Vec2d sum{0, 0};
+                std::size_t cnt{0};
+                for (auto i = offsets_[v]; i < offsets_[v + 1]; i++) {
+                    if (filled[neighbors_[i]] == 1) {
+                        sum += uvs_[neighbors_[i]];
+                        cnt++;
+                    }
+                }
+                if (cnt > 0) {
+                    next[v] = sum / static_cast<double>(cnt);
+                    filled[v] = 2;
+                    changed = true;
+                }
+            }
+            uvs_ = next;
+            std::replace(filled.begin(), filled.end(), 2, 1);
+        }
+    }
+
+    // Otherwise, project onto the best-fit plane
+    else if (numKnown == 0) {
+        cv::Vec3d centroid{0, 0, 0};
+        for (const auto& p : verts) {
+            centroid += p;
+        }
+        centroid /= static_cast<double>(numVerts);
+        cv::Matx33d cov = cv::Matx33d::zeros();
+        for (const auto& p : verts) {
+            auto d = p - centroid;
+            for (int i = 0; i < 3; i++) {
+                for (int j = 0; j < 3; j++) {
+                    cov(i, j) += d[i] * d[j];
+                }
+            }
+        }
+        cv::Matx31d evals;
+        cv::Matx33d evecs;
+        cv::eigen(cov, evals, evecs);
+        cv::Vec3d e0{evecs(0, 0), evecs(0, 1), evecs(0, 2)};
+        cv::Vec3d e1{evecs(1, 0), evecs(1, 1), evecs(1, 2)};
+        for (std::size_t v = 0; v < numVerts; v++) {
+            auto d = verts[v] - centroid;
+            uvs_[v] = {d.dot(e0), d.dot(e1)};
+        }
+
+        // Keep the orientation of the projected faces
+        double signedArea{0};
+        for (const auto& f : mesh_->faces) {
+            auto a = uvs_[f[1]] - uvs_[f[0]];
+            auto b = uvs_[f[2]] - uvs_[f[0]];
+            signedArea += a[0] * b[1] - a[1] * b[0];
+        }
+        if (signedArea < 0) {
+            for (auto& uv : uvs_) {
+                uv[1] = -uv[1];
+            }
+        }
+        std::fill(known.begin(), known.end(), 1);
+    }
+
+    // Pin the vertices at the extremes of the initial U axis
+    pinned_.assign(numVerts, false);
+    std::size_t minIdx{numVerts};
+    std::size_t maxIdx{numVerts};
+    for (std::size_t v = 0; v < numVerts; v++) {
+        if (known[v] == 0 or offsets_[v + 1] - offsets_[v] < 2) {
+            continue;
+        }
+        if (minIdx == numVerts or uvs_[v][0] < uvs_[minIdx][0]) {
+            minIdx = v;
+        }
+        if (maxIdx == numVerts or uvs_[v][0] > uvs_[maxIdx][0]) {
+            maxIdx = v;
+        }
+    }
+    if (minIdx == numVerts or minIdx == maxIdx) {
+        throw std::runtime_error("Failed to select LSCM pinned vertices.");
+    }
+    pinned_[minIdx] = pinned_[maxIdx] = true;
+
+    // Unreferenced vertices keep their initial positions
+    for (std::size_t v = 0; v < numVerts; v++) {
+        auto self = std::lower_bound(
+                        neighbors_.begin() + offsets_[v],
+                        neighbors_.begin() + offsets_[v + 1], v) -
+                    neighbors_.begin();
+        if (blocks_[self](0, 0) <= 0) {
+            pinned_[v] = true;
+        }
+    }
+}
+
+void SparseLSCM::solve_()
+{
+    auto numVerts = uvs_.size();
+
+    // y = A * x, treating pinned vertices as identity rows and columns
+    auto multiply = [&](const UVs& x, UVs& y) {
+        ParallelFor(
+            0, numVerts,
+            [&](std::size_t v) {
+                if (pinned_[v]) {
+                    y[v] = x[v];
+                    return;
+                }
+                cv::Vec2d sum{0, 0};
+                for (auto i = offsets_[v]; i < offsets_[v + 1]; i++) {
+                    if (not pinned_[neighbors_[i]]) {
+                        sum += blocks_[i] * x[neighbors_[i]];
+                    }
+                }
+                y[v] = sum;
+            },
+            numThreads_);
+    };
+
+    // Right-hand side and Jacobi preconditioner
+    UVs b(numVerts);
+    std::vector<double> invDiag(numVerts, 1);
+    ParallelFor(
+        0, numVerts,
+        [&](std::size_t v) {
+            if (pinned_[v]) {
+                b[v] = uvs_[v];
+                return;
+            }
+            cv::Vec2d sum{0, 0};
+            for (auto i = offsets_[v]; i < offsets_[v + 1]; i++) {
+                auto n = neighbors_[i];
+                if (n == v) {
+                    invDiag[v] = 1.0 / blocks_[i](0, 0);
+                } else if (pinned_[n]) {
+                    sum -= blocks_[i] * uvs_[n];
+                }
+            }
+            b[v] = sum;
+        },
+        numThreads_);
+
+    // Preconditioned conjugate gradient
+    UVs r(numVerts);
+    UVs z(numVerts);
+    UVs p(numVerts);
+    UVs ap(numVerts);
+    multiply(uvs_, ap);
+    ParallelFor(
+        0, numVerts,
+        [&](std::size_t v) {
+            r[v] = b[v] - ap[v];
+            z[v] = invDiag[v] * r[v];
+            p[v] = z[v];
+        },
+        numThreads_);
+
+    auto bNorm = std::sqrt(Dot(b, b, numThreads_));
+    if (bNorm == 0) {
+        bNorm = 1;
+    }
+    auto rz = Dot(r, z, numThreads_);
+    residual_ = std::sqrt(Dot(r, r, numThreads_)) / bNorm;
+    iters_ = 0;
+    while (residual_ > tol_ and iters_ < maxIters_) {
+        multiply(p, ap);
+        auto alpha = rz / Dot(p, ap, numThreads_);
+        ParallelFor(
+            0, numVerts,
+            [&](std::size_t v) {
+                uvs_[v] += alpha * p[v];
+                r[v] -= alpha * ap[v];
+                z[v] = invDiag[v] * r[v];
+            },
+            numThreads_);
+        auto rzNew = Dot(r, z, numThreads_);
+        auto beta = rzNew / rz;
+        rz = rzNew;
+        ParallelFor(
+            0, numVerts, [&](std::size_t v) { p[v] = z[v] + beta * p[v]; },
+            numThreads_);
+        residual_ = std::sqrt(Dot(r, r, numThreads_)) / bNorm;
+        iters_++;
+    }
+
+    if (residual_ > tol_) {
+        Logger()->warn(
+            "LSCM solver did not converge after {} iterations. Residual: "
+            "{:.5g}",
+            iters_, residual_);
+    }
+}
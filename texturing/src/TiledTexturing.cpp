@@ -0,0 +1,240 @@
+#include "vc/texturing/TiledTexturing.hpp"
+
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include "vc/core/io/ImageIO.hpp"
+#include "vc/core/types/Metadata.hpp"
+#include "vc/core/util/Logging.hpp"
+
+using namespace volcart;
+using namespace volcart::texturing;
+namespace fs = volcart::filesystem;
+
+using TileIndex = TiledTexturing::TileIndex;
+
+namespace
+{
+// Manifest format version
+constexpr int MANIFEST_VERSION{1};
+
+// Number of tiles needed to cover a length
+auto NumTiles(std::size_t length, std::size_t tileSize) -> std::size_t
+{
+    return (length + tileSize - 1) / tileSize;
+}
+}  // namespace
+
+auto TiledTexturing::New() -> Pointer
+{
+    return std::make_shared<TiledTexturing>();
+}
+
+void TiledTexturing::setPPMPath(const fs::path& path) { ppmPath_ = path; }
+
+void TiledTexturing::setAlgorithmFactory(AlgorithmFactory f)
+{
+    factory_ = std::move(f);
+}
+
+void TiledTexturing::setTileSize(std::size_t s)
+{
+    if (s == 0) {
+        throw std::invalid_argument("Tile size must be greater than 0");
+    }
+    tileSize_ = s;
+}
+
+auto TiledTexturing::tileSize() const -> std::size_t { return tileSize_; }
+
+void TiledTexturing::setTileDirectory(const fs::path& dir) { tileDir_ = dir; }
+
+void TiledTexturing::setParameterString(std::string params)
+{
+    params_ = std::move(params);
+}
+
+auto TiledTexturing::numOutputs() const -> std::size_t { return numOutputs_; }
+
+auto TiledTexturing::numTiles() const -> std::size_t
+{
+    return NumTiles(height_, tileSize_) * NumTiles(width_, tileSize_);
+}
+
+auto TiledTexturing::numCompletedTiles() const -> std::size_t
+{
+    return completed_.size();
+}
+
+auto TiledTexturing::progressIterations() const -> std::size_t
+{
+    return numTiles();
+}
+
+void TiledTexturing::compute()
+{
+    if (not factory_) {
+        throw std::runtime_error("Texturing algorithm factory not set");
+    }
+    if (tileDir_.empty()) {
+        throw std::runtime_error("Tile directory not set");
+    }
+
+    // Setup
+    std::tie(height_, width_) = PerPixelMap::ReadPPMDimensions(ppmPath_);
+    if (not fs::exists(tileDir_)) {
+        fs::create_directories(tileDir_);
+    }
+    load_manifest_();
+    if (not completed_.empty()) {
+        Logger()->info(
+            "Resuming tiled texturing: {}/{} tiles complete",
+            completed_.size(), numTiles());
+    }
+
+    // The mask is small relative to the mappings, so load it once
+    auto mask = PerPixelMap::ReadPPMMask(ppmPath_);
+
+    // Iterate over the tiles
+    const auto rows = NumTiles(height_, tileSize_);
+    const auto cols = NumTiles(width_, tileSize_);
+    std::size_t counter{0};
+    progressStarted();
+    for (std::size_t ty = 0; ty < rows; ty++) {
+        for (std::size_t tx = 0; tx < cols; tx++) {
+            progressUpdated(counter++);
+            const TileIndex tile{ty, tx};
+            if (completed_.count(tile) > 0) {
+                continue;
+            }
+
+            // Texture the tile
+            auto ppm = PerPixelMap::New(PerPixelMap::ReadPPMRegion(
+                ppmPath_, ty * tileSize_, tx * tileSize_, tileSize_, tileSize_,
+                mask));
+            auto texture = factory_(ppm)->compute();
+
+            // Check for a consistent number of outputs
+            if (numOutputs_ == 0) {
+                numOutputs_ = texture.size();
+            } else if (texture.size() != numOutputs_) {
+                throw std::runtime_error(
+                    "Texturing algorithm produced " +
+                    std::to_string(texture.size()) + " images. Expected " +
+                    std::to_string(numOutputs_));
+            }
+
+            // Checkpoint: write the images, then record the tile
+            for (std::size_t i = 0; i < texture.size(); i++) {
+                WriteImage(tile_path_(tile, i), texture[i]);
+            }
+            completed_.insert(tile);
+            save_manifest_();
+        }
+    }
+    progressComplete();
+}
+
+auto TiledTexturing::assemble(std::size_t output) const -> cv::Mat
+{
+    if (completed_.size() != numTiles()) {
+        throw std::runtime_error(
+            "Cannot assemble texture: " + std::to_string(completed_.size()) +
+            "/" + std::to_string(numTiles()) + " tiles complete");
+    }
+    if (output >= numOutputs_) {
+        throw std::out_of_range("Output index out of range");
+    }
+
+    cv::Mat image;
+    for (const auto& tile : completed_) {
+        auto t = ReadImage(tile_path_(tile, output));
+        if (image.empty()) {
+            image = cv::Mat::zeros(
+                static_cast<int>(height_), static_cast<int>(width_),
+                t.type());
+        }
+        const cv::Rect roi(
+            static_cast<int>(tile.second * tileSize_),
+            static_cast<int>(tile.first * tileSize_), t.cols, t.rows);
+        t.copyTo(image(roi));
+    }
+    return image;
+}
+
+void TiledTexturing::load_manifest_()
+{
+    completed_.clear();
+    numOutputs_ = 0;
+
+    auto path = tileDir_ / MANIFEST_FILE;
+    if (not fs::exists(path)) {
+        return;
+    }
+
+    try {
+        Metadata manifest(path);
+        auto matches =
+            manifest.get<int>("version") == MANIFEST_VERSION and
+            manifest.get<std::size_t>("height") == height_ and
+            manifest.get<std::size_t>("width") == width_ and
+            manifest.get<std::size_t>("tileSize") == tileSize_ and
+            manifest.get<std::string>("parameters") == params_;
+        if (not matches) {
+            Logger()->warn(
+                "Tile manifest does not match the current settings. "
+                "Regenerating all tiles.");
+            return;
+        }
+
+        // Only trust tiles whose images are all on disk
+        numOutputs_ = manifest.get<std::size_t>("outputs");
+        for (const auto& t : manifest.get<std::vector<TileIndex>>("tiles")) {
+            auto complete = true;
+            for (std::size_t i = 0; i < numOutputs_; i++) {
+                complete &= fs::exists(tile_path_(t, i));
+            }
+            if (complete) {
+                completed_.insert(t);
+            }
+        }
+    } catch (const std::exception& e) {
+        Logger()->warn(
+            "Failed to read tile manifest. Regenerating all tiles: {}",
+            e.what());
+        completed_.clear();
+        numOutputs_ = 0;
+    }
+}
+
+void TiledTexturing::save_manifest_() const
+{
+    Metadata manifest;
+    manifest.set("version", MANIFEST_VERSION);
+    manifest.set("ppm", ppmPath_.string());
+    manifest.set("height", height_);
+    manifest.set("width", width_);
+    manifest.set("tileSize", tileSize_);
+    manifest.set("parameters", params_);
+    manifest.set("outputs", numOutputs_);
+    manifest.set(
+        "tiles", std::vector<TileIndex>{completed_.begin(), completed_.end()});
+
+    // Write to a temporary file and rename so that an interruption never
+    // leaves a partial manifest
+    auto path = tileDir_ / MANIFEST_FILE;
+    auto tmp = path;
+    tmp += ".tmp";
+    manifest.save(tmp);
+    fs::rename(tmp, path);
+}
+
+auto TiledTexturing::tile_path_(const TileIndex& t, std::size_t output) const
+    -> fs::path
+{
+    auto name = "tile_" + std::to_string(t.first) + "_" +
+                std::to_string(t.second) + "_" + std::to_string(output) +
+                ".tif";
+    return tileDir_ / name;
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+
+#include "vc/core/shapes/Arch.hpp"
+#include "vc/core/shapes/Plane.hpp"
+#include "vc/texturing/AngleBasedFlattening.hpp"
+#include "vc/texturing/ChunkedFlattening.hpp"
+#include "vc/texturing/FlatteningError.hpp"
+
+using namespace volcart;
+using namespace volcart::shapes;
+using namespace volcart::texturing;
+
+TEST(ChunkedFlattening, PlaneIsIsometric)
+{
+    auto input = Plane(20, 20).itkMesh();
+
+    ChunkedFlattening flatten(input);
+    flatten.setUseABF(false);
+    flatten.setMaxPatchFaces(100);
+    flatten.setPatchOverlap(2);
+    auto output = flatten.compute();
+
+    // Mesh was flattened in multiple patches
+    const auto& metrics = flatten.patchMetrics();
+    ASSERT_GT(metrics.size(), 1);
+    std::size_t coreFaces{0};
+    for (const auto& m : metrics) {
+        coreFaces += m.coreFaces;
+        EXPECT_GT(m.faces, m.coreFaces);
+        EXPECT_NEAR(m.l2, 1.0, 1e-5);
+        EXPECT_NEAR(m.alignmentError, 0.0, 1e-5);
+    }
+    EXPECT_EQ(coreFaces, input->GetNumberOfCells());
+
+    // A planar mesh should be flattened with no distortion
+    ASSERT_EQ(output->GetNumberOfPoints(), input->GetNumberOfPoints());
+    for (auto cell = input->GetCells()->Begin();
+         cell != input->GetCells()->End(); ++cell) {
+        auto ids = cell.Value()->PointIdsBegin();
+        for (std::size_t i = 0; i < 3; i++) {
+            auto a = ids[i];
+            auto b = ids[(i + 1) % 3];
+            auto in = input->GetPoint(a).EuclideanDistanceTo(
+                input->GetPoint(b));
+            auto out = output->GetPoint(a).EuclideanDistanceTo(
+                output->GetPoint(b));
+            EXPECT_NEAR(out, in, 1e-5);
+        }
+    }
+}
+
+TEST(ChunkedFlattening, ArchThroughABF)
+{
+    auto input = Arch(40, 40).itkMesh();
+
+    // Patches are limited to one concurrent solve by the memory budget
+    AngleBasedFlattening abf(input);
+    abf.setMaxPatchFaces(400);
+    abf.setMemoryLimit(1);
+    auto output = abf.compute();
+    EXPECT_GT(abf.patchMetrics().size(), 1);
+
+    // Arch is developable and should flatten with little distortion
+    auto metrics = InvertLStretchMetrics(LStretch(input, output));
+    EXPECT_NEAR(metrics.l2, 1.0, 1e-2);
+}
+
+TEST(ChunkedFlattening, ManyPatchesAlign)
+{
+    // Enough patches that the alignment system is large and sparse
+    auto input = Plane(80, 80).itkMesh();
+
+    ChunkedFlattening flatten(input);
+    flatten.setUseABF(false);
+    flatten.setMaxPatchFaces(60);
+    flatten.setPatchOverlap(1);
+    auto output = flatten.compute();
+
+    const auto& metrics = flatten.patchMetrics();
+    ASSERT_GT(metrics.size(), 100);
+    for (const auto& m : metrics) {
+        EXPECT_NEAR(m.alignmentError, 0.0, 1e-5);
+    }
+
+    // Aligned patches reproduce the plane without distortion
+    auto error = InvertLStretchMetrics(LStretch(input, output));
+    EXPECT_NEAR(error.l2, 1.0, 1e-5);
+    EXPECT_NEAR(error.lInf, 1.0, 1e-5);
+}
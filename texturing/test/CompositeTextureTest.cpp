@@ -0,0 +1,339 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "vc/core/filesystem.hpp"
+#include "vc/core/neighborhood/CuboidGenerator.hpp"
+#include "vc/core/neighborhood/LineGenerator.hpp"
+#include "vc/core/types/PerPixelMap.hpp"
+#include "vc/core/types/Volume.hpp"
+#include "vc/testing/TestingUtils.hpp"
+#include "vc/texturing/CompositeTexture.hpp"
+
+using namespace volcart;
+using namespace volcart::texturing;
+namespace fs = volcart::filesystem;
+namespace vctest = volcart::testing;
+
+using Filter = CompositeTexture::Filter;
+using Samples = std::vector<std::uint16_t>;
+
+namespace
+{
+constexpr int VOL_SIZE{24};
+constexpr std::size_t PPM_HEIGHT{60};
+constexpr std::size_t PPM_WIDTH{80};
+
+const std::vector<Filter> FILTERS{
+    Filter::Minimum, Filter::Maximum, Filter::Median, Filter::Mean,
+    Filter::MedianAverage};
+
+// Neighborhood sizes on both sides of the sorting network limit
+const std::vector<std::size_t> SIZES{1, 2, 7, 8, 63, 64, 65, 100};
+
+////// Reference implementation: Per-Neighborhood filters //////
+auto RefFilter(Filter f, Samples n) -> std::uint16_t
+{
+    switch (f) {
+        case Filter::Minimum:
+            return *std::min_element(n.begin(), n.end());
+        case Filter::Maximum:
+            return *std::max_element(n.begin(), n.end());
+        case Filter::Median:
+            std::nth_element(n.begin(), n.begin() + n.size() / 2, n.end());
+            return n[n.size() / 2];
+        case Filter::Mean: {
+            auto sum = std::accumulate(n.begin(), n.end(), 0.0);
+            return static_cast<std::uint16_t>(std::round(sum / n.size()));
+        }
+        case Filter::MedianAverage: {
+            std::sort(n.begin(), n.end());
+            auto count = static_cast<std::size_t>(std::ceil(n.size() * 0.70));
+            auto offset = static_cast<std::size_t>(
+                std::floor((n.size() - count) / 2.0));
+            auto begin = n.begin() + static_cast<std::ptrdiff_t>(offset);
+            auto end = begin + static_cast<std::ptrdiff_t>(count);
+            auto sum = std::accumulate(begin, end, 0.0);
+            return static_cast<std::uint16_t>(std::round(sum / count));
+        }
+    }
+    return 0;
+}
+
+////// Reference implementation: Per-Neighborhood generators //////
+auto RefLine(
+    const Volume::Pointer& v,
+    const cv::Vec3d& pt,
+    const cv::Vec3d& axis,
+    double radius,
+    double interval,
+    Direction dir) -> Samples
+{
+    double min{-radius};
+    double max{radius};
+    if (dir == Direction::Positive) {
+        min = 0;
+    } else if (dir == Direction::Negative) {
+        max = 0;
+    }
+    auto count =
+        static_cast<std::size_t>(std::floor((max - min) / interval) + 1);
+    Samples n;
+    for (std::size_t it = 0; it < count; it++) {
+        n.push_back(v->interpolateAt(pt + axis * (min + it * interval)));
+    }
+    return n;
+}
+
+auto RefCuboid(
+    const Volume::Pointer& v,
+    const cv::Vec3d& pt,
+    const cv::Vec3d& axis,
+    cv::Vec3d radius,
+    double interval,
+    Direction dir) -> Samples
+{
+    // Generate the missing axes
+    const std::vector<cv::Vec3d> bases{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+    cv::Vec3d basis;
+    for (const auto& b : bases) {
+        if (axis.dot(b) != 1.0) {
+            basis = b;
+            break;
+        }
+    }
+    auto a1 = cv::normalize(axis.cross(basis));
+    auto a2 = cv::normalize(axis.cross(a1));
+
+    auto center = pt;
+    if (dir != Direction::Bidirectional) {
+        radius[0] /= 2.0;
+        center += axis * radius[0] * (dir == Direction::Negative ? -1 : 1);
+    }
+
+    auto count = [interval](double r) {
+        return static_cast<std::size_t>(std::floor(2.0 * r / interval) + 1);
+    };
+    Samples n;
+    for (std::size_t z = 0; z < count(radius[0]); z++) {
+        for (std::size_t y = 0; y < count(radius[1]); y++) {
+            for (std::size_t x = 0; x < count(radius[2]); x++) {
+                auto p = center + a2 * (-radius[2] + x * interval) +
+                         a1 * (-radius[1] + y * interval) +
+                         axis * (-radius[0] + z * interval);
+                n.push_back(v->interpolateAt(p));
+            }
+        }
+    }
+    return n;
+}
+
+////// A volume of random intensities
+auto MakeVolume(const fs::path& path) -> Volume::Pointer
+{
+    return vctest::WriteTestVolume(
+        path, {VOL_SIZE, VOL_SIZE, VOL_SIZE}, vctest::RandomSlices(1234));
+}
+
+// A tilted surface through the volume with varying normals. Includes
+// normals along each basis vector.
+auto MakePPM() -> PerPixelMap::Pointer
+{
+    auto ppm = PerPixelMap::New(PPM_HEIGHT, PPM_WIDTH);
+    cv::Mat mask = cv::Mat::zeros(PPM_HEIGHT, PPM_WIDTH, CV_8UC1);
+    for (std::size_t y = 0; y < PPM_HEIGHT; y++) {
+        for (std::size_t x = 0; x < PPM_WIDTH; x++) {
+            cv::Vec3d n{std::sin(0.1 * x), 0.3 * std::cos(0.1 * y), 1};
+            if (x == 0) {
+                n = {1, 0, 0};
+            } else if (x == 1) {
+                n = {0, 1, 0};
+            } else if (x == 2) {
+                n = {0, 0, 1};
+            }
+            n = cv::normalize(n);
+            (*ppm)(y, x) = {2 + 0.25 * x,
+                            2 + 0.33 * y,
+                            6 + 0.1 * x + 0.05 * y,
+                            n[0],
+                            n[1],
+                            n[2]};
+            if ((x + y) % 7 != 0) {
+                mask.at<std::uint8_t>(y, x) = 255;
+            }
+        }
+    }
+    ppm->setMask(mask);
+    return ppm;
+}
+
+auto RandomSamples(std::size_t size, std::uint16_t maxVal, std::mt19937& gen)
+    -> Samples
+{
+    std::uniform_int_distribution<std::uint16_t> dist(0, maxVal);
+    Samples n(size);
+    std::generate(n.begin(), n.end(), [&]() { return dist(gen); });
+    return n;
+}
+
+// The samples of a neighborhood in row-major order
+auto Flattened(const Neighborhood& n) -> Samples
+{
+    return {n.begin(), n.end()};
+}
+}  // namespace
+
+TEST(CompositeTexture, FiltersMatchReference)
+{
+    std::mt19937 gen(42);
+    for (auto size : SIZES) {
+        // Full range, and a small range with many duplicates
+        for (std::uint16_t maxVal : {65535, 3}) {
+            for (int trial = 0; trial < 20; trial++) {
+                auto n = RandomSamples(size, maxVal, gen);
+                for (auto f : FILTERS) {
+                    auto buffer = n;
+                    EXPECT_EQ(
+                        CompositeTexture::ApplyFilter(
+                            f, buffer.data(), buffer.size()),
+                        RefFilter(f, n))
+                        << "filter " << static_cast<int>(f) << ", size "
+                        << size;
+                }
+            }
+        }
+    }
+}
+
+TEST(CompositeTexture, FiltersPreserveSamples)
+{
+    // Filters may reorder a buffer, but later filters see the same values
+    std::mt19937 gen(7);
+    for (auto size : SIZES) {
+        auto n = RandomSamples(size, 1000, gen);
+        auto buffer = n;
+        for (auto f : FILTERS) {
+            EXPECT_EQ(
+                CompositeTexture::ApplyFilter(f, buffer.data(), buffer.size()),
+                RefFilter(f, n));
+        }
+        std::sort(n.begin(), n.end());
+        std::sort(buffer.begin(), buffer.end());
+        EXPECT_EQ(buffer, n);
+    }
+}
+
+TEST(CompositeTexture, GeneratorBuffersMatchReference)
+{
+    auto vol = MakeVolume("vc_texturing_CompositeTexture_Generators");
+    auto ppm = MakePPM();
+
+    for (auto dir :
+         {Direction::Bidirectional, Direction::Positive, Direction::Negative}) {
+        auto line = LineGenerator::New();
+        line->setSamplingRadius(5.5);
+        line->setSamplingInterval(0.5);
+        line->setSamplingDirection(dir);
+
+        auto cuboid = CuboidGenerator::New();
+        cuboid->setSamplingRadius(3, 2, 1.5);
+        cuboid->setSamplingInterval(0.75);
+        cuboid->setSamplingDirection(dir);
+
+        Samples lineBuf(line->size());
+        Samples cuboidBuf(cuboid->size());
+        for (const auto [y, x] : ppm->getMappingCoords()) {
+            if ((x + y) % 5 != 0) {
+                continue;
+            }
+            const auto& m = ppm->getMapping(y, x);
+            const cv::Vec3d pos{m[0], m[1], m[2]};
+            const cv::Vec3d normal{m[3], m[4], m[5]};
+
+            auto expected = RefLine(vol, pos, normal, 5.5, 0.5, dir);
+            ASSERT_EQ(line->size(), expected.size());
+            line->sample(vol, pos, normal, lineBuf.data());
+            EXPECT_EQ(lineBuf, expected);
+            EXPECT_EQ(Flattened(line->compute(vol, pos, {normal})), expected);
+
+            expected = RefCuboid(vol, pos, normal, {3, 2, 1.5}, 0.75, dir);
+            ASSERT_EQ(cuboid->size(), expected.size());
+            cuboid->sample(vol, pos, normal, cuboidBuf.data());
+            EXPECT_EQ(cuboidBuf, expected);
+            EXPECT_EQ(
+                Flattened(cuboid->compute(vol, pos, {normal})), expected);
+        }
+    }
+}
+
+TEST(CompositeTexture, ImageMatchesReferenceForAnyThreadCount)
+{
+    auto vol = MakeVolume("vc_texturing_CompositeTexture_Image");
+    auto ppm = MakePPM();
+
+    // Line generators with each of the tested neighborhood sizes, and a
+    // cuboid generator
+    std::vector<NeighborhoodGenerator::Pointer> gens;
+    for (auto [radius, dir] : std::vector<std::pair<double, Direction>>{
+             {0, Direction::Bidirectional},
+             {1, Direction::Positive},
+             {3, Direction::Bidirectional},
+             {7, Direction::Negative},
+             {63, Direction::Positive},
+             {32, Direction::Bidirectional}}) {
+        auto line = LineGenerator::New();
+        line->setSamplingRadius(radius);
+        line->setSamplingDirection(dir);
+        gens.push_back(line);
+    }
+    auto cuboid = CuboidGenerator::New();
+    cuboid->setSamplingRadius(2, 1, 1);
+    gens.push_back(cuboid);
+
+    for (const auto& gen : gens) {
+        // Samples for each mapping, as the old per-Neighborhood generators
+        // would have computed them
+        std::vector<Samples> neighborhoods;
+        auto mappings = ppm->getMappingCoords();
+        for (const auto [y, x] : mappings) {
+            const auto& m = ppm->getMapping(y, x);
+            const cv::Vec3d pos{m[0], m[1], m[2]};
+            const cv::Vec3d normal{m[3], m[4], m[5]};
+            neighborhoods.push_back(
+                Flattened(gen->compute(vol, pos, {normal})));
+        }
+
+        for (auto f : FILTERS) {
+            cv::Mat expected = cv::Mat::zeros(PPM_HEIGHT, PPM_WIDTH, CV_16UC1);
+            for (std::size_t i = 0; i < mappings.size(); i++) {
+                const auto [y, x] = mappings[i];
+                expected.at<std::uint16_t>(y, x) =
+                    RefFilter(f, neighborhoods[i]);
+            }
+
+            for (std::size_t threads : {1, 2, 3, 0}) {
+                auto texture = CompositeTexture::New();
+                texture->setVolume(vol);
+                texture->setPerPixelMap(ppm);
+                texture->setGenerator(gen);
+                texture->setFilter(f);
+                texture->setNumThreads(threads);
+                auto result = texture->compute();
+                ASSERT_EQ(result.size(), 1);
+                ASSERT_EQ(result[0].type(), CV_16UC1);
+                EXPECT_EQ(cv::countNonZero(result[0] != expected), 0)
+                    << "size " << gen->size() << ", filter "
+                    << static_cast<int>(f) << ", threads " << threads;
+            }
+        }
+    }
+}
@@ -1,6 +1,8 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 #include "vc/core/shapes/Arch.hpp"
 #include "vc/core/shapes/Plane.hpp"
 #include "vc/core/util/Logging.hpp"
@@ -29,15 +31,15 @@ TEST(FlatteningError, MetricsNoDistortion)
     // Arch should flatten without distortion
     SmallOrClose(metrics.l2, 1.0);
     SmallOrClose(metrics.lInf, 1.0);
-    using ::testing::DoubleNear;
+    using ::testing::FloatNear;
     using ::testing::Each;
-    EXPECT_THAT(metrics.faceL2, Each(DoubleNear(1.0, 1e-7)));
-    EXPECT_THAT(metrics.faceLInf, Each(DoubleNear(1.0, 1e-7)));
+    EXPECT_THAT(metrics.faceL2, Each(FloatNear(1.F, 1e-6F)));
+    EXPECT_THAT(metrics.faceLInf, Each(FloatNear(1.F, 1e-6F)));
 }
 
 TEST(FlatteningError, MetricsScale)
 {
-    using ::testing::DoubleNear;
+    using ::testing::FloatNear;
     using ::testing::Each;
 
     // Construct plane
@@ -46,23 +48,47 @@ TEST(FlatteningError, MetricsScale)
 
     // Double distortion: 2D->3D
     auto factor = 0.5;
-    auto expected = 1.0 / factor;
+    auto expected = static_cast<float>(1.0 / factor);
     auto mesh2D = ScaleMesh(mesh3D, factor);
     auto metrics = LStretch(mesh3D, mesh2D);
     SmallOrClose(metrics.l2, expected);
     SmallOrClose(metrics.lInf, expected);
-    EXPECT_THAT(metrics.faceL2, Each(DoubleNear(expected, 1e-7)));
-    EXPECT_THAT(metrics.faceLInf, Each(DoubleNear(expected, 1e-7)));
+    EXPECT_THAT(metrics.faceL2, Each(FloatNear(expected, 1e-6F)));
+    EXPECT_THAT(metrics.faceLInf, Each(FloatNear(expected, 1e-6F)));
 
     // Half distortion: 2D->3D
     factor = 2.0;
-    expected = 1.0 / factor;
+    expected = static_cast<float>(1.0 / factor);
     mesh2D = ScaleMesh(mesh3D, factor);
     metrics = LStretch(mesh3D, mesh2D);
     SmallOrClose(metrics.l2, expected);
     SmallOrClose(metrics.lInf, expected);
-    EXPECT_THAT(metrics.faceL2, Each(DoubleNear(expected, 1e-7)));
-    EXPECT_THAT(metrics.faceLInf, Each(DoubleNear(expected, 1e-7)));
+    EXPECT_THAT(metrics.faceL2, Each(FloatNear(expected, 1e-6F)));
+    EXPECT_THAT(metrics.faceLInf, Each(FloatNear(expected, 1e-6F)));
+}
+
+TEST(FlatteningError, MetricsRange)
+{
+    // Flatten an arch with some distortion
+    Arch arch;
+    auto mesh3D = arch.itkMesh();
+    auto mesh2D = ScaleMesh(mesh3D, 0.5);
+    auto metrics = LStretch(mesh3D, mesh2D);
+
+    // Global ranges match the per-face metrics
+    auto l2 = std::minmax_element(metrics.faceL2.begin(), metrics.faceL2.end());
+    EXPECT_FLOAT_EQ(metrics.minL2, *l2.first);
+    EXPECT_FLOAT_EQ(metrics.maxL2, *l2.second);
+    auto lInf =
+        std::minmax_element(metrics.faceLInf.begin(), metrics.faceLInf.end());
+    EXPECT_FLOAT_EQ(metrics.minLInf, *lInf.first);
+    EXPECT_FLOAT_EQ(metrics.lInf, *lInf.second);
+
+    // Inverted ranges are swapped
+    auto inverted = InvertLStretchMetrics(metrics);
+    EXPECT_FLOAT_EQ(inverted.minL2, 1.F / *l2.second);
+    EXPECT_FLOAT_EQ(inverted.maxL2, 1.F / *l2.first);
+    EXPECT_FLOAT_EQ(inverted.lInf, 1.F / *lInf.first);
 }
 
 auto main(int argc, char** argv) -> int
@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "vc/core/filesystem.hpp"
+#include "vc/core/neighborhood/CuboidGenerator.hpp"
+#include "vc/core/neighborhood/LineGenerator.hpp"
+#include "vc/core/types/PerPixelMap.hpp"
+#include "vc/core/types/Volume.hpp"
+#include "vc/testing/TestingUtils.hpp"
+#include "vc/texturing/CompositeTexture.hpp"
+#include "vc/texturing/LayerTexture.hpp"
+#include "vc/texturing/MultiOutputTexture.hpp"
+
+using namespace volcart;
+using namespace volcart::texturing;
+namespace fs = volcart::filesystem;
+namespace vctest = volcart::testing;
+
+using Filter = MultiOutputTexture::Filter;
+using Texture = MultiOutputTexture::Texture;
+
+namespace
+{
+constexpr int VOL_SIZE{24};
+constexpr std::size_t PPM_HEIGHT{60};
+constexpr std::size_t PPM_WIDTH{80};
+
+// Every filter, in an order where the sorting filters come before the
+// order-sensitive ones, and with a repeated filter
+const std::vector<Filter> FILTERS{
+    Filter::MedianAverage, Filter::Maximum, Filter::Median, Filter::Minimum,
+    Filter::Mean,          Filter::Maximum};
+
+// A volume of random intensities
+auto MakeVolume(const fs::path& path) -> Volume::Pointer
+{
+    return vctest::WriteTestVolume(
+        path, {VOL_SIZE, VOL_SIZE, VOL_SIZE}, vctest::RandomSlices(5678));
+}
+
+// A tilted surface through the volume with varying normals
+auto MakePPM() -> PerPixelMap::Pointer
+{
+    auto ppm = PerPixelMap::New(PPM_HEIGHT, PPM_WIDTH);
+    cv::Mat mask = cv::Mat::zeros(PPM_HEIGHT, PPM_WIDTH, CV_8UC1);
+    for (std::size_t y = 0; y < PPM_HEIGHT; y++) {
+        for (std::size_t x = 0; x < PPM_WIDTH; x++) {
+            auto n = cv::normalize(
+                cv::Vec3d{std::sin(0.1 * x), 0.3 * std::cos(0.1 * y), 1});
+            (*ppm)(y, x) = {2 + 0.25 * x,
+                            2 + 0.33 * y,
+                            6 + 0.1 * x + 0.05 * y,
+                            n[0],
+                            n[1],
+                            n[2]};
+            if ((x + y) % 7 != 0) {
+                mask.at<std::uint8_t>(y, x) = 255;
+            }
+        }
+    }
+    ppm->setMask(mask);
+    return ppm;
+}
+
+auto MakeLine(double radius) -> LineGenerator::Pointer
+{
+    auto line = LineGenerator::New();
+    line->setSamplingRadius(radius);
+    line->setSamplingInterval(0.5);
+    return line;
+}
+
+auto Identical(const cv::Mat& a, const cv::Mat& b) -> bool
+{
+    return a.size() == b.size() and a.type() == b.type() and
+           cv::countNonZero(a != b) == 0;
+}
+}  // namespace
+
+TEST(MultiOutputTexture, MatchesSeparateTextures)
+{
+    auto vol = MakeVolume("vc_texturing_MultiOutputTexture");
+    auto ppm = MakePPM();
+
+    // Neighborhoods on both sides of the sorting network limit
+    for (auto radius : {1.5, 16.0}) {
+        auto line = MakeLine(radius);
+
+        // Separate runs
+        Texture composites;
+        for (auto f : FILTERS) {
+            auto composite = CompositeTexture::New();
+            composite->setVolume(vol);
+            composite->setPerPixelMap(ppm);
+            composite->setGenerator(line);
+            composite->setFilter(f);
+            composites.push_back(composite->compute().front());
+        }
+        auto layerTexture = LayerTexture::New();
+        layerTexture->setVolume(vol);
+        layerTexture->setPerPixelMap(ppm);
+        layerTexture->setGenerator(line);
+        auto layers = layerTexture->compute();
+        ASSERT_EQ(layers.size(), line->size());
+
+        // Single sweep
+        for (std::size_t threads : {1, 3, 0}) {
+            auto multi = MultiOutputTexture::New();
+            multi->setVolume(vol);
+            multi->setPerPixelMap(ppm);
+            multi->setGenerator(line);
+            multi->setFilters(FILTERS);
+            multi->setGenerateLayers(true);
+            multi->setNumThreads(threads);
+            auto result = multi->compute();
+            ASSERT_EQ(result.size(), FILTERS.size() + layers.size());
+
+            auto filterImgs = multi->filterTextures();
+            ASSERT_EQ(filterImgs.size(), FILTERS.size());
+            for (std::size_t i = 0; i < FILTERS.size(); i++) {
+                EXPECT_TRUE(Identical(filterImgs[i], composites[i]))
+                    << "filter " << i << ", threads " << threads;
+                EXPECT_TRUE(Identical(result[i], composites[i]));
+            }
+
+            auto layerImgs = multi->layerTextures();
+            ASSERT_EQ(layerImgs.size(), layers.size());
+            for (std::size_t i = 0; i < layers.size(); i++) {
+                EXPECT_TRUE(Identical(layerImgs[i], layers[i]))
+                    << "layer " << i << ", threads " << threads;
+                EXPECT_TRUE(Identical(result[FILTERS.size() + i], layers[i]));
+            }
+        }
+    }
+}
+
+TEST(MultiOutputTexture, OutputSelection)
+{
+    auto vol = MakeVolume("vc_texturing_MultiOutputTexture_Outputs");
+    auto ppm = MakePPM();
+    auto line = MakeLine(2);
+
+    auto multi = MultiOutputTexture::New();
+    multi->setVolume(vol);
+    multi->setPerPixelMap(ppm);
+    multi->setGenerator(line);
+
+    // Filters only
+    multi->setFilters({Filter::Mean});
+    EXPECT_EQ(multi->compute().size(), 1);
+    EXPECT_EQ(multi->filterTextures().size(), 1);
+    EXPECT_TRUE(multi->layerTextures().empty());
+
+    // Layers only
+    multi->setFilters({});
+    multi->setGenerateLayers(true);
+    EXPECT_EQ(multi->compute().size(), line->size());
+    EXPECT_TRUE(multi->filterTextures().empty());
+    EXPECT_EQ(multi->layerTextures().size(), line->size());
+
+    // Layers need a 1D generator
+    auto cuboid = CuboidGenerator::New();
+    cuboid->setSamplingRadius(1);
+    multi->setGenerator(cuboid);
+    EXPECT_THROW(multi->compute(), std::invalid_argument);
+
+    // Nothing requested
+    multi->setGenerator(line);
+    multi->setGenerateLayers(false);
+    EXPECT_THROW(multi->compute(), std::invalid_argument);
+}
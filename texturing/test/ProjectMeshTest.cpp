@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include <itkIdentityTransform.h>
+
+#include "vc/core/shapes/Arch.hpp"
+#include "vc/core/shapes/Plane.hpp"
+#include "vc/texturing/ProjectMesh.hpp"
+
+using namespace volcart;
+using namespace volcart::texturing;
+
+TEST(ProjectMesh, PlaneRasterization)
+{
+    auto mesh = shapes::Plane(10, 10).itkMesh();
+
+    ProjectMesh projector;
+    projector.setMesh(mesh);
+    projector.setSampleMode(ProjectMesh::SampleMode::Dimensions);
+    projector.setPPMDimensions(64, 64);
+    auto ppm = projector.compute();
+
+    // Every pixel maps to the plane
+    const auto& mask = ppm.mask();
+    const auto& cellMap = ppm.cellMap();
+    for (int y = 0; y < 64; y++) {
+        for (int x = 0; x < 64; x++) {
+            ASSERT_EQ(mask.at<std::uint8_t>(y, x), 255);
+            EXPECT_GE(cellMap.at<std::int32_t>(y, x), 0);
+            const auto& m = ppm(y, x);
+            EXPECT_NEAR(m[1], 0, 1e-9);
+            EXPECT_NEAR(std::abs(m[4]), 1, 1e-9);
+        }
+    }
+}
+
+TEST(ProjectMesh, RasterizationMatchesRayCasting)
+{
+    static constexpr int SIZE{128};
+    auto mesh = shapes::Arch(20, 20).itkMesh();
+
+    // Orthographic projection is rasterized
+    ProjectMesh projector;
+    projector.setMesh(mesh);
+    projector.setSampleMode(ProjectMesh::SampleMode::Dimensions);
+    projector.setPPMDimensions(SIZE, SIZE);
+    auto raster = projector.compute();
+
+    // An identity registration transform uses ray casting
+    using Identity = itk::IdentityTransform<double, 2>;
+    auto tfm = ProjectMesh::CompositeTransform::New();
+    tfm->AddTransform(Identity::New());
+    projector.setTransform(tfm);
+    projector.setTextureDimensions(SIZE, SIZE);
+    auto rays = projector.compute();
+
+    std::size_t mismatched{0};
+    for (int y = 0; y < SIZE; y++) {
+        for (int x = 0; x < SIZE; x++) {
+            auto r = raster.mask().at<std::uint8_t>(y, x);
+            auto c = rays.mask().at<std::uint8_t>(y, x);
+            if (r != c) {
+                mismatched++;
+                continue;
+            }
+            if (r == 0) {
+                continue;
+            }
+            for (int i = 0; i < 6; i++) {
+                EXPECT_NEAR(raster(y, x)[i], rays(y, x)[i], 1e-6);
+            }
+        }
+    }
+
+    // Pixels on the boundary of the mesh may differ
+    EXPECT_LT(mismatched, SIZE * SIZE / 100);
+}
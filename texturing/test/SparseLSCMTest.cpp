@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+
+#include "vc/core/shapes/Arch.hpp"
+#include "vc/core/shapes/Plane.hpp"
+#include "vc/core/types/MeshArrays.hpp"
+#include "vc/texturing/AngleBasedFlattening.hpp"
+#include "vc/texturing/SparseLSCM.hpp"
+
+using namespace volcart;
+using namespace volcart::texturing;
+
+TEST(SparseLSCM, PlaneIsIsometric)
+{
+    auto input = shapes::Plane(10, 10).itkMesh();
+
+    AngleBasedFlattening abf(input);
+    abf.setUseABF(false);
+    abf.setSolver(AngleBasedFlattening::Solver::Sparse);
+    auto output = abf.compute();
+
+    // A planar mesh should be flattened with no distortion
+    ASSERT_EQ(output->GetNumberOfPoints(), input->GetNumberOfPoints());
+    for (auto cell = input->GetCells()->Begin();
+         cell != input->GetCells()->End(); ++cell) {
+        auto ids = cell.Value()->PointIdsBegin();
+        for (std::size_t i = 0; i < 3; i++) {
+            auto a = ids[i];
+            auto b = ids[(i + 1) % 3];
+            auto in = input->GetPoint(a).EuclideanDistanceTo(
+                input->GetPoint(b));
+            auto out = output->GetPoint(a).EuclideanDistanceTo(
+                output->GetPoint(b));
+            EXPECT_NEAR(out, in, 1e-5);
+        }
+    }
+
+    // Output lies on the XZ plane
+    for (auto pt = output->GetPoints()->Begin();
+         pt != output->GetPoints()->End(); ++pt) {
+        EXPECT_DOUBLE_EQ(pt->Value()[1], 0);
+    }
+}
+
+TEST(SparseLSCM, WarmStart)
+{
+    auto input = shapes::Arch(20, 20).itkMesh();
+    auto arrays = ToMeshArrays(input);
+
+    // Cold start
+    SparseLSCM cold;
+    cold.setMesh(arrays);
+    cold.setTolerance(1e-10);
+    auto coldUVs = cold.compute();
+    EXPECT_GT(cold.iterations(), 0);
+
+    // Warm start from the cold start solution
+    auto uvMap = UVMap::New();
+    for (std::size_t v = 0; v < coldUVs.size(); v++) {
+        uvMap->set(v, coldUVs[v]);
+    }
+    SparseLSCM warm;
+    warm.setMesh(arrays);
+    warm.setTolerance(1e-10);
+    warm.setInitialUVMap(uvMap);
+    auto warmUVs = warm.compute();
+
+    EXPECT_LT(warm.iterations(), cold.iterations());
+    for (std::size_t v = 0; v < coldUVs.size(); v++) {
+        EXPECT_NEAR(warmUVs[v][0], coldUVs[v][0], 1e-5);
+        EXPECT_NEAR(warmUVs[v][1], coldUVs[v][1], 1e-5);
+    }
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "vc/core/filesystem.hpp"
+#include "vc/core/types/PerPixelMap.hpp"
+#include "vc/texturing/TiledTexturing.hpp"
+
+using namespace volcart;
+using namespace volcart::texturing;
+namespace fs = volcart::filesystem;
+
+namespace
+{
+constexpr std::size_t HEIGHT{37};
+constexpr std::size_t WIDTH{50};
+
+// Texture each pixel with its global index, as stored in the PPM
+class IndexTexture : public TexturingAlgorithm
+{
+public:
+    auto compute() -> Texture override
+    {
+        result_.clear();
+        cv::Mat image = cv::Mat::zeros(
+            static_cast<int>(ppm_->height()), static_cast<int>(ppm_->width()),
+            CV_16UC1);
+        for (const auto [y, x] : ppm_->getMappingCoords()) {
+            const auto& m = ppm_->getMapping(y, x);
+            image.at<std::uint16_t>(static_cast<int>(y), static_cast<int>(x)) =
+                static_cast<std::uint16_t>(m[1] * WIDTH + m[0]);
+        }
+        result_.push_back(image);
+        return result_;
+    }
+};
+
+auto WriteTestPPM(const fs::path& path) -> void
+{
+    PerPixelMap ppm(HEIGHT, WIDTH);
+    cv::Mat mask = cv::Mat::zeros(HEIGHT, WIDTH, CV_8UC1);
+    for (std::size_t y = 0; y < HEIGHT; y++) {
+        for (std::size_t x = 0; x < WIDTH; x++) {
+            ppm(y, x) = {static_cast<double>(x), static_cast<double>(y), 0,
+                         0, 0, 1};
+            if ((x + y) % 3 != 0) {
+                mask.at<std::uint8_t>(y, x) = 255;
+            }
+        }
+    }
+    ppm.setMask(mask);
+    PerPixelMap::WritePPM(path, ppm);
+}
+}  // namespace
+
+TEST(TiledTexturing, AssembleAndResume)
+{
+    const fs::path ppmPath{"vc_texturing_TiledTexturing.ppm"};
+    const fs::path tileDir{"vc_texturing_TiledTexturing_tiles"};
+    fs::remove_all(tileDir);
+    WriteTestPPM(ppmPath);
+
+    std::size_t calls{0};
+    auto factory = [&calls](const PerPixelMap::Pointer& ppm) {
+        calls++;
+        auto algo = std::make_shared<IndexTexture>();
+        algo->setPerPixelMap(ppm);
+        return algo;
+    };
+
+    TiledTexturing tiler;
+    tiler.setPPMPath(ppmPath);
+    tiler.setTileDirectory(tileDir);
+    tiler.setTileSize(16);
+    tiler.setParameterString("index");
+    tiler.setAlgorithmFactory(factory);
+    tiler.compute();
+    EXPECT_EQ(tiler.numTiles(), 12);
+    EXPECT_EQ(calls, 12);
+    EXPECT_EQ(tiler.numOutputs(), 1);
+
+    // Assembled image matches a non-tiled texture
+    auto image = tiler.assemble();
+    ASSERT_EQ(image.rows, static_cast<int>(HEIGHT));
+    ASSERT_EQ(image.cols, static_cast<int>(WIDTH));
+    for (std::size_t y = 0; y < HEIGHT; y++) {
+        for (std::size_t x = 0; x < WIDTH; x++) {
+            auto expected = static_cast<std::uint16_t>(
+                ((x + y) % 3 != 0) ? y * WIDTH + x : 0);
+            EXPECT_EQ(image.at<std::uint16_t>(y, x), expected);
+        }
+    }
+
+    // Resuming skips all completed tiles
+    TiledTexturing resumed;
+    resumed.setPPMPath(ppmPath);
+    resumed.setTileDirectory(tileDir);
+    resumed.setTileSize(16);
+    resumed.setParameterString("index");
+    resumed.setAlgorithmFactory(factory);
+    resumed.compute();
+    EXPECT_EQ(calls, 12);
+    EXPECT_EQ(resumed.numCompletedTiles(), 12);
+
+    // Resume after losing a tile
+    fs::remove(tileDir / "tile_1_2_0.tif");
+    resumed.compute();
+    EXPECT_EQ(calls, 13);
+
+    // Changing the parameters regenerates every tile
+    resumed.setParameterString("changed");
+    resumed.compute();
+    EXPECT_EQ(calls, 25);
+}
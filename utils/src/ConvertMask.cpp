@@ -1,11 +1,13 @@
 // vc_convert_mask: Bidirectional conversion between Point Mask (.vcps) and
 // Volume Mask (Image sequence)
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <map>
 #include <regex>
 #include <sstream>
+#include <vector>
 
 #include <boost/program_options.hpp>
 #include <opencv2/core.hpp>
@@ -14,20 +16,31 @@
 #include "vc/app_support/ProgressIndicator.hpp"
 #include "vc/core/filesystem.hpp"
 #include "vc/core/io/FileFilters.hpp"
-#include "vc/core/io/PointSetIO.hpp"
+#include "vc/core/io/PointSetBuckets.hpp"
+#include "vc/core/io/PointSetStream.hpp"
 #include "vc/core/types/VolumePkg.hpp"
 #include "vc/core/util/FormatStrToRegexStr.hpp"
 #include "vc/core/util/Iteration.hpp"
 #include "vc/core/util/Logging.hpp"
+#include "vc/core/util/MemorySizeStringParser.hpp"
+#include "vc/core/util/Parallel.hpp"
 
 namespace fs = volcart::filesystem;
 namespace po = boost::program_options;
 namespace vc = volcart;
 
+static constexpr auto kDefaultMemory = "1G";
+static constexpr std::size_t kDefaultNumThreads = 0;
+// Number of points read from the input at a time
+static constexpr std::size_t kReadChunkSize = 1 << 20;
+
 void PointMaskToVolumeMask(
     const fs::path& ptsPath,
     const fs::path& outDir,
-    const vc::Volume::Pointer& volume);
+    const vc::Volume::Pointer& volume,
+    const fs::path& spillDir,
+    std::size_t memory,
+    std::size_t numThreads);
 void WriteMaskImage(
     int idx, std::size_t pad, const fs::path& dir, const cv::Mat& img);
 
@@ -50,7 +63,15 @@ auto main(int argc, char* argv[]) -> int
     ps2vmOpts.add_options()
         ("volpkg,v", po::value<std::string>(), "VolumePkg path")
         ("volume", po::value<std::string>(), "Volume to use for texturing. "
-           "Default: The first volume in the volume package.");
+           "Default: The first volume in the volume package.")
+        ("memory", po::value<std::string>()->default_value(kDefaultMemory),
+           "Maximum memory used to sort points by slice (e.g. 512M, 4G). "
+           "Points beyond this limit are spilled to temporary files.")
+        ("tmp-dir", po::value<std::string>(), "Directory for temporary "
+           "files. Default: The output directory.")
+        ("threads", po::value<std::size_t>()->default_value(kDefaultNumThreads),
+           "Number of threads writing slice masks. If 0, uses all available "
+           "threads");
     all.add(ps2vmOpts);
     // clang-format on
 
@@ -106,8 +127,29 @@ auto main(int argc, char* argv[]) -> int
             return EXIT_FAILURE;
         }
 
+        // Memory limit and temporary files
+        std::size_t memory{0};
+        try {
+            memory = vc::MemorySizeStringParser(
+                parsed["memory"].as<std::string>());
+        } catch (const std::exception& e) {
+            vc::Logger()->error("Invalid memory size: {}", e.what());
+            return EXIT_FAILURE;
+        }
+        auto spillDir = outPath;
+        if (parsed.count("tmp-dir") > 0) {
+            spillDir = parsed["tmp-dir"].as<std::string>();
+        }
+        if (not fs::is_directory(spillDir)) {
+            vc::Logger()->error(
+                "Temporary path is not directory: {}", spillDir.string());
+            return EXIT_FAILURE;
+        }
+
         // Do conversion
-        PointMaskToVolumeMask(inPath, outPath, volume);
+        PointMaskToVolumeMask(
+            inPath, outPath, volume, spillDir, memory,
+            parsed["threads"].as<std::size_t>());
 
     } else if (vc::IsFileType(inPath, {"jpg", "png", "tif", "bmp"})) {
         VolumeMaskToPointMask(inPath, outPath);
@@ -122,39 +164,59 @@ auto main(int argc, char* argv[]) -> int
 void PointMaskToVolumeMask(
     const fs::path& ptsPath,
     const fs::path& outDir,
-    const vc::Volume::Pointer& volume)
+    const vc::Volume::Pointer& volume,
+    const fs::path& spillDir,
+    std::size_t memory,
+    std::size_t numThreads)
 {
-    // Read the points
-    vc::Logger()->info("Loading point mask");
-    auto ptsRaw = vc::PointSetIO<cv::Vec3i>::ReadPointSet(ptsPath);
-
-    // Sort the points
-    vc::Logger()->info("Sorting points");
-    auto pts = ptsRaw.as_vector();
-    std::sort(pts.begin(), pts.end(), [](const auto& a, const auto& b) {
-        return a[2] < b[2];
-    });
-
-    // Mask the images
-    vc::Logger()->info("Converting mask");
-    std::size_t pad = std::to_string(volume->numSlices()).size();
-    int sliceNum{pts[0][2]};
-    cv::Size sliceSize(volume->sliceWidth(), volume->sliceHeight());
-    cv::Mat slice = cv::Mat::zeros(sliceSize, CV_8UC1);
-    for (const auto& p : vc::ProgressWrap(pts, "Masking voxels")) {
-        // If the slice number changes...
-        if (p[2] > sliceNum) {
-            // Write mask
-            WriteMaskImage(sliceNum, pad, outDir, slice);
-
-            // Set the new slice number and clear the slice
-            sliceNum = p[2];
-            slice = cv::Mat::zeros(sliceSize, CV_8UC1);
+    // Bucket the points by slice. Only the read buffer and at most memory
+    // bytes of points are held in memory, the rest are spilled to disk.
+    vc::Logger()->info("Sorting points by slice");
+    vc::PointSetReader<cv::Vec3i> reader(ptsPath);
+    auto maxBuffered = std::max<std::size_t>(memory / sizeof(cv::Vec3i), 1);
+    vc::PointSetBuckets<cv::Vec3i> buckets(spillDir, maxBuffered);
+
+    auto w = volume->sliceWidth();
+    auto h = volume->sliceHeight();
+    auto d = volume->numSlices();
+    std::size_t skipped{0};
+    std::vector<cv::Vec3i> chunk;
+    auto numChunks = (reader.size() + kReadChunkSize - 1) / kReadChunkSize;
+    auto readBar = vc::NewProgressBar(numChunks, "Reading points");
+    while (reader.read(chunk, kReadChunkSize) > 0) {
+        for (const auto& p : chunk) {
+            if (p[0] < 0 or p[0] >= w or p[1] < 0 or p[1] >= h or p[2] < 0 or
+                p[2] >= d) {
+                skipped++;
+                continue;
+            }
+            buckets.add(static_cast<std::size_t>(p[2]), p);
         }
-
-        slice.at<std::uint8_t>(p[1], p[0]) = 255;
+        readBar->tick();
     }
-    WriteMaskImage(sliceNum, pad, outDir, slice);
+    if (skipped > 0) {
+        vc::Logger()->warn("Skipped {} points outside of the volume", skipped);
+    }
+
+    // Mask the images. Every slice is independent, so only one slice image
+    // and its points are held in memory per thread.
+    vc::Logger()->info("Converting mask");
+    auto slices = buckets.buckets();
+    std::size_t pad = std::to_string(d).size();
+    cv::Size sliceSize(w, h);
+    auto bar = vc::NewProgressBar(slices.size(), "Masking slices");
+    vc::ParallelFor(
+        0, slices.size(),
+        [&](std::size_t i) {
+            auto z = slices[i];
+            cv::Mat slice = cv::Mat::zeros(sliceSize, CV_8UC1);
+            for (const auto& p : buckets.read(z)) {
+                slice.at<std::uint8_t>(p[1], p[0]) = 255;
+            }
+            WriteMaskImage(static_cast<int>(z), pad, outDir, slice);
+            bar->tick();
+        },
+        numThreads);
 }
 
 void WriteMaskImage(
@@ -173,7 +235,9 @@ void WriteMaskImage(
 
 void VolumeMaskToPointMask(const fs::path& inPath, const fs::path& outPath)
 {
-    vc::PointSet<cv::Vec3i> pts;
+    // Points are written as each slice is converted
+    vc::PointSetWriter<cv::Vec3i> writer(outPath);
+    std::vector<cv::Vec3i> pts;
 
     // Collect files
     vc::Logger()->info("Collecting file list");
@@ -194,11 +258,13 @@ void VolumeMaskToPointMask(const fs::path& inPath, const fs::path& outPath)
                 pts.emplace_back(x, y, z);
             }
         }
+        writer.write(pts);
+        pts.clear();
     }
 
-    // Write point set
+    // Finalize point set
     vc::Logger()->info("Writing point set...");
-    vc::PointSetIO<cv::Vec3i>::WritePointSet(outPath, pts);
+    writer.close();
 }
 
 auto CollectVolumeFiles(const fs::path& fmtPath) -> SliceList
@@ -6,6 +6,7 @@
 
 #include "vc/core/filesystem.hpp"
 #include "vc/core/io/FileFilters.hpp"
+#include "vc/core/io/MappedPointSet.hpp"
 #include "vc/core/io/PointSetIO.hpp"
 #include "vc/core/util/HashFunctions.hpp"
 #include "vc/core/util/Logging.hpp"
@@ -110,28 +111,32 @@ auto main(int argc, char* argv[]) -> int
 
     // Read all vcps files in the directory:
     for (const auto& p : resolvedPaths) {
-        // Load the file
+        // Map the file. Its points are only read, so they are used in place
+        // instead of being loaded into a PointSet.
         vc::Logger()->info("Loading file: \"{}\"", p.string());
-        auto tmpCloud = psio::ReadPointSet(p);
-        vc::Logger()->info("Loaded pointset with {} points", tmpCloud.size());
+        vc::MappedPointSet<Voxel> mapped(p);
+        vc::Logger()->info("Loaded pointset with {} points", mapped.size());
+        const Voxel* first = mapped.begin();
+        const Voxel* last = mapped.end();
 
         // Prune as needed
+        volcart::PointSet<Voxel> prunedCloud;
         if (parsed.count("prune")) {
             auto filename = p.stem().string();
             if (std::all_of(filename.begin(), filename.end(), ::isdigit)) {
                 int maxSliceNum = std::stoi(filename);
 
-                volcart::PointSet<Voxel> prunedCloud;
-                for (auto& pt : tmpCloud) {
+                for (const auto* pt = first; pt != last; ++pt) {
                     // Check the z-value. Only add it to prunedCloud if z is
                     // less than the vcps name.
-                    if (pt[2] <= maxSliceNum) {
-                        prunedCloud.push_back(pt);
+                    if ((*pt)[2] <= maxSliceNum) {
+                        prunedCloud.push_back(*pt);
                     }
                 }
-                tmpCloud = prunedCloud;
+                first = prunedCloud.data();
+                last = first + prunedCloud.size();
                 vc::Logger()->info(
-                    "Pruned pointset to {} points", tmpCloud.size());
+                    "Pruned pointset to {} points", prunedCloud.size());
             } else {
                 vc::Logger()->warn(
                     "Filename contains characters other than digits. File will "
@@ -143,7 +148,7 @@ auto main(int argc, char* argv[]) -> int
         // Overwrite overlap
         if (parsed.count("overwrite-overlap")) {
             auto minMax = std::minmax_element(
-                tmpCloud.begin(), tmpCloud.end(),
+                first, last,
                 [](const auto& l, const auto& r) { return l[2] < r[2]; });
             auto minZ = (*minMax.first)[2];
             auto maxZ = (*minMax.second)[2];
@@ -163,8 +168,8 @@ auto main(int argc, char* argv[]) -> int
 
         // Add all the points in the smaller cloud to the set
         auto origSize = pts.size();
-        pts.reserve(pts.size() + tmpCloud.size());
-        pts.insert(tmpCloud.begin(), tmpCloud.end());
+        pts.reserve(pts.size() + static_cast<std::size_t>(last - first));
+        pts.insert(first, last);
         vc::Logger()->info("Merged {} new points", pts.size() - origSize);
     }
 
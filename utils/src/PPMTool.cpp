@@ -1,4 +1,5 @@
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <regex>
 #include <vector>
@@ -7,6 +8,7 @@
 
 #include "vc/core/filesystem.hpp"
 #include "vc/core/io/FileFilters.hpp"
+#include "vc/core/io/MappedPointSet.hpp"
 #include "vc/core/io/MeshIO.hpp"
 #include "vc/core/types/ITKMesh.hpp"
 #include "vc/core/types/PerPixelMap.hpp"
@@ -92,16 +94,30 @@ auto main(int argc, char* argv[]) -> int
 
     // Get input file
     const fs::path ppmPath = parsed["ppm"].as<std::string>();
+
+    // Map the PPM and its mask. The stats and mesh output only read each
+    // mapping once, so the full PerPixelMap is not loaded for them.
     Logger()->info("Reading PPM...");
-    auto ppm = PerPixelMap::ReadPPM(ppmPath);
+    const MappedPointSet<cv::Vec6d> mapped(ppmPath);
+    if (!mapped.ordered()) {
+        Logger()->error("PPM is not ordered: {}", ppmPath.string());
+        return EXIT_FAILURE;
+    }
+    const auto mask = PerPixelMap::ReadPPMMask(ppmPath);
+    auto hasMapping = [&mask](std::size_t y, std::size_t x) {
+        return mask.empty() || mask.at<std::uint8_t>(y, x) == 255;
+    };
 
     // Get min/max bound
     std::array<double, 3> min;
     std::fill(min.begin(), min.end(), std::numeric_limits<double>::max());
     std::array<double, 3> max;
     std::fill(max.begin(), max.end(), std::numeric_limits<double>::min());
-    for (const auto [y, x] : ppm.getMappingCoords()) {
-        const auto& m = ppm.getMapping(y, x);
+    for (const auto [y, x] : range2D(mapped.height(), mapped.width())) {
+        if (!hasMapping(y, x)) {
+            continue;
+        }
+        const auto& m = mapped(y, x);
         min[0] = std::min(min[0], m[0]);
         min[1] = std::min(min[1], m[1]);
         min[2] = std::min(min[2], m[2]);
@@ -115,9 +131,10 @@ auto main(int argc, char* argv[]) -> int
     std::locale::global(std::locale(""));
 
     // Report PPM stats
-    auto h = ppm.height();
-    auto w = ppm.width();
-    auto ms = ppm.numMappings();
+    auto h = mapped.height();
+    auto w = mapped.width();
+    auto ms = mask.empty() ? h * w
+                           : static_cast<std::size_t>(cv::countNonZero(mask));
     auto p = 100. * static_cast<double>(ms) / static_cast<double>(h * w);
     Logger()->info(
         "Loaded PPM:\n"
@@ -144,8 +161,8 @@ auto main(int argc, char* argv[]) -> int
     // Setup ROI
     std::size_t minX = 0;
     std::size_t minY = 0;
-    std::size_t maxX = ppm.width();
-    std::size_t maxY = ppm.height();
+    std::size_t maxX = mapped.width();
+    std::size_t maxY = mapped.height();
     if (parsed.count("roi") > 0) {
         auto roi = ::ParseROI(parsed["roi"].as<std::string>());
         minX = std::max(minX, roi.x);
@@ -165,12 +182,12 @@ auto main(int argc, char* argv[]) -> int
         ITKPixel normal;
         for (auto [y, x] : range2D(minY, maxY, minX, maxX)) {
             // Skip unmapped pixels
-            if (!ppm.hasMapping(y, x)) {
+            if (!hasMapping(y, x)) {
                 continue;
             }
 
             const auto id = mesh->GetNumberOfPoints();
-            const auto& m = ppm.getMapping(y, x);
+            const auto& m = mapped(y, x);
             pt[0] = m[0];
             pt[1] = m[1];
             pt[2] = m[2];
@@ -185,6 +202,10 @@ auto main(int argc, char* argv[]) -> int
         Logger()->info("Writing mesh file...");
         WriteMesh(outPath, mesh);
     } else {
+        // The output keeps the cell map, so load the full PPM
+        Logger()->info("Loading PPM...");
+        auto ppm = PerPixelMap::ReadPPM(ppmPath);
+
         Logger()->info("Cropping PPM...");
         const auto h = maxY - minY;
         const auto w = maxX - minX;
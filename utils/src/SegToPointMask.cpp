@@ -1,5 +1,6 @@
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
 #include <boost/program_options.hpp>
 #include <opencv2/core.hpp>
@@ -7,7 +8,7 @@
 #include "vc/app_support/ProgressIndicator.hpp"
 #include "vc/core/filesystem.hpp"
 #include "vc/core/io/PointSetIO.hpp"
-#include "vc/core/types/PointSet.hpp"
+#include "vc/core/io/PointSetStream.hpp"
 #include "vc/core/types/VolumePkg.hpp"
 #include "vc/core/util/Logging.hpp"
 #include "vc/segmentation/ComputeVolumetricMask.hpp"
@@ -117,15 +118,22 @@ auto main(int argc, char* argv[]) -> int
     }
     maskGen.setMeasureVertical(parsed.count("measure-vert") > 0);
 
+    // Write each slice's mask as it's computed instead of storing the full
+    // mask in memory
+    vc::PointSetWriter<cv::Vec3i> writer(outPath);
+    maskGen.setStoreMask(false);
+    maskGen.sliceMasked.connect(
+        [&writer](std::size_t /*z*/, const std::vector<cv::Vec3i>& voxels) {
+            writer.write(voxels);
+        });
+
     // Setup progress reporting
     vc::ReportProgress(maskGen, "Generating mask");
 
     // Compute the mask
-    auto mask = maskGen.compute();
+    maskGen.compute();
 
     // Save the mask
     vc::Logger()->info("Saving mask");
-    vc::PointSet<cv::Vec3i> maskPts;
-    maskPts.append(mask->as_vector());
-    vc::PointSetIO<cv::Vec3i>::WritePointSet(outPath, maskPts);
+    writer.close();
 }
\ No newline at end of file
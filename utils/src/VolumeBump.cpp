@@ -1,22 +1,22 @@
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <iomanip>
 #include <limits>
-#include <map>
 #include <sstream>
+#include <vector>
 
 #include <boost/program_options.hpp>
 #include <opencv2/core.hpp>
 #include <opencv2/imgcodecs.hpp>
 
-#include "vc/app_support/GetMemorySize.hpp"
 #include "vc/core/filesystem.hpp"
 #include "vc/core/io/TIFFIO.hpp"
 #include "vc/core/types/PerPixelMap.hpp"
 #include "vc/core/types/Volume.hpp"
 #include "vc/core/types/VolumePkg.hpp"
 #include "vc/core/util/Logging.hpp"
-#include "vc/core/util/MemorySizeStringParser.hpp"
+#include "vc/core/util/Parallel.hpp"
 
 namespace po = boost::program_options;
 namespace fs = volcart::filesystem;
@@ -25,6 +25,15 @@ namespace vc = volcart;
 // Volpkg version required by this app
 static constexpr int VOLPKG_MIN_VERSION = 6;
 static const double MAX_16BPC = std::numeric_limits<std::uint16_t>::max();
+static constexpr std::size_t kDefaultNumThreads = 0;
+static constexpr std::size_t kDefaultBandSize = 16;
+
+// A bump applied to a single voxel of a slice
+struct Bump {
+    int x;
+    int y;
+    double opacity;
+};
 
 fs::path g_outputDir;
 std::size_t g_numSliceChars;
@@ -43,9 +52,13 @@ auto main(int argc, char* argv[]) -> int
         ("ppm,p", po::value<std::string>()->required(), "Input PPM file")
         ("bump-mask,m", po::value<std::string>()->required(), "Bump mask")
         ("output-dir,o", po::value<std::string>()->required(),"Output directory")
-        ("cache-memory-limit", po::value<std::string>(), "Maximum size of the "
-            "slice cache in bytes. Accepts the suffixes: (K|M|G|T)(B). "
-            "Default: 50% of the total system memory.");
+        ("cache-memory-limit", po::value<std::string>(), "Deprecated and "
+            "ignored. Every slice is read once, so slices are not cached.")
+        ("threads", po::value<std::size_t>()->default_value(kDefaultNumThreads),
+            "Number of threads bumping slices. If 0, uses all available "
+            "threads")
+        ("band-size", po::value<std::size_t>()->default_value(kDefaultBandSize),
+            "Number of consecutive slices assigned to a thread at a time");
 
 
     po::options_description visOptions("Visualization Options");
@@ -98,18 +111,12 @@ auto main(int argc, char* argv[]) -> int
     }
     g_numSliceChars = std::to_string(volume->numSlices()).size();
 
-    // Set the cache size
-    std::size_t cacheBytes;
-    if (parsed.count("cache-memory-limit")) {
-        auto cacheSizeOpt = parsed["cache-memory-limit"].as<std::string>();
-        cacheBytes = vc::MemorySizeStringParser(cacheSizeOpt);
-    } else {
-        cacheBytes = SystemMemorySize() / 2;
+    // Every slice is read, bumped, and written exactly once, so caching only
+    // costs memory
+    if (parsed.count("cache-memory-limit") > 0) {
+        vc::Logger()->warn("--cache-memory-limit is deprecated and ignored");
     }
-    volume->setCacheMemoryInBytes(cacheBytes);
-    vc::Logger()->info(
-        "Volume Cache :: Capacity: {} || Size: {}", volume->getCacheCapacity(),
-        vc::BytesToMemorySizeString(cacheBytes));
+    volume->setCacheSlices(false);
 
     ///// Load the output directory /////
     g_outputDir = parsed["output-dir"].as<std::string>();
@@ -126,61 +133,50 @@ auto main(int argc, char* argv[]) -> int
     auto bumpVal = (volume->max() - volume->min()) * bumpPerc;
 
     ///// Perform the bump /////
-    // Get the mappings
-    auto mappings = ppm.getMappings();
-
-    // Sort the mappings by Z-value
-    std::sort(
-        mappings.begin(), mappings.end(), [](const auto& lhs, const auto& rhs) {
-            return lhs.pos[2] < rhs.pos[2];
-        });
-
-    // Iterate through the mappings
-    int currentZ = -1;
-    cv::Mat currentSlice;
-    std::map<int, cv::Mat> bumpedSlices;
-    for (const auto& pixel : mappings) {
+    // Bucket the bumps by slice
+    vc::Logger()->info("Sorting mappings by slice");
+    std::vector<std::vector<Bump>> bumpsBySlice(volume->numSlices());
+    for (const auto& [py, px] : ppm.getMappingCoords()) {
+        const auto& m = ppm.getMapping(py, px);
+
         // Get integer coordinates
-        auto x = static_cast<int>(std::floor(pixel.pos[0]));
-        auto y = static_cast<int>(std::floor(pixel.pos[1]));
-        auto z = static_cast<int>(std::floor(pixel.pos[2]));
+        auto x = static_cast<int>(std::floor(m[0]));
+        auto y = static_cast<int>(std::floor(m[1]));
+        auto z = static_cast<int>(std::floor(m[2]));
 
         // Skip if this mapping is outside the volume bounds
         if (!volume->isInBounds(x, y, z)) {
             continue;
         }
 
-        // Check if our slice index has changed
-        if (z != currentZ) {
-            if (!currentSlice.empty()) {
-                // Add this to our image writing queue
-                bumpedSlices[currentZ] = currentSlice;
-
-                // Clear the queue if it's big enough
-                if (bumpedSlices.size() == 100) {
-                    for (const auto& s : bumpedSlices) {
-                        WriteBumpedSlice(s.second, s.first);
-                    }
-                    bumpedSlices.clear();
-                }
-            }
-
-            // Get the slice image for this PPM mapping
-            currentZ = z;
-            currentSlice = volume->getSliceDataCopy(currentZ);
-        }
-
         // Use the bump mask as an opacity function on the bumpVal
-        auto bumpOpacity =
-            bumpMask.at<std::uint16_t>(pixel.y, pixel.x) / MAX_16BPC;
-        auto bumped =
-            currentSlice.at<std::uint16_t>(y, x) + bumpOpacity * bumpVal;
-        currentSlice.at<std::uint16_t>(y, x) =
-            static_cast<std::uint16_t>(std::min(bumped, MAX_16BPC));
+        auto opacity = bumpMask.at<std::uint16_t>(py, px) / MAX_16BPC;
+        bumpsBySlice[z].push_back({x, y, opacity});
     }
 
-    // Write the last slice image
-    WriteBumpedSlice(currentSlice, currentZ);
+    // Bump bands of consecutive slices in parallel. Each thread only holds
+    // the slice it is currently bumping.
+    auto numThreads = parsed["threads"].as<std::size_t>();
+    auto bandSize = parsed["band-size"].as<std::size_t>();
+    bandSize = std::max<std::size_t>(bandSize, 1);
+    vc::ParallelForChunks(
+        0, bumpsBySlice.size(),
+        [&](std::size_t first, std::size_t last, std::size_t /*thread*/) {
+            for (auto z = first; z < last; z++) {
+                const auto& bumps = bumpsBySlice[z];
+                if (bumps.empty()) {
+                    continue;
+                }
+                auto slice = volume->getSliceDataCopy(static_cast<int>(z));
+                for (const auto& b : bumps) {
+                    auto& v = slice.at<std::uint16_t>(b.y, b.x);
+                    auto bumped = v + b.opacity * bumpVal;
+                    v = static_cast<std::uint16_t>(std::min(bumped, MAX_16BPC));
+                }
+                WriteBumpedSlice(slice, static_cast<int>(z));
+            }
+        },
+        numThreads, bandSize);
 }
 
 void WriteBumpedSlice(const cv::Mat& slice, int index)